@@ -0,0 +1,172 @@
+/// \file AnimationBenchmark.cpp
+/// \brief A command-line tool that compares playing a crowd from
+///   CompressedClips against playing it from the AnimationClips they were
+///   made from.
+/// \author Ethan Gingrich
+/// \version A08
+///
+/// Usage:
+///   AnimationBenchmark.out [characters [bones [frames]]]
+///     Bakes a walk-like clip for a skeleton of that many bones (60 by
+///     default) at 30 keys per second, compresses it, and reports both
+///     sizes and the largest error.  Then plays it forward on that many
+///     characters (1000 by default), each starting at a different time, for
+///     that many 60 Hz frames (120 by default): from the AnimationClip, from
+///     the CompressedClip one character at a time with and without cursors,
+///     and from the CompressedClip with sampleMany.  Build it with
+///     optimization on, or none of the sides is inlined.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "CompressedClip.hpp"
+#include "TimingHistory.hpp"
+
+/// \brief Bakes a looping clip like a walk cycle: the root travels and bobs,
+///   every bone swings on its own phase, a few bones bend on two axes, and
+///   nothing is scaled.
+/// \param[in] bones The number of bones.
+/// \return The clip.
+static AnimationClip
+bakeClip (unsigned int bones)
+{
+  const float SECONDS = 4.0f;
+  const float KEYS_PER_SECOND = 30.0f;
+  const unsigned int KEYS = static_cast<unsigned int> (SECONDS * KEYS_PER_SECOND) + 1;
+
+  AnimationClip clip ("walk", SECONDS);
+  for (unsigned int bone = 0; bone < bones; ++bone)
+  {
+    AnimationChannel channel;
+    channel.node = bone;
+    for (unsigned int keyNum = 0; keyNum < KEYS; ++keyNum)
+    {
+      float time = keyNum / KEYS_PER_SECOND;
+      float phase = 2.0f * static_cast<float> (M_PI) * time / SECONDS * 2.0f + bone * 0.7f;
+      Vector3 position (0, 0.25f, 0);
+      if (bone == 0)
+	position = Vector3 (0.1f * std::sin (phase), 1.0f + 0.05f * std::sin (2.0f * phase), time);
+      Quaternion swing (25.0f * std::sin (phase), Vector3 (1, 0, 0));
+      if (bone % 4 == 0)
+	swing = Quaternion (10.0f * std::cos (phase), Vector3 (0, 0, 1)) * swing;
+      channel.positionKeys.push_back ({ time, position });
+      channel.rotationKeys.push_back ({ time, swing });
+      channel.scaleKeys.push_back ({ time, Vector3 (1, 1, 1) });
+    }
+    clip.addChannel (channel);
+  }
+  return clip;
+}
+
+/// \brief Times a function.
+/// \param[in] work The function to time.
+/// \return The elapsed time in milliseconds.
+template<typename Function>
+static double
+timeMs (Function work)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  work ();
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now () - start;
+  return elapsed.count ();
+}
+
+/// \brief Runs the benchmark.
+/// \param[in] argc The number of command-line arguments.
+/// \param[in] argv The number of characters, bones, and frames.
+/// \return EXIT_SUCCESS.
+int
+main (int argc, char* argv[])
+{
+  const float FRAME_SECONDS = 1.0f / 60.0f;
+  const float START_STAGGER_SECONDS = 0.37f;
+
+  unsigned int characters = argc > 1 ? std::atoi (argv[1]) : 1000;
+  unsigned int bones = argc > 2 ? std::atoi (argv[2]) : 60;
+  unsigned int frames = argc > 3 ? std::atoi (argv[3]) : 120;
+
+  AnimationClip clip = bakeClip (bones);
+  CompressedClip compressed (clip);
+  unsigned int keys = 0;
+  for (const AnimationChannel& channel : clip.getChannels ())
+    keys += channel.positionKeys.size () + channel.rotationKeys.size () + channel.scaleKeys.size ();
+
+  // The largest error anywhere, sampled finer than the keys.
+  float positionError = 0.0f, rotationError = 0.0f;
+  std::vector<Transform> expected (bones), actual (bones);
+  for (float time = 0.0f; time < clip.getDuration (); time += 0.005f)
+  {
+    clip.sample (time, expected);
+    compressed.sample (time, actual);
+    for (unsigned int bone = 0; bone < bones; ++bone)
+    {
+      positionError = std::max (positionError,
+				(actual[bone].getPosition () - expected[bone].getPosition ()).length ());
+      float cosine = std::min (1.0f, actual[bone].getBack ().dot (expected[bone].getBack ()));
+      rotationError = std::max (rotationError, std::acos (cosine) * 180.0f / static_cast<float> (M_PI));
+    }
+  }
+
+  std::printf ("%u bones, %.1f s\n", bones, clip.getDuration ());
+  std::printf ("  AnimationClip   %6u keys %9zu bytes\n", keys, clip.getByteCount ());
+  std::printf ("  CompressedClip  %6u keys %9zu bytes (%.1fx smaller)\n", compressed.getKeyCount (),
+	       compressed.getByteCount (),
+	       static_cast<double> (clip.getByteCount ()) / compressed.getByteCount ());
+  std::printf ("  largest error   %.5f units, %.3f degrees\n", positionError, rotationError);
+
+  std::vector<std::vector<Transform>> locals (characters, std::vector<Transform> (bones));
+  std::vector<CompressedClip::Cursor> cursors (characters);
+  std::vector<std::vector<Transform>*> localPointers (characters);
+  std::vector<CompressedClip::Cursor*> cursorPointers (characters);
+  std::vector<float> times (characters);
+  for (unsigned int character = 0; character < characters; ++character)
+  {
+    localPointers[character] = &locals[character];
+    cursorPointers[character] = &cursors[character];
+  }
+  // Each side plays the same frames from the same start.
+  auto play = [&] (auto sampleFrame)
+  {
+    TimingHistory history (frames);
+    for (unsigned int character = 0; character < characters; ++character)
+      times[character] = character * START_STAGGER_SECONDS;
+    for (unsigned int frame = 0; frame < frames; ++frame)
+    {
+      history.add (timeMs (sampleFrame));
+      for (float& time : times)
+	time += FRAME_SECONDS;
+    }
+    return history.getPercentile (50);
+  };
+
+  double clipMs = play ([&] ()
+  {
+    for (unsigned int character = 0; character < characters; ++character)
+      clip.sample (times[character], locals[character]);
+  });
+  double searchMs = play ([&] ()
+  {
+    for (unsigned int character = 0; character < characters; ++character)
+      compressed.sample (times[character], locals[character]);
+  });
+  double cursorMs = play ([&] ()
+  {
+    for (unsigned int character = 0; character < characters; ++character)
+      compressed.sample (times[character], locals[character], &cursors[character]);
+  });
+  double manyMs = play ([&] ()
+  {
+    compressed.sampleMany (characters, times.data (), localPointers.data (), cursorPointers.data ());
+  });
+
+  double poses = characters;
+  std::printf ("%u characters, median of %u frames\n", characters, frames);
+  std::printf ("  AnimationClip::sample        %8.3f ms %10.0f poses/s\n", clipMs, poses * 1e3 / clipMs);
+  std::printf ("  CompressedClip::sample       %8.3f ms %10.0f poses/s\n", searchMs, poses * 1e3 / searchMs);
+  std::printf ("    with cursors               %8.3f ms %10.0f poses/s\n", cursorMs, poses * 1e3 / cursorMs);
+  std::printf ("  CompressedClip::sampleMany   %8.3f ms %10.0f poses/s\n", manyMs, poses * 1e3 / manyMs);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,130 @@
+/// \file AnimationClip.cpp
+/// \brief Definitions of AnimationClip member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <algorithm>
+#include <cmath>
+
+#include "AnimationClip.hpp"
+
+/// \brief Finds the two keys of a track on either side of some time.
+/// \tparam Key VectorKey or RotationKey.
+/// \param[in] keys The track, sorted by time.
+/// \param[in] time The time.
+/// \param[out] amount How far from the first key toward the second the time
+///   is, from 0 to 1.
+/// \return The position of the first key; the second follows it, unless
+///   time is outside the track, in which case both are the nearest end.
+/// \pre keys is not empty.
+template <typename Key>
+static size_t
+findKeys (const std::vector<Key>& keys, float time, float& amount)
+{
+  typename std::vector<Key>::const_iterator after =
+    std::upper_bound (keys.begin (), keys.end (), time,
+		      [] (float t, const Key& key) { return t < key.time; });
+  amount = 0.0f;
+  if (after == keys.begin ())
+    return 0;
+  if (after == keys.end ())
+    return keys.size () - 1;
+  const Key& before = *(after - 1);
+  amount = (time - before.time) / (after->time - before.time);
+  return after - keys.begin () - 1;
+}
+
+/// \brief Gets the value of a position or scale track at some time.
+/// \param[in] keys The track, sorted by time.
+/// \param[in] time The time.
+/// \return The value, linearly interpolated between keys.
+/// \pre keys is not empty.
+static Vector3
+sampleVectors (const std::vector<VectorKey>& keys, float time)
+{
+  float amount;
+  size_t first = findKeys (keys, time, amount);
+  if (amount == 0.0f)
+    return keys[first].value;
+  return keys[first].value * (1.0f - amount) + keys[first + 1].value * amount;
+}
+
+/// \brief Gets the value of a rotation track at some time.
+/// \param[in] keys The track, sorted by time.
+/// \param[in] time The time.
+/// \return The rotation, interpolated between keys.
+/// \pre keys is not empty.
+static Quaternion
+sampleRotations (const std::vector<RotationKey>& keys, float time)
+{
+  float amount;
+  size_t first = findKeys (keys, time, amount);
+  if (amount == 0.0f)
+    return keys[first].value;
+  return nlerp (keys[first].value, keys[first + 1].value, amount);
+}
+
+AnimationClip::AnimationClip (const std::string& name, float duration)
+  : m_name (name), m_duration (duration)
+{
+}
+
+const std::string&
+AnimationClip::getName () const
+{
+  return m_name;
+}
+
+float
+AnimationClip::getDuration () const
+{
+  return m_duration;
+}
+
+void
+AnimationClip::addChannel (const AnimationChannel& channel)
+{
+  m_channels.push_back (channel);
+}
+
+const std::vector<AnimationChannel>&
+AnimationClip::getChannels () const
+{
+  return m_channels;
+}
+
+size_t
+AnimationClip::getByteCount () const
+{
+  size_t bytes = m_channels.size () * sizeof (AnimationChannel);
+  for (const AnimationChannel& channel : m_channels)
+    bytes += (channel.positionKeys.size () + channel.scaleKeys.size ()) * sizeof (VectorKey)
+      + channel.rotationKeys.size () * sizeof (RotationKey);
+  return bytes;
+}
+
+void
+AnimationClip::sample (float time, std::vector<Transform>& locals) const
+{
+  if (m_duration > 0.0f)
+  {
+    time = std::fmod (time, m_duration);
+    if (time < 0.0f)
+      time += m_duration;
+  }
+  for (const AnimationChannel& channel : m_channels)
+  {
+    Transform& local = locals[channel.node];
+    // A track with no keys leaves that part of the bind pose as it was.
+    if (!channel.rotationKeys.empty ())
+      local.setOrientation (sampleRotations (channel.rotationKeys, time).toMatrix3 ());
+    if (!channel.scaleKeys.empty ())
+    {
+      Vector3 scale = sampleVectors (channel.scaleKeys, time);
+      local.setOrientation (local.getRight () * scale.m_x, local.getUp () * scale.m_y,
+			    local.getBack () * scale.m_z);
+    }
+    if (!channel.positionKeys.empty ())
+      local.setPosition (sampleVectors (channel.positionKeys, time));
+  }
+}
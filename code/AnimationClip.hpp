@@ -0,0 +1,108 @@
+/// \file AnimationClip.hpp
+/// \brief Declaration of AnimationClip class and the keyframe types it is
+///   made of.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef ANIMATION_CLIP_HPP
+#define ANIMATION_CLIP_HPP
+
+#include <string>
+#include <vector>
+
+#include "Quaternion.hpp"
+#include "Transform.hpp"
+#include "Vector3.hpp"
+
+/// \brief A position or scale at some time.
+struct VectorKey
+{
+  /// When, in seconds from the start of the clip.
+  float time;
+  /// The position or scale.
+  Vector3 value;
+};
+
+/// \brief A rotation at some time.
+struct RotationKey
+{
+  /// When, in seconds from the start of the clip.
+  float time;
+  /// The rotation.
+  Quaternion value;
+};
+
+/// \brief The keys that move one node of a model.  Each track is sorted by
+///   time, and an empty track leaves that part of the node's bind pose
+///   alone.
+struct AnimationChannel
+{
+  /// The position of the node in Model::nodes.
+  unsigned int node;
+  /// Where the node is relative to its parent.
+  std::vector<VectorKey> positionKeys;
+  /// How the node is turned relative to its parent.
+  std::vector<RotationKey> rotationKeys;
+  /// How the node is scaled along its own axes.
+  std::vector<VectorKey> scaleKeys;
+};
+
+/// \brief One named animation of a model, such as a walk cycle: a set of
+///   channels that together give every animated node's local transform at
+///   any time.
+class AnimationClip
+{
+public:
+
+  /// \brief Constructs an empty clip.
+  /// \param[in] name The name the file gave the clip.
+  /// \param[in] duration The length of the clip, in seconds.
+  AnimationClip (const std::string& name = "", float duration = 0.0f);
+
+  /// \brief Gets the name of the clip.
+  /// \return The name.
+  const std::string&
+  getName () const;
+
+  /// \brief Gets the length of the clip.
+  /// \return The length in seconds.
+  float
+  getDuration () const;
+
+  /// \brief Adds the keys for one node.
+  /// \param[in] channel The keys, each track sorted by time.
+  /// \pre No channel for the same node has been added.
+  void
+  addChannel (const AnimationChannel& channel);
+
+  /// \brief Gets every channel.
+  /// \return The channels, in the order they were added.
+  const std::vector<AnimationChannel>&
+  getChannels () const;
+
+  /// \brief Gets the memory the clip's keys and channels take.
+  /// \return The number of bytes.
+  size_t
+  getByteCount () const;
+
+  /// \brief Poses the animated nodes at some time.
+  /// \param[in] time The time in seconds.  The clip loops, so any time is
+  ///   wrapped into [0, duration).
+  /// \param[in,out] locals Every node's local transform, indexed like
+  ///   Model::nodes.  Those of animated nodes are replaced; the rest are
+  ///   left alone.
+  /// \pre locals has an element for every node a channel names.
+  void
+  sample (float time, std::vector<Transform>& locals) const;
+
+private:
+
+  /// The name the file gave the clip.
+  std::string m_name;
+  /// The length of the clip, in seconds.
+  float m_duration;
+  /// The keys for each animated node.
+  std::vector<AnimationChannel> m_channels;
+};
+
+#endif//ANIMATION_CLIP_HPP
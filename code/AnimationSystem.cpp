@@ -0,0 +1,176 @@
+/// \file AnimationSystem.cpp
+/// \brief Definitions of AnimationSystem member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+#include "AnimationSystem.hpp"
+#include "CpuProfiler.hpp"
+
+/// The number of per-character timings kept, enough for a crowd of
+///   hundreds over a few steps.
+static const unsigned int CHARACTER_TIME_HISTORY = 4096;
+
+AnimationSystem::Character::Character (const Model& model, const std::string& prefix)
+  : animator (model), namePrefix (prefix), seconds (0.0)
+{
+}
+
+AnimationSystem::AnimationSystem (JobSystem* jobs)
+  : m_jobs (jobs != nullptr ? jobs : &JobSystem::getShared ()),
+    m_characterTimes (CHARACTER_TIME_HISTORY)
+{
+}
+
+void
+AnimationSystem::addCharacter (const Model& model, const std::string& namePrefix,
+			       unsigned int clip, float startTime)
+{
+  std::unique_ptr<Character> character (new Character (model, namePrefix));
+  character->animator.play (clip, startTime);
+  m_arrivals.push (std::move (character));
+}
+
+void
+AnimationSystem::update (Scene& scene, float seconds)
+{
+  PROFILE_ZONE ("AnimationSystem::update");
+  std::unique_ptr<Character> arrived;
+  while (m_arrivals.tryPop (arrived))
+    m_waiting.push_back (std::move (arrived));
+  // Meshes reach the Scene a few per frame, so a character waits until the
+  //   last of its own has.
+  size_t characterCount = m_characters.size ();
+  for (size_t waitingNum = 0; waitingNum < m_waiting.size (); )
+  {
+    if (findMeshes (scene, *m_waiting[waitingNum]))
+    {
+      m_characters.push_back (std::move (m_waiting[waitingNum]));
+      m_waiting.erase (m_waiting.begin () + waitingNum);
+    }
+    else
+      ++waitingNum;
+  }
+  if (m_characters.size () != characterCount)
+    makeBatches ();
+  if (m_characters.empty ())
+    return;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  // Split into a few pieces per thread, so that threads finishing early
+  //   take more and a few expensive batches don't hold up the rest.
+  m_jobs->parallelFor (m_batchStarts.size (), 1, [&] (size_t begin, size_t end)
+  {
+    PROFILE_ZONE ("pose characters");
+    for (size_t batchNum = begin; batchNum < end; ++batchNum)
+    {
+      size_t start = m_batchStarts[batchNum];
+      size_t last = batchNum + 1 < m_batchStarts.size () ? m_batchStarts[batchNum + 1]
+	: m_characters.size ();
+      pose (&m_characters[start], static_cast<unsigned int> (last - start), seconds);
+    }
+  });
+
+  for (const std::unique_ptr<Character>& character : m_characters)
+    m_characterTimes.add (character->seconds * 1.0e6);
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now () - start;
+  m_updateTimes.add (elapsed.count ());
+}
+
+unsigned int
+AnimationSystem::getCharacterCount () const
+{
+  return m_characters.size ();
+}
+
+unsigned int
+AnimationSystem::getThreadCount () const
+{
+  return m_jobs->getThreadCount ();
+}
+
+const TimingHistory&
+AnimationSystem::getCharacterTimes () const
+{
+  return m_characterTimes;
+}
+
+const TimingHistory&
+AnimationSystem::getUpdateTimes () const
+{
+  return m_updateTimes;
+}
+
+bool
+AnimationSystem::findMeshes (Scene& scene, Character& character)
+{
+  const Model& model = character.animator.getModel ();
+  std::vector<std::pair<unsigned int, SkinnedMesh*>> meshes;
+  for (unsigned int meshNum = 0; meshNum < model.meshes.size (); ++meshNum)
+  {
+    if (model.meshes[meshNum].bones.empty ())
+      continue;
+    std::string name = character.namePrefix + std::to_string (meshNum);
+    if (!scene.hasMesh (name))
+      return false;
+    SkinnedMesh* mesh = dynamic_cast<SkinnedMesh*> (scene.getMesh (name));
+    if (mesh != nullptr)
+      meshes.push_back (std::make_pair (meshNum, mesh));
+  }
+  character.meshes = std::move (meshes);
+  return true;
+}
+
+void
+AnimationSystem::makeBatches ()
+{
+  std::stable_sort (m_characters.begin (), m_characters.end (),
+		    [] (const std::unique_ptr<Character>& a, const std::unique_ptr<Character>& b)
+		    {
+		      return std::less<const CompressedClip*> () (a->animator.getClip (),
+								  b->animator.getClip ());
+		    });
+  m_batchStarts.clear ();
+  for (size_t characterNum = 0; characterNum < m_characters.size (); ++characterNum)
+  {
+    bool sameClip = characterNum > 0 && m_characters[characterNum]->animator.getClip ()
+      == m_characters[characterNum - 1]->animator.getClip ();
+    if (!sameClip || characterNum - m_batchStarts.back () == CompressedClip::LANES)
+      m_batchStarts.push_back (characterNum);
+  }
+}
+
+void
+AnimationSystem::pose (const std::unique_ptr<Character>* characters, unsigned int count,
+		       float seconds)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  float times[CompressedClip::LANES];
+  std::vector<Transform>* locals[CompressedClip::LANES];
+  CompressedClip::Cursor* cursors[CompressedClip::LANES];
+  for (unsigned int characterNum = 0; characterNum < count; ++characterNum)
+  {
+    Animator& animator = characters[characterNum]->animator;
+    animator.advance (seconds);
+    times[characterNum] = animator.getTime ();
+    locals[characterNum] = &animator.startPose ();
+    cursors[characterNum] = &animator.getCursor ();
+  }
+  const CompressedClip* clip = characters[0]->animator.getClip ();
+  if (clip != nullptr)
+    clip->sampleMany (count, times, locals, cursors);
+  for (unsigned int characterNum = 0; characterNum < count; ++characterNum)
+  {
+    Character& character = *characters[characterNum];
+    character.animator.finishPose ();
+    for (const std::pair<unsigned int, SkinnedMesh*>& mesh : character.meshes)
+      mesh.second->setBonePalette (character.animator.getPalette (mesh.first));
+  }
+  // The batch is blended together, so its characters share its time.
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now () - start;
+  for (unsigned int characterNum = 0; characterNum < count; ++characterNum)
+    characters[characterNum]->seconds = elapsed.count () / count;
+}
@@ -0,0 +1,150 @@
+/// \file AnimationSystem.hpp
+/// \brief Declaration of AnimationSystem class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef ANIMATION_SYSTEM_HPP
+#define ANIMATION_SYSTEM_HPP
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Animator.hpp"
+#include "JobSystem.hpp"
+#include "MpscQueue.hpp"
+#include "Scene.hpp"
+#include "SkinnedMesh.hpp"
+#include "TimingHistory.hpp"
+
+/// \brief Poses every animated character in a Scene once per simulation
+///   step.
+/// A character is an Animator plus the SkinnedMeshes it poses, found in the
+///   Scene by name.  Characters playing the same clip are kept side by side
+///   and posed in batches of CompressedClip::LANES, so one sampleMany call
+///   blends all of a batch's keys together.  Each step the batches are split
+///   among a JobSystem's threads, each of which samples its batches' clips
+///   and hands the new bone matrices to their meshes.
+///   Characters share nothing but their (read-only) Model, so no locking is
+///   needed.
+class AnimationSystem
+{
+public:
+
+  /// \brief Constructs an AnimationSystem with no characters.
+  /// \param[in] jobs The JobSystem to pose characters on, or nullptr for
+  ///   the shared one.  It must outlive this AnimationSystem.
+  explicit AnimationSystem (JobSystem* jobs = nullptr);
+
+  /// \brief Copy constructor removed because you shouldn't be copying
+  ///   AnimationSystems.
+  AnimationSystem (const AnimationSystem&) = delete;
+
+  /// \brief Assignment operator removed because you shouldn't be assigning
+  ///   AnimationSystems.
+  AnimationSystem&
+  operator= (const AnimationSystem&) = delete;
+
+  /// \brief Adds a character.  Safe to call from any thread, typically an
+  ///   AssetLoader job that has just loaded the model.
+  /// \param[in] model The model.  It must outlive this AnimationSystem.
+  /// \param[in] namePrefix The character's meshes are the SkinnedMeshes
+  ///   named namePrefix + the mesh's position in Model::meshes, one for
+  ///   every mesh of the model that has bones.
+  /// \param[in] clip The clip to play, or Animator::NO_CLIP.
+  /// \param[in] startTime How far into the clip to start, in seconds.
+  /// \post The character is posed by every update from the first at which
+  ///   all of its meshes are in the Scene.  They must stay in the Scene
+  ///   from then on.
+  void
+  addCharacter (const Model& model, const std::string& namePrefix,
+		unsigned int clip, float startTime);
+
+  /// \brief Moves every character's clip forward and poses it.  Must only
+  ///   be called from one thread.
+  /// \param[in,out] scene The Scene holding the characters' meshes.
+  /// \param[in] seconds How far to move forward.
+  void
+  update (Scene& scene, float seconds);
+
+  /// \brief Gets the number of characters being posed.
+  /// \return The number of characters whose meshes have all been found.
+  unsigned int
+  getCharacterCount () const;
+
+  /// \brief Gets the most threads characters are posed on, those of its
+  ///   JobSystem.
+  /// \return The number of threads, counting the one calling update.
+  unsigned int
+  getThreadCount () const;
+
+  /// \brief Gets how long posing each character took.
+  /// \return One sample per character per update, in microseconds, each
+  ///   batch's time split evenly among its characters.
+  const TimingHistory&
+  getCharacterTimes () const;
+
+  /// \brief Gets how long each update took in all.
+  /// \return One sample per update with any characters, in milliseconds.
+  const TimingHistory&
+  getUpdateTimes () const;
+
+private:
+
+  /// \brief One animated character.
+  struct Character
+  {
+    /// \brief Constructs a character whose meshes haven't been found.
+    /// \param[in] model The model.
+    /// \param[in] prefix The prefix of its meshes' names.
+    Character (const Model& model, const std::string& prefix);
+
+    /// Plays the character's clip.
+    Animator animator;
+    /// The prefix of its meshes' names.
+    std::string namePrefix;
+    /// Each of its meshes, with the mesh's position in Model::meshes.
+    std::vector<std::pair<unsigned int, SkinnedMesh*>> meshes;
+    /// Its share of how long posing its batch took in the last update, in
+    ///   seconds.
+    double seconds;
+  };
+
+  /// \brief Looks for all of a character's meshes in a Scene.
+  /// \param[in] scene The Scene.
+  /// \param[in,out] character The character, whose meshes are filled in if
+  ///   all of them are found.
+  /// \return Whether they were all found.
+  static bool
+  findMeshes (Scene& scene, Character& character);
+
+  /// \brief Sorts the characters by clip and splits them into batches.
+  void
+  makeBatches ();
+
+  /// \brief Poses a batch of characters playing the same clip.
+  /// \param[in,out] characters The characters.
+  /// \param[in] count How many, at most CompressedClip::LANES.
+  /// \param[in] seconds How far to move their clip forward.
+  static void
+  pose (const std::unique_ptr<Character>* characters, unsigned int count, float seconds);
+
+  /// Characters added since the last update.
+  MpscQueue<std::unique_ptr<Character>> m_arrivals;
+  /// Characters whose meshes haven't all reached the Scene yet.
+  std::vector<std::unique_ptr<Character>> m_waiting;
+  /// Characters being posed, sorted by clip.
+  std::vector<std::unique_ptr<Character>> m_characters;
+  /// The position in m_characters of each batch's first character.  Each
+  ///   batch ends where the next starts.
+  std::vector<size_t> m_batchStarts;
+  /// The JobSystem characters are posed on.
+  JobSystem* m_jobs;
+  /// How long posing each character took, in microseconds.
+  TimingHistory m_characterTimes;
+  /// How long each update took, in milliseconds.
+  TimingHistory m_updateTimes;
+};
+
+#endif//ANIMATION_SYSTEM_HPP
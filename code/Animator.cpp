@@ -0,0 +1,114 @@
+/// \file Animator.cpp
+/// \brief Definitions of Animator member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <cassert>
+
+#include "Animator.hpp"
+
+const unsigned int Animator::NO_CLIP;
+
+Animator::Animator (const Model& model)
+  : m_model (&model), m_clip (nullptr), m_time (0.0f),
+    m_locals (model.nodes.size ()), m_worlds (model.nodes.size ()),
+    m_palettes (model.meshes.size ())
+{
+  for (unsigned int meshNum = 0; meshNum < model.meshes.size (); ++meshNum)
+    m_palettes[meshNum].resize (model.meshes[meshNum].bones.size () * 16);
+  evaluate ();
+}
+
+const Model&
+Animator::getModel () const
+{
+  return *m_model;
+}
+
+void
+Animator::play (unsigned int clip, float time)
+{
+  assert (clip == NO_CLIP || clip < m_model->animations.size ());
+  m_clip = clip == NO_CLIP ? nullptr : &m_model->animations[clip];
+  m_cursor.keys.clear ();
+  m_time = time;
+}
+
+void
+Animator::advance (float seconds)
+{
+  m_time += seconds;
+}
+
+float
+Animator::getTime () const
+{
+  return m_time;
+}
+
+void
+Animator::evaluate ()
+{
+  startPose ();
+  if (m_clip != nullptr)
+    m_clip->sample (m_time, m_locals, &m_cursor);
+  finishPose ();
+}
+
+std::vector<Transform>&
+Animator::startPose ()
+{
+  // Starting from the bind pose each time keeps nodes the clip doesn't
+  //   move where the file put them.
+  const std::vector<ModelNode>& nodes = m_model->nodes;
+  for (unsigned int nodeNum = 0; nodeNum < nodes.size (); ++nodeNum)
+    m_locals[nodeNum] = nodes[nodeNum].local;
+  return m_locals;
+}
+
+void
+Animator::finishPose ()
+{
+  // Parents come before children, so one pass composes everything.
+  const std::vector<ModelNode>& nodes = m_model->nodes;
+  for (unsigned int nodeNum = 0; nodeNum < nodes.size (); ++nodeNum)
+  {
+    int parent = nodes[nodeNum].parent;
+    m_worlds[nodeNum] = parent < 0 ? m_locals[nodeNum] : m_worlds[parent] * m_locals[nodeNum];
+  }
+
+  for (unsigned int meshNum = 0; meshNum < m_model->meshes.size (); ++meshNum)
+  {
+    const std::vector<ModelBone>& bones = m_model->meshes[meshNum].bones;
+    float* matrix = m_palettes[meshNum].data ();
+    for (const ModelBone& bone : bones)
+    {
+      (m_worlds[bone.node] * bone.offset).getTransform (matrix);
+      matrix += 16;
+    }
+  }
+}
+
+const CompressedClip*
+Animator::getClip () const
+{
+  return m_clip;
+}
+
+CompressedClip::Cursor&
+Animator::getCursor ()
+{
+  return m_cursor;
+}
+
+const std::vector<Transform>&
+Animator::getWorlds () const
+{
+  return m_worlds;
+}
+
+const std::vector<float>&
+Animator::getPalette (unsigned int mesh) const
+{
+  return m_palettes[mesh];
+}
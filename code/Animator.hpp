@@ -0,0 +1,117 @@
+/// \file Animator.hpp
+/// \brief Declaration of Animator class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef ANIMATOR_HPP
+#define ANIMATOR_HPP
+
+#include <vector>
+
+#include "ModelLoader.hpp"
+
+/// \brief Plays a model's animations, producing the bone matrices that
+///   skin its meshes.
+/// Each animated character has its own Animator; the Model, its clips, and
+///   its meshes' geometry are shared by all of them.  Everything here runs
+///   on the CPU and touches only this Animator, so many characters can be
+///   evaluated at once on different threads.
+class Animator
+{
+public:
+
+  /// Means no clip is playing, so the model stays in its bind pose.
+  static const unsigned int NO_CLIP = ~0u;
+
+  /// \brief Constructs an Animator that holds a model in its bind pose.
+  /// \param[in] model The model.  It must outlive this Animator.
+  explicit Animator (const Model& model);
+
+  /// \brief Gets the model being animated.
+  /// \return The model.
+  const Model&
+  getModel () const;
+
+  /// \brief Starts a clip.
+  /// \param[in] clip The position of the clip in Model::animations, or
+  ///   NO_CLIP.
+  /// \param[in] time Where in the clip to start, in seconds.  Characters
+  ///   playing the same clip look less like clones if they start apart.
+  void
+  play (unsigned int clip, float time = 0.0f);
+
+  /// \brief Moves the playing clip forward.
+  /// \param[in] seconds How far.
+  void
+  advance (float seconds);
+
+  /// \brief Gets how far into the playing clip this Animator is.
+  /// \return The time in seconds, which keeps growing past the clip's end
+  ///   as the clip loops.
+  float
+  getTime () const;
+
+  /// \brief Poses the model at the current time: samples the clip, composes
+  ///   each node's world transform, and rebuilds every skinned mesh's bone
+  ///   palette.
+  void
+  evaluate ();
+
+  /// \brief Starts posing the model without sampling the clip, for callers
+  ///   that sample many Animators' clips together with
+  ///   CompressedClip::sampleMany.
+  /// \return Every node's local transform, reset to the bind pose, for the
+  ///   clip to be sampled into.
+  /// \post finishPose is called before anything else here.
+  std::vector<Transform>&
+  startPose ();
+
+  /// \brief Finishes posing the model from its sampled local transforms:
+  ///   composes each node's world transform and rebuilds every palette.
+  void
+  finishPose ();
+
+  /// \brief Gets the playing clip.
+  /// \return The clip, or nullptr if none is playing.
+  const CompressedClip*
+  getClip () const;
+
+  /// \brief Gets where in the playing clip this Animator last sampled.
+  /// \return The cursor, to pass to CompressedClip::sampleMany.
+  CompressedClip::Cursor&
+  getCursor ();
+
+  /// \brief Gets every node's transform to the model's coordinates as of
+  ///   the last evaluate.
+  /// \return The transforms, indexed like Model::nodes.
+  const std::vector<Transform>&
+  getWorlds () const;
+
+  /// \brief Gets the bone matrices for one mesh as of the last evaluate.
+  /// \param[in] mesh The position of the mesh in Model::meshes.
+  /// \return 16 floats (a column-major matrix) per bone of the mesh, in the
+  ///   order of ModelMesh::bones, each taking the mesh's coordinates in the
+  ///   bind pose to the model's coordinates in the current pose.  Empty for
+  ///   a mesh with no bones.
+  const std::vector<float>&
+  getPalette (unsigned int mesh) const;
+
+private:
+
+  /// The model being animated.
+  const Model* m_model;
+  /// The playing clip, or nullptr.
+  const CompressedClip* m_clip;
+  /// Where in m_clip this Animator last sampled.
+  CompressedClip::Cursor m_cursor;
+  /// How far into m_clip this Animator is, in seconds.
+  float m_time;
+  /// Each node's transform relative to its parent in the current pose.
+  std::vector<Transform> m_locals;
+  /// Each node's transform to the model's coordinates in the current pose.
+  std::vector<Transform> m_worlds;
+  /// Each mesh's bone matrices.
+  std::vector<std::vector<float>> m_palettes;
+};
+
+#endif//ANIMATOR_HPP
@@ -0,0 +1,280 @@
+/// \file AssetLoader.cpp
+/// \brief Definitions of AssetLoader member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include <GLFW/glfw3.h>
+
+#include "AssetLoader.hpp"
+#include "ColorsMesh.hpp"
+#include "CpuProfiler.hpp"
+#include "NormalsMesh.hpp"
+#include "SkinnedMesh.hpp"
+
+LoadedMesh::LoadedMesh ()
+  : shader (nullptr), variants (nullptr), hasNormals (false), boneCount (0),
+    vbo (0), ibo (0), indexCount (0), fence (nullptr)
+{
+}
+
+AssetLoader::AssetLoader (unsigned int threadCount)
+  : m_uploadWindow (nullptr), m_uploadContext (nullptr), m_stopping (false),
+    m_pendingJobs (0), m_pendingUploads (0), m_longestUpload (0.0),
+    m_totalUpload (0.0)
+{
+  if (threadCount == 0)
+    threadCount = std::max (std::thread::hardware_concurrency (), 2u) - 1;
+  for (unsigned int t = 0; t < threadCount; ++t)
+    m_workers.emplace_back (&AssetLoader::workerLoop, this);
+}
+
+AssetLoader::~AssetLoader ()
+{
+  {
+    std::lock_guard<std::mutex> lock (m_jobMutex);
+    m_stopping = true;
+    m_jobs.clear ();
+  }
+  m_jobReady.notify_all ();
+  m_uploadReady.notify_all ();
+  for (std::thread& worker : m_workers)
+    worker.join ();
+  if (m_uploader.joinable ())
+    m_uploader.join ();
+
+  // Buffers that were uploaded but never claimed.  Objects are shared, so
+  //   the render thread's context can delete them.
+  std::unique_ptr<LoadedMesh> loaded;
+  while (m_finished.tryPop (loaded))
+    m_ready.push_back (std::move (loaded));
+  for (std::unique_ptr<LoadedMesh>& mesh : m_ready)
+  {
+    if (mesh->fence != nullptr)
+    {
+      m_uploadContext->deleteSync (mesh->fence);
+      m_uploadContext->deleteBuffers (1, &mesh->vbo);
+      m_uploadContext->deleteBuffers (1, &mesh->ibo);
+    }
+  }
+}
+
+void
+AssetLoader::startUploadThread (GLFWwindow* sharedWindow, OpenGLContext* context)
+{
+  m_uploadWindow = sharedWindow;
+  m_uploadContext = context;
+  m_uploader = std::thread (&AssetLoader::uploadLoop, this);
+}
+
+void
+AssetLoader::submit (Job job)
+{
+  ++m_pendingJobs;
+  {
+    std::lock_guard<std::mutex> lock (m_jobMutex);
+    m_jobs.push_back (std::move (job));
+  }
+  m_jobReady.notify_one ();
+}
+
+unsigned int
+AssetLoader::uploadPending (GlContext* context, Scene& scene, double budgetSeconds)
+{
+  PROFILE_ZONE ("AssetLoader::uploadPending");
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  unsigned int uploaded = 0;
+  std::unique_ptr<LoadedMesh> arrived;
+  while (m_finished.tryPop (arrived))
+    m_ready.push_back (std::move (arrived));
+
+  while (!m_ready.empty ())
+  {
+    std::unique_ptr<LoadedMesh>& loaded = m_ready.front ();
+    if (loaded->fence != nullptr)
+    {
+      // A zero timeout only polls.  Fences from one context signal in
+      //   order, so if this one hasn't, none behind it have either.
+      GLenum status = context->clientWaitSync (loaded->fence, 0, 0);
+      if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+	break;
+      context->deleteSync (loaded->fence);
+      loaded->fence = nullptr;
+    }
+
+    Mesh* mesh;
+    if (loaded->boneCount > 0)
+      mesh = new SkinnedMesh (context, loaded->shader, loaded->boneCount);
+    else if (loaded->hasNormals)
+      mesh = new NormalsMesh (context, loaded->shader);
+    else
+      mesh = new ColorsMesh (context, loaded->shader);
+    if (loaded->vbo != 0)
+    {
+      mesh->adoptBuffers (loaded->vbo, loaded->ibo, loaded->indexCount);
+    }
+    else if (loaded->mapped)
+    {
+      mesh->addMappedGeometry (std::move (loaded->mapped));
+    }
+    else
+    {
+      mesh->addGeometry (loaded->vertices);
+      mesh->addIndices (loaded->indices);
+    }
+    if (loaded->variants != nullptr)
+      mesh->setShaderVariants (loaded->variants);
+    mesh->setWorld (loaded->world);
+    mesh->prepareVao ();
+    scene.add (loaded->name, mesh, loaded->parent);
+    m_ready.pop_front ();
+    ++uploaded;
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now () - start;
+    if (elapsed.count () >= budgetSeconds)
+      break;
+  }
+
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now () - start;
+  m_longestUpload = std::max (m_longestUpload, elapsed.count ());
+  m_totalUpload += elapsed.count ();
+  return uploaded;
+}
+
+bool
+AssetLoader::isIdle () const
+{
+  return m_pendingJobs.load () == 0 && m_pendingUploads.load () == 0
+    && m_finished.empty () && m_ready.empty ();
+}
+
+unsigned int
+AssetLoader::getPendingJobCount () const
+{
+  return m_pendingJobs.load ();
+}
+
+double
+AssetLoader::getLongestUploadSeconds () const
+{
+  return m_longestUpload;
+}
+
+double
+AssetLoader::getTotalUploadSeconds () const
+{
+  return m_totalUpload;
+}
+
+void
+AssetLoader::workerLoop ()
+{
+  PROFILE_THREAD_NAME ("loader");
+  while (true)
+  {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock (m_jobMutex);
+      m_jobReady.wait (lock, [this] () { return m_stopping || !m_jobs.empty (); });
+      if (m_stopping)
+	return;
+      job = std::move (m_jobs.front ());
+      m_jobs.pop_front ();
+    }
+
+    std::vector<LoadedMesh> meshes;
+    {
+      PROFILE_ZONE ("AssetLoader job");
+      meshes = job ();
+    }
+    for (LoadedMesh& mesh : meshes)
+    {
+      std::unique_ptr<LoadedMesh> finished (new LoadedMesh (std::move (mesh)));
+      if (m_uploadWindow != nullptr)
+      {
+	++m_pendingUploads;
+	m_toUpload.push (std::move (finished));
+	{
+	  std::lock_guard<std::mutex> lock (m_jobMutex);
+	}
+	m_uploadReady.notify_one ();
+      }
+      else
+      {
+	m_finished.push (std::move (finished));
+      }
+    }
+    // Decremented only after the results are queued, so isIdle can't see a
+    //   finished job whose meshes haven't arrived yet.
+    --m_pendingJobs;
+  }
+}
+
+void
+AssetLoader::uploadLoop ()
+{
+  PROFILE_THREAD_NAME ("upload");
+  glfwMakeContextCurrent (m_uploadWindow);
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock (m_jobMutex);
+      m_uploadReady.wait (lock, [this] () { return m_stopping || !m_toUpload.empty (); });
+      if (m_stopping)
+	break;
+    }
+
+    std::unique_ptr<LoadedMesh> mesh;
+    while (m_toUpload.tryPop (mesh))
+    {
+      uploadBuffers (*mesh);
+      m_finished.push (std::move (mesh));
+      --m_pendingUploads;
+    }
+  }
+  glfwMakeContextCurrent (nullptr);
+}
+
+void
+AssetLoader::uploadBuffers (LoadedMesh& mesh)
+{
+  PROFILE_ZONE ("AssetLoader::uploadBuffers");
+  const GLvoid* vertexData = mesh.vertices.data ();
+  GLsizeiptr vertexBytes = mesh.vertices.size () * sizeof (float);
+  const GLvoid* indexData = mesh.indices.data ();
+  GLsizeiptr indexBytes = mesh.indices.size () * sizeof (unsigned int);
+  mesh.indexCount = mesh.indices.size ();
+  if (mesh.mapped)
+  {
+    const MeshFileHeader& header = mesh.mapped->getHeader ();
+    vertexData = mesh.mapped->getVertexData ();
+    vertexBytes = header.vertexBytes;
+    indexData = mesh.mapped->getIndexData ();
+    indexBytes = header.indexBytes;
+    mesh.indexCount = header.indexCount;
+  }
+
+  // This context has no VAO bound, so the index data goes in through a
+  //   target that isn't VAO state.  Buffers have no fixed type; the render
+  //   thread binds this one as its element array.
+  m_uploadContext->genBuffers (1, &mesh.vbo);
+  m_uploadContext->bindBuffer (GL_ARRAY_BUFFER, mesh.vbo);
+  m_uploadContext->bufferData (GL_ARRAY_BUFFER, vertexBytes, vertexData, GL_STATIC_DRAW);
+  m_uploadContext->genBuffers (1, &mesh.ibo);
+  m_uploadContext->bindBuffer (GL_COPY_WRITE_BUFFER, mesh.ibo);
+  m_uploadContext->bufferData (GL_COPY_WRITE_BUFFER, indexBytes, indexData, GL_STATIC_DRAW);
+  m_uploadContext->bindBuffer (GL_ARRAY_BUFFER, 0);
+  m_uploadContext->bindBuffer (GL_COPY_WRITE_BUFFER, 0);
+
+  mesh.fence = m_uploadContext->fenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  // Without a flush the fence might never reach the GPU, and the render
+  //   thread would wait on it forever.
+  m_uploadContext->flush ();
+
+  std::vector<float> ().swap (mesh.vertices);
+  std::vector<unsigned int> ().swap (mesh.indices);
+  mesh.mapped.reset ();
+}
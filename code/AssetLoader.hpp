@@ -0,0 +1,216 @@
+/// \file AssetLoader.hpp
+/// \brief Declaration of AssetLoader class and the LoadedMesh it produces.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef ASSET_LOADER_HPP
+#define ASSET_LOADER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MpscQueue.hpp"
+#include "MeshFile.hpp"
+#include "Transform.hpp"
+#include "OpenGLContext.hpp"
+#include "ShaderProgram.hpp"
+#include "ShaderVariants.hpp"
+#include "Scene.hpp"
+
+struct GLFWwindow;
+
+/// \brief The CPU-side result of loading one mesh: everything needed to
+///   build a Mesh except the OpenGL calls.
+struct LoadedMesh
+{
+  /// \brief Constructs a LoadedMesh with no data and no GPU buffers.
+  LoadedMesh ();
+
+  /// The name the Mesh should be given in the Scene.
+  std::string name;
+  /// The shader program the Mesh should be drawn with, if variants is
+  ///   nullptr.
+  ShaderProgram* shader;
+  /// The variants the Mesh should choose its own shader from, or nullptr.
+  ShaderVariants* variants;
+  /// True for a NormalsMesh (position / normal), false for a ColorsMesh
+  ///   (position / color).
+  bool hasNormals;
+  /// For a SkinnedMesh, the number of bones that pose it; otherwise 0.
+  unsigned int boneCount;
+  /// Interleaved vertex data, 6 floats per vertex, or for a SkinnedMesh as
+  ///   laid out by SkinnedMesh::interleave.
+  std::vector<float> vertices;
+  /// Indices into vertices, 3 per triangle.
+  std::vector<unsigned int> indices;
+  /// A mapped .mesh file to upload instead of vertices / indices, or
+  ///   nullptr.
+  std::unique_ptr<MappedMeshFile> mapped;
+  /// The Mesh's world transform, or its transform relative to parent.
+  Transform world;
+  /// The name of the Mesh this one is attached to in the Scene, or empty.
+  ///   The parent must reach the Scene first, so attach only to Meshes
+  ///   from the same job, listed earlier.
+  std::string parent;
+  /// A VBO already holding the vertices, or 0.  Only set by the upload
+  ///   thread, which also frees vertices and mapped.
+  GLuint vbo;
+  /// An IBO already holding the indices, or 0.
+  GLuint ibo;
+  /// The number of indices in ibo.
+  unsigned int indexCount;
+  /// Signals once vbo and ibo are safe to use from another context, or
+  ///   nullptr if there are no buffers.
+  GLsync fence;
+};
+
+/// \brief Loads meshes on background threads and adds them to a Scene as
+///   they become ready.
+/// Jobs (parsing files, indexing, computing normals, ...) run on worker
+///   threads and push finished LoadedMeshes onto a lock-free queue.  The
+///   render thread drains that queue with uploadPending, which makes all
+///   of the OpenGL calls and stops once its time budget for the frame is
+///   used up, so the window stays responsive however much is being loaded.
+/// Optionally, a dedicated upload thread with its own shared OpenGL context
+///   also takes over creating and filling the VBOs and IBOs.  It fences each
+///   upload, and the render thread only builds a VAO once that fence has
+///   signaled, so no bufferData call is ever made during a frame.
+class AssetLoader
+{
+public:
+
+  /// \brief A unit of background work.  It may produce any number of
+  ///   meshes.
+  using Job = std::function<std::vector<LoadedMesh> ()>;
+
+  /// \brief Constructs an AssetLoader and starts its worker threads.
+  /// \param[in] threadCount The number of worker threads, or 0 to leave one
+  ///   hardware thread for rendering and use the rest.
+  AssetLoader (unsigned int threadCount = 0);
+
+  /// \brief Stops the worker threads, abandoning any unfinished jobs and
+  ///   discarding any meshes that were never uploaded.
+  ~AssetLoader ();
+
+  /// \brief Copy constructor removed because worker threads can't be
+  ///   copied.
+  AssetLoader (const AssetLoader&) = delete;
+
+  /// \brief Assignment operator removed because worker threads can't be
+  ///   copied.
+  AssetLoader&
+  operator= (const AssetLoader&) = delete;
+
+  /// \brief Starts a thread that uploads finished meshes' buffers through a
+  ///   second OpenGL context.
+  /// \param[in] sharedWindow A (hidden) window whose context shares objects
+  ///   with the render thread's.  It must not be current on any thread, and
+  ///   must outlive this AssetLoader.
+  /// \param[in] context The object through which the upload thread makes its
+  ///   OpenGL calls.
+  /// \pre No job has been submitted yet, and this has not been called before.
+  void
+  startUploadThread (GLFWwindow* sharedWindow, OpenGLContext* context);
+
+  /// \brief Queues a job to run on a worker thread.
+  /// \param[in] job The job.  It must not make OpenGL calls.
+  void
+  submit (Job job);
+
+  /// \brief Turns finished LoadedMeshes into prepared Meshes in a Scene.
+  ///   Must be called from the thread that owns the OpenGL context.
+  /// \param[in] context The context the Meshes will use.
+  /// \param[in,out] scene The Scene the Meshes are added to.
+  /// \param[in] budgetSeconds Stop starting new uploads once this much time
+  ///   has passed.  At least one mesh is uploaded if any is ready, so
+  ///   loading always makes progress.
+  /// \return The number of Meshes added.
+  /// Meshes whose buffers came from the upload thread are held back until
+  ///   their fences signal; checking a fence never blocks.
+  unsigned int
+  uploadPending (GlContext* context, Scene& scene, double budgetSeconds);
+
+  /// \brief Tests whether every submitted job has finished and every mesh
+  ///   has been uploaded.
+  /// \return True if there is nothing left to do.
+  bool
+  isIdle () const;
+
+  /// \brief Gets the number of jobs that have been submitted but have not
+  ///   finished.
+  /// \return The number of unfinished jobs.
+  unsigned int
+  getPendingJobCount () const;
+
+  /// \brief Gets the longest time a single uploadPending call has taken,
+  ///   which is how badly loading has hitched a frame.
+  /// \return The time in seconds.
+  double
+  getLongestUploadSeconds () const;
+
+  /// \brief Gets the total time spent in uploadPending.
+  /// \return The time in seconds.
+  double
+  getTotalUploadSeconds () const;
+
+private:
+
+  /// \brief The body of each worker thread.
+  void
+  workerLoop ();
+
+  /// \brief The body of the upload thread.
+  void
+  uploadLoop ();
+
+  /// \brief Creates and fills a mesh's VBO and IBO, fences them, and frees
+  ///   its CPU-side data.  Only called on the upload thread.
+  /// \param[in,out] mesh The mesh to upload.
+  void
+  uploadBuffers (LoadedMesh& mesh);
+
+  /// The worker threads.
+  std::vector<std::thread> m_workers;
+  /// The upload thread, if there is one.
+  std::thread m_uploader;
+  /// The window whose context the upload thread makes current.
+  GLFWwindow* m_uploadWindow;
+  /// The object through which the upload thread makes OpenGL calls.
+  OpenGLContext* m_uploadContext;
+  /// Guards m_jobs and m_stopping, and is briefly taken before every wakeup
+  ///   so neither condition variable can miss one.
+  std::mutex m_jobMutex;
+  /// Signalled when a job is queued or the loader is stopping.
+  std::condition_variable m_jobReady;
+  /// Signalled when a mesh is queued for upload or the loader is stopping.
+  std::condition_variable m_uploadReady;
+  /// Jobs that no worker has started.
+  std::deque<Job> m_jobs;
+  /// Whether the workers should exit.
+  bool m_stopping;
+  /// Jobs submitted but not yet finished.
+  std::atomic<unsigned int> m_pendingJobs;
+  /// Meshes from finished jobs that have been queued for the upload thread
+  ///   but not yet passed on to m_finished.
+  std::atomic<unsigned int> m_pendingUploads;
+  /// Finished meshes waiting for the upload thread.
+  MpscQueue<std::unique_ptr<LoadedMesh>> m_toUpload;
+  /// Finished meshes waiting for the render thread.
+  MpscQueue<std::unique_ptr<LoadedMesh>> m_finished;
+  /// Meshes the render thread has taken from m_finished but not yet added
+  ///   to the Scene, in order.  Only touched by the render thread.
+  std::deque<std::unique_ptr<LoadedMesh>> m_ready;
+  /// The longest uploadPending call, in seconds.
+  double m_longestUpload;
+  /// The total time spent in uploadPending, in seconds.
+  double m_totalUpload;
+};
+
+#endif//ASSET_LOADER_HPP
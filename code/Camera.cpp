@@ -18,6 +18,7 @@
 Camera::Camera (const Vector3& eyePosition, const Vector3& localBackDirection,
 	float nearClipPlaneDistance, float farClipPlaneDistance,
 	float aspectRatio, float verticalFieldOfViewDegrees)
+  : m_revision (0)
 {
     m_eyePosition.set (eyePosition.m_x, eyePosition.m_y, eyePosition.m_z);
     // Since setPosition/Projection does the setting for it, use that to keep code clean *chef's kiss*
@@ -41,6 +42,7 @@ Camera::setPosition (const Vector3& position)
 {
     m_world.setPosition (position.m_x, position.m_y, position.m_z);
     viewRecalculate = true;
+    ++m_revision;
 }
 
 void 
@@ -48,6 +50,7 @@ Camera::moveRight (float distance)
 {
     m_world.moveRight (distance);
     viewRecalculate = true;
+    ++m_revision;
 }
 
 void 
@@ -55,6 +58,7 @@ Camera::moveUp (float distance)
 {
     m_world.moveUp (distance);
     viewRecalculate = true;
+    ++m_revision;
 }
 
 void 
@@ -62,6 +66,7 @@ Camera::moveBack (float distance)
 {
     m_world.moveBack (distance);
     viewRecalculate = true;
+    ++m_revision;
 }
 
 void
@@ -69,6 +74,7 @@ Camera::yaw (float degrees)
 {
     m_world.yaw (degrees);
     viewRecalculate = projRecalculate = true; 
+    ++m_revision;
 }
 
 void
@@ -76,6 +82,7 @@ Camera::pitch (float degrees)
 {
     m_world.pitch (degrees);
     viewRecalculate = projRecalculate = true;
+    ++m_revision;
 }
 
 void
@@ -83,6 +90,7 @@ Camera::roll (float degrees)
 {
     m_world.roll (degrees);
     viewRecalculate = projRecalculate = true;
+    ++m_revision;
 }
 
 Transform
@@ -104,6 +112,7 @@ Camera::setProjectionSymmetricPerspective (double verticalFovDegrees, double asp
 {
     m_projectionMatrix.setToPerspectiveProjection (toRadians(verticalFovDegrees), aspectRatio, 
                             nearZ, farZ);
+    ++m_revision;
 }
 
 void
@@ -111,6 +120,7 @@ Camera::setProjectionAsymmetricPerspective (double left, double right,
                     double top, double bottom, double nearZ, double farZ)
 {
     m_projectionMatrix.setToPerspectiveProjection (left, right, bottom, top, nearZ, farZ);
+    ++m_revision;
 }
 
 void
@@ -118,6 +128,7 @@ Camera::setProjectionOrthographic (double left, double right, double top,
                     double bottom, double nearZ, double farZ)
 {
     m_projectionMatrix.setToOrthographicProjection (left, right, bottom, top, nearZ, farZ);
+    ++m_revision;
 }
 
 Matrix4 
@@ -141,3 +152,9 @@ Camera::resetPose()
     getViewMatrix();
     getProjectionMatrix();
 }   
+
+unsigned long
+Camera::getRevision () const
+{
+    return m_revision;
+}
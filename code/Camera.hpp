@@ -133,6 +133,12 @@ public:
   void
   resetPose ();
 
+  /// \brief Gets a number that grows whenever the view or projection
+  ///   changes, so a renderer can tell whether the camera moved.
+  /// \return The revision, which starts at 0.
+  unsigned long
+  getRevision () const;
+
 private:
 
   /// The location of the camera.
@@ -152,6 +158,8 @@ private:
   bool projRecalculate;
   /// Determines whether the view matrix needs to be recalculated
   bool viewRecalculate;
+  /// Counts changes to the view and projection (see getRevision)
+  unsigned long m_revision;
 };
 
 #endif//CAMERA_HPP
@@ -5,7 +5,7 @@
 
 #include "ColorsMesh.hpp"
 
-ColorsMesh::ColorsMesh (OpenGLContext* context, ShaderProgram* shader) : Mesh (context, shader)
+ColorsMesh::ColorsMesh (GlContext* context, ShaderProgram* shader) : Mesh (context, shader)
 {
 }
 
@@ -19,6 +19,12 @@ ColorsMesh::getFloatsPerVertex () const
     return 6;
 }
 
+unsigned int
+ColorsMesh::getShaderFeatures () const
+{
+    return SHADER_VERTEX_COLOR;
+}
+
 void
 ColorsMesh::enableAttributes ()
 {
@@ -13,7 +13,7 @@ class ColorsMesh : public Mesh
     
 public:
     // Creates a new ColorsMesh class
-    ColorsMesh (OpenGLContext* context, ShaderProgram* shader);
+    ColorsMesh (GlContext* context, ShaderProgram* shader);
 
     // Empty destructor
     virtual ~ColorsMesh ();
@@ -22,6 +22,10 @@ public:
     virtual unsigned int
     getFloatsPerVertex () const;
 
+    // getShaderFeatures override
+    virtual unsigned int
+    getShaderFeatures () const;
+
 protected:
     // enableAttributes override
     virtual void
@@ -0,0 +1,143 @@
+/// \file CommandBufferBenchmark.cpp
+/// \brief A command-line tool that measures how recording Scene::draw into
+///   command buffers on several threads scales with the number of threads.
+/// \author Ethan Gingrich
+/// \version A08
+///
+/// Usage:
+///   CommandBufferBenchmark.out [meshes [frames]]
+///     Builds a Scene of that many cubes (50000 by default) and times
+///     drawing it directly, then recording it on 1, 2, 4, ... threads and
+///     replaying the recordings.  No window or driver is needed: every call
+///     goes to a NullOpenGLContext, so the times are the CPU cost of
+///     submission alone.  Run it from this directory, where the shaders are.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "ColorsMesh.hpp"
+#include "CommandBufferContext.hpp"
+#include "Geometry.hpp"
+#include "NullOpenGLContext.hpp"
+#include "Scene.hpp"
+#include "ShaderLibrary.hpp"
+#include "ShaderVariants.hpp"
+#include "TimingHistory.hpp"
+
+/// \brief Times a function.
+/// \param[in] work The function to time.
+/// \return The elapsed time in milliseconds.
+template<typename Function>
+static double
+timeMs (Function work)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  work ();
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now () - start;
+  return elapsed.count ();
+}
+
+/// \brief Runs the benchmark.
+/// \param[in] argc The number of command-line arguments.
+/// \param[in] argv The number of meshes and of frames to time.
+/// \return EXIT_SUCCESS.
+int
+main (int argc, char* argv[])
+{
+  unsigned int meshCount = argc > 1 ? std::atoi (argv[1]) : 50000;
+  unsigned int frames = argc > 2 ? std::atoi (argv[2]) : 30;
+  unsigned int hardwareThreads = std::max (std::thread::hardware_concurrency (), 1u);
+
+  NullOpenGLContext context;
+  ShaderLibrary library (&context, false);
+  ShaderVariants shaders (library, "Mesh.vert", "Vec3.frag");
+  std::unique_ptr<Scene> scene (new Scene ());
+
+  std::vector<Triangle> cube = buildCube ();
+  std::vector<float> vertices;
+  std::vector<unsigned int> indices;
+  indexData (dataWithVertexColors (cube, generateRandomVertexColors (cube)), 6, vertices, indices);
+  unsigned int side = 1;
+  while (side * side * side < meshCount)
+    ++side;
+  for (unsigned int meshNum = 0; meshNum < meshCount; ++meshNum)
+  {
+    Mesh* mesh = new ColorsMesh (&context, nullptr);
+    mesh->addGeometry (vertices);
+    mesh->addIndices (indices);
+    mesh->setShaderVariants (&shaders);
+    Transform world;
+    world.setPosition (meshNum % side * 2.0f, meshNum / side % side * 2.0f, meshNum / (side * side) * 2.0f);
+    mesh->setWorld (world);
+    mesh->prepareVao ();
+    scene->add ("cube" + std::to_string (meshNum), mesh);
+  }
+
+  Transform view;
+  Matrix4 projection;
+  projection.setToPerspectiveProjection (50.0, 4.0 / 3.0, 0.01, 1000.0);
+  // The first draw requests the shader; the second finds it linked.
+  scene->draw (view, projection);
+  library.poll ();
+  scene->draw (view, projection);
+
+  TimingHistory direct (frames);
+  for (unsigned int frame = 0; frame < frames; ++frame)
+    direct.add (timeMs ([&] () { scene->draw (view, projection); }));
+  std::printf ("%u meshes, median of %u frames, NullOpenGLContext\n", meshCount, frames);
+  std::printf ("  direct Scene::draw          %8.2f ms\n", direct.getPercentile (50));
+  std::printf ("  threads   record ms  speedup   replay ms   total ms   stream MB\n");
+
+  SceneSnapshot snapshot;
+  snapshot.view = view;
+  snapshot.projection = projection;
+  scene->capture (snapshot);
+
+  // 1, 2, 4, ... and finally every hardware thread.
+  std::vector<unsigned int> threadCounts;
+  for (unsigned int threads = 1; threads < hardwareThreads; threads *= 2)
+    threadCounts.push_back (threads);
+  threadCounts.push_back (hardwareThreads);
+
+  double oneThreadMs = 0.0;
+  for (unsigned int threads : threadCounts)
+  {
+    std::vector<std::unique_ptr<CommandBufferContext>> owned;
+    std::vector<CommandBufferContext*> buffers;
+    for (unsigned int thread = 0; thread < threads; ++thread)
+    {
+      owned.emplace_back (new CommandBufferContext ());
+      buffers.push_back (owned.back ().get ());
+    }
+    // One untimed frame sizes the buffers, as in a running program.
+    scene->recordDraw (snapshot, 1.0f, buffers);
+
+    TimingHistory record (frames);
+    TimingHistory replay (frames);
+    for (unsigned int frame = 0; frame < frames; ++frame)
+    {
+      record.add (timeMs ([&] () { scene->recordDraw (snapshot, 1.0f, buffers); }));
+      replay.add (timeMs ([&] ()
+			  {
+			    for (CommandBufferContext* buffer : buffers)
+			      buffer->replay (&context);
+			  }));
+    }
+    size_t bytes = 0;
+    for (CommandBufferContext* buffer : buffers)
+      bytes += buffer->getByteCount ();
+    if (threads == 1)
+      oneThreadMs = record.getPercentile (50);
+    std::printf ("  %7u %11.2f %7.2fx %11.2f %10.2f %11.2f\n", threads, record.getPercentile (50),
+		 oneThreadMs / record.getPercentile (50), replay.getPercentile (50),
+		 record.getPercentile (50) + replay.getPercentile (50), bytes / (1024.0 * 1024.0));
+  }
+
+  // Meshes delete their buffers through the context, so they go first.
+  scene.reset ();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,761 @@
+/// \file CommandBufferContext.cpp
+/// \brief Definitions of CommandBufferContext member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include "CommandBufferContext.hpp"
+
+/// Payloads start on multiples of this, so OpenGL can read them in place.
+static const size_t PAYLOAD_ALIGNMENT = 8;
+
+CommandBufferContext::CommandBufferContext ()
+  : m_size (0), m_commandCount (0)
+{
+}
+
+CommandBufferContext::~CommandBufferContext ()
+{
+}
+
+void
+CommandBufferContext::reset ()
+{
+  m_size = 0;
+  m_commandCount = 0;
+}
+
+void
+CommandBufferContext::replay (OpenGLContext* context) const
+{
+  size_t position = 0;
+  while (position < m_size)
+  {
+    switch (read<Opcode> (position))
+    {
+      case OP_ATTACH_SHADER:
+      {
+	GLuint program = read<GLuint> (position);
+	GLuint shader = read<GLuint> (position);
+	context->attachShader (program, shader);
+	break;
+      }
+      case OP_BEGIN_QUERY:
+      {
+	GLenum target = read<GLenum> (position);
+	GLuint id = read<GLuint> (position);
+	context->beginQuery (target, id);
+	break;
+      }
+      case OP_BIND_BUFFER:
+      {
+	GLenum target = read<GLenum> (position);
+	GLuint buffer = read<GLuint> (position);
+	context->bindBuffer (target, buffer);
+	break;
+      }
+      case OP_BIND_VERTEX_ARRAY:
+      {
+	GLuint array = read<GLuint> (position);
+	context->bindVertexArray (array);
+	break;
+      }
+      case OP_BUFFER_DATA:
+      {
+	GLenum target = read<GLenum> (position);
+	GLsizeiptr size = read<GLsizeiptr> (position);
+	const GLvoid* data = readPayload (position, size);
+	GLenum usage = read<GLenum> (position);
+	context->bufferData (target, size, data, usage);
+	break;
+      }
+      case OP_BUFFER_SUB_DATA:
+      {
+	GLenum target = read<GLenum> (position);
+	GLintptr offset = read<GLintptr> (position);
+	GLsizeiptr size = read<GLsizeiptr> (position);
+	const GLvoid* data = readPayload (position, size);
+	context->bufferSubData (target, offset, size, data);
+	break;
+      }
+      case OP_CLEAR:
+      {
+	GLbitfield mask = read<GLbitfield> (position);
+	context->clear (mask);
+	break;
+      }
+      case OP_CLEAR_COLOR:
+      {
+	GLfloat red = read<GLfloat> (position);
+	GLfloat green = read<GLfloat> (position);
+	GLfloat blue = read<GLfloat> (position);
+	GLfloat alpha = read<GLfloat> (position);
+	context->clearColor (red, green, blue, alpha);
+	break;
+      }
+      case OP_COMPILE_SHADER:
+      {
+	GLuint shader = read<GLuint> (position);
+	context->compileShader (shader);
+	break;
+      }
+      case OP_CULL_FACE:
+      {
+	GLenum mode = read<GLenum> (position);
+	context->cullFace (mode);
+	break;
+      }
+      case OP_DELETE_BUFFERS:
+      {
+	GLsizei n = read<GLsizei> (position);
+	const GLuint* buffers = static_cast<const GLuint*> (readPayload (position, n * sizeof (GLuint)));
+	context->deleteBuffers (n, buffers);
+	break;
+      }
+      case OP_DELETE_PROGRAM:
+      {
+	GLuint program = read<GLuint> (position);
+	context->deleteProgram (program);
+	break;
+      }
+      case OP_DELETE_QUERIES:
+      {
+	GLsizei n = read<GLsizei> (position);
+	const GLuint* ids = static_cast<const GLuint*> (readPayload (position, n * sizeof (GLuint)));
+	context->deleteQueries (n, ids);
+	break;
+      }
+      case OP_DELETE_SHADER:
+      {
+	GLuint shader = read<GLuint> (position);
+	context->deleteShader (shader);
+	break;
+      }
+      case OP_DELETE_SYNC:
+      {
+	GLsync sync = read<GLsync> (position);
+	context->deleteSync (sync);
+	break;
+      }
+      case OP_DELETE_VERTEX_ARRAYS:
+      {
+	GLsizei n = read<GLsizei> (position);
+	const GLuint* arrays = static_cast<const GLuint*> (readPayload (position, n * sizeof (GLuint)));
+	context->deleteVertexArrays (n, arrays);
+	break;
+      }
+      case OP_DETACH_SHADER:
+      {
+	GLuint program = read<GLuint> (position);
+	GLuint shader = read<GLuint> (position);
+	context->detachShader (program, shader);
+	break;
+      }
+      case OP_DRAW_ARRAYS:
+      {
+	GLenum mode = read<GLenum> (position);
+	GLint first = read<GLint> (position);
+	GLsizei count = read<GLsizei> (position);
+	context->drawArrays (mode, first, count);
+	break;
+      }
+      case OP_DRAW_ELEMENTS:
+      {
+	GLenum mode = read<GLenum> (position);
+	GLsizei count = read<GLsizei> (position);
+	GLenum type = read<GLenum> (position);
+	const GLvoid* indices = reinterpret_cast<const GLvoid*> (read<uintptr_t> (position));
+	context->drawElements (mode, count, type, indices);
+	break;
+      }
+      case OP_ENABLE:
+      {
+	GLenum cap = read<GLenum> (position);
+	context->enable (cap);
+	break;
+      }
+      case OP_ENABLE_VERTEX_ATTRIB_ARRAY:
+      {
+	GLuint index = read<GLuint> (position);
+	context->enableVertexAttribArray (index);
+	break;
+      }
+      case OP_END_QUERY:
+      {
+	GLenum target = read<GLenum> (position);
+	context->endQuery (target);
+	break;
+      }
+      case OP_FINISH:
+      {
+	context->finish ();
+	break;
+      }
+      case OP_FLUSH:
+      {
+	context->flush ();
+	break;
+      }
+      case OP_FRONT_FACE:
+      {
+	GLenum mode = read<GLenum> (position);
+	context->frontFace (mode);
+	break;
+      }
+      case OP_LINK_PROGRAM:
+      {
+	GLuint program = read<GLuint> (position);
+	context->linkProgram (program);
+	break;
+      }
+      case OP_MAX_SHADER_COMPILER_THREADS_KHR:
+      {
+	GLuint count = read<GLuint> (position);
+	context->maxShaderCompilerThreadsKHR (count);
+	break;
+      }
+      case OP_PROGRAM_BINARY:
+      {
+	GLuint program = read<GLuint> (position);
+	GLenum binaryFormat = read<GLenum> (position);
+	GLsizei length = read<GLsizei> (position);
+	const void* binary = readPayload (position, length);
+	context->programBinary (program, binaryFormat, binary, length);
+	break;
+      }
+      case OP_PROGRAM_PARAMETERI:
+      {
+	GLuint program = read<GLuint> (position);
+	GLenum pname = read<GLenum> (position);
+	GLint value = read<GLint> (position);
+	context->programParameteri (program, pname, value);
+	break;
+      }
+      case OP_QUERY_COUNTER:
+      {
+	GLuint id = read<GLuint> (position);
+	GLenum target = read<GLenum> (position);
+	context->queryCounter (id, target);
+	break;
+      }
+      case OP_SHADER_SOURCE:
+      {
+	GLuint shader = read<GLuint> (position);
+	GLsizei count = read<GLsizei> (position);
+	std::vector<const GLchar*> string;
+	std::vector<GLint> length;
+	readStrings (position, count, string, length);
+	context->shaderSource (shader, count, string.data (), length.data ());
+	break;
+      }
+      case OP_UNIFORM_MATRIX4FV:
+      {
+	GLint location = read<GLint> (position);
+	GLsizei count = read<GLsizei> (position);
+	GLboolean transpose = read<GLboolean> (position);
+	const GLfloat* value = static_cast<const GLfloat*> (readPayload (position, count * 16 * sizeof (GLfloat)));
+	context->uniformMatrix4fv (location, count, transpose, value);
+	break;
+      }
+      case OP_USE_PROGRAM:
+      {
+	GLuint program = read<GLuint> (position);
+	context->useProgram (program);
+	break;
+      }
+      case OP_VERTEX_ATTRIB_POINTER:
+      {
+	GLuint index = read<GLuint> (position);
+	GLint size = read<GLint> (position);
+	GLenum type = read<GLenum> (position);
+	GLboolean normalized = read<GLboolean> (position);
+	GLsizei stride = read<GLsizei> (position);
+	const GLvoid* pointer = reinterpret_cast<const GLvoid*> (read<uintptr_t> (position));
+	context->vertexAttribPointer (index, size, type, normalized, stride, pointer);
+	break;
+      }
+      case OP_VIEWPORT:
+      {
+	GLint x = read<GLint> (position);
+	GLint y = read<GLint> (position);
+	GLsizei width = read<GLsizei> (position);
+	GLsizei height = read<GLsizei> (position);
+	context->viewport (x, y, width, height);
+	break;
+      }
+    }
+  }
+}
+
+unsigned int
+CommandBufferContext::getCommandCount () const
+{
+  return m_commandCount;
+}
+
+size_t
+CommandBufferContext::getByteCount () const
+{
+  return m_size;
+}
+
+void
+CommandBufferContext::unsupported (const char* name)
+{
+  fprintf (stderr, "%s returns a value, so it can't be recorded in a CommandBufferContext\n", name);
+  std::abort ();
+}
+
+void
+CommandBufferContext::grow (size_t size)
+{
+  const size_t MINIMUM_BYTES = 4096;
+  m_bytes.resize (std::max (std::max (m_bytes.size () * 2, m_size + size), MINIMUM_BYTES));
+}
+
+void
+CommandBufferContext::writeOp (Opcode op)
+{
+  write (op);
+  ++m_commandCount;
+}
+
+void
+CommandBufferContext::writePayload (const void* data, size_t size)
+{
+  write<uint8_t> (data != nullptr);
+  if (data == nullptr)
+    return;
+  size_t padding = (PAYLOAD_ALIGNMENT - m_size % PAYLOAD_ALIGNMENT) % PAYLOAD_ALIGNMENT;
+  std::memcpy (allocate (padding + size) + padding, data, size);
+}
+
+const void*
+CommandBufferContext::readPayload (size_t& position, size_t size) const
+{
+  if (read<uint8_t> (position) == 0)
+    return nullptr;
+  position = (position + PAYLOAD_ALIGNMENT - 1) / PAYLOAD_ALIGNMENT * PAYLOAD_ALIGNMENT;
+  const void* data = m_bytes.data () + position;
+  position += size;
+  return data;
+}
+
+void
+CommandBufferContext::writeStrings (GLsizei count, const GLchar** strings, const GLint* lengths)
+{
+  for (GLsizei string = 0; string < count; ++string)
+  {
+    GLint length = lengths != nullptr && lengths[string] >= 0
+      ? lengths[string] : std::strlen (strings[string]);
+    write (length);
+    writePayload (strings[string], length);
+  }
+}
+
+void
+CommandBufferContext::readStrings (size_t& position, GLsizei count,
+				   std::vector<const GLchar*>& strings,
+				   std::vector<GLint>& lengths) const
+{
+  for (GLsizei string = 0; string < count; ++string)
+  {
+    lengths.push_back (read<GLint> (position));
+    strings.push_back (static_cast<const GLchar*> (readPayload (position, lengths.back ())));
+  }
+}
+
+void
+CommandBufferContext::attachShader (GLuint program, GLuint shader)
+{
+  writeOp (OP_ATTACH_SHADER);
+  write (program);
+  write (shader);
+}
+
+void
+CommandBufferContext::beginQuery (GLenum target, GLuint id)
+{
+  writeOp (OP_BEGIN_QUERY);
+  write (target);
+  write (id);
+}
+
+void
+CommandBufferContext::bindBuffer (GLenum target, GLuint buffer)
+{
+  writeOp (OP_BIND_BUFFER);
+  write (target);
+  write (buffer);
+}
+
+void
+CommandBufferContext::bindVertexArray (GLuint array)
+{
+  writeOp (OP_BIND_VERTEX_ARRAY);
+  write (array);
+}
+
+void
+CommandBufferContext::bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+  writeOp (OP_BUFFER_DATA);
+  write (target);
+  write (size);
+  writePayload (data, size);
+  write (usage);
+}
+
+void
+CommandBufferContext::bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+  writeOp (OP_BUFFER_SUB_DATA);
+  write (target);
+  write (offset);
+  write (size);
+  writePayload (data, size);
+}
+
+void
+CommandBufferContext::clear (GLbitfield mask)
+{
+  writeOp (OP_CLEAR);
+  write (mask);
+}
+
+void
+CommandBufferContext::clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+  writeOp (OP_CLEAR_COLOR);
+  write (red);
+  write (green);
+  write (blue);
+  write (alpha);
+}
+
+GLenum
+CommandBufferContext::clientWaitSync (GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+  unsupported ("clientWaitSync");
+}
+
+void
+CommandBufferContext::compileShader (GLuint shader)
+{
+  writeOp (OP_COMPILE_SHADER);
+  write (shader);
+}
+
+GLuint
+CommandBufferContext::createProgram ()
+{
+  unsupported ("createProgram");
+}
+
+GLuint
+CommandBufferContext::createShader (GLenum shaderType)
+{
+  unsupported ("createShader");
+}
+
+void
+CommandBufferContext::cullFace (GLenum mode)
+{
+  writeOp (OP_CULL_FACE);
+  write (mode);
+}
+
+void
+CommandBufferContext::deleteBuffers (GLsizei n, const GLuint* buffers)
+{
+  writeOp (OP_DELETE_BUFFERS);
+  write (n);
+  writePayload (buffers, n * sizeof (GLuint));
+}
+
+void
+CommandBufferContext::deleteProgram (GLuint program)
+{
+  writeOp (OP_DELETE_PROGRAM);
+  write (program);
+}
+
+void
+CommandBufferContext::deleteQueries (GLsizei n, const GLuint* ids)
+{
+  writeOp (OP_DELETE_QUERIES);
+  write (n);
+  writePayload (ids, n * sizeof (GLuint));
+}
+
+void
+CommandBufferContext::deleteShader (GLuint shader)
+{
+  writeOp (OP_DELETE_SHADER);
+  write (shader);
+}
+
+void
+CommandBufferContext::deleteSync (GLsync sync)
+{
+  writeOp (OP_DELETE_SYNC);
+  write (sync);
+}
+
+void
+CommandBufferContext::deleteVertexArrays (GLsizei n, const GLuint* arrays)
+{
+  writeOp (OP_DELETE_VERTEX_ARRAYS);
+  write (n);
+  writePayload (arrays, n * sizeof (GLuint));
+}
+
+void
+CommandBufferContext::detachShader (GLuint program, GLuint shader)
+{
+  writeOp (OP_DETACH_SHADER);
+  write (program);
+  write (shader);
+}
+
+void
+CommandBufferContext::drawArrays (GLenum mode, GLint first, GLsizei count)
+{
+  writeOp (OP_DRAW_ARRAYS);
+  write (mode);
+  write (first);
+  write (count);
+}
+
+void
+CommandBufferContext::drawElements (GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+  writeOp (OP_DRAW_ELEMENTS);
+  write (mode);
+  write (count);
+  write (type);
+  write (reinterpret_cast<uintptr_t> (indices));
+}
+
+void
+CommandBufferContext::enable (GLenum cap)
+{
+  writeOp (OP_ENABLE);
+  write (cap);
+}
+
+void
+CommandBufferContext::enableVertexAttribArray (GLuint index)
+{
+  writeOp (OP_ENABLE_VERTEX_ATTRIB_ARRAY);
+  write (index);
+}
+
+void
+CommandBufferContext::endQuery (GLenum target)
+{
+  writeOp (OP_END_QUERY);
+  write (target);
+}
+
+GLsync
+CommandBufferContext::fenceSync (GLenum condition, GLbitfield flags)
+{
+  unsupported ("fenceSync");
+}
+
+void
+CommandBufferContext::finish ()
+{
+  writeOp (OP_FINISH);
+}
+
+void
+CommandBufferContext::flush ()
+{
+  writeOp (OP_FLUSH);
+}
+
+void
+CommandBufferContext::frontFace (GLenum mode)
+{
+  writeOp (OP_FRONT_FACE);
+  write (mode);
+}
+
+void
+CommandBufferContext::genBuffers (GLsizei n, GLuint* buffers)
+{
+  unsupported ("genBuffers");
+}
+
+void
+CommandBufferContext::genQueries (GLsizei n, GLuint* ids)
+{
+  unsupported ("genQueries");
+}
+
+void
+CommandBufferContext::genVertexArrays (GLsizei n, GLuint* arrays)
+{
+  unsupported ("genVertexArrays");
+}
+
+GLint
+CommandBufferContext::getAttribLocation (GLuint program, const GLchar* name)
+{
+  unsupported ("getAttribLocation");
+}
+
+void
+CommandBufferContext::getIntegerv (GLenum pname, GLint* data)
+{
+  unsupported ("getIntegerv");
+}
+
+void
+CommandBufferContext::getProgramBinary (GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary)
+{
+  unsupported ("getProgramBinary");
+}
+
+void
+CommandBufferContext::getProgramInfoLog (GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog)
+{
+  unsupported ("getProgramInfoLog");
+}
+
+void
+CommandBufferContext::getProgramiv (GLuint program, GLenum pname, GLint* params)
+{
+  unsupported ("getProgramiv");
+}
+
+void
+CommandBufferContext::getQueryObjectiv (GLuint id, GLenum pname, GLint* params)
+{
+  unsupported ("getQueryObjectiv");
+}
+
+void
+CommandBufferContext::getQueryObjectui64v (GLuint id, GLenum pname, GLuint64* params)
+{
+  unsupported ("getQueryObjectui64v");
+}
+
+void
+CommandBufferContext::getShaderInfoLog (GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog)
+{
+  unsupported ("getShaderInfoLog");
+}
+
+void
+CommandBufferContext::getShaderiv (GLuint shader, GLenum pname, GLint* params)
+{
+  unsupported ("getShaderiv");
+}
+
+const GLubyte*
+CommandBufferContext::getString (GLenum name)
+{
+  unsupported ("getString");
+}
+
+GLint
+CommandBufferContext::getUniformLocation (GLuint program, const GLchar* name)
+{
+  unsupported ("getUniformLocation");
+}
+
+void
+CommandBufferContext::linkProgram (GLuint program)
+{
+  writeOp (OP_LINK_PROGRAM);
+  write (program);
+}
+
+void
+CommandBufferContext::maxShaderCompilerThreadsKHR (GLuint count)
+{
+  writeOp (OP_MAX_SHADER_COMPILER_THREADS_KHR);
+  write (count);
+}
+
+void
+CommandBufferContext::programBinary (GLuint program, GLenum binaryFormat, const void* binary, GLsizei length)
+{
+  writeOp (OP_PROGRAM_BINARY);
+  write (program);
+  write (binaryFormat);
+  // The length goes first so replay knows how much to read.
+  write (length);
+  writePayload (binary, length);
+}
+
+void
+CommandBufferContext::programParameteri (GLuint program, GLenum pname, GLint value)
+{
+  writeOp (OP_PROGRAM_PARAMETERI);
+  write (program);
+  write (pname);
+  write (value);
+}
+
+void
+CommandBufferContext::queryCounter (GLuint id, GLenum target)
+{
+  writeOp (OP_QUERY_COUNTER);
+  write (id);
+  write (target);
+}
+
+void
+CommandBufferContext::shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length)
+{
+  writeOp (OP_SHADER_SOURCE);
+  write (shader);
+  write (count);
+  writeStrings (count, string, length);
+}
+
+void
+CommandBufferContext::uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+  writeOp (OP_UNIFORM_MATRIX4FV);
+  write (location);
+  write (count);
+  write (transpose);
+  writePayload (value, count * 16 * sizeof (GLfloat));
+}
+
+void
+CommandBufferContext::useProgram (GLuint program)
+{
+  writeOp (OP_USE_PROGRAM);
+  write (program);
+}
+
+void
+CommandBufferContext::vertexAttribPointer (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer)
+{
+  writeOp (OP_VERTEX_ATTRIB_POINTER);
+  write (index);
+  write (size);
+  write (type);
+  write (normalized);
+  write (stride);
+  write (reinterpret_cast<uintptr_t> (pointer));
+}
+
+void
+CommandBufferContext::viewport (GLint x, GLint y, GLsizei width, GLsizei height)
+{
+  writeOp (OP_VIEWPORT);
+  write (x);
+  write (y);
+  write (width);
+  write (height);
+}
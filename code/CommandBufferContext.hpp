@@ -0,0 +1,365 @@
+/// \file CommandBufferContext.hpp
+/// \brief Declaration of CommandBufferContext.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef COMMAND_BUFFER_CONTEXT_HPP
+#define COMMAND_BUFFER_CONTEXT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "OpenGLContext.hpp"
+
+/// \brief A subclass of OpenGLContext that makes no OpenGL calls, but
+///   records them into a compact binary stream to be replayed later through
+///   another context.
+///
+/// Recording touches nothing but this object, so any thread may record
+///   (one thread per CommandBufferContext at a time), and only replay has
+///   to happen on the thread that owns the OpenGL context.  Data passed by
+///   pointer (buffer contents, matrices, names to delete, shader sources) is
+///   copied into the stream, so it may change as soon as the call returns.
+///   Pointers that are really offsets into a bound buffer (drawElements,
+///   vertexAttribPointer) are kept as offsets.
+/// Calls that return a value or write through a pointer can't be deferred;
+///   making one is a programming error that aborts the program.
+class CommandBufferContext : public OpenGLContext
+{
+public:
+
+  /// Constructs an empty CommandBufferContext.
+  CommandBufferContext ();
+
+  /// Destructs a CommandBufferContext.
+  virtual
+  ~CommandBufferContext ();
+
+  /// Copy constructor deleted because you should not be copying
+  ///   OpenGLContexts.
+  CommandBufferContext (const CommandBufferContext&) = delete;
+
+  /// Assignment operator deleted because you should not be assigning
+  ///   OpenGLContexts.
+  CommandBufferContext&
+  operator= (const CommandBufferContext&) = delete;
+
+  /// \brief Discards every recorded call, keeping the memory for reuse.
+  /// \post getCommandCount and getByteCount are 0.
+  void
+  reset ();
+
+  /// \brief Makes every recorded call, in order.
+  /// \param[in] context The context to make them through.
+  /// \pre No thread is recording into this.
+  void
+  replay (OpenGLContext* context) const;
+
+  /// \brief Gets the number of calls recorded.
+  /// \return The number of calls.
+  unsigned int
+  getCommandCount () const;
+
+  /// \brief Gets the size of the recorded stream.
+  /// \return The size in bytes.
+  size_t
+  getByteCount () const;
+
+  virtual void
+  attachShader (GLuint program, GLuint shader);
+
+  virtual void
+  beginQuery (GLenum target, GLuint id);
+
+  virtual void
+  bindBuffer (GLenum target, GLuint buffer);
+
+  virtual void
+  bindVertexArray (GLuint array);
+
+  virtual void
+  bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage);
+
+  virtual void
+  bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data);
+
+  virtual void
+  clear (GLbitfield mask);
+
+  virtual void
+  clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+
+  virtual GLenum
+  clientWaitSync (GLsync sync, GLbitfield flags, GLuint64 timeout);
+
+  virtual void
+  compileShader (GLuint shader);
+
+  virtual GLuint
+  createProgram ();
+
+  virtual GLuint
+  createShader (GLenum shaderType);
+
+  virtual void
+  cullFace (GLenum mode);
+
+  virtual void
+  deleteBuffers (GLsizei n, const GLuint* buffers);
+
+  virtual void
+  deleteProgram (GLuint program);
+
+  virtual void
+  deleteQueries (GLsizei n, const GLuint* ids);
+
+  virtual void
+  deleteShader (GLuint shader);
+
+  virtual void
+  deleteSync (GLsync sync);
+
+  virtual void
+  deleteVertexArrays (GLsizei n, const GLuint* arrays);
+
+  virtual void
+  detachShader (GLuint program, GLuint shader);
+
+  virtual void
+  drawArrays (GLenum mode, GLint first, GLsizei count);
+
+  virtual void
+  drawElements (GLenum mode, GLsizei count, GLenum type, const void* indices);
+
+  virtual void
+  enable (GLenum cap);
+
+  virtual void
+  enableVertexAttribArray (GLuint index);
+
+  virtual void
+  endQuery (GLenum target);
+
+  virtual GLsync
+  fenceSync (GLenum condition, GLbitfield flags);
+
+  virtual void
+  finish ();
+
+  virtual void
+  flush ();
+
+  virtual void
+  frontFace (GLenum mode);
+
+  virtual void
+  genBuffers (GLsizei n, GLuint* buffers);
+
+  virtual void
+  genQueries (GLsizei n, GLuint* ids);
+
+  virtual void
+  genVertexArrays (GLsizei n, GLuint* arrays);
+
+  virtual GLint
+  getAttribLocation (GLuint program, const GLchar* name);
+
+  virtual void
+  getIntegerv (GLenum pname, GLint* data);
+
+  virtual void
+  getProgramBinary (GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+
+  virtual void
+  getProgramInfoLog (GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
+
+  virtual void
+  getProgramiv (GLuint program, GLenum pname, GLint* params);
+
+  virtual void
+  getQueryObjectiv (GLuint id, GLenum pname, GLint* params);
+
+  virtual void
+  getQueryObjectui64v (GLuint id, GLenum pname, GLuint64* params);
+
+  virtual void
+  getShaderInfoLog (GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
+
+  virtual void
+  getShaderiv (GLuint shader, GLenum pname, GLint* params);
+
+  virtual const GLubyte*
+  getString (GLenum name);
+
+  virtual GLint
+  getUniformLocation (GLuint program, const GLchar* name);
+
+  virtual void
+  linkProgram (GLuint program);
+
+  virtual void
+  maxShaderCompilerThreadsKHR (GLuint count);
+
+  virtual void
+  programBinary (GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+
+  virtual void
+  programParameteri (GLuint program, GLenum pname, GLint value);
+
+  virtual void
+  queryCounter (GLuint id, GLenum target);
+
+  virtual void
+  shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length);
+
+  virtual void
+  uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+
+  virtual void
+  useProgram (GLuint program);
+
+  virtual void
+  vertexAttribPointer (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer);
+
+  virtual void
+  viewport (GLint x, GLint y, GLsizei width, GLsizei height);
+
+private:
+
+  /// \brief Identifies each call that can be recorded.
+  enum Opcode : uint8_t
+  {
+    OP_ATTACH_SHADER,
+    OP_BEGIN_QUERY,
+    OP_BIND_BUFFER,
+    OP_BIND_VERTEX_ARRAY,
+    OP_BUFFER_DATA,
+    OP_BUFFER_SUB_DATA,
+    OP_CLEAR,
+    OP_CLEAR_COLOR,
+    OP_COMPILE_SHADER,
+    OP_CULL_FACE,
+    OP_DELETE_BUFFERS,
+    OP_DELETE_PROGRAM,
+    OP_DELETE_QUERIES,
+    OP_DELETE_SHADER,
+    OP_DELETE_SYNC,
+    OP_DELETE_VERTEX_ARRAYS,
+    OP_DETACH_SHADER,
+    OP_DRAW_ARRAYS,
+    OP_DRAW_ELEMENTS,
+    OP_ENABLE,
+    OP_ENABLE_VERTEX_ATTRIB_ARRAY,
+    OP_END_QUERY,
+    OP_FINISH,
+    OP_FLUSH,
+    OP_FRONT_FACE,
+    OP_LINK_PROGRAM,
+    OP_MAX_SHADER_COMPILER_THREADS_KHR,
+    OP_PROGRAM_BINARY,
+    OP_PROGRAM_PARAMETERI,
+    OP_QUERY_COUNTER,
+    OP_SHADER_SOURCE,
+    OP_UNIFORM_MATRIX4FV,
+    OP_USE_PROGRAM,
+    OP_VERTEX_ATTRIB_POINTER,
+    OP_VIEWPORT,
+  };
+
+  /// \brief Reports a call that can't be recorded and aborts.
+  /// \param[in] name The call's name.
+  [[noreturn]] static void
+  unsupported (const char* name);
+
+  /// \brief Appends a value to the stream.
+  /// \param[in] value The value, which must be trivially copyable.
+  template<typename T>
+  void
+  write (const T& value)
+  {
+    std::memcpy (allocate (sizeof (T)), &value, sizeof (T));
+  }
+
+  /// \brief Reads a value written by write.
+  /// \param[in,out] position Where in the stream to read, which is moved
+  ///   past the value.
+  /// \return The value.
+  template<typename T>
+  T
+  read (size_t& position) const
+  {
+    T value;
+    std::memcpy (&value, m_bytes.data () + position, sizeof (T));
+    position += sizeof (T);
+    return value;
+  }
+
+  /// \brief Makes room at the end of the stream.
+  /// \param[in] size The number of bytes needed.
+  /// \return Where to write them.
+  unsigned char*
+  allocate (size_t size)
+  {
+    if (m_size + size > m_bytes.size ())
+      grow (size);
+    unsigned char* at = m_bytes.data () + m_size;
+    m_size += size;
+    return at;
+  }
+
+  /// \brief Enlarges m_bytes, at least doubling it so appends stay cheap.
+  /// \param[in] size The number of bytes that must fit after m_size.
+  void
+  grow (size_t size);
+
+  /// \brief Starts recording a call.
+  /// \param[in] op The call.
+  void
+  writeOp (Opcode op);
+
+  /// \brief Appends a copy of some memory, 8-byte aligned.  Its size isn't
+  ///   stored; replay gets it from the call's other arguments.
+  /// \param[in] data The memory, or nullptr.
+  /// \param[in] size Its size in bytes.
+  void
+  writePayload (const void* data, size_t size);
+
+  /// \brief Reads memory written by writePayload.
+  /// \param[in,out] position Where in the stream to read, which is moved
+  ///   past the memory.
+  /// \param[in] size Its size in bytes.
+  /// \return A pointer into the stream, or nullptr if nullptr was written.
+  const void*
+  readPayload (size_t& position, size_t size) const;
+
+  /// \brief Appends the strings given to shaderSource.
+  /// \param[in] count The number of strings.
+  /// \param[in] strings The strings.
+  /// \param[in] lengths Their lengths, or nullptr if all are
+  ///   null-terminated.
+  void
+  writeStrings (GLsizei count, const GLchar** strings, const GLint* lengths);
+
+  /// \brief Reads strings written by writeStrings.
+  /// \param[in,out] position Where in the stream to read, which is moved
+  ///   past the strings.
+  /// \param[in] count The number of strings.
+  /// \param[out] strings Receives pointers into the stream.
+  /// \param[out] lengths Receives their lengths.
+  void
+  readStrings (size_t& position, GLsizei count, std::vector<const GLchar*>& strings,
+	       std::vector<GLint>& lengths) const;
+
+  /// The recorded stream: each call is its Opcode followed by its arguments.
+  ///   Only the first m_size bytes are in use; the rest is kept from
+  ///   earlier frames so recording rarely allocates.
+  std::vector<unsigned char> m_bytes;
+  /// The number of bytes of m_bytes in use.
+  size_t m_size;
+  /// The number of calls recorded.
+  unsigned int m_commandCount;
+};
+
+#endif//COMMAND_BUFFER_CONTEXT_HPP
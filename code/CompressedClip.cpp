@@ -0,0 +1,468 @@
+/// \file CompressedClip.cpp
+/// \brief Definitions of CompressedClip member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "CompressedClip.hpp"
+
+const unsigned int CompressedClip::LANES;
+const uint32_t CompressedClip::NO_TRACK;
+
+const float CompressedClip::POSITION_TOLERANCE = 0.001f;
+const float CompressedClip::ROTATION_TOLERANCE_DEGREES = 0.1f;
+const float CompressedClip::SCALE_TOLERANCE = 0.001f;
+
+/// The largest quantized value or time.
+static const float QUANTUM_MAX = 65535.0f;
+
+/// How close to a whole number of ticks every key time must be for the
+///   clip's key spacing to be used as its tick.
+static const float TICK_SLACK = 1.0e-3f;
+
+/// \brief Wraps a time into a looping clip.
+/// \param[in] time The time in seconds.
+/// \param[in] duration The length of the clip.
+/// \return The time in [0, duration), or time itself if duration is 0.
+static float
+wrapTime (float time, float duration)
+{
+  if (duration <= 0.0f)
+    return time;
+  time = std::fmod (time, duration);
+  return time < 0.0f ? time + duration : time;
+}
+
+/// \brief Blends two keys' values.
+/// \param[in] from The value at amount 0.
+/// \param[in] to The value at amount 1.
+/// \param[in] amount How far from from toward to.
+/// \param[in] components 3, or 4 for a rotation, which is renormalized.
+/// \param[out] out The blended value.
+static void
+blend (const float* from, const float* to, float amount, unsigned int components, float* out)
+{
+  float lengthSquared = 0.0f;
+  for (unsigned int c = 0; c < components; ++c)
+  {
+    out[c] = from[c] + (to[c] - from[c]) * amount;
+    lengthSquared += out[c] * out[c];
+  }
+  if (components == 4)
+    for (unsigned int c = 0; c < components; ++c)
+      out[c] /= std::sqrt (lengthSquared);
+}
+
+/// \brief Checks whether a value is close enough to another to stand in
+///   for it.
+/// \param[in] a One value.
+/// \param[in] b The other.
+/// \param[in] components 3, or 4 for a rotation.
+/// \param[in] tolerance The largest difference in any component, or for a
+///   rotation the largest angle between them in degrees.
+/// \return Whether they are that close.
+static bool
+isClose (const float* a, const float* b, unsigned int components, float tolerance)
+{
+  if (components == 4)
+  {
+    float dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    // Two unit quaternions q and r are turned 2 acos |q . r| apart.
+    return std::abs (dot) >= std::cos (tolerance * static_cast<float> (M_PI) / 360.0f);
+  }
+  for (unsigned int c = 0; c < components; ++c)
+    if (std::abs (a[c] - b[c]) > tolerance)
+      return false;
+  return true;
+}
+
+/// \brief Checks whether every key between two can be dropped.
+/// \param[in] times The track's key times.
+/// \param[in] values The track's values.
+/// \param[in] components The floats per value.
+/// \param[in] tolerance As for isClose.
+/// \param[in] first The key before the gap.
+/// \param[in] last The key after it.
+/// \return Whether blending first and last reproduces every key between.
+static bool
+canSpan (const std::vector<float>& times, const std::vector<float>& values,
+	 unsigned int components, float tolerance, size_t first, size_t last)
+{
+  const float* from = &values[first * components];
+  const float* to = &values[last * components];
+  float span = times[last] - times[first];
+  for (size_t key = first + 1; key < last; ++key)
+  {
+    float blended[4];
+    float amount = span > 0.0f ? (times[key] - times[first]) / span : 0.0f;
+    blend (from, to, amount, components, blended);
+    if (!isClose (blended, &values[key * components], components, tolerance))
+      return false;
+  }
+  return true;
+}
+
+CompressedClip::CompressedClip ()
+  : m_duration (0.0f), m_secondsPerTick (1.0f)
+{
+}
+
+CompressedClip::CompressedClip (const AnimationClip& clip)
+  : m_name (clip.getName ()), m_duration (clip.getDuration ()), m_secondsPerTick (1.0f)
+{
+  const std::vector<AnimationChannel>& channels = clip.getChannels ();
+
+  // Files almost always bake keys at a fixed rate, so when every key falls
+  //   on a multiple of the closest spacing, that spacing is the tick and
+  //   keys land on exact ticks.  Otherwise the clip is split into 65535.
+  std::vector<float> allTimes;
+  for (const AnimationChannel& channel : channels)
+  {
+    for (const VectorKey& key : channel.positionKeys)
+      allTimes.push_back (key.time);
+    for (const RotationKey& key : channel.rotationKeys)
+      allTimes.push_back (key.time);
+    for (const VectorKey& key : channel.scaleKeys)
+      allTimes.push_back (key.time);
+  }
+  std::sort (allTimes.begin (), allTimes.end ());
+  float spacing = 0.0f;
+  for (size_t timeNum = 1; timeNum < allTimes.size (); ++timeNum)
+  {
+    float gap = allTimes[timeNum] - allTimes[timeNum - 1];
+    if (gap > 0.0f && (spacing == 0.0f || gap < spacing))
+      spacing = gap;
+  }
+  float lastTime = std::max (m_duration, allTimes.empty () ? 0.0f : allTimes.back ());
+  bool regular = spacing > 0.0f && lastTime / spacing <= QUANTUM_MAX;
+  for (size_t timeNum = 0; regular && timeNum < allTimes.size (); ++timeNum)
+  {
+    float ticks = allTimes[timeNum] / spacing;
+    regular = std::abs (ticks - std::round (ticks)) <= TICK_SLACK;
+  }
+  if (regular)
+    m_secondsPerTick = spacing;
+  else if (lastTime > 0.0f)
+    m_secondsPerTick = lastTime / QUANTUM_MAX;
+
+  for (const AnimationChannel& channel : channels)
+  {
+    Channel packed;
+    packed.node = channel.node;
+
+    std::vector<float> times, values;
+    for (const VectorKey& key : channel.positionKeys)
+    {
+      times.push_back (key.time);
+      values.insert (values.end (), { key.value.m_x, key.value.m_y, key.value.m_z });
+    }
+    packed.position = addTrack (times, values, 3, POSITION_TOLERANCE);
+
+    times.clear ();
+    values.clear ();
+    for (const RotationKey& key : channel.rotationKeys)
+    {
+      // q and -q are the same rotation; keeping each key on the same side
+      //   as the one before lets sampling blend without checking, and keeps
+      //   each component's range (and so its quantization step) small.
+      Quaternion q = key.value;
+      if (!values.empty ())
+      {
+	const float* last = &values[values.size () - 4];
+	if (q.m_w * last[0] + q.m_x * last[1] + q.m_y * last[2] + q.m_z * last[3] < 0.0f)
+	  q = Quaternion (-q.m_w, -q.m_x, -q.m_y, -q.m_z);
+      }
+      times.push_back (key.time);
+      values.insert (values.end (), { q.m_w, q.m_x, q.m_y, q.m_z });
+    }
+    packed.rotation = addTrack (times, values, 4, ROTATION_TOLERANCE_DEGREES);
+
+    times.clear ();
+    values.clear ();
+    for (const VectorKey& key : channel.scaleKeys)
+    {
+      times.push_back (key.time);
+      values.insert (values.end (), { key.value.m_x, key.value.m_y, key.value.m_z });
+    }
+    // Scaling by 1 changes nothing, so a track that never leaves it goes.
+    bool unitScale = true;
+    for (float value : values)
+      unitScale = unitScale && std::abs (value - 1.0f) <= SCALE_TOLERANCE;
+    packed.scale = unitScale ? NO_TRACK : addTrack (times, values, 3, SCALE_TOLERANCE);
+
+    m_channels.push_back (packed);
+  }
+}
+
+const std::string&
+CompressedClip::getName () const
+{
+  return m_name;
+}
+
+float
+CompressedClip::getDuration () const
+{
+  return m_duration;
+}
+
+unsigned int
+CompressedClip::getKeyCount () const
+{
+  return m_times.size ();
+}
+
+size_t
+CompressedClip::getByteCount () const
+{
+  return m_channels.size () * sizeof (Channel) + m_tracks.size () * sizeof (Track)
+    + m_times.size () * sizeof (uint16_t) + m_values.size () * sizeof (uint16_t);
+}
+
+void
+CompressedClip::sample (float time, std::vector<Transform>& locals, Cursor* cursor) const
+{
+  std::vector<Transform>* localsPointer = &locals;
+  sampleMany (1, &time, &localsPointer, cursor != nullptr ? &cursor : nullptr);
+}
+
+void
+CompressedClip::sampleMany (unsigned int count, const float* times,
+			    std::vector<Transform>* const* locals, Cursor* const* cursors) const
+{
+  for (unsigned int start = 0; start < count; start += LANES)
+  {
+    unsigned int lanes = std::min (LANES, count - start);
+    float ticks[LANES];
+    for (unsigned int lane = 0; lane < lanes; ++lane)
+    {
+      ticks[lane] = wrapTime (times[start + lane], m_duration) / m_secondsPerTick;
+      if (cursors != nullptr && cursors[start + lane]->keys.size () != m_tracks.size ())
+	cursors[start + lane]->keys.assign (m_tracks.size (), 0);
+    }
+    Cursor* const* laneCursors = cursors != nullptr ? cursors + start : nullptr;
+
+    for (const Channel& channel : m_channels)
+    {
+      // A channel with no track of some kind leaves that part of the bind
+      //   pose as it was, as AnimationClip::sample does.
+      float values[4][LANES];
+      if (channel.rotation != NO_TRACK)
+      {
+	sampleTrack (m_tracks[channel.rotation], channel.rotation, lanes, ticks, laneCursors,
+		     values);
+	for (unsigned int lane = 0; lane < lanes; ++lane)
+	{
+	  Quaternion q (values[0][lane], values[1][lane], values[2][lane], values[3][lane]);
+	  (*locals[start + lane])[channel.node].setOrientation (q.toMatrix3 ());
+	}
+      }
+      if (channel.scale != NO_TRACK)
+      {
+	sampleTrack (m_tracks[channel.scale], channel.scale, lanes, ticks, laneCursors, values);
+	for (unsigned int lane = 0; lane < lanes; ++lane)
+	{
+	  Transform& local = (*locals[start + lane])[channel.node];
+	  local.setOrientation (local.getRight () * values[0][lane],
+				local.getUp () * values[1][lane],
+				local.getBack () * values[2][lane]);
+	}
+      }
+      if (channel.position != NO_TRACK)
+      {
+	sampleTrack (m_tracks[channel.position], channel.position, lanes, ticks, laneCursors,
+		     values);
+	for (unsigned int lane = 0; lane < lanes; ++lane)
+	  (*locals[start + lane])[channel.node].setPosition (
+	    Vector3 (values[0][lane], values[1][lane], values[2][lane]));
+      }
+    }
+  }
+}
+
+uint32_t
+CompressedClip::addTrack (const std::vector<float>& times, const std::vector<float>& values,
+			  unsigned int components, float tolerance)
+{
+  size_t keyCount = times.size ();
+  if (keyCount == 0)
+    return NO_TRACK;
+  assert (keyCount <= QUANTUM_MAX + 1);
+
+  // Greedily stretch each segment as far as blending its ends still passes
+  //   within tolerance of every key it skips.
+  std::vector<size_t> kept (1, 0);
+  for (size_t key = 1; key + 1 < keyCount; ++key)
+    if (!canSpan (times, values, components, tolerance, kept.back (), key + 1))
+      kept.push_back (key);
+  if (keyCount > 1)
+    kept.push_back (keyCount - 1);
+  // A track that never strays from its first key needs only that key.
+  bool constant = true;
+  for (size_t key : kept)
+    constant = constant && isClose (&values[0], &values[key * components], components, tolerance);
+  if (constant)
+    kept.resize (1);
+
+  Track track;
+  track.firstKey = m_times.size ();
+  track.firstValue = m_values.size ();
+  track.keyCount = kept.size ();
+  track.components = components;
+  for (unsigned int c = 0; c < 4; ++c)
+  {
+    track.offset[c] = 0.0f;
+    track.step[c] = 0.0f;
+  }
+  for (unsigned int c = 0; c < components; ++c)
+  {
+    float low = values[c], high = values[c];
+    for (size_t key : kept)
+    {
+      low = std::min (low, values[key * components + c]);
+      high = std::max (high, values[key * components + c]);
+    }
+    track.offset[c] = low;
+    track.step[c] = (high - low) / QUANTUM_MAX;
+  }
+
+  for (size_t key : kept)
+  {
+    float tick = std::round (times[key] / m_secondsPerTick);
+    m_times.push_back (static_cast<uint16_t> (std::min (std::max (tick, 0.0f), QUANTUM_MAX)));
+    for (unsigned int c = 0; c < components; ++c)
+    {
+      float quantum = track.step[c] > 0.0f
+	? std::round ((values[key * components + c] - track.offset[c]) / track.step[c]) : 0.0f;
+      m_values.push_back (static_cast<uint16_t> (std::min (std::max (quantum, 0.0f), QUANTUM_MAX)));
+    }
+  }
+  m_tracks.push_back (track);
+  return m_tracks.size () - 1;
+}
+
+unsigned int
+CompressedClip::findKey (const Track& track, float tick, uint16_t* hint) const
+{
+  const uint16_t* times = &m_times[track.firstKey];
+  unsigned int key;
+  if (hint != nullptr && *hint < track.keyCount && times[*hint] <= tick)
+  {
+    // Playing forward, the key wanted is almost always this one or the
+    //   next.
+    key = *hint;
+    while (key + 1 < track.keyCount && times[key + 1] <= tick)
+      ++key;
+  }
+  else
+  {
+    const uint16_t* after = std::upper_bound (times, times + track.keyCount, tick,
+					      [] (float t, uint16_t time) { return t < time; });
+    key = after == times ? 0 : after - times - 1;
+  }
+  if (hint != nullptr)
+    *hint = key;
+  return key;
+}
+
+void
+CompressedClip::sampleTrack (const Track& track, uint32_t trackNum, unsigned int count,
+			     const float* ticks, Cursor* const* cursors, float out[4][LANES]) const
+{
+  if (track.keyCount == 1)
+  {
+    // A still track's only key quantizes to its offset.
+    for (unsigned int c = 0; c < track.components; ++c)
+      for (unsigned int lane = 0; lane < LANES; ++lane)
+	out[c][lane] = track.offset[c];
+    if (track.components == 4)
+    {
+      float length = std::sqrt (track.offset[0] * track.offset[0] + track.offset[1] * track.offset[1]
+				+ track.offset[2] * track.offset[2] + track.offset[3] * track.offset[3]);
+      for (unsigned int c = 0; c < 4; ++c)
+	for (unsigned int lane = 0; lane < LANES; ++lane)
+	  out[c][lane] /= length;
+    }
+    return;
+  }
+
+  // Gather each lane's pair of keys side by side, so dequantizing and
+  //   blending them is the same few instructions for every lane.
+  int32_t from[4][LANES], to[4][LANES];
+  float amounts[LANES];
+  const uint16_t* times = &m_times[track.firstKey];
+  const uint16_t* values = &m_values[track.firstValue];
+  for (unsigned int lane = 0; lane < LANES; ++lane)
+  {
+    if (lane >= count)
+    {
+      // Unused lanes repeat the first, so they blend harmless numbers.
+      for (unsigned int c = 0; c < track.components; ++c)
+      {
+	from[c][lane] = from[c][0];
+	to[c][lane] = to[c][0];
+      }
+      amounts[lane] = amounts[0];
+      continue;
+    }
+    uint16_t* hint = cursors != nullptr ? &cursors[lane]->keys[trackNum] : nullptr;
+    unsigned int key = findKey (track, ticks[lane], hint);
+    unsigned int next = key;
+    amounts[lane] = 0.0f;
+    if (key + 1 < track.keyCount && ticks[lane] > times[key])
+    {
+      next = key + 1;
+      amounts[lane] = (ticks[lane] - times[key]) / (times[next] - times[key]);
+    }
+    for (unsigned int c = 0; c < track.components; ++c)
+    {
+      from[c][lane] = values[key * track.components + c];
+      to[c][lane] = values[next * track.components + c];
+    }
+  }
+
+#ifdef __SSE2__
+  __m128 amount = _mm_loadu_ps (amounts);
+  __m128 lengthSquared = _mm_setzero_ps ();
+  __m128 blended[4];
+  for (unsigned int c = 0; c < track.components; ++c)
+  {
+    __m128 offset = _mm_set1_ps (track.offset[c]);
+    __m128 step = _mm_set1_ps (track.step[c]);
+    __m128 a = _mm_add_ps (offset, _mm_mul_ps (step, _mm_cvtepi32_ps (
+      _mm_loadu_si128 (reinterpret_cast<const __m128i*> (from[c])))));
+    __m128 b = _mm_add_ps (offset, _mm_mul_ps (step, _mm_cvtepi32_ps (
+      _mm_loadu_si128 (reinterpret_cast<const __m128i*> (to[c])))));
+    blended[c] = _mm_add_ps (a, _mm_mul_ps (_mm_sub_ps (b, a), amount));
+    lengthSquared = _mm_add_ps (lengthSquared, _mm_mul_ps (blended[c], blended[c]));
+  }
+  if (track.components == 4)
+  {
+    __m128 length = _mm_sqrt_ps (lengthSquared);
+    for (unsigned int c = 0; c < 4; ++c)
+      blended[c] = _mm_div_ps (blended[c], length);
+  }
+  for (unsigned int c = 0; c < track.components; ++c)
+    _mm_storeu_ps (out[c], blended[c]);
+#else
+  for (unsigned int lane = 0; lane < LANES; ++lane)
+  {
+    float a[4], b[4], blended[4];
+    for (unsigned int c = 0; c < track.components; ++c)
+    {
+      a[c] = track.offset[c] + track.step[c] * from[c][lane];
+      b[c] = track.offset[c] + track.step[c] * to[c][lane];
+    }
+    blend (a, b, amounts[lane], track.components, blended);
+    for (unsigned int c = 0; c < track.components; ++c)
+      out[c][lane] = blended[c];
+  }
+#endif
+}
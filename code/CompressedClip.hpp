@@ -0,0 +1,176 @@
+/// \file CompressedClip.hpp
+/// \brief Declaration of CompressedClip class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef COMPRESSED_CLIP_HPP
+#define COMPRESSED_CLIP_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "AnimationClip.hpp"
+
+/// \brief An AnimationClip packed for playing back a crowd.
+/// Building one drops every key that interpolating its neighbours already
+///   reproduces (within POSITION_TOLERANCE, ROTATION_TOLERANCE_DEGREES, or
+///   SCALE_TOLERANCE), so constant tracks shrink to one key and smooth ones
+///   to a handful.  Each remaining value is then stored as 16-bit integers
+///   spread over that track's own range, and each time as a 16-bit tick.
+///   Every track's keys sit together in time order, so playing forward
+///   with a Cursor walks memory in order instead of searching it.
+/// sampleMany poses up to LANES characters playing the clip at once, one
+///   per SIMD lane: the keys of each are gathered side by side and then
+///   dequantized and blended together.
+class CompressedClip
+{
+public:
+
+  /// The number of characters sampleMany blends at once.
+  static const unsigned int LANES = 4;
+
+  /// How far the fitted curve may pass from a dropped position key, in
+  ///   model units.  Quantizing adds up to half a step more.
+  static const float POSITION_TOLERANCE;
+  /// How far the fitted curve may be turned from a dropped rotation key, in
+  ///   degrees.
+  static const float ROTATION_TOLERANCE_DEGREES;
+  /// How far the fitted curve may pass from a dropped scale key.  A scale
+  ///   track this close to 1 throughout is dropped entirely.
+  static const float SCALE_TOLERANCE;
+
+  /// \brief Remembers where one character last was in each track, so the
+  ///   next sample searches forward from there.
+  struct Cursor
+  {
+    /// For each track, the key last sampled from.
+    std::vector<uint16_t> keys;
+  };
+
+  /// \brief Constructs an empty clip.
+  CompressedClip ();
+
+  /// \brief Compresses a clip.
+  /// \param[in] clip The clip.  Each track has at most 65536 keys.
+  explicit CompressedClip (const AnimationClip& clip);
+
+  /// \brief Gets the name of the clip.
+  /// \return The name.
+  const std::string&
+  getName () const;
+
+  /// \brief Gets the length of the clip.
+  /// \return The length in seconds.
+  float
+  getDuration () const;
+
+  /// \brief Gets the number of keys kept, over every track.
+  /// \return The number of keys.
+  unsigned int
+  getKeyCount () const;
+
+  /// \brief Gets the memory the clip's data takes.
+  /// \return The number of bytes.
+  size_t
+  getByteCount () const;
+
+  /// \brief Poses the animated nodes at some time, like
+  ///   AnimationClip::sample.
+  /// \param[in] time The time in seconds, wrapped into [0, duration).
+  /// \param[in,out] locals Every node's local transform.  Those of animated
+  ///   nodes are replaced; the rest are left alone.
+  /// \param[in,out] cursor Where this character last was, or nullptr to
+  ///   search every track from scratch.
+  void
+  sample (float time, std::vector<Transform>& locals, Cursor* cursor = nullptr) const;
+
+  /// \brief Poses several characters playing this clip.
+  /// \param[in] count The number of characters.
+  /// \param[in] times Each character's time in seconds.
+  /// \param[in,out] locals Each character's local transforms.
+  /// \param[in,out] cursors Each character's cursor, or nullptr to search
+  ///   from scratch.
+  void
+  sampleMany (unsigned int count, const float* times, std::vector<Transform>* const* locals,
+	      Cursor* const* cursors = nullptr) const;
+
+private:
+
+  /// \brief The kept keys of one position, rotation, or scale track.
+  struct Track
+  {
+    /// The position in m_times of the track's first key.
+    uint32_t firstKey;
+    /// The position in m_values of the track's first value.
+    uint32_t firstValue;
+    /// The number of keys.
+    uint32_t keyCount;
+    /// 3 for a position or scale, 4 for a rotation.
+    uint32_t components;
+    /// Each component's smallest value.
+    float offset[4];
+    /// Each component's range, divided by 65535.
+    float step[4];
+  };
+
+  /// \brief The tracks that move one node.
+  struct Channel
+  {
+    /// The position of the node in Model::nodes.
+    uint32_t node;
+    /// The position in m_tracks of each of its tracks, or NO_TRACK.
+    uint32_t position, rotation, scale;
+  };
+
+  /// Marks a channel with no track of some kind.
+  static const uint32_t NO_TRACK = ~0u;
+
+  /// \brief Fits and quantizes one track, appending it to m_tracks.
+  /// \param[in] times When each key is, in seconds.
+  /// \param[in] values Each key's components, components floats per key.
+  /// \param[in] components 3 or 4.
+  /// \param[in] tolerance How far (per component, or for a rotation in
+  ///   degrees) a dropped key may be from the fitted curve.
+  /// \return The track's position in m_tracks, or NO_TRACK if it is empty.
+  uint32_t
+  addTrack (const std::vector<float>& times, const std::vector<float>& values,
+	    unsigned int components, float tolerance);
+
+  /// \brief Finds the key at or before a time.
+  /// \param[in] track The track.
+  /// \param[in] tick The time, in ticks.
+  /// \param[in,out] hint The key last found, which is searched forward
+  ///   from if it isn't after tick, or nullptr.
+  /// \return The position of the key within the track.
+  unsigned int
+  findKey (const Track& track, float tick, uint16_t* hint) const;
+
+  /// \brief Blends one track for up to LANES characters.
+  /// \param[in] track The track.
+  /// \param[in] trackNum Its position in m_tracks, for the cursors.
+  /// \param[in] count The number of characters.
+  /// \param[in] ticks Each character's time, in ticks.
+  /// \param[in] cursors Each character's cursor, or nullptr.
+  /// \param[out] out Component-major blended values: out[c][lane].
+  void
+  sampleTrack (const Track& track, uint32_t trackNum, unsigned int count, const float* ticks,
+	       Cursor* const* cursors, float out[4][LANES]) const;
+
+  /// The name the file gave the clip.
+  std::string m_name;
+  /// The length of the clip, in seconds.
+  float m_duration;
+  /// The length of one tick, in seconds.
+  float m_secondsPerTick;
+  /// Every channel.
+  std::vector<Channel> m_channels;
+  /// Every track.
+  std::vector<Track> m_tracks;
+  /// Every key's time, in ticks, track after track.
+  std::vector<uint16_t> m_times;
+  /// Every key's quantized components, track after track.
+  std::vector<uint16_t> m_values;
+};
+
+#endif//COMPRESSED_CLIP_HPP
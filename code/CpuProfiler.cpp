@@ -0,0 +1,130 @@
+/// \file CpuProfiler.cpp
+/// \brief Definitions of CpuProfiler member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <algorithm>
+#include <cstdio>
+
+#include "CpuProfiler.hpp"
+
+std::mutex CpuProfiler::s_mutex;
+std::vector<std::unique_ptr<CpuProfiler::ThreadBuffer>> CpuProfiler::s_buffers;
+
+CpuProfiler::ThreadBuffer::ThreadBuffer (unsigned int threadId)
+  : id (threadId), zones (new ZoneRecord[ZONES_PER_THREAD]), count (0)
+{
+}
+
+void
+CpuProfiler::record (const char* name, uint64_t begin, uint64_t end)
+{
+  ThreadBuffer& buffer = getThreadBuffer ();
+  uint64_t count = buffer.count.load (std::memory_order_relaxed);
+  ZoneRecord& zone = buffer.zones[count % ZONES_PER_THREAD];
+  zone.name = name;
+  zone.begin = begin;
+  zone.end = end;
+  buffer.count.store (count + 1, std::memory_order_release);
+}
+
+void
+CpuProfiler::setThreadName (const std::string& name)
+{
+  ThreadBuffer& buffer = getThreadBuffer ();
+  std::lock_guard<std::mutex> lock (s_mutex);
+  buffer.name = name;
+}
+
+uint64_t
+CpuProfiler::getZoneCount ()
+{
+  std::lock_guard<std::mutex> lock (s_mutex);
+  uint64_t total = 0;
+  for (const std::unique_ptr<ThreadBuffer>& buffer : s_buffers)
+    total += buffer->count.load (std::memory_order_acquire);
+  return total;
+}
+
+bool
+CpuProfiler::writeChromeTrace (const std::string& fileName)
+{
+  std::FILE* out = std::fopen (fileName.c_str (), "w");
+  if (out == nullptr)
+    return false;
+
+  std::lock_guard<std::mutex> lock (s_mutex);
+  // Chrome wants microseconds; starting at the earliest zone keeps the
+  //   numbers small enough to print exactly.
+  uint64_t origin = UINT64_MAX;
+  for (const std::unique_ptr<ThreadBuffer>& buffer : s_buffers)
+  {
+    uint64_t count = buffer->count.load (std::memory_order_acquire);
+    uint64_t first = count > ZONES_PER_THREAD ? count - ZONES_PER_THREAD : 0;
+    for (uint64_t zone = first; zone < count; ++zone)
+      origin = std::min (origin, buffer->zones[zone % ZONES_PER_THREAD].begin);
+  }
+
+  std::fprintf (out, "{\"traceEvents\":[\n");
+  const char* separator = "";
+  for (const std::unique_ptr<ThreadBuffer>& buffer : s_buffers)
+  {
+    if (!buffer->name.empty ())
+    {
+      std::fprintf (out, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,"
+		    "\"args\":{\"name\":\"%s\"}}", separator, buffer->id,
+		    escapeJson (buffer->name).c_str ());
+      separator = ",\n";
+    }
+    uint64_t count = buffer->count.load (std::memory_order_acquire);
+    uint64_t first = count > ZONES_PER_THREAD ? count - ZONES_PER_THREAD : 0;
+    for (uint64_t zoneNum = first; zoneNum < count; ++zoneNum)
+    {
+      const ZoneRecord& zone = buffer->zones[zoneNum % ZONES_PER_THREAD];
+      std::fprintf (out, "%s{\"ph\":\"X\",\"name\":\"%s\",\"pid\":1,\"tid\":%u,"
+		    "\"ts\":%.3f,\"dur\":%.3f}", separator, escapeJson (zone.name).c_str (), buffer->id,
+		    (zone.begin - origin) / 1000.0, (zone.end - zone.begin) / 1000.0);
+      separator = ",\n";
+    }
+  }
+  std::fprintf (out, "\n]}\n");
+  bool ok = std::ferror (out) == 0;
+  return std::fclose (out) == 0 && ok;
+}
+
+std::string
+CpuProfiler::escapeJson (const std::string& text)
+{
+  std::string escaped;
+  escaped.reserve (text.size ());
+  for (char c : text)
+  {
+    if (c == '"' || c == '\\')
+    {
+      escaped += '\\';
+      escaped += c;
+    }
+    else if (static_cast<unsigned char> (c) < 0x20)
+    {
+      char code[7];
+      std::snprintf (code, sizeof (code), "\\u%04x", c);
+      escaped += code;
+    }
+    else
+      escaped += c;
+  }
+  return escaped;
+}
+
+CpuProfiler::ThreadBuffer&
+CpuProfiler::getThreadBuffer ()
+{
+  thread_local ThreadBuffer* t_buffer = nullptr;
+  if (t_buffer == nullptr)
+  {
+    std::lock_guard<std::mutex> lock (s_mutex);
+    s_buffers.emplace_back (new ThreadBuffer (s_buffers.size () + 1));
+    t_buffer = s_buffers.back ().get ();
+  }
+  return *t_buffer;
+}
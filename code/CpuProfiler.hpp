@@ -0,0 +1,180 @@
+/// \file CpuProfiler.hpp
+/// \brief Declaration of CpuProfiler class and the PROFILE_* macros.
+/// \author Ethan Gingrich
+/// \version A08
+///
+/// Zones are only recorded when the program is compiled with
+///   -DENABLE_PROFILER (see CPPFLAGS in the Makefile).  Otherwise every
+///   PROFILE_* macro expands to nothing, so zones can be left in hot code.
+
+#ifndef CPU_PROFILER_HPP
+#define CPU_PROFILER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// \brief Records how long named zones of code take on each thread, and
+///   writes them as a Chrome trace (load it in chrome://tracing or
+///   https://ui.perfetto.dev).
+/// Each thread writes completed zones into its own fixed-size ring buffer,
+///   so recording takes no locks and never allocates; a thread only takes a
+///   lock once, the first time it records anything, to register its buffer.
+///   When a buffer fills, its oldest zones are overwritten.
+class CpuProfiler
+{
+public:
+
+  /// The number of zones each thread keeps.
+  static const unsigned int ZONES_PER_THREAD = 1u << 16;
+
+  /// \brief Times a zone from its construction to its destruction.  Use
+  ///   PROFILE_ZONE rather than constructing one directly.
+  class Zone
+  {
+  public:
+
+    /// \brief Begins a zone.
+    /// \param[in] name The zone's name.  It must live as long as the
+    ///   program (normally a string literal), since only the pointer is
+    ///   stored.
+    Zone (const char* name)
+      : m_name (name), m_begin (now ())
+    {
+    }
+
+    /// \brief Ends the zone, recording it.
+    ~Zone ()
+    {
+      record (m_name, m_begin, now ());
+    }
+
+    /// \brief Copy constructor removed because a zone ends exactly once.
+    Zone (const Zone&) = delete;
+
+    /// \brief Assignment operator removed because a zone ends exactly once.
+    Zone&
+    operator= (const Zone&) = delete;
+
+  private:
+
+    /// The zone's name.
+    const char* m_name;
+    /// When the zone began, in nanoseconds.
+    uint64_t m_begin;
+  };
+
+  /// \brief Gets the current time.
+  /// \return Nanoseconds on a monotonic clock.
+  static uint64_t
+  now ()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>
+      (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+  }
+
+  /// \brief Records a zone for the calling thread.
+  /// \param[in] name The zone's name, which must live as long as the program.
+  /// \param[in] begin When the zone began, from now.
+  /// \param[in] end When the zone ended, from now.
+  static void
+  record (const char* name, uint64_t begin, uint64_t end);
+
+  /// \brief Names the calling thread in traces.
+  /// \param[in] name The thread's name.
+  static void
+  setThreadName (const std::string& name);
+
+  /// \brief Gets the number of zones recorded so far on every thread,
+  ///   including any that have since been overwritten.
+  /// \return The number of zones.
+  static uint64_t
+  getZoneCount ();
+
+  /// \brief Writes every zone still held as Chrome trace_event JSON.
+  /// \param[in] fileName The file to write.
+  /// \return True if the file was written.
+  /// Best called while other threads are idle: a zone being overwritten as
+  ///   it is read may come out garbled, though nothing worse happens.
+  static bool
+  writeChromeTrace (const std::string& fileName);
+
+  /// \brief Escapes text for use inside a JSON string.
+  /// \param[in] text The text.
+  /// \return The text with quotes, backslashes, and control characters
+  ///   escaped.
+  static std::string
+  escapeJson (const std::string& text);
+
+private:
+
+  /// \brief One completed zone.
+  struct ZoneRecord
+  {
+    /// The zone's name.
+    const char* name;
+    /// When it began, in nanoseconds.
+    uint64_t begin;
+    /// When it ended, in nanoseconds.
+    uint64_t end;
+  };
+
+  /// \brief The zones recorded by one thread.  Only that thread writes to
+  ///   it; it outlives the thread so its zones can still be exported.
+  struct ThreadBuffer
+  {
+    /// \brief Constructs an empty buffer.
+    /// \param[in] threadId The id traces show for the thread.
+    ThreadBuffer (unsigned int threadId);
+
+    /// The id traces show for the thread.
+    unsigned int id;
+    /// The thread's name, or empty.
+    std::string name;
+    /// The ring of zones.
+    std::unique_ptr<ZoneRecord[]> zones;
+    /// The number of zones ever recorded; the next goes at this modulo
+    ///   ZONES_PER_THREAD.  Published with release ordering after each zone
+    ///   is written.
+    std::atomic<uint64_t> count;
+  };
+
+  /// \brief Gets the calling thread's buffer, registering it on first use.
+  /// \return The buffer.
+  static ThreadBuffer&
+  getThreadBuffer ();
+
+  /// Guards s_buffers.
+  static std::mutex s_mutex;
+  /// Every thread's buffer, in the order they were registered.
+  static std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+};
+
+#ifdef ENABLE_PROFILER
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER (a, b)
+
+/// \brief Times the rest of the enclosing block as a zone called name.
+#define PROFILE_ZONE(name) \
+  CpuProfiler::Zone PROFILE_CONCAT (profileZone, __LINE__) (name)
+
+/// \brief Times the rest of the enclosing function as a zone named after it.
+#define PROFILE_FUNCTION() PROFILE_ZONE (__func__)
+
+/// \brief Names the calling thread in traces.
+#define PROFILE_THREAD_NAME(name) CpuProfiler::setThreadName (name)
+
+#else
+
+#define PROFILE_ZONE(name) do { } while (false)
+#define PROFILE_FUNCTION() do { } while (false)
+#define PROFILE_THREAD_NAME(name) do { } while (false)
+
+#endif//ENABLE_PROFILER
+
+#endif//CPU_PROFILER_HPP
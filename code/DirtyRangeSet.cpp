@@ -0,0 +1,63 @@
+/// \file DirtyRangeSet.cpp
+/// \brief Definitions of DirtyRangeSet member and associated global functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <algorithm>
+
+#include "DirtyRangeSet.hpp"
+
+DirtyRangeSet::DirtyRangeSet ()
+{
+}
+
+void
+DirtyRangeSet::add (unsigned int begin, unsigned int end)
+{
+  if (begin >= end)
+    return;
+
+  // Find the first stored range that ends at or after the new one begins.
+  // Everything before it is strictly to the left and can't be merged.
+  std::vector<Range>::iterator first =
+    std::lower_bound (m_ranges.begin (), m_ranges.end (), begin,
+		      [] (const Range& r, unsigned int value)
+		      { return r.end < value; });
+  // Swallow every range that starts at or before the new one ends.
+  std::vector<Range>::iterator last = first;
+  while (last != m_ranges.end () && last->begin <= end)
+  {
+    begin = std::min (begin, last->begin);
+    end = std::max (end, last->end);
+    ++last;
+  }
+  first = m_ranges.erase (first, last);
+  m_ranges.insert (first, Range { begin, end });
+}
+
+void
+DirtyRangeSet::clear ()
+{
+  m_ranges.clear ();
+}
+
+bool
+DirtyRangeSet::empty () const
+{
+  return m_ranges.empty ();
+}
+
+const std::vector<DirtyRangeSet::Range>&
+DirtyRangeSet::getRanges () const
+{
+  return m_ranges;
+}
+
+unsigned int
+DirtyRangeSet::getTotalLength () const
+{
+  unsigned int total = 0;
+  for (const Range& r : m_ranges)
+    total += r.end - r.begin;
+  return total;
+}
@@ -0,0 +1,69 @@
+/// \file DirtyRangeSet.hpp
+/// \brief Declaration of DirtyRangeSet class and any associated global
+///   functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef DIRTY_RANGE_SET_HPP
+#define DIRTY_RANGE_SET_HPP
+
+#include <vector>
+
+/// \brief A collection of half-open [begin, end) ranges of elements that have
+///   been modified and still need to be copied somewhere (usually to a GPU
+///   buffer).
+/// The ranges are always kept sorted and coalesced: no two stored ranges
+///   overlap or touch, so each one can be uploaded with a single call.
+class DirtyRangeSet
+{
+public:
+
+  /// \brief A half-open range of element positions, [begin, end).
+  struct Range
+  {
+    /// The first element in the range.
+    unsigned int begin;
+    /// One past the last element in the range.
+    unsigned int end;
+  };
+
+  /// \brief Constructs an empty DirtyRangeSet.
+  /// \post No elements are dirty.
+  DirtyRangeSet ();
+
+  /// \brief Marks a range of elements as dirty.
+  /// \param[in] begin The first element that was modified.
+  /// \param[in] end One past the last element that was modified.
+  /// \post Every element in [begin, end) is dirty.  Any stored ranges that
+  ///   overlap or touch the new one have been merged with it.
+  void
+  add (unsigned int begin, unsigned int end);
+
+  /// \brief Forgets all dirty ranges.
+  /// \post No elements are dirty.
+  void
+  clear ();
+
+  /// \brief Tests whether or not any elements are dirty.
+  /// \return True if no elements are dirty, otherwise false.
+  bool
+  empty () const;
+
+  /// \brief Gets the dirty ranges.
+  /// \return The dirty ranges, sorted by position, none overlapping or
+  ///   touching another.
+  const std::vector<Range>&
+  getRanges () const;
+
+  /// \brief Gets the total number of dirty elements.
+  /// \return The sum of the lengths of all dirty ranges.
+  unsigned int
+  getTotalLength () const;
+
+private:
+
+  /// The sorted, coalesced dirty ranges.
+  std::vector<Range> m_ranges;
+};
+
+#endif//DIRTY_RANGE_SET_HPP
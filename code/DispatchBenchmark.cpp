@@ -0,0 +1,182 @@
+/// \file DispatchBenchmark.cpp
+/// \brief A command-line tool that measures what calling OpenGL through the
+///   virtual OpenGLContext interface costs, compared with the direct calls a
+///   STATIC_GL_CONTEXT build makes (see GlContext.hpp).
+/// \author Ethan Gingrich
+/// \version A08
+///
+/// Usage:
+///   DispatchBenchmark.out [draws [frames]]
+///     Makes the seven calls Mesh::draw makes per mesh, for that many meshes
+///     (50000 by default), first through an OpenGLContext* and then through
+///     a pointer to a final class, as RealOpenGLContext is.  Each call ends
+///     in a call through a function pointer, as GLEW's do, so the only
+///     difference between the two is the virtual dispatch.  Build it with
+///     optimization on, or neither side is inlined.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "NullOpenGLContext.hpp"
+#include "TimingHistory.hpp"
+
+/// Stand-ins for GLEW's function pointers.  They are non-const globals, as
+///   GLEW's are, so calls through them can't be inlined.
+void (*g_useProgram) (GLuint);
+void (*g_uniformMatrix4fv) (GLint, GLsizei, GLboolean, const GLfloat*);
+void (*g_bindVertexArray) (GLuint);
+void (*g_drawElements) (GLenum, GLsizei, GLenum, const GLvoid*);
+
+/// Accumulates the arguments of every call, so none can be optimized away.
+unsigned long g_sink;
+
+/// \brief Pretends to be glUseProgram.
+/// \param[in] program The program.
+static void
+fakeUseProgram (GLuint program)
+{
+  g_sink += program;
+}
+
+/// \brief Pretends to be glUniformMatrix4fv.
+/// \param[in] location The uniform's location.
+/// \param[in] count The number of matrices.
+/// \param[in] transpose Whether the matrices are row-major.
+/// \param[in] value The matrices.
+static void
+fakeUniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+  g_sink += location + static_cast<unsigned long> (value[0]);
+}
+
+/// \brief Pretends to be glBindVertexArray.
+/// \param[in] array The VAO.
+static void
+fakeBindVertexArray (GLuint array)
+{
+  g_sink += array;
+}
+
+/// \brief Pretends to be glDrawElements.
+/// \param[in] mode The kind of primitive.
+/// \param[in] count The number of indices.
+/// \param[in] type The type of the indices.
+/// \param[in] indices The offset of the first index.
+static void
+fakeDrawElements (GLenum mode, GLsizei count, GLenum type, const GLvoid* indices)
+{
+  g_sink += count;
+}
+
+/// \brief A context whose draw-path calls go through the stand-in function
+///   pointers, as RealOpenGLContext's go through GLEW's.
+class PointerContext : public NullOpenGLContext
+{
+public:
+
+  virtual void
+  bindVertexArray (GLuint array)
+  {
+    g_bindVertexArray (array);
+  }
+
+  virtual void
+  drawElements (GLenum mode, GLsizei count, GLenum type, const GLvoid* indices)
+  {
+    g_drawElements (mode, count, type, indices);
+  }
+
+  virtual void
+  uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+  {
+    g_uniformMatrix4fv (location, count, transpose, value);
+  }
+
+  virtual void
+  useProgram (GLuint program)
+  {
+    g_useProgram (program);
+  }
+};
+
+/// \brief The same context, but final, so calls through a pointer to it are
+///   bound at compile time.
+class FinalPointerContext final : public PointerContext
+{
+};
+
+/// \brief Makes the calls Mesh::draw makes, for many meshes.
+/// \param[in] context The context to make the calls through.
+/// \param[in] draws The number of meshes.
+/// \param[in] modelView A matrix to upload for each.
+template<typename Context>
+static void
+drawAll (Context* context, unsigned int draws, const float* modelView)
+{
+  for (unsigned int draw = 0; draw < draws; ++draw)
+  {
+    context->useProgram (1);
+    context->uniformMatrix4fv (0, 1, GL_FALSE, modelView);
+    context->uniformMatrix4fv (1, 1, GL_FALSE, modelView);
+    context->bindVertexArray (draw + 1);
+    context->drawElements (GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
+    context->bindVertexArray (0);
+    context->useProgram (0);
+  }
+}
+
+/// \brief Times a function.
+/// \param[in] work The function to time.
+/// \return The elapsed time in milliseconds.
+template<typename Function>
+static double
+timeMs (Function work)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  work ();
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now () - start;
+  return elapsed.count ();
+}
+
+/// \brief Runs the benchmark.
+/// \param[in] argc The number of command-line arguments.
+/// \param[in] argv The number of draws and of frames to time.
+/// \return EXIT_SUCCESS.
+int
+main (int argc, char* argv[])
+{
+  const unsigned int CALLS_PER_DRAW = 7;
+
+  unsigned int draws = argc > 1 ? std::atoi (argv[1]) : 50000;
+  unsigned int frames = argc > 2 ? std::atoi (argv[2]) : 100;
+  g_useProgram = fakeUseProgram;
+  g_uniformMatrix4fv = fakeUniformMatrix4fv;
+  g_bindVertexArray = fakeBindVertexArray;
+  g_drawElements = fakeDrawElements;
+
+  FinalPointerContext context;
+  // Picked at run time, so the compiler can't devirtualize the calls.
+  std::vector<OpenGLContext*> contexts (1, &context);
+  OpenGLContext* virtualContext = contexts[argc % contexts.size ()];
+  float modelView[16] = { 1.0f };
+
+  TimingHistory dynamic (frames);
+  TimingHistory direct (frames);
+  for (unsigned int frame = 0; frame < frames; ++frame)
+  {
+    // Interleaved, so neither side gets a quieter machine.
+    dynamic.add (timeMs ([&] () { drawAll (virtualContext, draws, modelView); }));
+    direct.add (timeMs ([&] () { drawAll (&context, draws, modelView); }));
+  }
+
+  double dynamicMs = dynamic.getPercentile (50);
+  double directMs = direct.getPercentile (50);
+  double perCallNs = (dynamicMs - directMs) * 1e6 / (static_cast<double> (draws) * CALLS_PER_DRAW);
+  std::printf ("%u draws (%u calls), median of %u frames\n", draws, draws * CALLS_PER_DRAW, frames);
+  std::printf ("  virtual OpenGLContext   %8.3f ms\n", dynamicMs);
+  std::printf ("  final (static)          %8.3f ms\n", directMs);
+  std::printf ("  difference              %8.3f ms, %.2f ns per call\n", dynamicMs - directMs, perCallNs);
+  return EXIT_SUCCESS;
+}
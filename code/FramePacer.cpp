@@ -0,0 +1,138 @@
+/// \file FramePacer.cpp
+/// \brief Definitions of FramePacer member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <chrono>
+#include <thread>
+
+#include "FramePacer.hpp"
+
+/// How long before a just-in-time deadline a frame starts, beyond its
+///   predicted work, to absorb wake-up jitter.
+static const double SAFETY_MARGIN_SECONDS = 0.001;
+
+/// How close to a deadline sleeping stops and spinning starts.  Sleeps
+///   routinely overshoot by a millisecond or so.
+static const double SPIN_SECONDS = 0.002;
+
+/// The number of frames whose work predicts the next.
+static const unsigned int WORK_HISTORY = 120;
+
+FramePacer::FramePacer (Mode mode, double targetHz)
+  : m_mode (mode), m_period (1.0 / targetHz), m_frameStart (0.0),
+    m_nextStart (0.0), m_lastSwap (-1.0), m_workTimes (WORK_HISTORY)
+{
+}
+
+FramePacer::Mode
+FramePacer::getMode () const
+{
+  return m_mode;
+}
+
+std::string
+FramePacer::getModeName () const
+{
+  switch (m_mode)
+  {
+    case VSYNC:
+      return "vsync";
+    case UNCAPPED:
+      return "uncapped";
+    case CAPPED:
+      return "cap";
+    default:
+      return "jit";
+  }
+}
+
+int
+FramePacer::getSwapInterval () const
+{
+  return m_mode == VSYNC || m_mode == JUST_IN_TIME ? 1 : 0;
+}
+
+double
+FramePacer::getWakeTime () const
+{
+  if (m_mode == CAPPED)
+    return m_nextStart;
+  if (m_mode == JUST_IN_TIME && m_lastSwap >= 0.0)
+  {
+    // The swap blocks until vertical blank, so the last one returned on a
+    //   blank and the next is one period later.
+    return m_lastSwap + m_period - getPredictedWorkSeconds () - SAFETY_MARGIN_SECONDS;
+  }
+  return 0.0;
+}
+
+double
+FramePacer::getPredictedWorkSeconds () const
+{
+  return m_workTimes.getPercentile (95) / 1000.0;
+}
+
+void
+FramePacer::wait ()
+{
+  sleepUntil (getWakeTime ());
+  beginFrame (now ());
+}
+
+void
+FramePacer::beginFrame (double time)
+{
+  m_frameStart = time;
+  // Keep to the cadence unless a whole frame has been missed, in which case
+  //   start a new one rather than rushing to catch up.
+  if (time - m_nextStart < m_period)
+    m_nextStart += m_period;
+  else
+    m_nextStart = time + m_period;
+}
+
+void
+FramePacer::endWork (double time)
+{
+  m_workTimes.add ((time - m_frameStart) * 1000.0);
+}
+
+void
+FramePacer::endFrame (double time)
+{
+  m_lastSwap = time;
+}
+
+double
+FramePacer::now ()
+{
+  std::chrono::duration<double> sinceEpoch = std::chrono::steady_clock::now ().time_since_epoch ();
+  return sinceEpoch.count ();
+}
+
+void
+FramePacer::sleepUntil (double deadline)
+{
+  double remaining = deadline - now ();
+  if (remaining > SPIN_SECONDS)
+    std::this_thread::sleep_for (std::chrono::duration<double> (remaining - SPIN_SECONDS));
+  while (now () < deadline)
+    std::this_thread::yield ();
+}
+
+bool
+FramePacer::parseMode (const std::string& name, Mode& mode)
+{
+  if (name == "vsync")
+    mode = VSYNC;
+  else if (name == "uncapped")
+    mode = UNCAPPED;
+  else if (name == "cap")
+    mode = CAPPED;
+  else if (name == "jit")
+    mode = JUST_IN_TIME;
+  else
+    return false;
+  return true;
+}
@@ -0,0 +1,124 @@
+/// \file FramePacer.hpp
+/// \brief Declaration of FramePacer class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef FRAME_PACER_HPP
+#define FRAME_PACER_HPP
+
+#include <string>
+
+#include "TimingHistory.hpp"
+
+/// \brief Decides when the render loop starts each frame.
+/// The render loop calls wait at the top of every frame, then marks when
+///   the frame's work ended (just before the swap) and when the swap
+///   returned.  Times are in seconds on the clock now reads.
+class FramePacer
+{
+public:
+
+  /// \brief The ways frames can be paced.
+  enum Mode
+  {
+    /// Frames start as soon as the last swap returns, and the swap waits
+    ///   for vertical blank.
+    VSYNC,
+    /// Frames start as soon as the last one ends, and swaps don't wait.
+    UNCAPPED,
+    /// Frames start at a fixed rate, and swaps don't wait.
+    CAPPED,
+    /// Swaps wait for vertical blank, but each frame starts only just
+    ///   before the next one is predicted to be due, so the input it
+    ///   samples is as fresh as possible when shown.
+    JUST_IN_TIME
+  };
+
+  /// \brief Constructs a FramePacer.
+  /// \param[in] mode How frames are paced.
+  /// \param[in] targetHz The frame rate for CAPPED, or the display's
+  ///   refresh rate for JUST_IN_TIME.  Ignored otherwise.
+  /// \pre targetHz > 0.
+  FramePacer (Mode mode, double targetHz);
+
+  /// \brief Gets how frames are paced.
+  /// \return The mode.
+  Mode
+  getMode () const;
+
+  /// \brief Gets the mode's name, as parseMode takes it.
+  /// \return The name.
+  std::string
+  getModeName () const;
+
+  /// \brief Gets the swap interval the window should use.
+  /// \return 1 if swaps should wait for vertical blank, otherwise 0.
+  int
+  getSwapInterval () const;
+
+  /// \brief Gets when the next frame should start.
+  /// \return The time, which may already have passed.
+  double
+  getWakeTime () const;
+
+  /// \brief Gets how long a frame's work is expected to take: the 95th
+  ///   percentile of recent frames, so few overrun it.
+  /// \return The time in seconds, or 0 if no frame has been timed.
+  double
+  getPredictedWorkSeconds () const;
+
+  /// \brief Waits until the next frame should start, then begins it.
+  void
+  wait ();
+
+  /// \brief Begins a frame.  wait calls this; call it directly only if not
+  ///   waiting.
+  /// \param[in] time When the frame began.
+  void
+  beginFrame (double time);
+
+  /// \brief Marks the end of a frame's work, just before the swap.
+  /// \param[in] time When the work ended.
+  void
+  endWork (double time);
+
+  /// \brief Marks when a frame's swap returned.
+  /// \param[in] time When it returned.
+  void
+  endFrame (double time);
+
+  /// \brief Gets the current time.
+  /// \return Seconds on a steady clock with an arbitrary epoch.
+  static double
+  now ();
+
+  /// \brief Waits until a time, sleeping while the deadline is far enough
+  ///   off for the scheduler to be trusted and spinning for the rest.
+  /// \param[in] deadline The time, as now reads it.
+  static void
+  sleepUntil (double deadline);
+
+  /// \brief Looks up a mode by name.
+  /// \param[in] name "vsync", "uncapped", "cap", or "jit".
+  /// \param[out] mode The mode, if the name is known.
+  /// \return True if the name is known.
+  static bool
+  parseMode (const std::string& name, Mode& mode);
+
+private:
+
+  /// How frames are paced.
+  Mode m_mode;
+  /// The time between frames (CAPPED) or vertical blanks (JUST_IN_TIME).
+  double m_period;
+  /// When the current frame began.
+  double m_frameStart;
+  /// When the next CAPPED frame is due.
+  double m_nextStart;
+  /// When the last swap returned, or a negative number before the first.
+  double m_lastSwap;
+  /// How long recent frames' work took, in milliseconds.
+  TimingHistory m_workTimes;
+};
+
+#endif//FRAME_PACER_HPP
@@ -7,12 +7,22 @@
 #include <cassert>
 #include <iostream>
 
+#include "CpuProfiler.hpp"
 #include "Geometry.hpp"
+#include "JobSystem.hpp"
+
+/// The fewest faces worth computing face normals for on another thread.
+static const size_t FACE_NORMAL_GRAIN = 4096;
+
+/// The fewest faces worth computing vertex normals for on another thread.
+///   Each one compares against every face, so this is much smaller.
+static const size_t VERTEX_NORMAL_GRAIN = 16;
 
 void
 indexData (const std::vector<float>& geometry, unsigned int floatsPerVertex,
 	   std::vector<float>& data, std::vector<unsigned int>& indices)
 {
+  PROFILE_FUNCTION ();
   const unsigned int VERTICES_PER_TRIANGLE = 3;
   const float EPSILON = 0.00001f;
   assert (geometry.size () % (floatsPerVertex * VERTICES_PER_TRIANGLE) == 0);
@@ -54,14 +64,19 @@ indexData (const std::vector<float>& geometry, unsigned int floatsPerVertex,
 std::vector<Vector3>
 computeFaceNormals (const std::vector<Triangle>& faces)
 {
-  std::vector<Vector3> faceNormals;
-  for(unsigned int faceIndex = 0; faceIndex < faces.size (); faceIndex++)
+  PROFILE_FUNCTION ();
+  std::vector<Vector3> faceNormals (faces.size ());
+  // Each face is independent, so big meshes are split among threads.
+  JobSystem::getShared ().parallelFor (faces.size (), FACE_NORMAL_GRAIN, [&] (size_t begin, size_t end)
   {
-    // We learned this algorithm back in Lecture 04!
-    Vector3 normal = (faces[faceIndex][1] - faces[faceIndex][0]).cross (faces[faceIndex][2] - faces[faceIndex][0]);
-    normal.normalize ();
-    faceNormals.push_back (normal);
-  }
+    for(size_t faceIndex = begin; faceIndex < end; faceIndex++)
+    {
+      // We learned this algorithm back in Lecture 04!
+      Vector3 normal = (faces[faceIndex][1] - faces[faceIndex][0]).cross (faces[faceIndex][2] - faces[faceIndex][0]);
+      normal.normalize ();
+      faceNormals[faceIndex] = normal;
+    }
+  });
   return faceNormals;
 }
 
@@ -69,39 +84,45 @@ std::vector<Vector3>
 computeVertexNormals (const std::vector<Triangle>& faces,
 		      const std::vector<Vector3>& faceNormals)
 {
+  PROFILE_FUNCTION ();
   assert (faces.size () == faceNormals.size ());
-  std::vector<Vector3> vertexNormals;
-  for (unsigned int faceIndex = 0; faceIndex < faces.size (); faceIndex++)
+  std::vector<Vector3> vertexNormals (faces.size () * 3);
+  // Each face's vertices only read the other faces, so faces are split
+  //   among threads.
+  JobSystem::getShared ().parallelFor (faces.size (), VERTEX_NORMAL_GRAIN, [&] (size_t begin, size_t end)
   {
-    for (unsigned int vertexIndex = 0; vertexIndex < 3; vertexIndex++)
+    for (size_t faceIndex = begin; faceIndex < end; faceIndex++)
     {
-      // We need to find *every* vertex in any triangle that is at this
-      //   position and average their face normals.
-      Vector3 vertexNormal (0.0f, 0.0f, 0.0f);
-      for (unsigned int otherFaceIndex = 0; otherFaceIndex < faces.size (); otherFaceIndex++)
+      for (unsigned int vertexIndex = 0; vertexIndex < 3; vertexIndex++)
       {
-	for (unsigned int otherVertexIndex = 0; otherVertexIndex < 3; otherVertexIndex++ )
+	// We need to find *every* vertex in any triangle that is at this
+	//   position and average their face normals.
+	Vector3 vertexNormal (0.0f, 0.0f, 0.0f);
+	for (unsigned int otherFaceIndex = 0; otherFaceIndex < faces.size (); otherFaceIndex++)
 	{
-	  if (faces[faceIndex][vertexIndex] == faces[otherFaceIndex][otherVertexIndex])
+	  for (unsigned int otherVertexIndex = 0; otherVertexIndex < 3; otherVertexIndex++ )
 	  {
-	    // Hey, we derived this formula in Lecture 04!
-	    float area = 0.5f * ((faces[otherFaceIndex][1] - faces[otherFaceIndex][0]).cross (faces[otherFaceIndex][2] - faces[otherFaceIndex][0])).length ();
-	    unsigned int oppositeIndexA = (otherVertexIndex + 1) % 3;
-	    unsigned int oppositeIndexB = (otherVertexIndex + 2) % 3;
-	    float angle = (faces[otherFaceIndex][oppositeIndexA] - faces[otherFaceIndex][otherVertexIndex]).angleBetween (faces[otherFaceIndex][oppositeIndexB] - faces[otherFaceIndex][otherVertexIndex]);
-	    // Weighting the average by area makes it so that lots of smaller
-	    //   faces don't overwhelm a few larger faces.
-	    // Weighting the average by angle makes it so that points where
-	    //   two 45 degree angles and points where one 90 degree angle meet
-	    //   get the same treatment.
-	    vertexNormal += faceNormals[otherFaceIndex] * fabs (area) * fabs (angle);
+	    if (faces[faceIndex][vertexIndex] == faces[otherFaceIndex][otherVertexIndex])
+	    {
+	      // Hey, we derived this formula in Lecture 04!
+	      float area = 0.5f * ((faces[otherFaceIndex][1] - faces[otherFaceIndex][0]).cross (faces[otherFaceIndex][2] - faces[otherFaceIndex][0])).length ();
+	      unsigned int oppositeIndexA = (otherVertexIndex + 1) % 3;
+	      unsigned int oppositeIndexB = (otherVertexIndex + 2) % 3;
+	      float angle = (faces[otherFaceIndex][oppositeIndexA] - faces[otherFaceIndex][otherVertexIndex]).angleBetween (faces[otherFaceIndex][oppositeIndexB] - faces[otherFaceIndex][otherVertexIndex]);
+	      // Weighting the average by area makes it so that lots of smaller
+	      //   faces don't overwhelm a few larger faces.
+	      // Weighting the average by angle makes it so that points where
+	      //   two 45 degree angles and points where one 90 degree angle meet
+	      //   get the same treatment.
+	      vertexNormal += faceNormals[otherFaceIndex] * fabs (area) * fabs (angle);
+	    }
 	  }
 	}
+	vertexNormal.normalize ();
+	vertexNormals[faceIndex * 3 + vertexIndex] = vertexNormal;
       }
-      vertexNormal.normalize ();
-      vertexNormals.push_back (vertexNormal);
     }
-  }
+  });
   return vertexNormals;
 }
 
@@ -155,6 +176,7 @@ std::vector<float>
 dataWithFaceColors (const std::vector<Triangle>& faces,
 		    const std::vector<Vector3>& faceColors)
 {
+  PROFILE_FUNCTION ();
   assert (faces.size () == faceColors.size ());
   std::vector<float> data;
   for(unsigned int faceIndex = 0; faceIndex < faces.size (); faceIndex++)
@@ -176,6 +198,7 @@ std::vector<float>
 dataWithVertexColors (const std::vector<Triangle>& faces,
 		      const std::vector<Vector3>& vertexColors)
 {
+  PROFILE_FUNCTION ();
   assert (faces.size () * 3 == vertexColors.size ());
   std::vector<float> data;
   for(unsigned int faceIndex = 0; faceIndex < faces.size (); faceIndex++)
@@ -197,6 +220,7 @@ std::vector<float>
 dataWithFaceNormals (const std::vector<Triangle>& faces,
 		     const std::vector<Vector3>& faceNormals)
 {
+  PROFILE_FUNCTION ();
   assert (faces.size () == faceNormals.size ());
   std::vector<float> data;
   for(unsigned int faceIndex = 0; faceIndex < faces.size (); faceIndex++)
@@ -218,6 +242,7 @@ std::vector<float>
 dataWithVertexNormals (const std::vector<Triangle>& faces,
 		       const std::vector<Vector3>& vertexNormals)
 {
+  PROFILE_FUNCTION ();
   assert (faces.size () * 3 == vertexNormals.size ());
   std::vector<float> data;
   for(unsigned int faceIndex = 0; faceIndex < faces.size (); faceIndex++)
@@ -0,0 +1,27 @@
+/// \file GlContext.hpp
+/// \brief Declaration of GlContext, the context type that Meshes and
+///   ShaderPrograms make their OpenGL calls through.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef GL_CONTEXT_HPP
+#define GL_CONTEXT_HPP
+
+/// By default GlContext is the abstract OpenGLContext, so any subclass (a
+///   NullOpenGLContext in tests, a StatsOpenGLContext around the real one,
+///   ...) can be handed to a Mesh, and every call is a virtual call that
+///   then goes through GLEW's function pointer.
+/// Compiling with -DSTATIC_GL_CONTEXT makes it RealOpenGLContext instead.
+///   That class is final, so calls through a GlContext* are direct and, with
+///   -flto, inline down to the GLEW call.  Only a RealOpenGLContext can then
+///   be given to a Mesh, ShaderProgram or ShaderLibrary, so tests and
+///   benchmarks that use other contexts are built without the flag.
+#ifdef STATIC_GL_CONTEXT
+#include "RealOpenGLContext.hpp"
+using GlContext = RealOpenGLContext;
+#else
+#include "OpenGLContext.hpp"
+using GlContext = OpenGLContext;
+#endif
+
+#endif//GL_CONTEXT_HPP
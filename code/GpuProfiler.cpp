@@ -0,0 +1,191 @@
+/// \file GpuProfiler.cpp
+/// \brief Definitions of GpuProfiler member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <cstdio>
+#include <fstream>
+
+#include "GpuProfiler.hpp"
+
+GpuProfiler::Scope::Scope (GpuProfiler* profiler, const std::string& name)
+  : m_profiler (profiler)
+{
+  if (m_profiler != nullptr)
+    m_profiler->beginScope (name);
+}
+
+GpuProfiler::Scope::~Scope ()
+{
+  if (m_profiler != nullptr)
+    m_profiler->endScope ();
+}
+
+GpuProfiler::GpuProfiler (OpenGLContext* context, unsigned int historyLength)
+  : m_context (context), m_current (FRAMES_IN_FLIGHT - 1),
+    m_historyLength (historyLength), m_droppedFrames (0)
+{
+  for (Frame& frame : m_frames)
+  {
+    frame.usedQueries = 0;
+    frame.pending = false;
+  }
+}
+
+GpuProfiler::~GpuProfiler ()
+{
+  for (Frame& frame : m_frames)
+  {
+    if (!frame.queries.empty ())
+      m_context->deleteQueries (frame.queries.size (), frame.queries.data ());
+  }
+}
+
+void
+GpuProfiler::beginFrame ()
+{
+  m_current = (m_current + 1) % FRAMES_IN_FLIGHT;
+  Frame& frame = m_frames[m_current];
+  if (frame.pending)
+    collect (frame);
+  frame.usedQueries = 0;
+  frame.scopes.clear ();
+  frame.open.clear ();
+}
+
+void
+GpuProfiler::endFrame ()
+{
+  Frame& frame = m_frames[m_current];
+  frame.pending = !frame.scopes.empty ();
+}
+
+void
+GpuProfiler::beginScope (const std::string& name)
+{
+  std::map<std::string, unsigned int>::iterator itr = m_nameIndices.find (name);
+  if (itr == m_nameIndices.end ())
+  {
+    itr = m_nameIndices.insert (std::make_pair (name, m_names.size ())).first;
+    m_names.push_back (name);
+    m_histories.push_back (TimingHistory (m_historyLength));
+  }
+  Frame& frame = m_frames[m_current];
+  ScopeRecord record;
+  record.name = itr->second;
+  record.begin = timestamp ();
+  record.end = record.begin;
+  frame.open.push_back (frame.scopes.size ());
+  frame.scopes.push_back (record);
+}
+
+void
+GpuProfiler::endScope ()
+{
+  Frame& frame = m_frames[m_current];
+  frame.scopes[frame.open.back ()].end = timestamp ();
+  frame.open.pop_back ();
+}
+
+const std::vector<std::string>&
+GpuProfiler::getScopeNames () const
+{
+  return m_names;
+}
+
+const TimingHistory*
+GpuProfiler::getHistory (const std::string& name) const
+{
+  std::map<std::string, unsigned int>::const_iterator itr = m_nameIndices.find (name);
+  if (itr == m_nameIndices.end ())
+    return nullptr;
+  return &m_histories[itr->second];
+}
+
+unsigned int
+GpuProfiler::getDroppedFrameCount () const
+{
+  return m_droppedFrames;
+}
+
+void
+GpuProfiler::report (std::ostream& out) const
+{
+  char line[160];
+  std::snprintf (line, sizeof (line), "%-24s %8s %8s %8s %8s %8s\n",
+		 "GPU scope (ms)", "frames", "min", "avg", "p99", "max");
+  out << line;
+  for (unsigned int nameNum = 0; nameNum < m_names.size (); ++nameNum)
+  {
+    const TimingHistory& history = m_histories[nameNum];
+    std::snprintf (line, sizeof (line), "%-24s %8u %8.3f %8.3f %8.3f %8.3f\n",
+		   m_names[nameNum].c_str (), history.getCount (), history.getMin (),
+		   history.getAverage (), history.getPercentile (99), history.getMax ());
+    out << line;
+  }
+  if (m_droppedFrames > 0)
+    out << m_droppedFrames << " frame(s) dropped because their queries weren't ready\n";
+}
+
+bool
+GpuProfiler::exportCsv (const std::string& fileName) const
+{
+  std::ofstream out (fileName);
+  out << "scope,frame,ms\n";
+  for (unsigned int nameNum = 0; nameNum < m_names.size (); ++nameNum)
+  {
+    std::vector<double> samples = m_histories[nameNum].getSamples ();
+    for (unsigned int sampleNum = 0; sampleNum < samples.size (); ++sampleNum)
+      out << m_names[nameNum] << ',' << sampleNum << ',' << samples[sampleNum] << '\n';
+  }
+  return static_cast<bool> (out);
+}
+
+unsigned int
+GpuProfiler::timestamp ()
+{
+  Frame& frame = m_frames[m_current];
+  if (frame.usedQueries == frame.queries.size ())
+  {
+    // Grow in batches; after the first few frames this never happens.
+    const unsigned int BATCH = 32;
+    frame.queries.resize (frame.usedQueries + BATCH);
+    m_context->genQueries (BATCH, frame.queries.data () + frame.usedQueries);
+  }
+  unsigned int query = frame.usedQueries++;
+  m_context->queryCounter (frame.queries[query], GL_TIMESTAMP);
+  return query;
+}
+
+void
+GpuProfiler::collect (Frame& frame)
+{
+  frame.pending = false;
+  // Queries complete in order, so if the last one is done they all are.
+  GLint available = GL_FALSE;
+  m_context->getQueryObjectiv (frame.queries[frame.usedQueries - 1],
+			       GL_QUERY_RESULT_AVAILABLE, &available);
+  if (available == GL_FALSE)
+  {
+    ++m_droppedFrames;
+    return;
+  }
+
+  std::vector<GLuint64> times (frame.usedQueries);
+  for (unsigned int query = 0; query < frame.usedQueries; ++query)
+    m_context->getQueryObjectui64v (frame.queries[query], GL_QUERY_RESULT, &times[query]);
+
+  // Scopes with the same name are summed, so the history has one sample
+  //   per name per frame.
+  std::vector<double> totals (m_names.size (), -1.0);
+  for (const ScopeRecord& scope : frame.scopes)
+  {
+    double ms = (times[scope.end] - times[scope.begin]) / 1.0e6;
+    totals[scope.name] = totals[scope.name] < 0.0 ? ms : totals[scope.name] + ms;
+  }
+  for (unsigned int nameNum = 0; nameNum < totals.size (); ++nameNum)
+  {
+    if (totals[nameNum] >= 0.0)
+      m_histories[nameNum].add (totals[nameNum]);
+  }
+}
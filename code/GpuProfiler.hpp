@@ -0,0 +1,181 @@
+/// \file GpuProfiler.hpp
+/// \brief Declaration of GpuProfiler class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef GPU_PROFILER_HPP
+#define GPU_PROFILER_HPP
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "OpenGLContext.hpp"
+#include "TimingHistory.hpp"
+
+/// \brief Measures how much GPU time named parts of each frame take.
+/// Each scope is bracketed by two GL_TIMESTAMP queries, so scopes may nest
+///   (Scene::draw around every Mesh).  Queries are kept for FRAMES_IN_FLIGHT
+///   frames before being read, by which time the GPU has almost always
+///   finished them; a frame whose results still aren't ready is dropped
+///   rather than waited for, so profiling never stalls the pipeline.
+class GpuProfiler
+{
+public:
+
+  /// The number of frames whose queries are outstanding at once.
+  static const unsigned int FRAMES_IN_FLIGHT = 3;
+
+  /// \brief Times one scope for as long as it exists.  Does nothing if
+  ///   given a null profiler, so call sites don't need to check.
+  class Scope
+  {
+  public:
+
+    /// \brief Begins a scope.
+    /// \param[in] profiler The profiler, or nullptr.
+    /// \param[in] name The scope's name.
+    Scope (GpuProfiler* profiler, const std::string& name);
+
+    /// \brief Ends the scope.
+    ~Scope ();
+
+    /// \brief Copy constructor removed because a scope ends exactly once.
+    Scope (const Scope&) = delete;
+
+    /// \brief Assignment operator removed because a scope ends exactly once.
+    Scope&
+    operator= (const Scope&) = delete;
+
+  private:
+
+    /// The profiler, or nullptr.
+    GpuProfiler* m_profiler;
+  };
+
+  /// \brief Constructs a GpuProfiler with no history.
+  /// \param[in] context The object through which OpenGL calls are made.
+  /// \param[in] historyLength The number of frames of history kept for each
+  ///   scope.
+  GpuProfiler (OpenGLContext* context, unsigned int historyLength = 240);
+
+  /// \brief Destructs this GpuProfiler, deleting its queries.
+  ~GpuProfiler ();
+
+  /// \brief Copy constructor removed because queries can't be copied.
+  GpuProfiler (const GpuProfiler&) = delete;
+
+  /// \brief Assignment operator removed because queries can't be copied.
+  GpuProfiler&
+  operator= (const GpuProfiler&) = delete;
+
+  /// \brief Starts a frame, first collecting the results of the frame that
+  ///   last used the same set of queries.
+  /// \pre The previous frame, if any, has ended.
+  void
+  beginFrame ();
+
+  /// \brief Ends a frame.
+  /// \pre Every scope begun during the frame has ended.
+  void
+  endFrame ();
+
+  /// \brief Starts timing a scope.  Prefer the Scope class.
+  /// \param[in] name The scope's name.  Every scope with the same name in a
+  ///   frame is added together.
+  /// \pre A frame has begun.
+  void
+  beginScope (const std::string& name);
+
+  /// \brief Stops timing the most recently begun scope.
+  void
+  endScope ();
+
+  /// \brief Gets every scope name seen so far, in the order first seen.
+  /// \return The names.
+  const std::vector<std::string>&
+  getScopeNames () const;
+
+  /// \brief Gets the per-frame history of a scope.
+  /// \param[in] name The scope's name.
+  /// \return Its GPU times in milliseconds, or nullptr if no such scope has
+  ///   been collected.
+  const TimingHistory*
+  getHistory (const std::string& name) const;
+
+  /// \brief Gets the number of frames dropped because their results weren't
+  ///   ready in time.
+  /// \return The number of dropped frames.
+  unsigned int
+  getDroppedFrameCount () const;
+
+  /// \brief Writes a table of min / average / p99 / max per scope.
+  /// \param[in,out] out The stream to write to.
+  void
+  report (std::ostream& out) const;
+
+  /// \brief Writes every scope's history to a CSV file, one row per sample
+  ///   ("scope,frame,ms"), for plotting.
+  /// \param[in] fileName The file to write.
+  /// \return True if the file was written.
+  bool
+  exportCsv (const std::string& fileName) const;
+
+private:
+
+  /// \brief One timed scope within a frame.
+  struct ScopeRecord
+  {
+    /// The position of the scope's name in m_names.
+    unsigned int name;
+    /// The position of the starting timestamp query in Frame::queries.
+    unsigned int begin;
+    /// The position of the ending timestamp query in Frame::queries.
+    unsigned int end;
+  };
+
+  /// \brief Everything recorded during one frame.
+  struct Frame
+  {
+    /// Query objects, reused every FRAMES_IN_FLIGHT frames.
+    std::vector<GLuint> queries;
+    /// The number of queries used this frame.
+    unsigned int usedQueries;
+    /// The scopes timed this frame.
+    std::vector<ScopeRecord> scopes;
+    /// Positions in scopes of the scopes still open.
+    std::vector<unsigned int> open;
+    /// Whether there are results waiting to be collected.
+    bool pending;
+  };
+
+  /// \brief Issues a timestamp query for the current frame.
+  /// \return The position of the query in the frame's queries.
+  unsigned int
+  timestamp ();
+
+  /// \brief Reads a frame's results into the histories, if they're ready.
+  /// \param[in,out] frame The frame.
+  void
+  collect (Frame& frame);
+
+  /// The object through which OpenGL calls are made.
+  OpenGLContext* m_context;
+  /// The frames in flight.
+  Frame m_frames[FRAMES_IN_FLIGHT];
+  /// The position in m_frames of the current frame.
+  unsigned int m_current;
+  /// Every scope name seen so far.
+  std::vector<std::string> m_names;
+  /// Positions in m_names, by name.
+  std::map<std::string, unsigned int> m_nameIndices;
+  /// One history per name, in the same order as m_names.
+  std::vector<TimingHistory> m_histories;
+  /// The number of frames of history kept.
+  unsigned int m_historyLength;
+  /// The number of frames dropped.
+  unsigned int m_droppedFrames;
+};
+
+#endif//GPU_PROFILER_HPP
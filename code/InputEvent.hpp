@@ -0,0 +1,46 @@
+/// \file InputEvent.hpp
+/// \brief Declaration of the InputEvent struct.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef INPUT_EVENT_HPP
+#define INPUT_EVENT_HPP
+
+/// \brief One thing the user did, as reported by a GLFW callback, stamped
+///   with when it happened.
+/// Small and trivially copyable, so callbacks can hand them to the update
+///   thread through an SpscRing without allocating.
+struct InputEvent
+{
+  /// \brief The kinds of event.
+  enum Type
+  {
+    /// A key was pressed, repeated, or released.  code is the GLFW_KEY_?
+    ///   and action the GLFW_PRESS / GLFW_REPEAT / GLFW_RELEASE.
+    KEY,
+    /// A mouse button was pressed or released.  code is the
+    ///   GLFW_MOUSE_BUTTON_? and action the GLFW_PRESS / GLFW_RELEASE.
+    MOUSE_BUTTON,
+    /// The cursor moved to (x, y).
+    CURSOR,
+    /// The wheel scrolled by (x, y).
+    SCROLL,
+    /// The framebuffer was resized to x by y.
+    RESIZE
+  };
+
+  /// What happened.
+  Type type;
+  /// The key or button, for KEY and MOUSE_BUTTON.
+  int code;
+  /// The action, for KEY and MOUSE_BUTTON.
+  int action;
+  /// The position, offset, or size, for CURSOR, SCROLL, and RESIZE.
+  double x;
+  /// The position, offset, or size, for CURSOR, SCROLL, and RESIZE.
+  double y;
+  /// When it happened, in glfwGetTime's seconds.
+  double time;
+};
+
+#endif//INPUT_EVENT_HPP
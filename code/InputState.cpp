@@ -0,0 +1,144 @@
+/// \file InputState.cpp
+/// \brief Definitions of InputState member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <algorithm>
+
+#include "InputState.hpp"
+
+InputState::InputState ()
+  : m_hasCursor (false), m_stepStart (0.0), m_downSince (GLFW_KEY_LAST + 1, 0.0),
+    m_heldSeconds (GLFW_KEY_LAST + 1, 0.0), m_leftDragX (0.0), m_leftDragY (0.0),
+    m_rightDragX (0.0), m_scrollY (0.0), m_eventCount (0)
+{
+}
+
+void
+InputState::beginStep (double time)
+{
+  for (int key : m_heldKeys)
+    m_heldSeconds[key] = 0.0;
+  m_heldKeys.clear ();
+  m_stepStart = time;
+  m_leftDragX = m_leftDragY = m_rightDragX = 0.0;
+  m_scrollY = 0.0;
+  m_eventCount = 0;
+}
+
+void
+InputState::apply (const InputEvent& event)
+{
+  ++m_eventCount;
+  switch (event.type)
+  {
+  case InputEvent::KEY:
+    if (event.code < 0 || event.code > GLFW_KEY_LAST)
+      break;
+    if (event.action == GLFW_PRESS && !m_keys.isKeyDown (event.code))
+    {
+      m_keys.setKeyDown (event.code);
+      m_downSince[event.code] = clampTime (event);
+    }
+    else if (event.action == GLFW_RELEASE && m_keys.isKeyDown (event.code))
+    {
+      m_keys.setKeyUp (event.code);
+      if (m_heldSeconds[event.code] == 0.0)
+	m_heldKeys.push_back (event.code);
+      m_heldSeconds[event.code] += clampTime (event) - m_downSince[event.code];
+    }
+    break;
+  case InputEvent::MOUSE_BUTTON:
+    if (event.code == GLFW_MOUSE_BUTTON_LEFT)
+      m_mouse.setLeftButton (event.action == GLFW_PRESS);
+    else if (event.code == GLFW_MOUSE_BUTTON_RIGHT)
+      m_mouse.setRightButton (event.action == GLFW_PRESS);
+    break;
+  case InputEvent::CURSOR:
+    if (m_hasCursor)
+    {
+      double dx = event.x - m_mouse.getX ();
+      double dy = event.y - m_mouse.getY ();
+      if (m_mouse.getLeftButton ())
+      {
+	m_leftDragX += dx;
+	m_leftDragY += dy;
+      }
+      if (m_mouse.getRightButton ())
+	m_rightDragX += dx;
+    }
+    m_mouse.setPosition (event.x, event.y);
+    m_hasCursor = true;
+    break;
+  case InputEvent::SCROLL:
+    m_scrollY += event.y;
+    break;
+  case InputEvent::RESIZE:
+    break;
+  }
+}
+
+void
+InputState::endStep (double time)
+{
+  time = std::max (time, m_stepStart);
+  for (int key = 0; key <= GLFW_KEY_LAST; ++key)
+  {
+    if (!m_keys.isKeyDown (key))
+      continue;
+    if (m_heldSeconds[key] == 0.0)
+      m_heldKeys.push_back (key);
+    // A press stamped after the step ends counts only from the next.
+    m_heldSeconds[key] += std::max (time - m_downSince[key], 0.0);
+    // Still down, so it is held from the start of the next step.
+    m_downSince[key] = std::max (time, m_downSince[key]);
+  }
+}
+
+double
+InputState::getHeldSeconds (int key) const
+{
+  return m_heldSeconds[key];
+}
+
+bool
+InputState::isKeyDown (int key) const
+{
+  return m_keys.isKeyDown (key);
+}
+
+double
+InputState::getLeftDragX () const
+{
+  return m_leftDragX;
+}
+
+double
+InputState::getLeftDragY () const
+{
+  return m_leftDragY;
+}
+
+double
+InputState::getRightDragX () const
+{
+  return m_rightDragX;
+}
+
+double
+InputState::getScrollY () const
+{
+  return m_scrollY;
+}
+
+unsigned int
+InputState::getEventCount () const
+{
+  return m_eventCount;
+}
+
+double
+InputState::clampTime (const InputEvent& event) const
+{
+  return std::max (event.time, m_stepStart);
+}
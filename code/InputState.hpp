@@ -0,0 +1,121 @@
+/// \file InputState.hpp
+/// \brief Declaration of InputState class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef INPUT_STATE_HPP
+#define INPUT_STATE_HPP
+
+#include <vector>
+
+#include "InputEvent.hpp"
+#include "KeyBuffer.hpp"
+#include "MouseBuffer.hpp"
+
+/// \brief What the user did during one simulation step, built up from a
+///   stream of timestamped InputEvents.
+/// Rather than only whether each key is down, it records for how much of
+///   the step each key was held, so a tap shorter than a step still counts.
+///   Cursor motion is summed into one drag per button, so the consumer
+///   makes one proportional rotation per step however many motion events
+///   arrived.
+class InputState
+{
+public:
+
+  /// \brief Constructs an InputState with no keys or buttons down and no
+  ///   step begun.
+  InputState ();
+
+  /// \brief Starts a new step, forgetting the previous step's held times,
+  ///   drags, and scrolling.  Keys and buttons still down stay down.
+  /// \param[in] time When the step's input begins, in event time.  The
+  ///   previous step's end time is usual.
+  void
+  beginStep (double time);
+
+  /// \brief Applies one event to this step.
+  /// \param[in] event The event.  Events must come in the order they
+  ///   happened; one stamped before the step began counts as at its start.
+  void
+  apply (const InputEvent& event);
+
+  /// \brief Ends the step, counting keys still down as held until its end.
+  /// \param[in] time When the step's input ends, in event time.  A key
+  ///   pressed after it is held for none of this step.
+  void
+  endStep (double time);
+
+  /// \brief Gets how long a key was held during the step.
+  /// \param[in] key The key (a GLFW_KEY_? constant).
+  /// \return The time in seconds, which is 0 if it was never down.
+  /// \pre endStep has been called.
+  double
+  getHeldSeconds (int key) const;
+
+  /// \brief Tests whether a key is down now.
+  /// \param[in] key The key (a GLFW_KEY_? constant).
+  /// \return True if it is down.
+  bool
+  isKeyDown (int key) const;
+
+  /// \brief Gets how far the cursor was dragged with the left button down
+  ///   during the step, in screen coordinates.
+  /// \return The horizontal distance.
+  double
+  getLeftDragX () const;
+
+  /// \brief Gets how far the cursor was dragged with the left button down.
+  /// \return The vertical distance, positive downward.
+  double
+  getLeftDragY () const;
+
+  /// \brief Gets how far the cursor was dragged with the right button down.
+  /// \return The horizontal distance.
+  double
+  getRightDragX () const;
+
+  /// \brief Gets how far the wheel was scrolled during the step.
+  /// \return The total vertical offset.
+  double
+  getScrollY () const;
+
+  /// \brief Gets the number of events applied during the step.
+  /// \return The number of events.
+  unsigned int
+  getEventCount () const;
+
+private:
+
+  /// \brief Gets an event's time, clamped into the current step.
+  /// \param[in] event The event.
+  /// \return The time.
+  double
+  clampTime (const InputEvent& event) const;
+
+  /// Which keys are down now.
+  KeyBuffer m_keys;
+  /// Which buttons are down now, and where the cursor last was.
+  MouseBuffer m_mouse;
+  /// Whether any cursor position has been seen yet.
+  bool m_hasCursor;
+  /// When the current step began.
+  double m_stepStart;
+  /// For each key that is down, when it went down (or when the step began,
+  ///   if that was later).
+  std::vector<double> m_downSince;
+  /// For each key, how long it has been held during the step.
+  std::vector<double> m_heldSeconds;
+  /// The keys whose held times are nonzero, so beginStep clears only them.
+  std::vector<int> m_heldKeys;
+  /// The left-button drag so far this step.
+  double m_leftDragX, m_leftDragY;
+  /// The right-button drag so far this step.
+  double m_rightDragX;
+  /// The scrolling so far this step.
+  double m_scrollY;
+  /// The number of events applied this step.
+  unsigned int m_eventCount;
+};
+
+#endif//INPUT_STATE_HPP
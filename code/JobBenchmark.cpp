@@ -0,0 +1,132 @@
+/// \file JobBenchmark.cpp
+/// \brief A command-line tool that times a JobSystem's fork/join overhead
+///   and how its parallelFor scales with threads.
+/// \author Ethan Gingrich
+/// \version A08
+///
+/// Usage:
+///   JobBenchmark.out [items [rounds]]
+///     First times, on at least 4 threads, starting and waiting on 10000
+///     empty jobs and a parallelFor over nothing, against starting and
+///     joining a thread per extra core as each system used to.  Then times
+///     a parallelFor over that many items (1000000 by default) of a few
+///     dozen flops each, on 1 thread, then on twice as many, and so on up
+///     to every hardware thread.  Each time is the median of that many
+///     rounds (20 by default).  Build it with optimization on, or the work
+///     is too slow to show the overhead.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "JobSystem.hpp"
+#include "TimingHistory.hpp"
+
+/// \brief Times a function.
+/// \param[in] work The function to time.
+/// \return The elapsed time in milliseconds.
+template<typename Function>
+static double
+timeMs (Function work)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  work ();
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now () - start;
+  return elapsed.count ();
+}
+
+/// \brief Times a function over several rounds.
+/// \param[in] rounds The number of rounds.
+/// \param[in] work The function to time.
+/// \return The median time in milliseconds.
+template<typename Function>
+static double
+medianMs (unsigned int rounds, Function work)
+{
+  TimingHistory history (rounds);
+  for (unsigned int round = 0; round < rounds; ++round)
+    history.add (timeMs (work));
+  return history.getPercentile (50);
+}
+
+/// \brief Does a few dozen flops of work that can't be optimized away.
+/// \param[in] item The item's number.
+/// \return A value depending on every step.
+static float
+work (size_t item)
+{
+  float x = item * 1.0e-6f;
+  for (unsigned int step = 0; step < 16; ++step)
+    x = std::sqrt (x * x + 1.0f) - 0.5f * x;
+  return x;
+}
+
+/// \brief Runs the benchmark.
+/// \param[in] argc The number of command-line arguments.
+/// \param[in] argv The number of items and of rounds.
+/// \return EXIT_SUCCESS.
+int
+main (int argc, char* argv[])
+{
+  const unsigned int EMPTY_JOBS = 10000;
+  const unsigned int MIN_FORK_THREADS = 4;
+
+  size_t items = argc > 1 ? std::atoi (argv[1]) : 1000000;
+  unsigned int rounds = argc > 2 ? std::atoi (argv[2]) : 20;
+  unsigned int hardwareThreads = std::max (std::thread::hardware_concurrency (), 1u);
+
+  // Enough threads that forking costs something even on one core.
+  unsigned int forkThreads = std::max (hardwareThreads, MIN_FORK_THREADS);
+  std::printf ("Fork/join overhead on %u threads, median of %u rounds\n", forkThreads, rounds);
+  {
+    JobSystem jobs (forkThreads);
+    double emptyMs = medianMs (rounds, [&] ()
+    {
+      JobSystem::Counter counter;
+      for (unsigned int job = 0; job < EMPTY_JOBS; ++job)
+	jobs.run ([] () { }, &counter);
+      jobs.wait (counter);
+    });
+    double forMs = medianMs (rounds, [&] ()
+    {
+      for (unsigned int call = 0; call < 100; ++call)
+	jobs.parallelFor (forkThreads * 4, 1, [] (size_t, size_t) { });
+    }) / 100;
+    double spawnMs = medianMs (rounds, [&] ()
+    {
+      std::vector<std::thread> threads;
+      for (unsigned int t = 1; t < forkThreads; ++t)
+	threads.emplace_back ([] () { });
+      for (std::thread& thread : threads)
+	thread.join ();
+    });
+    std::printf ("  run and wait, per empty job     %8.3f us\n", emptyMs * 1e3 / EMPTY_JOBS);
+    std::printf ("  parallelFor, per empty call     %8.3f us\n", forMs * 1e3);
+    std::printf ("  spawn and join %2u threads       %8.3f us\n", forkThreads - 1, spawnMs * 1e3);
+  }
+
+  std::vector<float> results (items);
+  double serialMs = 0.0;
+  std::printf ("parallelFor over %zu items, median of %u rounds\n", items, rounds);
+  for (unsigned int threads = 1; ; threads = std::min (threads * 2, hardwareThreads))
+  {
+    JobSystem jobs (threads);
+    double ms = medianMs (rounds, [&] ()
+    {
+      jobs.parallelFor (items, 1024, [&] (size_t begin, size_t end)
+      {
+	for (size_t item = begin; item < end; ++item)
+	  results[item] = work (item);
+      });
+    });
+    if (threads == 1)
+      serialMs = ms;
+    std::printf ("  %2u thread(s)  %8.3f ms (%.2fx)\n", threads, ms, serialMs / ms);
+    if (threads == hardwareThreads)
+      break;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,262 @@
+/// \file JobSystem.cpp
+/// \brief Definitions of JobSystem member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <cassert>
+#include <string>
+
+#include "CpuProfiler.hpp"
+#include "JobSystem.hpp"
+
+/// How many times an idle worker looks for a job before sleeping.  Jobs
+///   often come in quick bursts, and waking a sleeping thread takes far
+///   longer than looking.
+static const unsigned int IDLE_SPINS = 64;
+
+/// Marks a thread that isn't one of the current JobSystem's workers.
+static const unsigned int NOT_A_WORKER = ~0u;
+
+/// The JobSystem the current thread is a worker of, or nullptr.
+static thread_local JobSystem* t_system = nullptr;
+/// The current thread's position among its JobSystem's workers.
+static thread_local unsigned int t_workerIndex = NOT_A_WORKER;
+/// Where the current thread next starts looking for a job to steal, so
+///   thieves spread out rather than all trying the same worker.
+static thread_local unsigned int t_nextVictim = 0;
+
+const unsigned int JobSystem::DEQUE_CAPACITY;
+const unsigned int JobSystem::PIECES_PER_THREAD;
+
+JobSystem::Counter::Counter ()
+  : m_pending (0)
+{
+}
+
+JobSystem::Counter::~Counter ()
+{
+  assert (m_pending.load () == 0);
+  assert (m_continuations.empty ());
+}
+
+bool
+JobSystem::Counter::isDone () const
+{
+  return m_pending.load (std::memory_order_acquire) == 0;
+}
+
+JobSystem::JobSystem (unsigned int threadCount)
+  : m_sharedCount (0), m_queued (0), m_sleepers (0), m_stopping (false)
+{
+  if (threadCount == 0)
+    threadCount = std::max (std::thread::hardware_concurrency (), 1u);
+  // Every worker exists before any starts looking at the others.
+  for (unsigned int t = 1; t < threadCount; ++t)
+    m_workers.emplace_back (new Worker ());
+  for (unsigned int index = 0; index < m_workers.size (); ++index)
+    m_workers[index]->thread = std::thread (&JobSystem::workerLoop, this, index);
+}
+
+JobSystem::~JobSystem ()
+{
+  for (Job* job = findJob (); job != nullptr; job = findJob ())
+    execute (job);
+  {
+    std::lock_guard<std::mutex> lock (m_sleepMutex);
+    m_stopping = true;
+  }
+  m_wake.notify_all ();
+  for (std::unique_ptr<Worker>& worker : m_workers)
+    worker->thread.join ();
+}
+
+void
+JobSystem::run (std::function<void ()> task, Counter* counter)
+{
+  if (counter != nullptr)
+    counter->m_pending.fetch_add (1, std::memory_order_relaxed);
+  submit (new Job { std::move (task), counter });
+}
+
+void
+JobSystem::runAfter (Counter& dependency, std::function<void ()> task, Counter* counter)
+{
+  if (counter != nullptr)
+    counter->m_pending.fetch_add (1, std::memory_order_relaxed);
+  Job* job = new Job { std::move (task), counter };
+  {
+    // finish empties the list under the same lock once the count reaches
+    //   zero, so the job is either queued here in time or started below.
+    std::lock_guard<std::mutex> lock (dependency.m_mutex);
+    if (dependency.m_pending.load (std::memory_order_acquire) != 0)
+    {
+      dependency.m_continuations.push_back (job);
+      return;
+    }
+  }
+  submit (job);
+}
+
+void
+JobSystem::wait (Counter& counter)
+{
+  PROFILE_ZONE ("JobSystem::wait");
+  if (t_system == this || m_workers.empty ())
+  {
+    while (!counter.isDone ())
+    {
+      Job* job = findJob ();
+      if (job != nullptr)
+	execute (job);
+      else
+	std::this_thread::yield ();
+    }
+    // The last job may still be inside finish, so let it leave before the
+    //   caller destroys the Counter.
+    std::lock_guard<std::mutex> lock (counter.m_mutex);
+    return;
+  }
+  // Only this thread starts jobs on the shared queue for this Counter;
+  //   whatever those start goes on the workers' deques.
+  for (Job* job = takeShared (&counter); job != nullptr; job = takeShared (&counter))
+    execute (job);
+  std::unique_lock<std::mutex> lock (counter.m_mutex);
+  counter.m_finished.wait (lock, [&counter] () { return counter.isDone (); });
+}
+
+unsigned int
+JobSystem::getThreadCount () const
+{
+  return m_workers.size () + 1;
+}
+
+JobSystem&
+JobSystem::getShared ()
+{
+  static JobSystem shared;
+  return shared;
+}
+
+void
+JobSystem::submit (Job* job)
+{
+  // Counted before it can be taken, so m_queued never goes negative.
+  m_queued.fetch_add (1, std::memory_order_seq_cst);
+  if (t_system != this || !m_workers[t_workerIndex]->jobs.push (job))
+  {
+    std::lock_guard<std::mutex> lock (m_sharedMutex);
+    m_shared.push_back (job);
+    m_sharedCount.fetch_add (1, std::memory_order_release);
+  }
+  // Pairs with workerLoop: either a sleeper sees the job counted, or this
+  //   sees the sleeper.
+  if (m_sleepers.load (std::memory_order_seq_cst) > 0)
+  {
+    std::lock_guard<std::mutex> lock (m_sleepMutex);
+    m_wake.notify_one ();
+  }
+}
+
+JobSystem::Job*
+JobSystem::findJob ()
+{
+  Job* job = nullptr;
+  unsigned int self = t_system == this ? t_workerIndex : NOT_A_WORKER;
+  bool found = self != NOT_A_WORKER && m_workers[self]->jobs.pop (job);
+  if (!found)
+  {
+    // Counted as taken there.
+    job = takeShared (nullptr);
+    if (job != nullptr)
+      return job;
+  }
+  for (unsigned int tries = 0; !found && tries < m_workers.size (); ++tries)
+  {
+    unsigned int victim = t_nextVictim++ % m_workers.size ();
+    found = victim != self && m_workers[victim]->jobs.steal (job);
+  }
+  if (!found)
+    return nullptr;
+  m_queued.fetch_sub (1, std::memory_order_relaxed);
+  return job;
+}
+
+JobSystem::Job*
+JobSystem::takeShared (const Counter* counter)
+{
+  if (m_sharedCount.load (std::memory_order_acquire) == 0)
+    return nullptr;
+  std::lock_guard<std::mutex> lock (m_sharedMutex);
+  std::deque<Job*>::iterator job = m_shared.begin ();
+  while (job != m_shared.end () && counter != nullptr && (*job)->counter != counter)
+    ++job;
+  if (job == m_shared.end ())
+    return nullptr;
+  Job* taken = *job;
+  m_shared.erase (job);
+  m_sharedCount.fetch_sub (1, std::memory_order_relaxed);
+  m_queued.fetch_sub (1, std::memory_order_relaxed);
+  return taken;
+}
+
+void
+JobSystem::execute (Job* job)
+{
+  job->task ();
+  Counter* counter = job->counter;
+  delete job;
+  if (counter != nullptr)
+    finish (*counter);
+}
+
+void
+JobSystem::finish (Counter& counter)
+{
+  std::vector<Job*> ready;
+  {
+    std::lock_guard<std::mutex> lock (counter.m_mutex);
+    if (counter.m_pending.fetch_sub (1, std::memory_order_acq_rel) == 1)
+    {
+      ready.swap (counter.m_continuations);
+      counter.m_finished.notify_all ();
+    }
+  }
+  // The Counter may be gone by now; only its continuations are used.
+  for (Job* job : ready)
+    submit (job);
+}
+
+void
+JobSystem::workerLoop (unsigned int index)
+{
+  PROFILE_THREAD_NAME ("job worker " + std::to_string (index));
+  t_system = this;
+  t_workerIndex = index;
+  t_nextVictim = index + 1;
+  unsigned int idle = 0;
+  while (true)
+  {
+    Job* job = findJob ();
+    if (job != nullptr)
+    {
+      execute (job);
+      idle = 0;
+      continue;
+    }
+    if (++idle < IDLE_SPINS)
+    {
+      std::this_thread::yield ();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock (m_sleepMutex);
+    m_sleepers.fetch_add (1, std::memory_order_seq_cst);
+    m_wake.wait (lock, [this] ()
+		 {
+		   return m_stopping || m_queued.load (std::memory_order_seq_cst) > 0;
+		 });
+    m_sleepers.fetch_sub (1, std::memory_order_relaxed);
+    if (m_stopping && m_queued.load () == 0)
+      return;
+    idle = 0;
+  }
+}
@@ -0,0 +1,259 @@
+/// \file JobSystem.hpp
+/// \brief Declaration of JobSystem class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef JOB_SYSTEM_HPP
+#define JOB_SYSTEM_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "WorkStealingDeque.hpp"
+
+/// \brief Runs short jobs on a fixed set of worker threads, shared by
+///   everything that wants more than one core.
+/// Each worker keeps its own WorkStealingDeque of jobs.  Jobs a worker
+///   starts go on its own deque, and it takes the newest back first; a
+///   worker with nothing to do steals the oldest job from another's.  Jobs
+///   started by any other thread, such as the main thread, go on one shared
+///   queue that workers check before stealing.  Idle workers spin briefly
+///   and then sleep until something is started.
+/// A Counter tracks a group of jobs.  A worker waiting on one runs any
+///   other jobs until it reaches zero, so jobs may start and wait on jobs
+///   of their own.  Any other thread waiting on one only runs the jobs it
+///   started on that Counter and then sleeps, so that two threads sharing
+///   the workers, such as an update thread and a render thread, never end
+///   up running each other's work.  A job can also be started only once a
+///   Counter reaches zero, to chain jobs together without anyone waiting.
+/// With a thread count of one there are no workers, and jobs run on
+///   whichever thread waits for them.
+class JobSystem
+{
+  /// \brief One job.
+  struct Job;
+
+public:
+
+  /// \brief Counts the unfinished jobs of a group, and holds the jobs to
+  ///   start once they are done.
+  /// It must not be destroyed while it has unfinished jobs, so wait on it
+  ///   first.
+  class Counter
+  {
+  public:
+
+    /// \brief Constructs a Counter with no jobs.
+    Counter ();
+
+    /// \brief Destructs a Counter, which must have no unfinished jobs.
+    ~Counter ();
+
+    /// \brief Copy constructor removed because jobs point to their
+    ///   Counter.
+    Counter (const Counter&) = delete;
+
+    /// \brief Assignment operator removed because jobs point to their
+    ///   Counter.
+    Counter&
+    operator= (const Counter&) = delete;
+
+    /// \brief Tests whether every job counted here has finished.
+    /// \return True if none are left.
+    bool
+    isDone () const;
+
+  private:
+
+    friend class JobSystem;
+
+    /// The number of jobs started and not yet finished.
+    std::atomic<unsigned int> m_pending;
+    /// Guards m_continuations, and the moment m_pending reaches zero.
+    std::mutex m_mutex;
+    /// Wakes threads that aren't workers when m_pending reaches zero.
+    std::condition_variable m_finished;
+    /// The jobs to start when m_pending next reaches zero.
+    std::vector<Job*> m_continuations;
+  };
+
+  /// \brief Constructs a JobSystem and starts its workers.
+  /// \param[in] threadCount The number of threads to run jobs on, counting
+  ///   one thread waiting for them, or 0 for one per core.
+  explicit JobSystem (unsigned int threadCount = 0);
+
+  /// \brief Runs any jobs still waiting, then stops the workers.
+  ~JobSystem ();
+
+  /// \brief Copy constructor removed because you shouldn't be copying
+  ///   JobSystems.
+  JobSystem (const JobSystem&) = delete;
+
+  /// \brief Assignment operator removed because you shouldn't be assigning
+  ///   JobSystems.
+  JobSystem&
+  operator= (const JobSystem&) = delete;
+
+  /// \brief Starts a job.  Safe to call from any thread, including a job.
+  /// \param[in] task What the job does.
+  /// \param[in] counter A Counter to count the job on until it finishes, or
+  ///   nullptr for none.
+  void
+  run (std::function<void ()> task, Counter* counter = nullptr);
+
+  /// \brief Starts a job once every job counted by a Counter has finished,
+  ///   or now if they all have.  Safe to call from any thread.
+  /// \param[in] dependency The Counter to wait for.  It must not be
+  ///   destroyed before the job has started.
+  /// \param[in] task What the job does.
+  /// \param[in] counter A Counter to count the job on from now until it
+  ///   finishes, or nullptr for none.
+  void
+  runAfter (Counter& dependency, std::function<void ()> task, Counter* counter = nullptr);
+
+  /// \brief Returns once every job counted by a Counter has finished.  A
+  ///   worker runs any jobs meanwhile; any other thread runs only jobs it
+  ///   started on this Counter, unless there are no workers to run the
+  ///   rest, and then sleeps.  Safe to call from any thread, including a
+  ///   job.
+  /// \param[in] counter The Counter.
+  void
+  wait (Counter& counter);
+
+  /// \brief Calls a function on pieces of a range in parallel, returning
+  ///   once all of them are done.  The calling thread takes the first
+  ///   piece and helps with the rest.
+  /// \param[in] count The size of the range.
+  /// \param[in] grain The fewest items worth a piece of their own, to keep
+  ///   small ranges from costing more to split than to run.
+  /// \param[in] work Called with the beginning and end of each piece.  It
+  ///   may be called from several threads at once.
+  template<typename Function>
+  void
+  parallelFor (size_t count, size_t grain, Function work);
+
+  /// \brief Gets the number of threads jobs run on.
+  /// \return The number of workers, plus one for a thread waiting on them.
+  unsigned int
+  getThreadCount () const;
+
+  /// \brief Gets the JobSystem shared by the whole program, which has one
+  ///   thread per core.  It is made the first time this is called.
+  /// \return The shared JobSystem.
+  static JobSystem&
+  getShared ();
+
+private:
+
+  struct Job
+  {
+    /// What the job does.
+    std::function<void ()> task;
+    /// The Counter it is counted on, or nullptr.
+    Counter* counter;
+  };
+
+  /// The most jobs a worker's deque holds.  Any more go on the shared
+  ///   queue.
+  static const unsigned int DEQUE_CAPACITY = 4096;
+
+  /// How many pieces parallelFor splits a range into per thread, so that a
+  ///   thread that finishes early can take another.
+  static const unsigned int PIECES_PER_THREAD = 4;
+
+  /// \brief A worker thread and its jobs.
+  struct Worker
+  {
+    /// Jobs this worker started, newest at the bottom.
+    WorkStealingDeque<Job*, DEQUE_CAPACITY> jobs;
+    /// The thread.
+    std::thread thread;
+  };
+
+  /// \brief Queues a job where the calling thread will find it first.
+  /// \param[in] job The job.
+  void
+  submit (Job* job);
+
+  /// \brief Takes a job to run: the calling worker's newest, else the
+  ///   oldest started by a non-worker, else one stolen from another worker.
+  /// \return The job, or nullptr if none was found.
+  Job*
+  findJob ();
+
+  /// \brief Takes the oldest job started by a non-worker that is counted on
+  ///   a Counter.
+  /// \param[in] counter The Counter, or nullptr to take any job.
+  /// \return The job, or nullptr if none was found.
+  Job*
+  takeShared (const Counter* counter);
+
+  /// \brief Runs a job and counts it as finished.
+  /// \param[in] job The job, which is deleted.
+  void
+  execute (Job* job);
+
+  /// \brief Counts a job as finished, starting the Counter's continuations
+  ///   if it was the last.
+  /// \param[in] counter The Counter.
+  void
+  finish (Counter& counter);
+
+  /// \brief Runs jobs until the JobSystem is stopped.  Run by each worker.
+  /// \param[in] index The worker's position in m_workers.
+  void
+  workerLoop (unsigned int index);
+
+  /// The workers.
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  /// Guards m_shared.
+  std::mutex m_sharedMutex;
+  /// Jobs started by threads that aren't workers, oldest first.
+  std::deque<Job*> m_shared;
+  /// The number of jobs in m_shared, checked before locking it.
+  std::atomic<unsigned int> m_sharedCount;
+  /// The number of jobs queued anywhere and not yet taken.
+  std::atomic<unsigned int> m_queued;
+  /// The number of workers asleep or about to be.
+  std::atomic<unsigned int> m_sleepers;
+  /// Guards sleeping and waking workers.
+  std::mutex m_sleepMutex;
+  /// Wakes workers when a job is queued or the JobSystem stops.
+  std::condition_variable m_wake;
+  /// Whether the workers should exit.
+  bool m_stopping;
+};
+
+template<typename Function>
+void
+JobSystem::parallelFor (size_t count, size_t grain, Function work)
+{
+  size_t pieces = (count + std::max<size_t> (grain, 1) - 1) / std::max<size_t> (grain, 1);
+  pieces = std::min<size_t> (pieces, getThreadCount () * PIECES_PER_THREAD);
+  if (pieces <= 1)
+  {
+    if (count > 0)
+      work (size_t (0), count);
+    return;
+  }
+  // Started last to first, so that this thread, taking the newest back
+  //   first, works through them in order.
+  Counter counter;
+  for (size_t piece = pieces - 1; piece > 0; --piece)
+    run ([&work, piece, pieces, count] ()
+	 {
+	   work (count * piece / pieces, count * (piece + 1) / pieces);
+	 }, &counter);
+  work (size_t (0), count / pieces);
+  wait (counter);
+}
+
+#endif//JOB_SYSTEM_HPP
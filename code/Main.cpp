@@ -8,8 +8,16 @@
 
 /******************************************************************/
 // System includes
+#include <atomic>
+#include <chrono>
 #include <cstdio>
+#include <cmath>
 #include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 #include <sstream>
 
@@ -23,14 +31,31 @@
 /******************************************************************/
 // Local includes
 #include "RealOpenGLContext.hpp"
+#include "GlContext.hpp"
+#include "StatsOpenGLContext.hpp"
+#include "CommandBufferContext.hpp"
 #include "ShaderProgram.hpp"
+#include "ShaderLibrary.hpp"
+#include "ShaderVariants.hpp"
 #include "Mesh.hpp"
 #include "Scene.hpp"
 #include "MyScene.hpp"
 #include "Camera.hpp"
-#include "KeyBuffer.hpp"
 #include "Transform.hpp"
-#include "MouseBuffer.hpp"
+#include "InputEvent.hpp"
+#include "InputState.hpp"
+#include "ModelLoader.hpp"
+#include "AssetLoader.hpp"
+#include "AnimationSystem.hpp"
+#include "TweenSystem.hpp"
+#include "SkinnedMesh.hpp"
+#include "GpuProfiler.hpp"
+#include "CpuProfiler.hpp"
+#include "TimingHistory.hpp"
+#include "FramePacer.hpp"
+#include "SpscRing.hpp"
+#include "SceneSnapshot.hpp"
+#include "TripleBuffer.hpp"
 
 /******************************************************************/
 // Global variables
@@ -40,19 +65,212 @@
 /// This should be allocated in ::init and deallocated in ::releaseGlResources.
 OpenGLContext* g_context;
 
+/// \brief Counts the calls made through ::g_context, which wraps it, or
+///   nullptr if calls aren't being counted.
+///
+/// This is allocated in ::init when benchmarking or when the program is run
+///   with --gl-stats, and is deallocated as ::g_context.
+StatsOpenGLContext* g_glStats;
+
+/// \brief The context Meshes and ShaderPrograms make their calls through.
+///
+/// This is ::g_context, except in a STATIC_GL_CONTEXT build (see
+///   GlContext.hpp), where it is the RealOpenGLContext that ::g_glStats may
+///   wrap, and those calls aren't counted.
+GlContext* g_meshContext;
+
+/// \brief Whether GL call counts should be logged every few seconds.
+bool g_logGlStats;
+
+/// \brief Buffers that Scene::recordDraw fills on worker threads, one per
+///   thread, or empty to draw directly.
+///
+/// These are allocated in ::init when the program is run with
+///   --record-threads, and deallocated in ::releaseGlResources.
+std::vector<CommandBufferContext*> g_commandBuffers;
+
 /// \brief A collection of the Meshes for each of the objects we want to draw.
 ///
 /// This will be filled in initScene, and its contents need to be deleted in
 ///   releaseGlResources.
 Scene* myScene;
 
-/// \brief The ShaderProgram that transforms and lights the primitives.
+/// \brief Snapshots of the Scene, handed from whichever thread runs the
+///   simulation to the render thread.
+TripleBuffer<SceneSnapshot> g_snapshots;
+
+/// \brief Runs ::processKeys and ::updateScene at a fixed rate of its own,
+///   so simulation never waits on vsync or the GPU.  Only started when
+///   running interactively; the benchmark simulates on the render thread.
+///
+/// This is started in ::main after ::init and joined before
+///   ::releaseGlResources.
+std::thread g_updateThread;
+
+/// \brief Tells ::g_updateThread to exit.
+std::atomic<bool> g_stopUpdating;
+
+/// \brief Guards the Scene's set of Meshes, which ::uploadAssets adds to
+///   while the update thread moves them.
+std::mutex g_sceneMutex;
+
+/// \brief Input that callbacks on the render thread stamp and hand to
+///   whichever thread runs the simulation, so that only it touches the
+///   Camera and the Meshes' transforms.
+SpscRing<InputEvent, 1024> g_inputEvents;
+
+/// \brief The number of events dropped because ::g_inputEvents was full.
+///   Only touched by the render thread.
+unsigned long g_droppedInputEvents;
+
+/// \brief What the user did during the current simulation step.  Only
+///   touched by whichever thread runs the simulation.
+InputState g_input;
+
+/// \brief When the previous step's input ended, in glfwGetTime seconds.
+double g_inputTime;
+
+/// \brief When the oldest input taken in since the last published snapshot
+///   happened, or a negative number if there is none.  Only touched by
+///   whichever thread runs the simulation.
+double g_unshownInputTime = -1.0;
+
+/// \brief Decides when each frame starts, and whether swaps wait for
+///   vertical blank.
+///
+/// This should be allocated in ::init and deallocated in
+///   ::releaseGlResources.
+FramePacer* g_framePacer;
+
+/// \brief How frames are paced, as chosen with --pacing.
+FramePacer::Mode g_pacingMode = FramePacer::VSYNC;
+
+/// \brief The frame rate for --pacing cap, or the display's refresh rate
+///   for --pacing jit; 0 to use the primary monitor's.
+double g_targetHz;
+
+/// \brief How long input took to reach the screen: from an event's stamp
+///   to the return of the first swap showing a tick that took it in, in
+///   milliseconds.  Only touched by the render thread.
+TimingHistory g_inputLatency (1000);
+
+/// \brief Whether frames are drawn only when something changed, as chosen
+///   with --on-demand.
+bool g_renderOnDemand;
+
+/// \brief Whether the next frame must be drawn whatever the snapshot says:
+///   at first, after the window is exposed or resized, and while shaders
+///   are still being built.  Only touched by the render thread.
+bool g_redrawRequested = true;
+
+/// \brief The revision and blend of the last snapshot drawn.  Only touched
+///   by the render thread.
+unsigned long g_drawnRevision;
+float g_drawnAlpha;
+
+/// \brief The simulation's revision at the start of the current step, and
+///   as of the last snapshot published.  Only touched by whichever thread
+///   runs the simulation.
+unsigned long g_stepStartRevision;
+unsigned long g_publishedRevision;
+
+/// \brief Time spent blocked waiting for something to draw, the process's
+///   CPU time meanwhile, and the number of waits, all in seconds.  Only
+///   touched by the render thread.
+double g_idleSeconds;
+double g_idleCpuSeconds;
+unsigned long g_idleWaits;
+
+/// \brief When the render thread last woke from idling to draw, or a
+///   negative number if it hasn't drawn since.  Only touched by the render
+///   thread.
+double g_wakeTime = -1.0;
+
+/// \brief How long each draw after idling took to reach its swap, from
+///   waking, in milliseconds.  Only touched by the render thread.
+TimingHistory g_wakeLatency (1000);
+
+/// \brief How many times per second the update thread ticks.
+double g_updateHz = 60.0;
+
+/// \brief How long each tick's work took, in milliseconds.  Only touched by
+///   the update thread until it is joined.
+TimingHistory g_tickTimes;
+
+/// \brief The Camera's view matrix at the start of the current simulation
+///   step.  Only touched by whichever thread runs the simulation.
+Transform g_previousView;
+
+/// \brief The number of ticks the update thread has run.  Only touched by
+///   the update thread until it is joined.
+unsigned long g_tickCount;
+
+/// \brief Builds the Scene's Meshes in the background.
+///
+/// This is allocated in ::initScene and deallocated by ::uploadAssets once
+///   everything has been loaded.
+AssetLoader* g_assetLoader;
+
+/// \brief Poses the animated characters once per simulation step.
+///
+/// This is allocated in ::initScene and deallocated in ::releaseGlResources.
+AnimationSystem* g_animation;
+
+/// \brief Spins and bobs Meshes when asked to with T and B.
+///
+/// This is allocated in ::initScene and deallocated in ::releaseGlResources.
+TweenSystem* g_tweens;
+
+/// \brief The Meshes set bobbing with B.
+std::unordered_set<Mesh*> g_bobbing;
+
+/// \brief The model file animated characters are loaded from, as given with
+///   --characters, or empty for none.
+std::string g_characterFile;
+
+/// \brief How many characters to load from ::g_characterFile.
+unsigned int g_characterCount = 1;
+
+/// \brief A hidden window whose context shares objects with the main one,
+///   used by the asset loader's upload thread.
+///
+/// This is only created (in ::initWindow) when the program is run with
+///   --upload-thread, and is destroyed once loading finishes.
+GLFWwindow* g_uploadWindow;
+
+/// \brief Whether buffers should be uploaded on a background thread.
+bool g_useUploadThread;
+
+/// \brief The number of frames to render in benchmark mode, or 0 to run
+///   interactively.
+unsigned int g_benchFrames;
+
+/// \brief Which API the benchmark's context is created through: 0 for the
+///   platform default, or GLFW_EGL_CONTEXT_API / GLFW_OSMESA_CONTEXT_API.
+int g_benchContextApi;
+
+/// \brief Builds and owns every ShaderProgram.
 ///
 /// This should be allocated in ::initShaders and deallocated in
 ///   ::releaseGlResources.
-ShaderProgram* g_colorShader;
+ShaderLibrary* g_shaderLibrary;
+
+/// \brief The time at which shader compilation was submitted.
+double g_shaderStartTime;
 
-ShaderProgram* g_normShader;
+/// \brief The shaders that transform and light the primitives, one variant
+///   per vertex format in use.
+///
+/// This should be allocated in ::initShaders and deallocated in
+///   ::releaseGlResources.  Its programs are owned by ::g_shaderLibrary.
+ShaderVariants* g_meshShaders;
+
+/// \brief Times the parts of each frame on the GPU.  G prints a report and
+///   writes gpu-profile.csv.
+///
+/// This should be allocated in ::init and deallocated in
+///   ::releaseGlResources.
+GpuProfiler* g_gpuProfiler;
 
 /// \brief The Camera that views the Scene.
 ///
@@ -60,11 +278,6 @@ ShaderProgram* g_normShader;
 ///   ::releaseGlResources.
 Camera* g_camera;
 
-/// \brief The keyBuffer that keeps track of which key is being pressed
-KeyBuffer* g_keyBuffer;
-
-MouseBuffer* g_mouseBuffer;
-
 /// the field of vision and aspect ratio
 double fov, aspectRatio;
 
@@ -82,6 +295,11 @@ init (GLFWwindow*& window);
 void
 initGlfw ();
 
+/// \brief Creates the FramePacer.  Should only be called by ::init, after
+///   ::initGlfw.
+void
+initFramePacer ();
+
 /// \brief Initializes the GLEW library.  Should only be called by ::init.
 void
 initGlew ();
@@ -104,20 +322,110 @@ resetViewport (GLFWwindow* window, int width, int height);
 void
 initScene ();
 
-/// \brief Creates the ShaderProgram.  Should only be called by ::init.
+/// \brief Queues a job that loads ::g_characterCount copies of the model in
+///   ::g_characterFile, each playing its first clip, and hands them to
+///   ::g_animation.  Should only be called by ::initScene.
+void
+addCharacters ();
+
+/// \brief Creates the ShaderPrograms and starts building them.  Should only
+///   be called by ::init.
 void
 initShaders ();
 
+/// \brief Finishes any shader variants whose compiles are done, without
+///   waiting for the rest.  This should be called for every frame.
+void
+pollShaders ();
+
 /// \brief Initializes the Camera.  Should only be called by ::init.
 void
 initCamera ();
 
 /// \brief Moves geometric objects around using game logic.  This should be
-///   called for every frame.
-/// \param[in] time The number of seconds since the previous update.
+///   called for every simulation step.
+/// \param[in] time The length of the step, in seconds.
 void
 updateScene (double time);
 
+/// \brief Starts a Mesh bobbing up and down, or stops its tweens where they
+///   are if it already is.  Should only be called by ::processInput.
+/// \param[in] mesh The Mesh.
+void
+toggleBob (Mesh* mesh);
+
+/// \brief Stamps an input event and queues it for the simulation.  Call
+///   from the render thread only.
+/// \param[in] event The event, whose time is filled in here.
+void
+queueInput (InputEvent event);
+
+/// \brief Takes every queued input event stamped up to now into ::g_input,
+///   leaving later ones for the next step, acting on presses and resizes
+///   as they come, then turns the step's drags and scrolling into one
+///   change each.  Should only be called by ::stepSimulation.
+void
+processInput ();
+
+/// \brief Advances the simulation by one fixed step: remembers where the
+///   Camera and Meshes were, takes in queued input, processes held keys,
+///   and updates the Scene.  Call from whichever thread is running the
+///   simulation, holding ::g_sceneMutex if the other might add Meshes.
+/// \param[in] seconds The length of the step.
+void
+stepSimulation (double seconds);
+
+/// \brief Captures the Camera and every Mesh's world transform, as of the
+///   start and end of the last step, and hands them to the render thread.
+///   Call under the same conditions as ::stepSimulation.
+/// \param[in] tick The number of the tick just finished.
+/// \param[in] time The simulation time, in seconds.
+/// \param[in] tickSeconds The length of the tick, or 0 to draw the end
+///   state without blending.
+/// \param[in] due When the tick was due to finish.
+void
+publishSnapshot (unsigned long tick, double time, double tickSeconds,
+		 std::chrono::steady_clock::time_point due);
+
+/// \brief The body of ::g_updateThread: steps the simulation ::g_updateHz
+///   times per (real) second, however fast frames are drawn, until
+///   ::g_stopUpdating is set.  Elapsed time is gathered in an accumulator
+///   and spent in whole steps, so every step is the same length and the
+///   simulation is deterministic.
+void
+updateLoop ();
+
+/// \brief Moves Meshes that finished loading onto the GPU and into the
+///   Scene, spending no more than a few milliseconds of the frame doing so.
+///   This should be called for every frame.
+void
+uploadAssets ();
+
+/// \brief Gets a number that grows whenever the Camera moves or the Scene
+///   changes.  Call under the same conditions as ::stepSimulation.
+/// \return The revision.
+unsigned long
+getSimulationRevision ();
+
+/// \brief Tests whether the next frame would look any different from the
+///   last one drawn.
+/// \return True if the newest snapshot is new, is still being blended
+///   toward its end, or anything else (loading, building shaders, the
+///   window being exposed) asks for a redraw.
+bool
+needsRedraw ();
+
+/// \brief Blocks until an event arrives or the update thread publishes a
+///   change, and counts the time and CPU spent idle.
+void
+waitForChange ();
+
+/// \brief Asks for the window to be redrawn.  This should be set as a
+///   callback.
+/// \param[in] window The GLFWwindow that needs it.
+void
+requestRedraw (GLFWwindow* window);
+
 /// \brief Draws the Scene onto the window.  This should be called for every
 ///   frame.
 /// \param[in] window The GLFWwindow to draw in.
@@ -144,6 +452,8 @@ releaseGlResources ();
 void
 outputGlfwError (int error, const char* description);
 
+/// \brief Moves the Camera or the active Mesh for as long as each key was
+///   held during the step, according to ::g_input.
 void
 processKeys ();
 
@@ -159,57 +469,313 @@ changePerspective (std::string projectionType, double fovOrLeft, double aspRatio
 
 void
 recordScroll (GLFWwindow* window, double xoffset, double yoffset);
+
+/// \brief Loads the Scene, then renders g_benchFrames frames as fast as
+///   possible while flying the Camera along a fixed path, and prints frame
+///   time percentiles, draw calls, and triangles as JSON on stdout.
+/// \param[in] window The (hidden) GLFWwindow to draw in.
+/// \return EXIT_SUCCESS, or EXIT_FAILURE if the Scene never finished
+///   loading.
+int
+runBenchmark (GLFWwindow* window);
+
+/// \brief Places the Camera on the benchmark's path.
+/// \param[in] t How far along the path, from 0 to 1.  The path is a closed
+///   loop around the Scene that also moves in, out, up, and down.
+void
+placeBenchCamera (double t);
 /******************************************************************/
 
 /// \brief Runs our program.
-/// \param[in] argc The number of command-line arguments, which we ignore.
-/// \param[in] argv The array of command-line-arguments, which we ignore.
+/// \param[in] argc The number of command-line arguments.
+/// \param[in] argv The array of command-line-arguments.  --upload-thread
+///   moves all buffer uploads onto a background thread with its own shared
+///   OpenGL context.  --gl-stats logs per-frame GL call counts every 300
+///   frames.  --record-threads n records each frame's draw calls on n
+///   threads and replays them on this one.  --update-hz n runs the
+///   simulation n times per second (60 by default).  --pacing mode paces
+///   frames: vsync (the default), uncapped, cap (at --fps n, 60 by
+///   default), or jit, which waits for vertical blank but starts each
+///   frame just before it is due (at --fps n, or the monitor's refresh
+///   rate).  --on-demand draws only when something changed and otherwise
+///   sleeps until an event arrives.  --characters file [n] adds n copies
+///   (1 by default) of an animated model, skinned on the GPU.  --bench [frames]
+///   renders that many frames (600 by default) in a hidden window without
+///   vsync, prints statistics as JSON, and exits; add --egl or --osmesa to
+///   create its context through EGL or OSMesa instead of the platform
+///   default.
 int
 main (int argc, char* argv[])
 {
-  g_keyBuffer = new KeyBuffer ();
-  g_mouseBuffer = new MouseBuffer ();
+  for (int arg = 1; arg < argc; ++arg)
+  {
+    std::string option = argv[arg];
+    if (option == "--upload-thread")
+      g_useUploadThread = true;
+    else if (option == "--gl-stats")
+      g_logGlStats = true;
+    else if (option == "--record-threads" && arg + 1 < argc)
+      g_commandBuffers.resize (std::max (std::atoi (argv[++arg]), 0), nullptr);
+    else if (option == "--update-hz" && arg + 1 < argc)
+      g_updateHz = std::max (std::atof (argv[++arg]), 1.0);
+    else if (option == "--pacing" && arg + 1 < argc)
+    {
+      if (!FramePacer::parseMode (argv[++arg], g_pacingMode))
+	fprintf (stderr, "Unknown pacing mode %s -- using vsync\n", argv[arg]);
+    }
+    else if (option == "--on-demand")
+      g_renderOnDemand = true;
+    else if (option == "--characters" && arg + 1 < argc)
+    {
+      g_characterFile = argv[++arg];
+      if (arg + 1 < argc && std::atoi (argv[arg + 1]) > 0)
+	g_characterCount = std::atoi (argv[++arg]);
+    }
+    else if (option == "--fps" && arg + 1 < argc)
+      g_targetHz = std::max (std::atof (argv[++arg]), 1.0);
+    else if (option == "--bench")
+    {
+      g_benchFrames = 600;
+      if (arg + 1 < argc && std::atoi (argv[arg + 1]) > 0)
+	g_benchFrames = std::atoi (argv[++arg]);
+    }
+    else if (option == "--egl")
+      g_benchContextApi = GLFW_EGL_CONTEXT_API;
+    else if (option == "--osmesa")
+      g_benchContextApi = GLFW_OSMESA_CONTEXT_API;
+  }
+  PROFILE_THREAD_NAME ("render");
   GLFWwindow* window;
-  init (window);
+  {
+    PROFILE_ZONE ("init");
+    init (window);
+  }
 
-  // Game/render loop
-  double previousTime = glfwGetTime ();
-  while (!glfwWindowShouldClose (window))
+  int status = EXIT_SUCCESS;
+  if (g_benchFrames > 0)
+    status = runBenchmark (window);
+
+  // Render loop.  Simulation runs on its own thread, and each frame draws
+  //   the newest snapshot it has published.
+  if (g_benchFrames == 0)
+    g_updateThread = std::thread (updateLoop);
+  TimingHistory frameTimes;
+  unsigned int frameCount = 0;
+  double startTime = glfwGetTime ();
+  double previousTime = startTime;
+  while (g_benchFrames == 0 && !glfwWindowShouldClose (window))
   {
+    PROFILE_ZONE ("frame");
+    {
+      PROFILE_ZONE ("pace");
+      g_framePacer->wait ();
+    }
+    // Process events in the event queue, which results in callbacks
+    //   being invoked.  Done after waiting, so the input is as fresh as
+    //   the pacing allows.
+    {
+      PROFILE_ZONE ("glfwPollEvents");
+      glfwPollEvents ();
+    }
+    {
+      PROFILE_ZONE ("uploadAssets");
+      uploadAssets ();
+    }
+    if (g_renderOnDemand && !needsRedraw ())
+    {
+      PROFILE_ZONE ("idle");
+      waitForChange ();
+      previousTime = glfwGetTime ();
+      continue;
+    }
+    {
+      PROFILE_ZONE ("drawScene");
+      drawScene (window);
+    }
+    if (g_wakeTime >= 0.0)
+    {
+      g_wakeLatency.add ((glfwGetTime () - g_wakeTime) * 1000.0);
+      g_wakeTime = -1.0;
+    }
+    if (g_glStats != nullptr)
+      g_glStats->endFrame ();
     double currentTime = glfwGetTime ();
-    // Compute frame times, which we can use later for frame rate computation,
-    //   animation, and physics.
-    double deltaTime = currentTime - previousTime;
+    frameTimes.add ((currentTime - previousTime) * 1000.0);
     previousTime = currentTime;
-    updateScene (deltaTime);
-    drawScene (window);
-    // Process events in the event queue, which results in callbacks
-    //   being invoked.
-    glfwPollEvents ();
-    processKeys ();
+    ++frameCount;
+  }
+
+  if (g_updateThread.joinable ())
+  {
+    g_stopUpdating = true;
+    g_updateThread.join ();
+    // The two rates are independent; this is how far apart they ended up.
+    double elapsed = glfwGetTime () - startTime;
+    fprintf (stderr, "Rendered %u frames at %.1f Hz (median %.2f ms apart); "
+	     "simulated %lu ticks at %.1f Hz (median %.3f ms of work each)\n",
+	     frameCount, frameCount / elapsed, frameTimes.getPercentile (50),
+	     g_tickCount, g_tickCount / elapsed, g_tickTimes.getPercentile (50));
+    if (g_inputLatency.getCount () > 0)
+      fprintf (stderr, "Pacing %s: input reached the screen in median %.2f ms, p95 %.2f ms, max %.2f ms (last %u inputs)\n",
+	       g_framePacer->getModeName ().c_str (), g_inputLatency.getPercentile (50),
+	       g_inputLatency.getPercentile (95), g_inputLatency.getMax (),
+	       g_inputLatency.getCount ());
+    if (g_renderOnDemand)
+      fprintf (stderr, "On demand: idle %.1f%% of the time (%lu waits), using %.1f%% of a core meanwhile; "
+	       "woke to swap in median %.2f ms, p95 %.2f ms\n",
+	       100.0 * g_idleSeconds / elapsed, g_idleWaits,
+	       g_idleSeconds > 0.0 ? 100.0 * g_idleCpuSeconds / g_idleSeconds : 0.0,
+	       g_wakeLatency.getPercentile (50), g_wakeLatency.getPercentile (95));
+    if (g_animation->getCharacterCount () > 0)
+      fprintf (stderr, "Animated %u character(s) on up to %u thread(s): posing took median %.1f us, p95 %.1f us "
+	       "per character per tick, median %.3f ms per tick in all\n",
+	       g_animation->getCharacterCount (), g_animation->getThreadCount (),
+	       g_animation->getCharacterTimes ().getPercentile (50),
+	       g_animation->getCharacterTimes ().getPercentile (95),
+	       g_animation->getUpdateTimes ().getPercentile (50));
+    if (g_tweens->getUpdateTimes ().getCount () > 0)
+      fprintf (stderr, "Tweened on up to %u thread(s): median %.3f ms, p95 %.3f ms per tick\n",
+	       g_tweens->getThreadCount (), g_tweens->getUpdateTimes ().getPercentile (50),
+	       g_tweens->getUpdateTimes ().getPercentile (95));
+    if (g_droppedInputEvents > 0)
+      fprintf (stderr, "Dropped %lu input event(s) while the input queue was full\n",
+	       g_droppedInputEvents);
   }
 
   releaseGlResources ();
+#ifdef ENABLE_PROFILER
+  if (CpuProfiler::writeChromeTrace ("trace.json"))
+    std::cerr << "CPU zones written to trace.json" << std::endl;
+#endif
   // Destroying the window destroys the OpenGL context
   glfwDestroyWindow (window);
   glfwTerminate ();
 
+  return status;
+}
+
+/******************************************************************/
+
+int
+runBenchmark (GLFWwindow* window)
+{
+  // Load everything and build every shader variant first, so the timed
+  //   frames measure drawing and nothing else.
+  const double LOAD_TIMEOUT_SECONDS = 60.0;
+  const unsigned int WARMUP_FRAMES = 10;
+  unsigned int warmFrames = 0;
+  while (warmFrames < WARMUP_FRAMES)
+  {
+    if (glfwGetTime () > LOAD_TIMEOUT_SECONDS)
+    {
+      fprintf (stderr, "Scene did not finish loading within %.0f s -- exiting\n",
+	       LOAD_TIMEOUT_SECONDS);
+      return EXIT_FAILURE;
+    }
+    uploadAssets ();
+    placeBenchCamera (0.0);
+    g_previousView = g_camera->getViewMatrix ();
+    publishSnapshot (0, 0.0, 0.0, std::chrono::steady_clock::now ());
+    drawScene (window);
+    g_context->finish ();
+    glfwPollEvents ();
+    if (g_assetLoader == nullptr && g_shaderLibrary->poll ())
+      ++warmFrames;
+  }
+  g_glStats->reset ();
+
+  // finish after each frame, so a frame's time includes its GPU work rather
+  //   than just queueing it.
+  TimingHistory frameTimes (g_benchFrames);
+  double previousTime = glfwGetTime ();
+  for (unsigned int frame = 0; frame < g_benchFrames; ++frame)
+  {
+    PROFILE_ZONE ("bench frame");
+    g_framePacer->wait ();
+    placeBenchCamera (static_cast<double> (frame) / g_benchFrames);
+    g_previousView = g_camera->getViewMatrix ();
+    publishSnapshot (frame + 1, static_cast<double> (frame) / g_benchFrames, 0.0,
+		     std::chrono::steady_clock::now ());
+    drawScene (window);
+    g_context->finish ();
+    glfwPollEvents ();
+    g_glStats->endFrame ();
+    double currentTime = glfwGetTime ();
+    frameTimes.add ((currentTime - previousTime) * 1000.0);
+    previousTime = currentTime;
+  }
+
+  printf ("{\n");
+  const GLubyte* renderer = g_context->getString (GL_RENDERER);
+  printf ("  \"renderer\": \"%s\",\n",
+	  CpuProfiler::escapeJson (renderer != nullptr ? reinterpret_cast<const char*> (renderer) : "").c_str ());
+  printf ("  \"frames\": %u,\n", frameTimes.getCount ());
+  printf ("  \"frame_ms\": {\"min\": %.3f, \"avg\": %.3f, \"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"max\": %.3f},\n",
+	  frameTimes.getMin (), frameTimes.getAverage (), frameTimes.getPercentile (50),
+	  frameTimes.getPercentile (95), frameTimes.getPercentile (99), frameTimes.getMax ());
+  // Averages per frame, as actually submitted.
+  const GlStats& stats = g_glStats->getTotalStats ();
+  double frames = g_glStats->getFrameCount ();
+  printf ("  \"meshes\": %u,\n", myScene->getMeshCount ());
+  // In the Scene, whether or not all of them were drawn.
+  printf ("  \"scene_triangles\": %lu,\n", myScene->getTriangleCount ());
+  printf ("  \"draw_calls\": %.1f,\n", stats.drawCalls / frames);
+  printf ("  \"triangles\": %.0f,\n", stats.triangles / frames);
+  printf ("  \"upload_bytes\": %.0f,\n", stats.uploadBytes / frames);
+  printf ("  \"gl_calls\": %.1f\n", stats.getTotalCalls () / frames);
+  printf ("}\n");
   return EXIT_SUCCESS;
 }
 
 /******************************************************************/
 
+void
+placeBenchCamera (double t)
+{
+  const double TWO_PI = 6.283185307179586;
+  const double RADIUS = 12.0;
+  double angle = t * TWO_PI;
+  // One lap of the Scene, dollying in and out twice and bobbing once.
+  double radius = RADIUS + 4.0 * std::sin (2.0 * angle);
+  double height = 2.0 * std::sin (angle);
+  g_camera->resetPose ();
+  g_camera->setPosition (Vector3 (radius * std::sin (angle), height, radius * std::cos (angle)));
+  // Yawing the starting pose (looking down -z) by the angle faces the
+  //   Scene's center.
+  g_camera->yaw (angle * 360.0 / TWO_PI);
+}
+
+/******************************************************************/
+
 void
 init (GLFWwindow*& window)
 {
-  g_context = new RealOpenGLContext ();
+  RealOpenGLContext* realContext = new RealOpenGLContext ();
+  g_context = realContext;
+  if (g_benchFrames > 0 || g_logGlStats)
+  {
+    g_glStats = new StatsOpenGLContext (g_context);
+    g_context = g_glStats;
+    if (g_logGlStats)
+      g_glStats->setLogInterval (300, std::cerr);
+  }
+#ifdef STATIC_GL_CONTEXT
+  g_meshContext = realContext;
+#else
+  g_meshContext = g_context;
+#endif
   // Always initialize GLFW before GLEW
   initGlfw ();
+  initFramePacer ();
   initWindow (window);
   initGlew ();
   initShaders ();
   initCamera ();
   initScene ();
+  for (CommandBufferContext*& buffer : g_commandBuffers)
+    buffer = new CommandBufferContext ();
+  g_gpuProfiler = new GpuProfiler (g_context);
+  myScene->setGpuProfiler (g_gpuProfiler);
 }
 
 /******************************************************************/
@@ -227,6 +793,26 @@ initGlfw ()
 
 /******************************************************************/
 
+void
+initFramePacer ()
+{
+  // The benchmark draws as fast as it can
+  if (g_benchFrames > 0)
+    g_pacingMode = FramePacer::UNCAPPED;
+  double hz = g_targetHz;
+  if (hz <= 0.0 && g_pacingMode == FramePacer::JUST_IN_TIME)
+  {
+    const GLFWvidmode* mode = glfwGetVideoMode (glfwGetPrimaryMonitor ());
+    if (mode != nullptr)
+      hz = mode->refreshRate;
+  }
+  if (hz <= 0.0)
+    hz = 60.0;
+  g_framePacer = new FramePacer (g_pacingMode, hz);
+}
+
+/******************************************************************/
+
 void
 initWindow (GLFWwindow*& window)
 {
@@ -237,6 +823,13 @@ initWindow (GLFWwindow*& window)
   glfwWindowHint (GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
   glfwWindowHint (GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 #endif
+  if (g_benchFrames > 0)
+  {
+    // Nothing is shown, and the driver is free to skip presenting.
+    glfwWindowHint (GLFW_VISIBLE, GLFW_FALSE);
+    if (g_benchContextApi != 0)
+      glfwWindowHint (GLFW_CONTEXT_CREATION_API, g_benchContextApi);
+  }
   window = glfwCreateWindow (800, 600, "OpenGL Engine", nullptr, nullptr);
   if (window == nullptr)
   {
@@ -246,14 +839,27 @@ initWindow (GLFWwindow*& window)
   }
   glfwSetWindowPos (window, 200, 100);
 
+  if (g_useUploadThread)
+  {
+    // Windows must be created on the main thread, so the loader's context
+    //   comes from here too.  It shares buffers, but not VAOs, with window.
+    glfwWindowHint (GLFW_VISIBLE, GLFW_FALSE);
+    g_uploadWindow = glfwCreateWindow (1, 1, "Upload", nullptr, window);
+    glfwWindowHint (GLFW_VISIBLE, GLFW_TRUE);
+    if (g_uploadWindow == nullptr)
+      fprintf (stderr, "Failed to create upload context -- uploading on the render thread\n");
+  }
+
   glfwMakeContextCurrent (window);
-  // Swap buffers after 1 frame
-  glfwSwapInterval (1);
+  // Swap buffers after 1 frame, or as soon as possible if the pacing
+  //   doesn't wait for vertical blank
+  glfwSwapInterval (g_framePacer->getSwapInterval ());
   glfwSetKeyCallback (window, recordKeys);
   glfwSetCursorPosCallback (window, recordMouseMvmt);
   glfwSetMouseButtonCallback (window, recordMouseButtons);
   glfwSetScrollCallback (window, recordScroll);
   glfwSetFramebufferSizeCallback (window, resetViewport);
+  glfwSetWindowRefreshCallback (window, requestRedraw);
 
   // Specify background color
   g_context->clearColor (0.0f, 0.0f, 0.0f, 1.0f);
@@ -298,9 +904,14 @@ resetViewport (GLFWwindow* window, int width, int height)
 {
   // Render into entire window
   // Origin for window coordinates is lower-left of window
-  aspectRatio = width/height;
-  g_camera->setProjectionSymmetricPerspective (fov, aspectRatio, 0.01, 40.0);
   g_context->viewport (0, 0, width, height);
+  g_redrawRequested = true;
+  // The projection belongs to the simulation, which follows the new size
+  InputEvent event = InputEvent ();
+  event.type = InputEvent::RESIZE;
+  event.x = width;
+  event.y = height;
+  queueInput (event);
 }
 
 /******************************************************************/
@@ -308,8 +919,76 @@ resetViewport (GLFWwindow* window, int width, int height)
 void
 initScene ()
 {
-  // Initialize a new Scene
-  myScene = new MyScene(g_context, g_colorShader, g_normShader);
+  // Initialize a new Scene, which fills in over the first few frames
+  g_assetLoader = new AssetLoader ();
+  if (g_uploadWindow != nullptr)
+  {
+    // Counting isn't thread-safe, so the upload thread bypasses it.
+    OpenGLContext* uploadContext = g_glStats != nullptr ? g_glStats->getInner () : g_context;
+    g_assetLoader->startUploadThread (g_uploadWindow, uploadContext);
+  }
+  myScene = new MyScene(*g_assetLoader, g_meshShaders);
+  g_animation = new AnimationSystem ();
+  g_tweens = new TweenSystem ();
+  if (!g_characterFile.empty ())
+    addCharacters ();
+}
+
+/******************************************************************/
+
+void
+addCharacters ()
+{
+  std::string fileName = g_characterFile;
+  unsigned int count = g_characterCount;
+  ShaderVariants* shaders = g_meshShaders;
+  AnimationSystem* animation = g_animation;
+  g_assetLoader->submit ([fileName, count, shaders, animation] ()
+			 {
+			   // How far apart the characters stand, in a square grid.
+			   const float SPACING = 3.0f;
+			   // Offsets each character's clip so the crowd doesn't move in
+			   //   lockstep.
+			   const float START_STAGGER_SECONDS = 0.37f;
+
+			   std::vector<LoadedMesh> meshes;
+			   const Model* model = ModelLoader::getInstance ().load (fileName);
+			   if (model == nullptr)
+			     return meshes;
+			   if (model->animations.empty ())
+			     fprintf (stderr, "%s has no animations; its characters will stand still\n", fileName.c_str ());
+			   unsigned int clip = model->animations.empty () ? Animator::NO_CLIP : 0;
+			   unsigned int columns = std::ceil (std::sqrt (count));
+			   for (unsigned int character = 0; character < count; ++character)
+			   {
+			     std::string prefix = "character" + std::to_string (character) + "_";
+			     Transform world;
+			     world.setPosition (SPACING * (character % columns), 0.0f,
+						-SPACING * (character / columns));
+			     // Only the meshes with bones are drawn; see
+			     //   AnimationSystem::addCharacter.
+			     for (unsigned int meshNum = 0; meshNum < model->meshes.size (); ++meshNum)
+			     {
+			       const ModelMesh& data = model->meshes[meshNum];
+			       if (data.bones.empty ())
+				 continue;
+			       meshes.emplace_back ();
+			       LoadedMesh& mesh = meshes.back ();
+			       mesh.name = prefix + std::to_string (meshNum);
+			       mesh.variants = shaders;
+			       mesh.hasNormals = true;
+			       mesh.boneCount = data.bones.size ();
+			       mesh.vertices = SkinnedMesh::interleave (data.vertices, data.skinning);
+			       mesh.indices = data.indices;
+			       mesh.world = world;
+			     }
+			     animation->addCharacter (*model, prefix, clip,
+						      character * START_STAGGER_SECONDS);
+			   }
+			   if (meshes.empty ())
+			     fprintf (stderr, "%s has no meshes with bones to animate\n", fileName.c_str ());
+			   return meshes;
+			 });
 }
 
 /******************************************************************/
@@ -317,17 +996,32 @@ initScene ()
 void
 initShaders ()
 {
-  // Create shader programs, which consist of linked shaders.
-  // No need to use the program until we draw or set uniform variables.
-  g_colorShader = new ShaderProgram (g_context);
-  g_colorShader->createVertexShader ("Vec3.vert");
-  g_colorShader->createFragmentShader ("Vec3.frag");
-  g_colorShader->link ();
+  // Linked programs are saved here, so only the first run (or the first
+  //   after a shader or driver changes) has to compile anything.
+  ShaderProgram::setBinaryCacheDirectory ("shader-cache");
+  g_shaderStartTime = glfwGetTime ();
+
+  // Nothing is compiled yet: each variant is built the first time a Mesh
+  //   with that vertex format is drawn, and finishes a frame or so later.
+  g_shaderLibrary = new ShaderLibrary (g_meshContext, GLEW_KHR_parallel_shader_compile);
+  g_meshShaders = new ShaderVariants (*g_shaderLibrary, "Mesh.vert", "Vec3.frag");
+}
 
-  g_normShader = new ShaderProgram (g_context);
-  g_normShader->createVertexShader ("Vec3Norm.vert");
-  g_normShader->createFragmentShader ("Vec3.frag");
-  g_normShader->link ();
+/******************************************************************/
+
+void
+pollShaders ()
+{
+  static unsigned int reportedVariants = 0;
+  unsigned int variants = g_meshShaders->getVariantCount ();
+  if (!g_shaderLibrary->poll () || variants == reportedVariants)
+    return;
+  unsigned int cached = g_shaderLibrary->getCachedProgramCount ();
+  fprintf (stderr, "%u shader variant(s) ready %.2f ms after startup (%s: %u from the binary cache, %u shader(s) compiled)\n",
+	   variants, (glfwGetTime () - g_shaderStartTime) * 1000.0,
+	   cached == variants ? "warm" : "cold", cached,
+	   g_shaderLibrary->getCompiledShaderCount ());
+  reportedVariants = variants;
 }
 
 /******************************************************************/
@@ -351,68 +1045,356 @@ initCamera ()
 /******************************************************************/
 
 void
-updateScene (double time)
+queueInput (InputEvent event)
 {
-  // No updates in this simple program.
+  event.time = glfwGetTime ();
+  if (!g_inputEvents.push (event))
+    ++g_droppedInputEvents;
 }
 
 /******************************************************************/
 
 void
-drawScene (GLFWwindow* window)
+processInput ()
 {
-  g_context->clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  // Degrees of rotation per screen coordinate dragged
+  const double DEGREES_PER_PIXEL = 0.25;
+  // Degrees of field of view per notch of the wheel
+  const double FOV_PER_SCROLL = 2.0;
+
+  // Everything stamped up to now belongs to this step; anything arriving
+  //   while it runs belongs to the next.
+  double now = glfwGetTime ();
+  g_input.beginStep (g_inputTime);
+  InputEvent event = InputEvent ();
+  while (g_inputEvents.tryPeek (event) && event.time <= now)
+  {
+    g_inputEvents.tryPop (event);
+    g_input.apply (event);
+    if (g_unshownInputTime < 0.0)
+      g_unshownInputTime = event.time;
+    if (event.type == InputEvent::RESIZE && event.y > 0)
+    {
+      aspectRatio = event.x / event.y;
+      g_camera->setProjectionSymmetricPerspective (fov, aspectRatio, 0.01, 40.0);
+    }
+    if (event.type != InputEvent::KEY || event.action != GLFW_PRESS)
+      continue;
+    if (event.code == GLFW_KEY_MINUS)
+      myScene->activatePreviousMesh ();
+    else if (event.code == GLFW_KEY_EQUAL)
+      myScene->activateNextMesh ();
+    else if (event.code == GLFW_KEY_P)
+      changePerspective ("Symm", fov, aspectRatio, 0.01, 40.0);
+    else if (event.code == GLFW_KEY_LEFT_BRACKET)
+      changePerspective ("Asymm", -1.0, 1.0, 0.01, 30.0, -1.3, 1.3);
+    else if (event.code == GLFW_KEY_O)
+      changePerspective ("Ortho", -20.0, 20.0, 0.01, 40.0, -15.0, 15.0);
+    // T spins the active Mesh a full turn; B sets it bobbing up and down
+    //   until pressed again.
+    else if (event.code == GLFW_KEY_T && myScene->getActiveMesh () != nullptr)
+      g_tweens->rotate (myScene->getActiveMesh (), Vector3 (0, 360, 0), 1.0f);
+    else if (event.code == GLFW_KEY_B && myScene->getActiveMesh () != nullptr)
+      toggleBob (myScene->getActiveMesh ());
+  }
+  g_input.endStep (now);
+  g_inputTime = now;
+
+  // However many motion events arrived, one rotation per axis
+  if (g_input.getLeftDragX () != 0)
+    g_camera->yaw (g_input.getLeftDragX () * DEGREES_PER_PIXEL);
+  if (g_input.getLeftDragY () != 0)
+    g_camera->pitch (g_input.getLeftDragY () * DEGREES_PER_PIXEL);
+  if (g_input.getRightDragX () != 0)
+    g_camera->roll (g_input.getRightDragX () * DEGREES_PER_PIXEL);
+  if (g_input.getScrollY () != 0)
+  {
+    fov = std::min (std::max (fov + g_input.getScrollY () * FOV_PER_SCROLL, 1.0), 120.0);
+    changePerspective ("Symm", fov, aspectRatio, 0.01, 40.0);
+  }
+}
 
-  const Transform modelView = g_camera->getViewMatrix();
-  const Matrix4 projectionView = g_camera->getProjectionMatrix();
+/******************************************************************/
 
-  // draw all Meshes in this Scene
-  myScene->draw (modelView, projectionView);
-  glfwSwapBuffers (window);
+void
+stepSimulation (double seconds)
+{
+  g_previousView = g_camera->getViewMatrix ();
+  myScene->savePreviousWorlds ();
+  g_stepStartRevision = getSimulationRevision ();
+  processInput ();
+  processKeys ();
+  updateScene (seconds);
 }
 
 /******************************************************************/
 
 void
-recordKeys (GLFWwindow* window, int key, int scanCode, int action,
-	     int modifiers)
+publishSnapshot (unsigned long tick, double time, double tickSeconds,
+		 std::chrono::steady_clock::time_point due)
 {
-  // Actions are GLFW_PRESS, GLFW_RELEASE, and GLFW_REPEAT
-  // Exit if ESC is pressed
-  if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
+  SceneSnapshot& snapshot = g_snapshots.getWriteBuffer ();
+  snapshot.previousView = g_previousView;
+  snapshot.view = g_camera->getViewMatrix ();
+  snapshot.projection = g_camera->getProjectionMatrix ();
+  myScene->capture (snapshot);
+  snapshot.tick = tick;
+  snapshot.time = time;
+  snapshot.tickSeconds = tickSeconds;
+  snapshot.due = due;
+  snapshot.oldestInput = g_unshownInputTime;
+  g_unshownInputTime = -1.0;
+  snapshot.revision = getSimulationRevision ();
+  snapshot.moving = snapshot.revision != g_stepStartRevision;
+  g_snapshots.publish ();
+  // An idle render thread is blocked in glfwWaitEventsTimeout; this wakes it
+  if (g_renderOnDemand && snapshot.revision != g_publishedRevision)
+    glfwPostEmptyEvent ();
+  g_publishedRevision = snapshot.revision;
+}
+
+/******************************************************************/
+
+void
+updateLoop ()
+{
+  PROFILE_THREAD_NAME ("update");
+  const double STEP_SECONDS = 1.0 / g_updateHz;
+  // After a stall longer than this, the rest is dropped rather than caught
+  //   up on, so one hitch can't snowball into the next.
+  const unsigned int MAX_STEPS_PER_WAKE = 5;
+
+  std::chrono::steady_clock::time_point previousWake = std::chrono::steady_clock::now ();
+  double accumulator = 0.0;
+  while (!g_stopUpdating.load ())
   {
-    glfwSetWindowShouldClose (window, GL_TRUE);
+    std::chrono::steady_clock::time_point wake = std::chrono::steady_clock::now ();
+    accumulator += std::chrono::duration<double> (wake - previousWake).count ();
+    previousWake = wake;
+
+    unsigned int steps = 0;
+    while (accumulator >= STEP_SECONDS && steps < MAX_STEPS_PER_WAKE)
+    {
+      std::chrono::steady_clock::time_point stepStart = std::chrono::steady_clock::now ();
+      {
+	PROFILE_ZONE ("tick");
+	std::lock_guard<std::mutex> lock (g_sceneMutex);
+	stepSimulation (STEP_SECONDS);
+	++g_tickCount;
+	accumulator -= STEP_SECONDS;
+	++steps;
+	if (accumulator < STEP_SECONDS || steps == MAX_STEPS_PER_WAKE)
+	{
+	  // Only the last step's state is drawn.  It was due when the time
+	  //   still in the accumulator began.
+	  std::chrono::steady_clock::time_point due = wake
+	    - std::chrono::duration_cast<std::chrono::steady_clock::duration> (
+		std::chrono::duration<double> (accumulator));
+	  publishSnapshot (g_tickCount, g_tickCount * STEP_SECONDS, STEP_SECONDS, due);
+	}
+      }
+      std::chrono::duration<double, std::milli> work = std::chrono::steady_clock::now () - stepStart;
+      g_tickTimes.add (work.count ());
+    }
+    if (accumulator >= STEP_SECONDS)
+      accumulator = 0.0;
+
+    std::this_thread::sleep_for (std::chrono::duration<double> (STEP_SECONDS - accumulator));
+  }
+}
+
+/******************************************************************/
+
+void
+toggleBob (Mesh* mesh)
+{
+  // Half a unit up and back each second and a half.
+  const float BOB_HEIGHT = 0.5f;
+  const float BOB_SECONDS = 0.75f;
+
+  if (g_bobbing.erase (mesh) > 0)
+    g_tweens->stop (mesh);
+  else
+  {
+    g_bobbing.insert (mesh);
+    g_tweens->translate (mesh, Vector3 (0, BOB_HEIGHT, 0), BOB_SECONDS, TweenSystem::EASE_IN_OUT,
+			 TweenSystem::PING_PONG);
+  }
+}
+
+/******************************************************************/
+
+void
+updateScene (double time)
+{
+  g_animation->update (*myScene, time);
+  g_tweens->update (time);
+}
+
+/******************************************************************/
+
+void
+uploadAssets ()
+{
+  // Leaves most of a 60 Hz frame for drawing.
+  const double UPLOAD_BUDGET_SECONDS = 0.004;
+
+  if (g_assetLoader == nullptr)
     return;
-  } 
-  else if (key == GLFW_KEY_MINUS && action == GLFW_PRESS)
   {
-    myScene->activatePreviousMesh ();
-    myScene->getActiveMesh ();
+    // Held for the whole budget at most, which the update thread can absorb.
+    std::lock_guard<std::mutex> lock (g_sceneMutex);
+    g_assetLoader->uploadPending (g_meshContext, *myScene, UPLOAD_BUDGET_SECONDS);
   }
-  else if (key == GLFW_KEY_EQUAL && action == GLFW_PRESS)
+  if (g_assetLoader->isIdle ())
   {
-    myScene->activateNextMesh ();
-    myScene->getActiveMesh ();
+    const ModelLoader& loader = ModelLoader::getInstance ();
+    fprintf (stderr, "Scene loaded after %.2f s; model loading: %u file parse(s), %u cache hit(s), %.2f ms\n",
+	     glfwGetTime (), loader.getParseCount (), loader.getCacheHitCount (),
+	     loader.getLoadSeconds () * 1000.0);
+    // The longest call is the worst hitch loading added to any frame.
+    fprintf (stderr, "Render-thread uploads (%s): longest %.2f ms, total %.2f ms\n",
+	     g_uploadWindow != nullptr ? "upload thread" : "inline",
+	     g_assetLoader->getLongestUploadSeconds () * 1000.0,
+	     g_assetLoader->getTotalUploadSeconds () * 1000.0);
+    delete g_assetLoader;
+    g_assetLoader = nullptr;
+    if (g_uploadWindow != nullptr)
+    {
+      glfwDestroyWindow (g_uploadWindow);
+      g_uploadWindow = nullptr;
+    }
   }
-  else if (key == GLFW_KEY_P && action == GLFW_PRESS)
+}
+
+/******************************************************************/
+
+unsigned long
+getSimulationRevision ()
+{
+  return g_camera->getRevision () + myScene->getRevision ();
+}
+
+/******************************************************************/
+
+bool
+needsRedraw ()
+{
+  // Meshes skip themselves until their shaders are built, so keep drawing
+  //   until they are, and once more after
+  if (g_assetLoader != nullptr || !g_shaderLibrary->poll ())
+    g_redrawRequested = true;
+  if (g_redrawRequested)
+    return true;
+  g_snapshots.update ();
+  const SceneSnapshot& snapshot = g_snapshots.getReadBuffer ();
+  return snapshot.revision != g_drawnRevision || (snapshot.moving && g_drawnAlpha < 1.0f);
+}
+
+/******************************************************************/
+
+void
+waitForChange ()
+{
+  // Only a backstop: events and published changes end the wait sooner
+  const double IDLE_TIMEOUT_SECONDS = 0.5;
+
+  double start = glfwGetTime ();
+  std::clock_t cpuStart = std::clock ();
+  glfwWaitEventsTimeout (IDLE_TIMEOUT_SECONDS);
+  g_wakeTime = glfwGetTime ();
+  g_idleSeconds += g_wakeTime - start;
+  g_idleCpuSeconds += static_cast<double> (std::clock () - cpuStart) / CLOCKS_PER_SEC;
+  ++g_idleWaits;
+}
+
+/******************************************************************/
+
+void
+requestRedraw (GLFWwindow* window)
+{
+  g_redrawRequested = true;
+}
+
+/******************************************************************/
+
+void
+drawScene (GLFWwindow* window)
+{
+  g_gpuProfiler->beginFrame ();
   {
-    changePerspective ("Symm", fov, aspectRatio, 0.01, 40.0);
+    GpuProfiler::Scope scope (g_gpuProfiler, "clear");
+    g_context->clear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   }
-  else if (key == GLFW_KEY_LEFT_BRACKET && action == GLFW_PRESS)
+
+  // The newest snapshot, or the last one again if no tick has finished since
+  g_snapshots.update ();
+  const SceneSnapshot& snapshot = g_snapshots.getReadBuffer ();
+  // Snapshots from here on are at least this new, so Meshes removed before
+  //   it can go
+  myScene->releaseRetired (snapshot.capture);
+  float alpha = snapshot.getAlpha (std::chrono::steady_clock::now ());
+  g_drawnRevision = snapshot.revision;
+  g_drawnAlpha = alpha;
+  g_redrawRequested = false;
+
+  // draw all Meshes in the snapshot (each skips itself until its shader is
+  //   ready), then finish any shaders those draws asked for
   {
-    changePerspective ("Asymm", -1.0, 1.0, 0.01, 30.0, -1.3, 1.3);
+    GpuProfiler::Scope scope (g_gpuProfiler, "Scene::draw");
+    if (g_commandBuffers.empty ())
+      myScene->draw (snapshot, alpha);
+    else
+    {
+      myScene->recordDraw (snapshot, alpha, g_commandBuffers);
+      for (CommandBufferContext* buffer : g_commandBuffers)
+        buffer->replay (g_context);
+    }
   }
-  else if (key == GLFW_KEY_O && action == GLFW_PRESS)
+  pollShaders ();
+  g_framePacer->endWork (FramePacer::now ());
   {
-    changePerspective ("Ortho", -20.0, 20.0, 0.01, 40.0, -15.0, 15.0);
+    GpuProfiler::Scope scope (g_gpuProfiler, "swap");
+    glfwSwapBuffers (window);
   }
-  else if (action == GLFW_PRESS)
+  g_framePacer->endFrame (FramePacer::now ());
+  g_gpuProfiler->endFrame ();
+
+  // The first swap showing a tick is when the input it took in reached the
+  //   screen (to within the display's own latency)
+  static unsigned long shownTick = 0;
+  if (snapshot.tick != shownTick && snapshot.oldestInput >= 0.0)
+    g_inputLatency.add ((glfwGetTime () - snapshot.oldestInput) * 1000.0);
+  shownTick = snapshot.tick;
+}
+
+/******************************************************************/
+
+void
+recordKeys (GLFWwindow* window, int key, int scanCode, int action,
+	     int modifiers)
+{
+  // Actions are GLFW_PRESS, GLFW_RELEASE, and GLFW_REPEAT
+  // Exit if ESC is pressed
+  if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
   {
-    g_keyBuffer->setKeyDown(key);
+    glfwSetWindowShouldClose (window, GL_TRUE);
+    return;
   } 
-  else if (action == GLFW_RELEASE)
+  else if (key == GLFW_KEY_G && action == GLFW_PRESS)
+  {
+    g_gpuProfiler->report (std::cerr);
+    if (g_gpuProfiler->exportCsv ("gpu-profile.csv"))
+      std::cerr << "GPU history written to gpu-profile.csv" << std::endl;
+  }
+  else if (action != GLFW_REPEAT)
   {
-    g_keyBuffer->setKeyUp(key);
+    // Everything else is the simulation's, which sees when it happened
+    InputEvent event;
+    event.type = InputEvent::KEY;
+    event.code = key;
+    event.action = action;
+    queueInput (event);
   }
 }
 
@@ -421,24 +1403,12 @@ recordKeys (GLFWwindow* window, int key, int scanCode, int action,
 void
 recordMouseMvmt (GLFWwindow* window, double xpos, double ypos)
 {
-  const float ROTATION_DELTA = 1.0f;
-  double x, y;
-
-  g_mouseBuffer->setPosition (xpos, ypos);
-  glfwGetCursorPos (window, &x, &y);
-  if (g_mouseBuffer->getLeftButton () == true && (x - g_mouseBuffer->getX ()) > 0) 
-    g_camera->yaw (ROTATION_DELTA);
-    //4Debug: std::cout << g_camera->getViewMatrix () << "\n";
-  else if (g_mouseBuffer->getLeftButton () == true && (x - g_mouseBuffer->getX ()) < 0)
-    g_camera->yaw (-ROTATION_DELTA);
-  else if (g_mouseBuffer->getLeftButton () == true && (y - g_mouseBuffer->getY ()) > 0)
-    g_camera->pitch (ROTATION_DELTA);
-  else if (g_mouseBuffer->getLeftButton () == true && (y - g_mouseBuffer->getY ()) < 0)
-    g_camera->pitch (-ROTATION_DELTA);
-  if (g_mouseBuffer->getRightButton () == true && (x - g_mouseBuffer->getX ()) > 0)
-    g_camera->roll (ROTATION_DELTA);
-  else if (g_mouseBuffer->getRightButton () == true && (x - g_mouseBuffer->getX ()) < 0)
-    g_camera->roll (-ROTATION_DELTA);
+  // Only where the cursor went; the simulation sums the motion into drags
+  InputEvent event = InputEvent ();
+  event.type = InputEvent::CURSOR;
+  event.x = xpos;
+  event.y = ypos;
+  queueInput (event);
 }
 
 /******************************************************************/
@@ -446,22 +1416,11 @@ recordMouseMvmt (GLFWwindow* window, double xpos, double ypos)
 void
 recordMouseButtons (GLFWwindow* window, int button, int action, int mods)
 {
-  if (button == GLFW_MOUSE_BUTTON_RIGHT && action == GLFW_PRESS)
-  {
-    g_mouseBuffer->setRightButton (true);
-  }
-  else if (button == GLFW_MOUSE_BUTTON_RIGHT && action == GLFW_RELEASE)
-  {
-    g_mouseBuffer->setRightButton (false);
-  }
-  else if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
-  {
-    g_mouseBuffer->setLeftButton (true);
-  }
-  else if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_RELEASE)
-  {
-    g_mouseBuffer->setLeftButton (false);
-  }
+  InputEvent event = InputEvent ();
+  event.type = InputEvent::MOUSE_BUTTON;
+  event.code = button;
+  event.action = action;
+  queueInput (event);
 }
 
 /******************************************************************/
@@ -469,16 +1428,11 @@ recordMouseButtons (GLFWwindow* window, int button, int action, int mods)
 void
 recordScroll (GLFWwindow* window, double xoffset, double yoffset)
 {
-  changePerspective ("Symm", fov, aspectRatio, 0.01, 40.0);
-
-  if (yoffset > 0 && fov < 120)
-  {
-    changePerspective ("Symm", fov += 2, aspectRatio, 0.01, 40.0);
-  }
-  else if (yoffset < 0 && fov > 1)
-  {
-    changePerspective ("Symm", fov -= 2, aspectRatio, 0.01, 40.0);
-  } 
+  InputEvent event = InputEvent ();
+  event.type = InputEvent::SCROLL;
+  event.x = xoffset;
+  event.y = yoffset;
+  queueInput (event);
 }
 
 /******************************************************************/
@@ -486,51 +1440,59 @@ recordScroll (GLFWwindow* window, double xoffset, double yoffset)
 void
 processKeys ()
 {
-  const float MOVEMENT_DELTA = 0.05f;
-  const float ROTATION_DELTA = 1.00f;
-
-  if (g_keyBuffer->isKeyDown(GLFW_KEY_W))
-    g_camera->moveBack(-MOVEMENT_DELTA);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_S))
-    g_camera->moveBack(MOVEMENT_DELTA);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_A))
-    g_camera->moveRight(-MOVEMENT_DELTA);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_D))
-    g_camera->moveRight(MOVEMENT_DELTA);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_C))
-    g_camera->moveUp(-MOVEMENT_DELTA);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_F))
-    g_camera->moveUp(MOVEMENT_DELTA);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_R))
+  // Rates per second, which are the old per-frame steps at 60 frames per
+  //   second.
+  const float MOVEMENT_SPEED = 3.0f;
+  const float ROTATION_SPEED = 60.0f;
+  const float GROWTH_PER_SECOND = 1.8167f;
+
+  // Each key acts for as long as it was held this step, so a tap shorter
+  //   than a step still moves something, by as much as it lasted.
+  float held;
+  if ((held = g_input.getHeldSeconds (GLFW_KEY_W)) > 0)
+    g_camera->moveBack(-MOVEMENT_SPEED * held);
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_S)) > 0)
+    g_camera->moveBack(MOVEMENT_SPEED * held);
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_A)) > 0)
+    g_camera->moveRight(-MOVEMENT_SPEED * held);
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_D)) > 0)
+    g_camera->moveRight(MOVEMENT_SPEED * held);
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_C)) > 0)
+    g_camera->moveUp(-MOVEMENT_SPEED * held);
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_F)) > 0)
+    g_camera->moveUp(MOVEMENT_SPEED * held);
+  else if (g_input.getHeldSeconds (GLFW_KEY_R) > 0)
     g_camera->resetPose();  
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_J))
-    myScene->getActiveMesh ()->yaw (ROTATION_DELTA);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_L))
-    myScene->getActiveMesh ()->yaw(-ROTATION_DELTA);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_I))
-    myScene->getActiveMesh ()->pitch(ROTATION_DELTA);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_K))
-    myScene->getActiveMesh ()->pitch(-ROTATION_DELTA);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_N))
-    myScene->getActiveMesh ()->roll(ROTATION_DELTA);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_M))
-    myScene->getActiveMesh ()->roll(-ROTATION_DELTA);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_1))
-    myScene->getActiveMesh ()->moveRight (MOVEMENT_DELTA);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_2))
-    myScene->getActiveMesh ()->moveRight (-MOVEMENT_DELTA);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_3))
-    myScene->getActiveMesh ()->moveUp (MOVEMENT_DELTA);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_4))
-    myScene->getActiveMesh ()->moveUp (-MOVEMENT_DELTA);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_5))
-    myScene->getActiveMesh ()->moveBack (MOVEMENT_DELTA);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_6))
-    myScene->getActiveMesh ()->moveBack (-MOVEMENT_DELTA);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_7))
-    myScene->getActiveMesh ()->scaleLocal (1.01f);
-  else if (g_keyBuffer->isKeyDown(GLFW_KEY_8))
-    myScene->getActiveMesh ()->scaleLocal (0.99f);
+  else if (myScene->getActiveMesh () == nullptr)
+    return; // Nothing has finished loading yet.
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_J)) > 0)
+    myScene->getActiveMesh ()->yaw (ROTATION_SPEED * held);
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_L)) > 0)
+    myScene->getActiveMesh ()->yaw(-ROTATION_SPEED * held);
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_I)) > 0)
+    myScene->getActiveMesh ()->pitch(ROTATION_SPEED * held);
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_K)) > 0)
+    myScene->getActiveMesh ()->pitch(-ROTATION_SPEED * held);
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_N)) > 0)
+    myScene->getActiveMesh ()->roll(ROTATION_SPEED * held);
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_M)) > 0)
+    myScene->getActiveMesh ()->roll(-ROTATION_SPEED * held);
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_1)) > 0)
+    myScene->getActiveMesh ()->moveRight (MOVEMENT_SPEED * held);
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_2)) > 0)
+    myScene->getActiveMesh ()->moveRight (-MOVEMENT_SPEED * held);
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_3)) > 0)
+    myScene->getActiveMesh ()->moveUp (MOVEMENT_SPEED * held);
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_4)) > 0)
+    myScene->getActiveMesh ()->moveUp (-MOVEMENT_SPEED * held);
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_5)) > 0)
+    myScene->getActiveMesh ()->moveBack (MOVEMENT_SPEED * held);
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_6)) > 0)
+    myScene->getActiveMesh ()->moveBack (-MOVEMENT_SPEED * held);
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_7)) > 0)
+    myScene->getActiveMesh ()->scaleLocal (std::pow (GROWTH_PER_SECOND, held));
+  else if ((held = g_input.getHeldSeconds (GLFW_KEY_8)) > 0)
+    myScene->getActiveMesh ()->scaleLocal (1.0f / std::pow (GROWTH_PER_SECOND, held));
 } 
 
 /******************************************************************/
@@ -566,10 +1528,21 @@ changePerspective (std::string projectionType, double fovOrLeft, double aspRatio
 void
 releaseGlResources ()
 {
+  // Stop the loader first so no worker is still building a Mesh.
+  delete g_assetLoader;
+  if (g_uploadWindow != nullptr)
+    glfwDestroyWindow (g_uploadWindow);
+  g_gpuProfiler->report (std::cerr);
+  delete g_gpuProfiler;
+  delete g_animation;
+  delete g_tweens;
   delete myScene;
+  for (CommandBufferContext* buffer : g_commandBuffers)
+    delete buffer;
   delete g_camera;
-  delete g_colorShader;
-  delete g_normShader;
+  delete g_meshShaders;
+  delete g_shaderLibrary;
+  delete g_framePacer;
   delete g_context;
 }
 
@@ -3,10 +3,17 @@
 /// \author Ethan Gingrich
 /// \version A02
 
+#include <cassert>
+#include <algorithm>
+
 #include "Mesh.hpp"
 
 // Mesh constructor
-Mesh::Mesh(OpenGLContext* context, ShaderProgram* shader)
+Mesh::Mesh(GlContext* context, ShaderProgram* shader)
+  : m_variants (nullptr), m_locationsShader (nullptr), m_modelViewLocation (-1),
+    m_projectionLocation (-1), m_bonesLocation (-1), m_indexCount (0), m_prepared (false),
+    m_buffersFilled (false), m_usage (GL_STATIC_DRAW), m_revision (0),
+    m_teleportRevision (0)
 {
   m_shader = shader;
   m_context = context;
@@ -40,37 +47,127 @@ Mesh::prepareVao ()
 
   // Set up triangle geometry
   m_context->bindBuffer (GL_ARRAY_BUFFER, m_vbo);
-  // 3 3D points, followed by 3 RGB colors
-  m_context->bufferData (GL_ARRAY_BUFFER, m_vertices.size () * sizeof(float),
-			 m_vertices.data (),
-			 GL_STATIC_DRAW);
-  glBindBuffer (GL_ELEMENT_ARRAY_BUFFER, m_ibo);
-  glBufferData (GL_ELEMENT_ARRAY_BUFFER, m_indices.size () * sizeof (unsigned int), 
-        m_indices.data (), GL_STATIC_DRAW);
+  m_context->bindBuffer (GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+  if (m_buffersFilled)
+  {
+    // Already uploaded by whoever handed us the buffers; only the VAO (which
+    //   can't be shared between contexts) is left to build.
+  }
+  else if (m_mappedFile)
+  {
+    // Straight from the page cache to the driver; nothing is parsed.
+    const MeshFileHeader& header = m_mappedFile->getHeader ();
+    m_context->bufferData (GL_ARRAY_BUFFER, header.vertexBytes,
+			   m_mappedFile->getVertexData (), m_usage);
+    m_context->bufferData (GL_ELEMENT_ARRAY_BUFFER, header.indexBytes,
+			   m_mappedFile->getIndexData (), m_usage);
+    m_indexCount = header.indexCount;
+    m_mappedFile.reset ();
+  }
+  else
+  {
+    // 3 3D points, followed by 3 RGB colors
+    m_context->bufferData (GL_ARRAY_BUFFER, m_vertices.size () * sizeof(float),
+			   m_vertices.data (),
+			   m_usage);
+    m_context->bufferData (GL_ELEMENT_ARRAY_BUFFER, m_indices.size () * sizeof (unsigned int),
+			   m_indices.data (), m_usage);
+    m_indexCount = m_indices.size ();
+  }
   // Tell the shaders how the data in the array is laid out
   enableAttributes ();
 
   m_context->bindVertexArray (0);
+  // Everything was just uploaded, so nothing is dirty anymore.
+  m_dirtyVertices.clear ();
+  m_dirtyIndices.clear ();
+  m_prepared = true;
 }
 
 // Draws this Mesh
 void
 Mesh::draw (const Transform viewMatrix, const Matrix4& projectionMatrix)
 {
-  m_shader->enable();
-  int numIndices = m_indices.size ();
-  Transform modelView;
-  modelView = viewMatrix * m_world;
+  if (!prepareDraw ())
+    return;
+  std::vector<float> bones;
+  copyBonePalette (bones);
+  issueDraw (m_context, viewMatrix, projectionMatrix, m_world, &bones);
+}
 
-  m_shader->setUniformMatrix ("uModelView", modelView.getTransform ());
-  m_shader->setUniformMatrix ("uProjection", projectionMatrix);
+// Draws this Mesh with some other world transform
+void
+Mesh::draw (const Transform& viewMatrix, const Matrix4& projectionMatrix,
+	    const Transform& world, const std::vector<float>* bones)
+{
+  if (prepareDraw ())
+    issueDraw (m_context, viewMatrix, projectionMatrix, world, bones);
+}
 
-  m_context->bindVertexArray (m_vao);
-  m_context->drawElements (GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, 
-    reinterpret_cast<void*> (0));
-  m_context->bindVertexArray (0);
+// Does the part of drawing that needs the OpenGL context
+bool
+Mesh::prepareDraw ()
+{
+  if (m_variants != nullptr && m_shader == nullptr)
+    m_shader = m_variants->get (getShaderFeatures ());
+  // A variant that is still compiling; this Mesh appears once it's done.
+  if (!m_shader->isLinked ())
+    return false;
+  if (m_locationsShader != m_shader)
+  {
+    // Looked up once rather than every frame: a query stalls, and can't be
+    //   recorded for later.
+    m_modelViewLocation = m_shader->getUniformLocation ("uModelView");
+    m_projectionLocation = m_shader->getUniformLocation ("uProjection");
+    m_bonesLocation = m_shader->getUniformLocation ("uBones");
+    m_locationsShader = m_shader;
+  }
+  if (hasPendingUpdates ())
+  {
+    m_context->bindVertexArray (m_vao);
+    uploadDirtyRanges ();
+    m_context->bindVertexArray (0);
+  }
+  return true;
+}
+
+// Makes the calls that draw this Mesh through a context
+void
+Mesh::recordDraw (OpenGLContext* context, const Transform& viewMatrix,
+		  const Matrix4& projectionMatrix, const Transform& world,
+		  const std::vector<float>* bones) const
+{
+  issueDraw (context, viewMatrix, projectionMatrix, world, bones);
+}
 
-  m_shader->disable ();
+// Copies this Mesh's bone matrices, of which a plain Mesh has none
+void
+Mesh::copyBonePalette (std::vector<float>& palette) const
+{
+  palette.clear ();
+}
+
+// Makes the calls that draw this Mesh, bound statically to the context type
+template <typename Context>
+void
+Mesh::issueDraw (Context* context, const Transform& viewMatrix,
+		 const Matrix4& projectionMatrix, const Transform& world,
+		 const std::vector<float>* bones) const
+{
+  float modelView[16];
+  (viewMatrix * world).getTransform (modelView);
+
+  context->useProgram (m_shader->getProgramId ());
+  context->uniformMatrix4fv (m_modelViewLocation, 1, GL_FALSE, modelView);
+  context->uniformMatrix4fv (m_projectionLocation, 1, GL_FALSE, projectionMatrix.data ());
+  // The whole palette goes up in one call.
+  if (bones != nullptr && !bones->empty () && m_bonesLocation >= 0)
+    context->uniformMatrix4fv (m_bonesLocation, bones->size () / 16, GL_FALSE, bones->data ());
+  context->bindVertexArray (m_vao);
+  context->drawElements (GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT,
+			 reinterpret_cast<void*> (0));
+  context->bindVertexArray (0);
+  context->useProgram (0);
 }
 
   /*****************************************************************************/
@@ -85,6 +182,50 @@ Mesh::getWorld () const
   return m_world;
 }
 
+/// \brief Replaces the mesh's world matrix, jumping there.
+/// \param[in] world The new world matrix.
+/// \post The mesh's world matrix is world.
+void
+Mesh::setWorld (const Transform& world)
+{
+  m_world = world;
+  ++m_revision;
+  m_teleportRevision = m_revision;
+}
+
+/// \brief Replaces the mesh's world matrix as one step of smooth motion.
+/// \param[in] world The new world matrix.
+/// \post The mesh's world matrix is world.
+void
+Mesh::moveTo (const Transform& world)
+{
+  m_world = world;
+  ++m_revision;
+}
+
+/// \brief Gets a number that grows whenever the mesh's world matrix changes.
+/// \return The revision.
+unsigned long
+Mesh::getRevision () const
+{
+  return m_revision;
+}
+
+/// \brief Gets the revision as of the last setWorld.
+/// \return The revision.
+unsigned long
+Mesh::getTeleportRevision () const
+{
+  return m_teleportRevision;
+}
+
+// Counts a change, other than moving, that changes how this Mesh looks
+void
+Mesh::countChange ()
+{
+  ++m_revision;
+}
+
 /// \brief Moves the mesh right (locally).
 /// \param[in] distance The distance to move the mesh.
 /// \post The mesh has been moved.
@@ -92,6 +233,7 @@ void
 Mesh::moveRight (float distance)
 {
   m_world.moveRight (distance);
+  ++m_revision;
 }
 
 /// \brief Moves the mesh up (locally).
@@ -101,6 +243,7 @@ void
 Mesh::moveUp (float distance)
 {
   m_world.moveUp (distance);
+  ++m_revision;
 }
 
 /// \brief Moves the mesh back (locally).
@@ -110,6 +253,7 @@ void
 Mesh::moveBack (float distance)
 {
   m_world.moveBack (distance);
+  ++m_revision;
 }
 
 /// \brief Moves the mesh in some local direction.
@@ -120,6 +264,7 @@ void
 Mesh::moveLocal (float distance, const Vector3& localDirection)
 {
   m_world.moveLocal (distance, localDirection);
+  ++m_revision;
 }
 
 /// \brief Moves the mesh in some world direction.
@@ -130,6 +275,7 @@ void
 Mesh::moveWorld (float distance, const Vector3& worldDirection)
 {
   m_world.moveWorld (distance, worldDirection);
+  ++m_revision;
 }
 
 /// \brief Rotates the mesh around its own local right axis.
@@ -139,6 +285,7 @@ void
 Mesh::pitch (float angleDegrees)
 {
   m_world.pitch (angleDegrees);
+  ++m_revision;
 }
 
 /// \brief Rotates the mesh around its own local up axis.
@@ -148,6 +295,7 @@ void
 Mesh::yaw (float angleDegrees)
 {
   m_world.yaw (angleDegrees);
+  ++m_revision;
 }
 
 /// \brief Rotates the mesh around its own local back axis.
@@ -157,6 +305,7 @@ void
 Mesh::roll (float angleDegrees)
 {
   m_world.roll (angleDegrees);
+  ++m_revision;
 }
 
 /// \brief Rotates the mesh around some local direction.
@@ -167,6 +316,7 @@ void
 Mesh::rotateLocal (float angleDegrees, const Vector3& axis)
 {
   m_world.rotateLocal (angleDegrees, axis);
+  ++m_revision;
 }
 
 /// \brief Aligns the mesh with the world Y axis.
@@ -177,6 +327,7 @@ void
 Mesh::alignWithWorldY ()
 {
   m_world.alignWithWorldY ();
+  ++m_revision;
 }
 
 /// \brief Scales the mesh (locally).
@@ -186,6 +337,7 @@ void
 Mesh::scaleLocal (float scale)
 {
   m_world.scaleLocal (scale);
+  ++m_revision;
 }
 
 /// \brief Scales the mesh (locally).
@@ -197,6 +349,7 @@ void
 Mesh::scaleLocal (float scaleX, float scaleY, float scaleZ)
 {
   m_world.scaleLocal (scaleX, scaleY, scaleZ);
+  ++m_revision;
 }
 
 /// \brief Scales the mesh (worldly).
@@ -206,6 +359,7 @@ void
 Mesh::scaleWorld (float scale) 
 {
   m_world.scaleWorld (scale);
+  ++m_revision;
 }
 
 /// \brief Scales the mesh (worldly).
@@ -217,6 +371,7 @@ void
 Mesh::scaleWorld (float scaleX, float scaleY, float scaleZ)
 {
   m_world.scaleWorld (scaleX, scaleY, scaleZ);
+  ++m_revision;
 }
 
 /// \brief Shears the mesh's local X by its local Y and local Z.
@@ -227,6 +382,7 @@ void
 Mesh::shearLocalXByYz (float shearY, float shearZ)
 {
   m_world.shearLocalXByYz (shearY, shearZ);
+  ++m_revision;
 }
 
 /// \brief Shears the mesh's local Y by its local X and local Z.
@@ -237,6 +393,7 @@ void
 Mesh::shearLocalYByXz (float shearX, float shearZ)
 {
   m_world.shearLocalYByXz (shearX, shearZ);
+  ++m_revision;
 }
 
 /// \brief Shears the mesh's local Z by its local X and local Y.
@@ -247,6 +404,7 @@ void
 Mesh::shearLocalZByXy (float shearX, float shearY)
 {
   m_world.shearLocalZByXy (shearX, shearY);
+  ++m_revision;
 }
 
 /****************************************************************/
@@ -265,6 +423,38 @@ Mesh::addIndices (const std::vector<unsigned int>& indices)
   m_indices.insert (m_indices.end(), indices.begin (), indices.end ());
 }
 
+/// \brief Gives this Mesh a mapped .mesh file to take its geometry and
+///   indices from, instead of copying them into its internal stores.
+/// \param[in] file The mapped file, which this Mesh now owns.
+/// \pre This Mesh has not yet been prepared and has no other geometry.
+/// \post prepareVao will copy straight from the mapping into the buffers.
+void
+Mesh::addMappedGeometry (std::unique_ptr<MappedMeshFile> file)
+{
+  assert (file->isValid ());
+  assert (file->getHeader ().floatsPerVertex == getFloatsPerVertex ());
+  m_mappedFile = std::move (file);
+}
+
+/// \brief Replaces this Mesh's VBO and IBO with buffers that were already
+///   created and filled.
+/// \param[in] vbo A filled vertex buffer, which this Mesh now owns.
+/// \param[in] ibo A filled index buffer, which this Mesh now owns.
+/// \param[in] indexCount The number of indices in ibo.
+/// \pre This Mesh has not yet been prepared and has no other geometry.
+/// \post prepareVao will only build the VAO.
+void
+Mesh::adoptBuffers (GLuint vbo, GLuint ibo, unsigned int indexCount)
+{
+  assert (!m_prepared && m_vertices.empty () && !m_mappedFile);
+  m_context->deleteBuffers (1, &m_vbo);
+  m_context->deleteBuffers (1, &m_ibo);
+  m_vbo = vbo;
+  m_ibo = ibo;
+  m_indexCount = indexCount;
+  m_buffersFilled = true;
+}
+
 /// \brief Gets the number of floats used to represent each vertex.
 /// \return The number of floats used for each vertex.
 unsigned int
@@ -276,6 +466,24 @@ Mesh::getFloatsPerVertex () const
   return 6;
 }
 
+/// \brief Gets the shader features this Mesh's vertex format needs.
+/// \return A combination of ShaderFeature flags.
+unsigned int
+Mesh::getShaderFeatures () const
+{
+  // Only positions are enabled by Mesh::enableAttributes.
+  return 0;
+}
+
+/// \brief Has this Mesh pick its own shader from a set of variants.
+/// \param[in] variants The variants to choose from.
+void
+Mesh::setShaderVariants (ShaderVariants* variants)
+{
+  m_variants = variants;
+  m_shader = nullptr;
+}
+
 /// \brief Enables VAO attributes.
 /// \pre This Mesh's VAO has been bound.
 /// \post Any attributes (positions, colors, normals, texture coordinates)
@@ -289,4 +497,94 @@ Mesh::enableAttributes()
   // Positions have 3 parts, each are floats, and start at beginning of array
   m_context->vertexAttribPointer (POSITION_ATTRIB_INDEX, 3, GL_FLOAT, GL_FALSE, (getFloatsPerVertex () * sizeof(float)),
 				  reinterpret_cast<void*> (0));
-}
\ No newline at end of file
+}
+
+/****************************************************************/
+                        // PARTIAL UPDATES //
+/****************************************************************/
+
+// Sets the usage hint the buffers are created with
+void
+Mesh::setUsage (GLenum usage)
+{
+  m_usage = usage;
+}
+
+// Gets the usage hint the buffers are created with
+GLenum
+Mesh::getUsage () const
+{
+  return m_usage;
+}
+
+// Counts the vertices in this Mesh
+unsigned int
+Mesh::getVertexCount () const
+{
+  return m_vertices.size () / getFloatsPerVertex ();
+}
+
+// Counts the indices this Mesh draws
+unsigned int
+Mesh::getIndexCount () const
+{
+  return m_indexCount;
+}
+
+// Overwrites some vertices, marking them to be uploaded
+void
+Mesh::updateVertices (unsigned int firstVertex, const std::vector<float>& vertexData)
+{
+  unsigned int first = firstVertex * getFloatsPerVertex ();
+  assert (first + vertexData.size () <= m_vertices.size ());
+  std::copy (vertexData.begin (), vertexData.end (), m_vertices.begin () + first);
+  // Before prepareVao the whole store gets uploaded anyway.
+  if (m_prepared)
+    m_dirtyVertices.add (first, first + vertexData.size ());
+}
+
+// Overwrites some indices, marking them to be uploaded
+void
+Mesh::updateIndices (unsigned int firstIndex, const std::vector<unsigned int>& indices)
+{
+  assert (firstIndex + indices.size () <= m_indices.size ());
+  std::copy (indices.begin (), indices.end (), m_indices.begin () + firstIndex);
+  if (m_prepared)
+    m_dirtyIndices.add (firstIndex, firstIndex + indices.size ());
+}
+
+// Tells whether any changed data is still to be uploaded
+bool
+Mesh::hasPendingUpdates () const
+{
+  return !m_dirtyVertices.empty () || !m_dirtyIndices.empty ();
+}
+
+// Uploads just the changed parts of the buffers
+void
+Mesh::uploadDirtyRanges ()
+{
+  if (!m_dirtyVertices.empty ())
+  {
+    m_context->bindBuffer (GL_ARRAY_BUFFER, m_vbo);
+    for (const DirtyRangeSet::Range& r : m_dirtyVertices.getRanges ())
+    {
+      m_context->bufferSubData (GL_ARRAY_BUFFER, r.begin * sizeof (float),
+				(r.end - r.begin) * sizeof (float),
+				m_vertices.data () + r.begin);
+    }
+    m_dirtyVertices.clear ();
+  }
+  if (!m_dirtyIndices.empty ())
+  {
+    // The IBO binding is part of VAO state, so it is already bound.
+    for (const DirtyRangeSet::Range& r : m_dirtyIndices.getRanges ())
+    {
+      m_context->bufferSubData (GL_ELEMENT_ARRAY_BUFFER,
+				r.begin * sizeof (unsigned int),
+				(r.end - r.begin) * sizeof (unsigned int),
+				m_indices.data () + r.begin);
+    }
+    m_dirtyIndices.clear ();
+  }
+}
@@ -7,10 +7,14 @@
 #define MESH_HPP
 
 #include <vector>
+#include <memory>
 
 #include "Transform.hpp"
-#include "OpenGLContext.hpp"
+#include "DirtyRangeSet.hpp"
+#include "MeshFile.hpp"
+#include "GlContext.hpp"
 #include "ShaderProgram.hpp"
+#include "ShaderVariants.hpp"
 #include "Matrix4.hpp"
 #include "Camera.hpp"
 
@@ -25,7 +29,7 @@ public:
   ///   to make OpenGL calls.
   /// \post A unique VAO and VBO have been generated for this Mesh and stored
   ///   for later use.
-  Mesh (OpenGLContext* context, ShaderProgram* shader);
+  Mesh (GlContext* context, ShaderProgram* shader);
 
   /// \brief Destructs this Mesh.
   /// \post The VAO and VBO associated with this Mesh have been deleted.
@@ -70,6 +74,49 @@ public:
   ///   the "uModelView" uniform matrix and the geometry has been drawn.
   void
   draw (Transform viewMatrix, const Matrix4& projectionMatrix);
+
+  /// \brief Draws this Mesh as if its world transform were another one.
+  /// \param[in] viewMatrix The view matrix.
+  /// \param[in] projectionMatrix The projection matrix.
+  /// \param[in] world The world transform to draw with, usually from a
+  ///   SceneSnapshot, so this Mesh's own may be changed meanwhile.
+  /// \param[in] bones The bone palette to draw with (see copyBonePalette),
+  ///   or nullptr for a Mesh with no bones.
+  /// \pre This Mesh has been prepared.
+  void
+  draw (const Transform& viewMatrix, const Matrix4& projectionMatrix,
+	const Transform& world, const std::vector<float>* bones = nullptr);
+
+  /// \brief Does the part of drawing that needs the OpenGL context: picks
+  ///   this Mesh's shader, looks up its uniforms, and uploads any pending
+  ///   updates.  Must be called on the thread that owns the context.
+  /// \return Whether this Mesh can be drawn (its shader is linked).
+  /// \pre This Mesh has been prepared.
+  bool
+  prepareDraw ();
+
+  /// \brief Makes the calls that draw this Mesh through some context, which
+  ///   may be a CommandBufferContext being recorded on another thread.
+  ///   Touches nothing but this Mesh's own state, so Meshes may be recorded
+  ///   in parallel.
+  /// \param[in] context The context to make the calls through.
+  /// \param[in] viewMatrix The view matrix.
+  /// \param[in] projectionMatrix The projection matrix.
+  /// \param[in] world The world transform to draw with.
+  /// \param[in] bones The bone palette to draw with, or nullptr.
+  /// \pre prepareDraw has returned true.
+  void
+  recordDraw (OpenGLContext* context, const Transform& viewMatrix,
+	      const Matrix4& projectionMatrix, const Transform& world,
+	      const std::vector<float>* bones = nullptr) const;
+
+  /// \brief Copies the matrices of the bones that currently pose this
+  ///   Mesh, so that it can be drawn later from the copy.
+  /// \param[out] palette Receives 16 floats (a column-major matrix) per
+  ///   bone, or is emptied if this Mesh has no bones, as in this base
+  ///   class.
+  virtual void
+  copyBonePalette (std::vector<float>& palette) const;
   
   /*****************************************************************************/
                           //TRANSFORM FUNCTIONS START HERE//
@@ -80,6 +127,32 @@ public:
   Transform
   getWorld () const;
 
+  /// \brief Replaces the mesh's world matrix, jumping there.
+  /// \param[in] world The new world matrix.
+  /// \post The mesh's world matrix is world, and getTeleportRevision is its
+  ///   revision, so a Scene doesn't blend the jump across a frame.
+  void
+  setWorld (const Transform& world);
+
+  /// \brief Replaces the mesh's world matrix as one step of smooth motion,
+  ///   which a Scene blends into like any other move.
+  /// \param[in] world The new world matrix.
+  /// \post The mesh's world matrix is world.
+  void
+  moveTo (const Transform& world);
+
+  /// \brief Gets a number that grows whenever the mesh's world matrix (or
+  ///   anything else that changes how it looks, such as its pose) changes,
+  ///   so a renderer can tell whether anything moved.
+  /// \return The revision, which starts at 0.
+  unsigned long
+  getRevision () const;
+
+  /// \brief Gets the revision as of the last setWorld.
+  /// \return The revision, or 0 if setWorld has never been called.
+  unsigned long
+  getTeleportRevision () const;
+
   /// \brief Moves the mesh right (locally).
   /// \param[in] distance The distance to move the mesh.
   /// \post The mesh has been moved.
@@ -206,15 +279,140 @@ public:
   void
   addIndices (const std::vector<unsigned int>& indices);
 
+  /// \brief Gives this Mesh a mapped .mesh file to take its geometry and
+  ///   indices from, instead of copying them into its internal stores.
+  /// \param[in] file The mapped file.  This Mesh takes ownership of it and
+  ///   releases it once its contents have been uploaded by prepareVao.
+  /// \pre This Mesh has not yet been prepared and has no other geometry.
+  /// \pre The file is valid and its floatsPerVertex matches this Mesh's.
+  /// \post prepareVao will copy straight from the mapping into the VBO and
+  ///   IBO.  The resulting Mesh cannot be edited with updateVertices or
+  ///   updateIndices, because there is no CPU-side copy to edit.
+  void
+  addMappedGeometry (std::unique_ptr<MappedMeshFile> file);
+
+  /// \brief Replaces this Mesh's VBO and IBO with buffers that were already
+  ///   created and filled, typically by a loader thread on a shared context.
+  /// \param[in] vbo A buffer holding this Mesh's vertices, laid out as
+  ///   enableAttributes expects.  This Mesh takes ownership of it.
+  /// \param[in] ibo A buffer holding indexCount unsigned int indices.  This
+  ///   Mesh takes ownership of it.
+  /// \param[in] indexCount The number of indices in ibo.
+  /// \pre This Mesh has not yet been prepared and has no other geometry.
+  /// \pre Whatever filled the buffers has finished (its fence has signaled).
+  /// \post prepareVao only builds the VAO; it uploads nothing.  Like a
+  ///   mapped Mesh, the result cannot be edited with updateVertices or
+  ///   updateIndices.
+  void
+  adoptBuffers (GLuint vbo, GLuint ibo, unsigned int indexCount);
+
   /// \brief Gets the number of floats used to represent each vertex.
   /// \return The number of floats used for each vertex.
   virtual unsigned int
   getFloatsPerVertex () const;
 
+  /// \brief Gets the shader features this Mesh's vertex format needs.
+  /// \return A combination of ShaderFeature flags.
+  virtual unsigned int
+  getShaderFeatures () const;
+
+  /// \brief Has this Mesh pick its own shader, the first time it is drawn,
+  ///   as the variant matching getShaderFeatures.
+  /// \param[in] variants The variants to choose from.  They must outlive
+  ///   this Mesh.
+  /// \post The shader given to the constructor (if any) is no longer used.
+  void
+  setShaderVariants (ShaderVariants* variants);
+
+  /****************************************************************/
+                        // PARTIAL UPDATES //
+  /****************************************************************/
+
+  /// \brief Sets the usage hint passed to OpenGL for this Mesh's buffers.
+  /// \param[in] usage GL_STATIC_DRAW for geometry that never changes (the
+  ///   default), GL_DYNAMIC_DRAW for geometry that is edited now and then,
+  ///   or GL_STREAM_DRAW for geometry that is rewritten nearly every frame.
+  /// \pre This Mesh has not yet been prepared.
+  /// \post This Mesh's VBO and IBO will be created with that hint.
+  void
+  setUsage (GLenum usage);
+
+  /// \brief Gets the usage hint used for this Mesh's buffers.
+  /// \return The usage hint.
+  GLenum
+  getUsage () const;
+
+  /// \brief Gets the number of vertices stored in this Mesh.
+  /// \return The number of vertices.
+  unsigned int
+  getVertexCount () const;
+
+  /// \brief Gets the number of indices each draw submits.
+  /// \return The number of indices, or 0 before prepareVao.
+  unsigned int
+  getIndexCount () const;
+
+  /// \brief Overwrites the data of one or more consecutive vertices.
+  /// \param[in] firstVertex The 0-based index of the first vertex to change.
+  /// \param[in] vertexData The new data, laid out exactly like the data
+  ///   originally given to addGeometry.  It may end partway through a vertex.
+  /// \pre The vertices being overwritten already exist in this Mesh.
+  /// \post This Mesh's geometry store holds the new data.
+  /// \post If this Mesh has been prepared, the changed floats have been
+  ///   marked dirty and will be copied into the VBO at the next draw.
+  void
+  updateVertices (unsigned int firstVertex, const std::vector<float>& vertexData);
+
+  /// \brief Overwrites one or more consecutive indices.
+  /// \param[in] firstIndex The 0-based position of the first index to change.
+  /// \param[in] indices The new indices.
+  /// \pre The indices being overwritten already exist in this Mesh.
+  /// \post This Mesh's index store holds the new indices.
+  /// \post If this Mesh has been prepared, the changed indices have been
+  ///   marked dirty and will be copied into the IBO at the next draw.
+  void
+  updateIndices (unsigned int firstIndex, const std::vector<unsigned int>& indices);
+
+  /// \brief Tests whether or not any edits are waiting to be uploaded.
+  /// \return True if some vertex or index data is dirty, otherwise false.
+  bool
+  hasPendingUpdates () const;
+
 private:
 
+  /// \brief Copies every dirty range of vertex and index data into the
+  ///   VBO and IBO, then forgets about them.
+  /// \pre This Mesh's VAO is bound.
+  /// \post No vertex or index data is dirty.
+  void
+  uploadDirtyRanges ();
+
+  /// \brief Makes the calls that draw this Mesh.  A template so that draw
+  ///   calls its GlContext directly, while recordDraw accepts any context.
+  /// \param[in] context The context to make the calls through.
+  /// \param[in] viewMatrix The view matrix.
+  /// \param[in] projectionMatrix The projection matrix.
+  /// \param[in] world The world transform to draw with.
+  /// \param[in] bones The bone palette to draw with, or nullptr.
+  /// \pre prepareDraw has returned true.
+  template <typename Context>
+  void
+  issueDraw (Context* context, const Transform& viewMatrix,
+	     const Matrix4& projectionMatrix, const Transform& world,
+	     const std::vector<float>* bones) const;
+
   /// A pointer to the shader program that is being used by this mesh
   ShaderProgram* m_shader;
+  /// The variants m_shader is chosen from, or nullptr if it was given.
+  ShaderVariants* m_variants;
+  /// The shader whose uniform locations are cached below, or nullptr.
+  ShaderProgram* m_locationsShader;
+  /// The location of "uModelView" in m_locationsShader.
+  GLint m_modelViewLocation;
+  /// The location of "uProjection" in m_locationsShader.
+  GLint m_projectionLocation;
+  /// The location of "uBones" in m_locationsShader, or -1 if it has none.
+  GLint m_bonesLocation;
   /// This Mesh's VAO.
   GLuint m_vao;
   /// This Mesh's VBO.
@@ -225,19 +423,43 @@ private:
   std::vector<float> m_vertices;
   /// This Mesh's index data.
   std::vector<unsigned int> m_indices;
+  /// A mapped file holding this Mesh's geometry and indices, if they were
+  ///   loaded from one and have not yet been uploaded.
+  std::unique_ptr<MappedMeshFile> m_mappedFile;
+  /// The number of indices in the IBO, fixed when this Mesh is prepared.
+  unsigned int m_indexCount;
   /// This Mesh's VAO data.
   std::vector<GLuint> m_vaos;
   /// Whether or not this Mesh has been prepared.
   bool m_prepared;
-  /// Transforms this Mesh's local coordinates to world coordinates
+  /// Whether m_vbo and m_ibo were filled somewhere else (see adoptBuffers).
+  bool m_buffersFilled;
+  /// The usage hint used when creating the VBO and IBO.
+  GLenum m_usage;
+  /// Ranges of m_vertices (in floats) that changed since the last upload.
+  DirtyRangeSet m_dirtyVertices;
+  /// Ranges of m_indices that changed since the last upload.
+  DirtyRangeSet m_dirtyIndices;
+  /// Transforms this Mesh's local coordinates to world coordinates, or to
+  ///   its parent's coordinates if its Scene gave it one
   Transform m_world;
+  /// Counts changes to m_world (see getRevision)
+  unsigned long m_revision;
+  /// m_revision as of the last setWorld
+  unsigned long m_teleportRevision;
   /* IBO DATA MEMBER NEEDED*/
   std::vector<unsigned int> indices;
 
 protected:
 
   // A pointer to the object through which this Mesh will make OpenGL calls.
-  OpenGLContext* m_context;
+  GlContext* m_context;
+
+  /// \brief Counts a change to something other than the world matrix that
+  ///   changes how this Mesh looks.
+  /// \post getRevision has grown.
+  void
+  countChange ();
 
   /****************************************************************/
                         // MODELS ADDITIONS //
@@ -0,0 +1,110 @@
+#version 330
+/*
+  Filename: Mesh.vert
+  Authors: Gary M. Zoppetti, Ph.D., Chad Hogg & Ethan Gingrich
+  Course: CSCI375
+  Assignment: A08Model
+  Description: The vertex shader for every kind of Mesh.  Which inputs it
+    reads is chosen by #defines that ShaderVariants inserts after the
+    #version line, one combination per vertex format in use:
+      HAS_VERTEX_COLOR  a per-vertex color at location 1
+      HAS_NORMALS       a per-vertex normal at location 2, lit by one
+                        directional light
+      SKINNED           up to 4 bone indices at location 8 and their
+                        weights at location 9, blending matrices from
+                        uBones before anything else
+    With neither HAS_VERTEX_COLOR nor HAS_NORMALS every vertex is white.
+*/
+
+/*********************************************************/
+// Vertex attributes
+// Incoming position attribute for each vertex
+layout (location = 0) in vec3 aPosition;
+#ifdef HAS_VERTEX_COLOR
+// Incoming color attribute for each vertex (R, G, B)
+layout (location = 1) in vec3 aColor;
+#endif
+#ifdef HAS_NORMALS
+// Incoming normal attribute for each vertex
+layout (location = 2) in vec3 aNormal;
+#endif
+#ifdef SKINNED
+// Which entries of uBones move this vertex (stored as floats)
+layout (location = 8) in vec4 aBoneIndices;
+// How much each of them moves it; the four sum to 1, or all are 0
+layout (location = 9) in vec4 aBoneWeights;
+#endif
+
+/*********************************************************/
+// Uniforms are constant for all vertices from a single
+//   draw call.
+// Specify world and view transform for object.
+//   This matrix should contain View * World.
+uniform mat4 uModelView;
+// Specify projection
+uniform mat4 uProjection;
+
+#ifdef SKINNED
+// Must match ModelMesh::MAX_BONES.
+const int MAX_BONES = 64;
+// Each bone's matrix, taking bind-pose coordinates to the current pose's.
+uniform mat4 uBones[MAX_BONES];
+#endif
+
+#ifdef HAS_NORMALS
+// We are using a single directional light to illuminate our scene.
+// "uLightDirection" MUST point TOWARD the light source, in *eye space*.
+uniform vec3 uLightDirection = vec3 (0, 0, 1);
+// Color of the light
+uniform vec3 uLightIntensity = vec3 (0.5, 0.2, 0.1);
+#endif
+
+/*********************************************************/
+// Vertex color we will output
+out vec3 vColor;
+
+void
+main ()
+{
+  vec3 position = aPosition;
+#ifdef HAS_NORMALS
+  vec3 normal = aNormal;
+#endif
+
+#ifdef SKINNED
+  // Blend the bones' matrices, then move the vertex once.  A vertex with
+  //   no weight follows the bone in its first slot rather than collapsing
+  //   to the origin.
+  vec4 weights = aBoneWeights;
+  if (dot (weights, vec4 (1.0)) <= 0.0)
+    weights = vec4 (1.0, 0.0, 0.0, 0.0);
+  mat4 skin = uBones[int (aBoneIndices.x)] * weights.x
+    + uBones[int (aBoneIndices.y)] * weights.y
+    + uBones[int (aBoneIndices.z)] * weights.z
+    + uBones[int (aBoneIndices.w)] * weights.w;
+  position = vec3 (skin * vec4 (position, 1.0));
+#ifdef HAS_NORMALS
+  normal = mat3 (skin) * normal;
+#endif
+#endif
+
+  mat4 modelView = uModelView;
+
+  // Transform the vertex from local space to clip space
+  gl_Position = uProjection * modelView * vec4 (position, 1.0);
+
+#if defined (HAS_NORMALS)
+  // We need the inverse transpose of the upper 3x3 portion of the
+  //   model-view matrix to transform normals to eye space.
+  mat3 normalMatrix = transpose (inverse (mat3 (modelView)));
+  vec3 normalEye = normalize (normalMatrix * normal);
+  // How directly is the light shining on the surface?
+  float brightness = clamp (dot (normalEye, normalize (uLightDirection)), 0, 1);
+  vColor = brightness * uLightIntensity;
+#elif defined (HAS_VERTEX_COLOR)
+  // Just pass along the color unchanged to the next stage
+  vColor = aColor;
+#else
+  vColor = vec3 (1.0, 1.0, 1.0);
+#endif
+}
@@ -0,0 +1,90 @@
+/// \file MeshConverter.cpp
+/// \brief A command-line tool that converts any model assimp can read into
+///   the binary .mesh format that NormalsMesh can memory-map.
+/// \author Ethan Gingrich
+/// \version A08
+///
+/// Usage: MeshConverter.out inputFile outputFile.mesh [meshNum]
+/// The mesh is triangulated, given smooth normals if it lacks them, and
+///   indexed exactly as NormalsMesh would do at runtime, so converting once
+///   moves all of that work out of startup.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <assimp/scene.h>
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+
+#include "MeshFile.hpp"
+
+/// \brief Runs the converter.
+/// \param[in] argc The number of command-line arguments.
+/// \param[in] argv The input file, output file, and optional mesh number.
+/// \return EXIT_SUCCESS if the file was converted, otherwise EXIT_FAILURE.
+int
+main (int argc, char* argv[])
+{
+  if (argc != 3 && argc != 4)
+  {
+    std::cerr << "Usage: " << argv[0] << " inputFile outputFile.mesh [meshNum]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::string inputFile = argv[1];
+  std::string outputFile = argv[2];
+  unsigned int meshNum = argc == 4 ? std::stoul (argv[3]) : 0;
+
+  Assimp::Importer importer;
+  unsigned int flags =
+    aiProcess_Triangulate              // convert all shapes to triangles
+    | aiProcess_GenSmoothNormals       // create vertex normals if not there
+    | aiProcess_JoinIdenticalVertices; // combine vertices for indexing
+  const aiScene* scene = importer.ReadFile (inputFile, flags);
+  if (scene == nullptr)
+  {
+    std::cerr << "Failed to load model " << inputFile << " with error " << importer.GetErrorString () << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (meshNum >= scene->mNumMeshes)
+  {
+    std::cerr << "Could not read mesh " << meshNum << " from " << inputFile << " because it only has " << scene->mNumMeshes << " meshes." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Interleaved position / normal, the layout NormalsMesh uses.
+  const unsigned int FLOATS_PER_VERTEX = 6;
+  const aiMesh* mesh = scene->mMeshes[meshNum];
+  std::vector<float> vertexData;
+  vertexData.reserve (mesh->mNumVertices * FLOATS_PER_VERTEX);
+  for (unsigned int vertexNum = 0; vertexNum < mesh->mNumVertices; ++vertexNum)
+  {
+    vertexData.push_back (mesh->mVertices[vertexNum].x);
+    vertexData.push_back (mesh->mVertices[vertexNum].y);
+    vertexData.push_back (mesh->mVertices[vertexNum].z);
+    vertexData.push_back (mesh->mNormals[vertexNum].x);
+    vertexData.push_back (mesh->mNormals[vertexNum].y);
+    vertexData.push_back (mesh->mNormals[vertexNum].z);
+  }
+  std::vector<unsigned int> indexes;
+  indexes.reserve (mesh->mNumFaces * 3);
+  for (unsigned int faceNum = 0; faceNum < mesh->mNumFaces; ++faceNum)
+  {
+    const aiFace& face = mesh->mFaces[faceNum];
+    for (unsigned int indexNum = 0; indexNum < 3; ++indexNum)
+      indexes.push_back (face.mIndices[indexNum]);
+  }
+
+  const std::vector<MeshFileAttribute> layout
+  {
+    { 0, 3, 0 }, // position
+    { 2, 3, 3 }  // normal
+  };
+  if (!writeMeshFile (outputFile, vertexData, indexes, FLOATS_PER_VERTEX, layout))
+    return EXIT_FAILURE;
+
+  std::cout << "Wrote " << mesh->mNumVertices << " vertices and "
+	    << mesh->mNumFaces << " triangles to " << outputFile << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,172 @@
+/// \file MeshFile.cpp
+/// \brief Definitions of MappedMeshFile member and associated global
+///   functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "MeshFile.hpp"
+
+/// \brief Rounds a byte offset up to the next MESH_FILE_ALIGNMENT boundary.
+/// \param[in] offset The offset to round.
+/// \return The smallest aligned offset that is not less than offset.
+static uint64_t
+alignOffset (uint64_t offset)
+{
+  return (offset + MESH_FILE_ALIGNMENT - 1) / MESH_FILE_ALIGNMENT * MESH_FILE_ALIGNMENT;
+}
+
+bool
+writeMeshFile (const std::string& fileName, const std::vector<float>& vertices,
+	       const std::vector<unsigned int>& indices,
+	       unsigned int floatsPerVertex,
+	       const std::vector<MeshFileAttribute>& attributes)
+{
+  if (floatsPerVertex < 3 || vertices.size () % floatsPerVertex != 0
+      || attributes.size () > MESH_FILE_MAX_ATTRIBUTES)
+  {
+    std::cerr << "Refusing to write malformed mesh to " << fileName << std::endl;
+    return false;
+  }
+
+  MeshFileHeader header;
+  std::memset (&header, 0, sizeof (header));
+  header.magic = MESH_FILE_MAGIC;
+  header.version = MESH_FILE_VERSION;
+  header.headerSize = sizeof (MeshFileHeader);
+  header.floatsPerVertex = floatsPerVertex;
+  header.vertexCount = vertices.size () / floatsPerVertex;
+  header.indexCount = indices.size ();
+  header.attributeCount = attributes.size ();
+  std::copy (attributes.begin (), attributes.end (), header.attributes);
+
+  for (unsigned int part = 0; part < 3; ++part)
+  {
+    header.boundsMin[part] = header.vertexCount > 0 ? vertices[part] : 0.0f;
+    header.boundsMax[part] = header.boundsMin[part];
+  }
+  for (unsigned int v = 0; v < header.vertexCount; ++v)
+  {
+    for (unsigned int part = 0; part < 3; ++part)
+    {
+      float value = vertices[v * floatsPerVertex + part];
+      header.boundsMin[part] = std::min (header.boundsMin[part], value);
+      header.boundsMax[part] = std::max (header.boundsMax[part], value);
+    }
+  }
+
+  header.vertexOffset = alignOffset (sizeof (MeshFileHeader));
+  header.vertexBytes = vertices.size () * sizeof (float);
+  header.indexOffset = alignOffset (header.vertexOffset + header.vertexBytes);
+  header.indexBytes = indices.size () * sizeof (unsigned int);
+
+  std::ofstream out (fileName, std::ios::binary | std::ios::trunc);
+  if (!out)
+  {
+    std::cerr << "Could not open " << fileName << " for writing" << std::endl;
+    return false;
+  }
+  const char padding[MESH_FILE_ALIGNMENT] = { 0 };
+  out.write (reinterpret_cast<const char*> (&header), sizeof (header));
+  out.write (padding, header.vertexOffset - sizeof (header));
+  out.write (reinterpret_cast<const char*> (vertices.data ()), header.vertexBytes);
+  out.write (padding, header.indexOffset - header.vertexOffset - header.vertexBytes);
+  out.write (reinterpret_cast<const char*> (indices.data ()), header.indexBytes);
+  if (!out)
+  {
+    std::cerr << "Failed while writing " << fileName << std::endl;
+    return false;
+  }
+  return true;
+}
+
+MappedMeshFile::MappedMeshFile (const std::string& fileName)
+  : m_data (nullptr), m_size (0)
+{
+  int fd = open (fileName.c_str (), O_RDONLY);
+  if (fd < 0)
+  {
+    std::cerr << "Failed to open mesh file " << fileName << std::endl;
+    return;
+  }
+  struct stat info;
+  if (fstat (fd, &info) != 0 || static_cast<size_t> (info.st_size) < sizeof (MeshFileHeader))
+  {
+    std::cerr << "Mesh file " << fileName << " is too small" << std::endl;
+    close (fd);
+    return;
+  }
+  void* mapping = mmap (nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps its own reference to the file.
+  close (fd);
+  if (mapping == MAP_FAILED)
+  {
+    std::cerr << "Failed to map mesh file " << fileName << std::endl;
+    return;
+  }
+  m_data = static_cast<const unsigned char*> (mapping);
+  m_size = info.st_size;
+
+  const MeshFileHeader& header = getHeader ();
+  bool valid = header.magic == MESH_FILE_MAGIC
+    && header.version == MESH_FILE_VERSION
+    && header.headerSize == sizeof (MeshFileHeader)
+    && header.floatsPerVertex >= 3
+    && header.attributeCount <= MESH_FILE_MAX_ATTRIBUTES
+    && header.vertexBytes == uint64_t (header.vertexCount) * header.floatsPerVertex * sizeof (float)
+    && header.indexBytes == uint64_t (header.indexCount) * sizeof (unsigned int)
+    && header.vertexOffset % MESH_FILE_ALIGNMENT == 0
+    && header.indexOffset % MESH_FILE_ALIGNMENT == 0
+    && header.vertexOffset + header.vertexBytes <= m_size
+    && header.indexOffset + header.indexBytes <= m_size;
+  if (!valid)
+  {
+    std::cerr << fileName << " is not a valid version " << MESH_FILE_VERSION
+	      << " mesh file" << std::endl;
+    munmap (mapping, m_size);
+    m_data = nullptr;
+    m_size = 0;
+    return;
+  }
+  // We are about to hand all of it to the driver, so start paging it in.
+  madvise (mapping, m_size, MADV_WILLNEED);
+}
+
+MappedMeshFile::~MappedMeshFile ()
+{
+  if (m_data != nullptr)
+    munmap (const_cast<unsigned char*> (m_data), m_size);
+}
+
+bool
+MappedMeshFile::isValid () const
+{
+  return m_data != nullptr;
+}
+
+const MeshFileHeader&
+MappedMeshFile::getHeader () const
+{
+  return *reinterpret_cast<const MeshFileHeader*> (m_data);
+}
+
+const float*
+MappedMeshFile::getVertexData () const
+{
+  return reinterpret_cast<const float*> (m_data + getHeader ().vertexOffset);
+}
+
+const unsigned int*
+MappedMeshFile::getIndexData () const
+{
+  return reinterpret_cast<const unsigned int*> (m_data + getHeader ().indexOffset);
+}
@@ -0,0 +1,151 @@
+/// \file MeshFile.hpp
+/// \brief Declaration of the binary mesh file format, the MappedMeshFile
+///   class, and associated global functions.
+/// \author Ethan Gingrich
+/// \version A08
+///
+/// A .mesh file is an already-indexed mesh stored exactly the way OpenGL
+///   wants it, so that loading it is just a matter of mapping it into memory
+///   and handing the pointers to glBufferData.  The layout is:
+///   [ MeshFileHeader | padding | vertex blob | padding | index blob ]
+/// Both blobs start on a MESH_FILE_ALIGNMENT boundary.  The vertex blob is
+///   interleaved floats (floatsPerVertex per vertex) and the index blob is
+///   32-bit unsigned ints.  Everything is stored in the byte order of the
+///   machine that wrote it; a reader on a different byte order will reject
+///   the file because the magic number won't match.
+
+#ifndef MESH_FILE_HPP
+#define MESH_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// The first four bytes of every .mesh file.
+const uint32_t MESH_FILE_MAGIC = 0x4853454D; // "MESH" read little-endian
+/// The version of the format written by this code.  Bump it whenever
+///   MeshFileHeader changes.
+const uint32_t MESH_FILE_VERSION = 1;
+/// The alignment, in bytes, of the vertex and index blobs.
+const uint32_t MESH_FILE_ALIGNMENT = 64;
+/// The most vertex attributes a .mesh file can describe.
+const uint32_t MESH_FILE_MAX_ATTRIBUTES = 4;
+
+/// \brief Describes one interleaved vertex attribute in a .mesh file.
+struct MeshFileAttribute
+{
+  /// The shader attribute index (0 = position, 1 = color, 2 = normal).
+  uint32_t index;
+  /// The number of floats in the attribute.
+  uint32_t components;
+  /// The offset of the attribute within a vertex, in floats.
+  uint32_t offset;
+};
+
+/// \brief The fixed-size header at the start of every .mesh file.
+struct MeshFileHeader
+{
+  /// Must be MESH_FILE_MAGIC.
+  uint32_t magic;
+  /// Must be MESH_FILE_VERSION.
+  uint32_t version;
+  /// sizeof (MeshFileHeader) when the file was written.
+  uint32_t headerSize;
+  /// The number of floats used to represent each vertex.
+  uint32_t floatsPerVertex;
+  /// The number of vertices in the vertex blob.
+  uint32_t vertexCount;
+  /// The number of indices in the index blob.
+  uint32_t indexCount;
+  /// The number of used entries in attributes.
+  uint32_t attributeCount;
+  /// Unused; always 0.
+  uint32_t reserved;
+  /// The layout of each vertex.
+  MeshFileAttribute attributes[MESH_FILE_MAX_ATTRIBUTES];
+  /// The smallest X, Y, and Z of any vertex position.
+  float boundsMin[3];
+  /// The largest X, Y, and Z of any vertex position.
+  float boundsMax[3];
+  /// The byte offset of the vertex blob from the start of the file.
+  uint64_t vertexOffset;
+  /// The size of the vertex blob in bytes.
+  uint64_t vertexBytes;
+  /// The byte offset of the index blob from the start of the file.
+  uint64_t indexOffset;
+  /// The size of the index blob in bytes.
+  uint64_t indexBytes;
+};
+
+/// \brief Writes an indexed mesh to a .mesh file.
+/// \param[in] fileName The name of the file to create / truncate.
+/// \param[in] vertices Interleaved vertex data, floatsPerVertex per vertex.
+///   The first three floats of each vertex must be its position.
+/// \param[in] indices Indices into vertices, 3 per triangle.
+/// \param[in] floatsPerVertex The number of floats used for each vertex.
+/// \param[in] attributes The layout of each vertex.
+/// \return True if the file was written, otherwise false (and an error
+///   message has been printed).
+bool
+writeMeshFile (const std::string& fileName, const std::vector<float>& vertices,
+	       const std::vector<unsigned int>& indices,
+	       unsigned int floatsPerVertex,
+	       const std::vector<MeshFileAttribute>& attributes);
+
+/// \brief A read-only view of a .mesh file that has been mapped into memory.
+/// Nothing is parsed or copied: the vertex and index pointers point straight
+///   into the mapping and stay valid until the MappedMeshFile is destroyed.
+class MappedMeshFile
+{
+public:
+
+  /// \brief Maps a .mesh file into memory and validates its header.
+  /// \param[in] fileName The name of the file to map.
+  /// \post If the file exists and is a valid .mesh file, isValid () returns
+  ///   true.  Otherwise nothing is mapped and an error message has been
+  ///   printed.
+  MappedMeshFile (const std::string& fileName);
+
+  /// \brief Unmaps the file.
+  ~MappedMeshFile ();
+
+  /// \brief Copy constructor removed because a mapping has a single owner.
+  MappedMeshFile (const MappedMeshFile&) = delete;
+
+  /// \brief Assignment operator removed because a mapping has a single owner.
+  MappedMeshFile&
+  operator= (const MappedMeshFile&) = delete;
+
+  /// \brief Tests whether or not the file was mapped and validated.
+  /// \return True if the file can be used, otherwise false.
+  bool
+  isValid () const;
+
+  /// \brief Gets the file's header.
+  /// \return The header.
+  /// \pre isValid () is true.
+  const MeshFileHeader&
+  getHeader () const;
+
+  /// \brief Gets the interleaved vertex data.
+  /// \return A pointer to header.vertexBytes bytes of vertex data.
+  /// \pre isValid () is true.
+  const float*
+  getVertexData () const;
+
+  /// \brief Gets the index data.
+  /// \return A pointer to header.indexCount indices.
+  /// \pre isValid () is true.
+  const unsigned int*
+  getIndexData () const;
+
+private:
+
+  /// The start of the mapping, or nullptr if nothing is mapped.
+  const unsigned char* m_data;
+  /// The length of the mapping in bytes.
+  size_t m_size;
+};
+
+#endif//MESH_FILE_HPP
@@ -0,0 +1,344 @@
+/// \file ModelLoader.cpp
+/// \brief Definitions of ModelLoader member and associated global functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+
+#include <assimp/scene.h>
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+
+#include "CpuProfiler.hpp"
+#include "JobSystem.hpp"
+#include "ModelLoader.hpp"
+#include "ObjReader.hpp"
+
+const unsigned int ModelMesh::MAX_BONES;
+const unsigned int ModelMesh::BONES_PER_VERTEX;
+
+/// \brief Converts an assimp matrix into one of our Transforms.
+/// \param[in] m The matrix, which must be affine.
+/// \return The same transformation.
+static Transform
+toTransform (const aiMatrix4x4& m)
+{
+  Transform t;
+  t.setOrientation (Vector3 (m.a1, m.b1, m.c1), Vector3 (m.a2, m.b2, m.c2),
+		    Vector3 (m.a3, m.b3, m.c3));
+  t.setPosition (m.a4, m.b4, m.c4);
+  return t;
+}
+
+/// \brief Copies the bones of one assimp mesh, and which of them each vertex
+///   follows.
+/// \param[in] mesh The assimp mesh, which has bones.
+/// \param[in] nodesByName The position in Model::nodes of every named node.
+/// \param[out] out The mesh to fill in.
+static void
+buildBones (const aiMesh* mesh, const std::map<std::string, unsigned int>& nodesByName,
+	    ModelMesh& out)
+{
+  const unsigned int PER_VERTEX = ModelMesh::BONES_PER_VERTEX;
+  unsigned int boneCount = std::min (mesh->mNumBones, ModelMesh::MAX_BONES);
+  if (boneCount < mesh->mNumBones)
+    std::cerr << "Mesh " << out.name << " has " << mesh->mNumBones << " bones; only the first " << boneCount << " will move it." << std::endl;
+
+  out.bones.resize (boneCount);
+  out.skinning.assign (mesh->mNumVertices * PER_VERTEX * 2, 0.0f);
+  for (unsigned int boneNum = 0; boneNum < boneCount; ++boneNum)
+  {
+    const aiBone* bone = mesh->mBones[boneNum];
+    ModelBone& outBone = out.bones[boneNum];
+    outBone.name = bone->mName.C_Str ();
+    std::map<std::string, unsigned int>::const_iterator node = nodesByName.find (outBone.name);
+    outBone.node = node != nodesByName.end () ? node->second : 0;
+    if (node == nodesByName.end ())
+      std::cerr << "Mesh " << out.name << " has bone " << outBone.name << " with no node of that name; it will follow the root." << std::endl;
+    outBone.offset = toTransform (bone->mOffsetMatrix);
+
+    for (unsigned int weightNum = 0; weightNum < bone->mNumWeights; ++weightNum)
+    {
+      // Keep the heaviest PER_VERTEX influences, replacing the lightest.
+      const aiVertexWeight& weight = bone->mWeights[weightNum];
+      float* indices = &out.skinning[weight.mVertexId * PER_VERTEX * 2];
+      float* weights = indices + PER_VERTEX;
+      float* lightest = std::min_element (weights, weights + PER_VERTEX);
+      if (weight.mWeight > *lightest)
+      {
+	*lightest = weight.mWeight;
+	indices[lightest - weights] = boneNum;
+      }
+    }
+  }
+
+  for (unsigned int vertexNum = 0; vertexNum < mesh->mNumVertices; ++vertexNum)
+  {
+    // Dropped influences would otherwise shrink the vertex toward the
+    //   origin, as would having none at all, so a vertex no bone moves
+    //   follows the first.
+    float* indices = &out.skinning[vertexNum * PER_VERTEX * 2];
+    float* weights = indices + PER_VERTEX;
+    float total = 0.0f;
+    for (unsigned int slot = 0; slot < PER_VERTEX; ++slot)
+      total += weights[slot];
+    if (total > 0.0f)
+      for (unsigned int slot = 0; slot < PER_VERTEX; ++slot)
+	weights[slot] /= total;
+    else
+    {
+      indices[0] = 0.0f;
+      weights[0] = 1.0f;
+    }
+  }
+}
+
+/// \brief Copies one assimp animation, converting its times to seconds.
+/// \param[in] animation The assimp animation.
+/// \param[in] nodesByName The position in Model::nodes of every named node.
+/// \return The clip.  Channels for nodes that don't exist are dropped.
+static AnimationClip
+buildClip (const aiAnimation* animation,
+	   const std::map<std::string, unsigned int>& nodesByName)
+{
+  // Files that don't say how fast their ticks are mostly mean 25 a second.
+  const double DEFAULT_TICKS_PER_SECOND = 25.0;
+  double ticksPerSecond = animation->mTicksPerSecond > 0.0
+    ? animation->mTicksPerSecond : DEFAULT_TICKS_PER_SECOND;
+  AnimationClip clip (animation->mName.C_Str (),
+		      static_cast<float> (animation->mDuration / ticksPerSecond));
+  for (unsigned int channelNum = 0; channelNum < animation->mNumChannels; ++channelNum)
+  {
+    const aiNodeAnim* source = animation->mChannels[channelNum];
+    std::map<std::string, unsigned int>::const_iterator node =
+      nodesByName.find (source->mNodeName.C_Str ());
+    if (node == nodesByName.end ())
+      continue;
+
+    AnimationChannel channel;
+    channel.node = node->second;
+    for (unsigned int keyNum = 0; keyNum < source->mNumPositionKeys; ++keyNum)
+    {
+      const aiVectorKey& key = source->mPositionKeys[keyNum];
+      channel.positionKeys.push_back ({ static_cast<float> (key.mTime / ticksPerSecond),
+					Vector3 (key.mValue.x, key.mValue.y, key.mValue.z) });
+    }
+    for (unsigned int keyNum = 0; keyNum < source->mNumRotationKeys; ++keyNum)
+    {
+      const aiQuatKey& key = source->mRotationKeys[keyNum];
+      channel.rotationKeys.push_back ({ static_cast<float> (key.mTime / ticksPerSecond),
+					Quaternion (key.mValue.w, key.mValue.x,
+						    key.mValue.y, key.mValue.z) });
+    }
+    for (unsigned int keyNum = 0; keyNum < source->mNumScalingKeys; ++keyNum)
+    {
+      const aiVectorKey& key = source->mScalingKeys[keyNum];
+      channel.scaleKeys.push_back ({ static_cast<float> (key.mTime / ticksPerSecond),
+				     Vector3 (key.mValue.x, key.mValue.y, key.mValue.z) });
+    }
+    clip.addChannel (channel);
+  }
+  return clip;
+}
+
+/// \brief Copies one assimp mesh into the interleaved position / normal
+///   layout NormalsMesh uses.
+/// \param[in] mesh The (triangulated) assimp mesh.
+/// \param[in] nodesByName The position in Model::nodes of every named node,
+///   which bones are matched against.
+/// \param[out] out The mesh to fill in.
+static void
+buildMesh (const aiMesh* mesh, const std::map<std::string, unsigned int>& nodesByName,
+	   ModelMesh& out)
+{
+  out.name = mesh->mName.C_Str ();
+  out.vertices.resize (mesh->mNumVertices * 6);
+  float* vertex = out.vertices.data ();
+  for (unsigned int vertexNum = 0; vertexNum < mesh->mNumVertices; ++vertexNum)
+  {
+    *vertex++ = mesh->mVertices[vertexNum].x;
+    *vertex++ = mesh->mVertices[vertexNum].y;
+    *vertex++ = mesh->mVertices[vertexNum].z;
+    *vertex++ = mesh->mNormals[vertexNum].x;
+    *vertex++ = mesh->mNormals[vertexNum].y;
+    *vertex++ = mesh->mNormals[vertexNum].z;
+  }
+  out.indices.resize (mesh->mNumFaces * 3);
+  unsigned int* index = out.indices.data ();
+  for (unsigned int faceNum = 0; faceNum < mesh->mNumFaces; ++faceNum)
+  {
+    const aiFace& face = mesh->mFaces[faceNum];
+    for (unsigned int indexNum = 0; indexNum < 3; ++indexNum)
+      *index++ = face.mIndices[indexNum];
+  }
+  if (mesh->HasBones ())
+    buildBones (mesh, nodesByName, out);
+}
+
+ModelLoader::ModelLoader ()
+  : m_parseCount (0), m_cacheHits (0), m_loadSeconds (0.0), m_useNativeObj (true)
+{
+}
+
+ModelLoader&
+ModelLoader::getInstance ()
+{
+  static ModelLoader instance;
+  return instance;
+}
+
+const Model*
+ModelLoader::load (const std::string& fileName)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  // A thread asking for a file another is importing waits for it rather
+  //   than parsing it again; different files import in parallel.
+  m_imported.wait (lock, [this, &fileName] () { return m_importing.count (fileName) == 0; });
+  std::map<std::string, std::unique_ptr<Model>>::iterator itr = m_models.find (fileName);
+  if (itr != m_models.end ())
+  {
+    ++m_cacheHits;
+    return itr->second.get ();
+  }
+  m_importing.insert (fileName);
+  bool useNativeObj = m_useNativeObj;
+  lock.unlock ();
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  std::unique_ptr<Model> model = import (fileName, useNativeObj);
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now () - start;
+
+  lock.lock ();
+  ++m_parseCount;
+  m_loadSeconds += elapsed.count ();
+  // Failures are cached too, so a bad file is only reported once.
+  const Model* result = model.get ();
+  m_models[fileName] = std::move (model);
+  m_importing.erase (fileName);
+  m_imported.notify_all ();
+  return result;
+}
+
+void
+ModelLoader::setUseNativeObjReader (bool useNative)
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  m_useNativeObj = useNative;
+}
+
+void
+ModelLoader::clear ()
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  m_models.clear ();
+}
+
+unsigned int
+ModelLoader::getParseCount () const
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  return m_parseCount;
+}
+
+unsigned int
+ModelLoader::getCacheHitCount () const
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  return m_cacheHits;
+}
+
+double
+ModelLoader::getLoadSeconds () const
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  return m_loadSeconds;
+}
+
+std::unique_ptr<Model>
+ModelLoader::import (const std::string& fileName, bool useNativeObj)
+{
+  PROFILE_ZONE ("ModelLoader::import");
+  const std::string OBJ_EXTENSION = ".obj";
+  if (useNativeObj && fileName.size () >= OBJ_EXTENSION.size ()
+      && fileName.compare (fileName.size () - OBJ_EXTENSION.size (),
+			   OBJ_EXTENSION.size (), OBJ_EXTENSION) == 0)
+  {
+    std::unique_ptr<Model> model (new Model ());
+    model->fileName = fileName;
+    if (!readObj (fileName, model->meshes))
+      return nullptr;
+    // OBJ has no hierarchy, so every mesh hangs off a single root.
+    ModelNode root;
+    root.parent = -1;
+    for (unsigned int meshNum = 0; meshNum < model->meshes.size (); ++meshNum)
+      root.meshes.push_back (meshNum);
+    model->nodes.push_back (root);
+    return model;
+  }
+
+  // Importers aren't thread-safe, so each thread keeps its own, along
+  //   with the memory it reuses between files.
+  static thread_local Assimp::Importer importer;
+  unsigned int flags =
+    aiProcess_Triangulate              // convert all shapes to triangles
+    | aiProcess_GenSmoothNormals       // create vertex normals if not there
+    | aiProcess_JoinIdenticalVertices  // combine vertices for indexing
+    | aiProcess_LimitBoneWeights;      // at most 4 bones per vertex
+  const aiScene* scene = importer.ReadFile (fileName, flags);
+  if (scene == nullptr)
+  {
+    std::cerr << "Failed to load model " << fileName << " with error " << importer.GetErrorString () << std::endl;
+    return nullptr;
+  }
+
+  std::unique_ptr<Model> model (new Model ());
+  model->fileName = fileName;
+
+  // Flatten the hierarchy depth-first so parents precede their children,
+  //   which lets world transforms be computed in a single pass.
+  std::vector<std::pair<const aiNode*, int>> stack;
+  if (scene->mRootNode != nullptr)
+    stack.push_back (std::make_pair (scene->mRootNode, -1));
+  while (!stack.empty ())
+  {
+    const aiNode* node = stack.back ().first;
+    int parent = stack.back ().second;
+    stack.pop_back ();
+
+    ModelNode out;
+    out.name = node->mName.C_Str ();
+    out.parent = parent;
+    out.local = toTransform (node->mTransformation);
+    out.world = parent < 0 ? out.local : model->nodes[parent].world * out.local;
+    out.meshes.assign (node->mMeshes, node->mMeshes + node->mNumMeshes);
+    model->nodes.push_back (out);
+
+    int self = model->nodes.size () - 1;
+    // Pushed in reverse so children come out in the file's order.
+    for (unsigned int child = node->mNumChildren; child > 0; --child)
+      stack.push_back (std::make_pair (node->mChildren[child - 1], self));
+  }
+
+  // Bones and animation channels name the nodes they move.
+  std::map<std::string, unsigned int> nodesByName;
+  for (unsigned int nodeNum = 0; nodeNum < model->nodes.size (); ++nodeNum)
+    nodesByName.insert (std::make_pair (model->nodes[nodeNum].name, nodeNum));
+  for (unsigned int animationNum = 0; animationNum < scene->mNumAnimations; ++animationNum)
+    model->animations.emplace_back (buildClip (scene->mAnimations[animationNum], nodesByName));
+
+  // Build every mesh at once, one job per mesh, so one huge mesh doesn't
+  //   hold up a batch of small ones.
+  model->meshes.resize (scene->mNumMeshes);
+  JobSystem::getShared ().parallelFor (scene->mNumMeshes, 1, [&] (size_t begin, size_t end)
+  {
+    for (size_t meshNum = begin; meshNum < end; ++meshNum)
+      buildMesh (scene->mMeshes[meshNum], nodesByName, model->meshes[meshNum]);
+  });
+
+  // Everything is copied out, so the importer needn't hold the scene until
+  //   this thread's next import.
+  importer.FreeScene ();
+  return model;
+}
@@ -0,0 +1,180 @@
+/// \file ModelLoader.hpp
+/// \brief Declaration of ModelLoader class and the plain data types it
+///   produces.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef MODEL_LOADER_HPP
+#define MODEL_LOADER_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <set>
+
+#include "CompressedClip.hpp"
+#include "Transform.hpp"
+
+/// \brief One bone that deforms a mesh.
+struct ModelBone
+{
+  /// The name of the node the bone follows.
+  std::string name;
+  /// The position of that node in Model::nodes.
+  unsigned int node;
+  /// Transforms the mesh's coordinates to the bone's, in the bind pose.
+  Transform offset;
+};
+
+/// \brief The CPU-side data for one mesh of a model, already indexed and in
+///   the interleaved position / normal layout NormalsMesh uses.
+struct ModelMesh
+{
+  /// The most bones one mesh may have.  Mesh.vert's uBones array is this
+  ///   long.
+  static const unsigned int MAX_BONES = 64;
+  /// The most bones one vertex may follow.
+  static const unsigned int BONES_PER_VERTEX = 4;
+
+  /// The name the file gave this mesh (may be empty).
+  std::string name;
+  /// Interleaved position / normal data, 6 floats per vertex.
+  std::vector<float> vertices;
+  /// Indices into vertices, 3 per triangle.
+  std::vector<unsigned int> indices;
+  /// The bones that deform this mesh, or empty if it is rigid.
+  std::vector<ModelBone> bones;
+  /// For each vertex, the positions in bones of the bones it follows and
+  ///   then how much it follows each, BONES_PER_VERTEX of each, with the
+  ///   weights summing to 1.  Indices are stored as floats so they can
+  ///   share a VBO with the rest of the vertex.  Empty if bones is.
+  std::vector<float> skinning;
+};
+
+/// \brief One node of a model's hierarchy.
+struct ModelNode
+{
+  /// The name the file gave this node (may be empty).
+  std::string name;
+  /// The position of this node's parent in Model::nodes, or -1 for the root.
+  int parent;
+  /// Transforms this node's coordinates to its parent's coordinates.
+  Transform local;
+  /// Transforms this node's coordinates to the model's coordinates.
+  Transform world;
+  /// Positions in Model::meshes of the meshes drawn at this node.
+  std::vector<unsigned int> meshes;
+};
+
+/// \brief Everything that was read from a model file.
+struct Model
+{
+  /// The name of the file the model was read from.
+  std::string fileName;
+  /// Every mesh in the file, in the file's order.
+  std::vector<ModelMesh> meshes;
+  /// Every node in the file, in depth-first order, so a node's parent
+  ///   always comes before it.
+  std::vector<ModelNode> nodes;
+  /// Every animation in the file, which move the nodes, compressed as they
+  ///   were read.
+  std::vector<CompressedClip> animations;
+};
+
+/// \brief Imports model files, exactly once per file.  OBJ files go through
+///   our own reader (see ObjReader.hpp); everything else goes through assimp.
+/// Every mesh in a file is built at the same time on several threads, and
+///   the result is cached by file name so later requests for any mesh of
+///   the same file cost only a map lookup.
+class ModelLoader
+{
+public:
+
+  /// \brief Constructs a ModelLoader with an empty cache.
+  ModelLoader ();
+
+  /// \brief Copy constructor removed because you shouldn't be copying
+  ///   caches.
+  ModelLoader (const ModelLoader&) = delete;
+
+  /// \brief Assignment operator removed because you shouldn't be assigning
+  ///   caches.
+  ModelLoader&
+  operator= (const ModelLoader&) = delete;
+
+  /// \brief Gets the ModelLoader shared by everything that loads models
+  ///   without being handed a specific one.
+  /// \return The shared ModelLoader.
+  static ModelLoader&
+  getInstance ();
+
+  /// \brief Gets a model, importing it if it is not already cached.
+  /// \param[in] fileName The name of the file to read.
+  /// \return A pointer to the model, which stays valid until the cache is
+  ///   cleared, or nullptr if the file could not be imported (in which case
+  ///   an error message has been printed).
+  /// Safe to call from several threads at once.
+  const Model*
+  load (const std::string& fileName);
+
+  /// \brief Chooses how OBJ files are read.
+  /// \param[in] useNative True to read them with the multithreaded reader in
+  ///   ObjReader.hpp (the default), false to read them with assimp like
+  ///   every other format.
+  /// \post Later imports of OBJ files use the chosen reader.  Models that are
+  ///   already cached are not affected.
+  void
+  setUseNativeObjReader (bool useNative);
+
+  /// \brief Forgets every cached model.
+  /// \post Every pointer returned by load is invalid.
+  void
+  clear ();
+
+  /// \brief Gets the number of times a file has actually been parsed.
+  /// \return The number of imports performed.
+  unsigned int
+  getParseCount () const;
+
+  /// \brief Gets the number of load requests answered from the cache.
+  /// \return The number of cache hits.
+  unsigned int
+  getCacheHitCount () const;
+
+  /// \brief Gets the total time spent importing and building models.
+  /// \return The time in seconds.
+  double
+  getLoadSeconds () const;
+
+private:
+
+  /// \brief Imports a file and builds a Model from it.  Called without the
+  ///   lock held.
+  /// \param[in] fileName The name of the file to read.
+  /// \param[in] useNativeObj Whether OBJ files are read by ObjReader.
+  /// \return The model, or nullptr if it could not be imported.
+  static std::unique_ptr<Model>
+  import (const std::string& fileName, bool useNativeObj);
+
+  /// Guards every member below.
+  mutable std::mutex m_mutex;
+  /// Wakes threads waiting for a file another thread is importing.
+  std::condition_variable m_imported;
+  /// The cached models, keyed by file name.
+  std::map<std::string, std::unique_ptr<Model>> m_models;
+  /// The files being imported right now.
+  std::set<std::string> m_importing;
+  /// The number of imports performed.
+  unsigned int m_parseCount;
+  /// The number of cache hits.
+  unsigned int m_cacheHits;
+  /// The total time spent importing, in seconds.
+  double m_loadSeconds;
+  /// Whether OBJ files are read by ObjReader rather than assimp.
+  bool m_useNativeObj;
+};
+
+#endif//MODEL_LOADER_HPP
@@ -0,0 +1,112 @@
+/// \file MpscQueue.hpp
+/// \brief Declaration and definition of the MpscQueue class template.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef MPSC_QUEUE_HPP
+#define MPSC_QUEUE_HPP
+
+#include <atomic>
+#include <utility>
+
+/// \brief An unbounded lock-free queue that any number of threads may push
+///   onto but only one thread may pop from.
+/// Pushing is a single atomic exchange, so producers never wait on each
+///   other or on the consumer.  This is Dmitry Vyukov's intrusive MPSC
+///   queue, with the value stored alongside each link.
+/// \tparam T The type of value stored.  It must be default-constructible
+///   and movable.
+template<typename T>
+class MpscQueue
+{
+public:
+
+  /// \brief Constructs an empty queue.
+  MpscQueue ()
+    : m_head (new Node ()), m_tail (m_head.load ())
+  {
+  }
+
+  /// \brief Destructs the queue and anything still in it.
+  ~MpscQueue ()
+  {
+    T discarded;
+    while (tryPop (discarded))
+    {
+    }
+    delete m_tail;
+  }
+
+  /// \brief Copy constructor removed because queues can't be copied safely.
+  MpscQueue (const MpscQueue&) = delete;
+
+  /// \brief Assignment operator removed because queues can't be assigned
+  ///   safely.
+  MpscQueue&
+  operator= (const MpscQueue&) = delete;
+
+  /// \brief Adds a value to the back of the queue.  Safe to call from any
+  ///   thread.
+  /// \param[in] value The value, which is moved into the queue.
+  void
+  push (T value)
+  {
+    Node* node = new Node ();
+    node->value = std::move (value);
+    Node* previous = m_head.exchange (node, std::memory_order_acq_rel);
+    // Until this store the consumer sees the queue as ending at previous.
+    previous->next.store (node, std::memory_order_release);
+  }
+
+  /// \brief Removes the value at the front of the queue, if any.  Must only
+  ///   be called from the single consumer thread.
+  /// \param[out] value Receives the value that was removed.
+  /// \return True if a value was removed, or false if the queue was empty
+  ///   (or a push is still halfway done).
+  bool
+  tryPop (T& value)
+  {
+    Node* tail = m_tail;
+    Node* next = tail->next.load (std::memory_order_acquire);
+    if (next == nullptr)
+      return false;
+    value = std::move (next->value);
+    // next becomes the new placeholder node.
+    m_tail = next;
+    delete tail;
+    return true;
+  }
+
+  /// \brief Tests whether the queue looks empty.  Must only be called from
+  ///   the consumer thread.
+  /// \return True if tryPop would currently fail.
+  bool
+  empty () const
+  {
+    return m_tail->next.load (std::memory_order_acquire) == nullptr;
+  }
+
+private:
+
+  /// \brief One link of the queue.
+  struct Node
+  {
+    Node ()
+      : next (nullptr), value ()
+    {
+    }
+
+    /// The next-newer node, or nullptr if this is the newest.
+    std::atomic<Node*> next;
+    /// The value carried by this node (unused in the placeholder).
+    T value;
+  };
+
+  /// The most recently pushed node.  Written by producers.
+  std::atomic<Node*> m_head;
+  /// The placeholder node before the oldest value.  Only touched by the
+  ///   consumer.
+  Node* m_tail;
+};
+
+#endif//MPSC_QUEUE_HPP
@@ -3,15 +3,37 @@
 /// \author Ethan Gingrich
 /// \version A02
 
+#include <fstream>
+
 #include "MyScene.hpp"
 #include "Geometry.hpp"
-
-MyScene::MyScene (OpenGLContext* context, ShaderProgram* colors, ShaderProgram* normals) 
+#include "ModelLoader.hpp"
+
+/// \brief Indexes raw triangle data into a LoadedMesh.
+/// \param[in] name The name the Mesh will have in the Scene.
+/// \param[in] shaders The variants the Mesh will pick its shader from.
+/// \param[in] hasNormals Whether the data is position / normal rather than
+///   position / color.
+/// \param[in] geometry Unindexed vertex data, 6 floats per vertex.
+/// \param[in] world The Mesh's world transform.
+/// \return The indexed mesh.
+static LoadedMesh
+indexedMesh (const std::string& name, ShaderVariants* shaders, bool hasNormals,
+	     const std::vector<float>& geometry, const Transform& world)
 {
-  ColorsMesh* cubeMesh = new ColorsMesh(context, colors);
-  std::vector<float> data;                    /// Holds unique vertex data
-  std::vector<unsigned int> indices;          /// Holds index data 
+  LoadedMesh mesh;
+  mesh.name = name;
+  mesh.variants = shaders;
+  mesh.hasNormals = hasNormals;
+  indexData (geometry, 6, mesh.vertices, mesh.indices);
+  mesh.world = world;
+  return mesh;
+}
 
+MyScene::MyScene (AssetLoader& loader, ShaderVariants* shaders) 
+{
+  // Everything below runs on the loader's threads; each Mesh shows up in the
+  //   Scene once the render loop has uploaded it.
   const std::vector<float> cube
   {
     0.0f, 0.0f, 0.0f, 0.2f, 0.0f, 0.0f,     /// BEGIN FIRST FACE
@@ -57,19 +79,15 @@ MyScene::MyScene (OpenGLContext* context, ShaderProgram* colors, ShaderProgram*
     0.0f, -2.0f, 0.0f, 1.0f, 1.0f, 0.8f    /// END SIXTH FACE
   };
 
-  indexData (cube, cubeMesh->getFloatsPerVertex(), data, indices);
-  cubeMesh->addGeometry (data);
-  cubeMesh->addIndices (indices);
-  //cubeMesh->moveRight (2.0f);
-  cubeMesh->pitch (45.0f);
-  cubeMesh->prepareVao ();
-
-  add("cube01", cubeMesh);
-
-  data.clear ();
-  indices.clear ();
-
-  ColorsMesh* largeLMesh = new ColorsMesh(context, colors);
+  loader.submit ([cube, shaders] ()
+		 {
+		   Transform world;
+		   //world.moveRight (2.0f);
+		   world.pitch (45.0f);
+		   std::vector<LoadedMesh> meshes;
+		   meshes.push_back (indexedMesh ("cube01", shaders, false, cube, world));
+		   return meshes;
+		 });
 
   const std::vector<float> largeL 
   {
@@ -142,95 +160,79 @@ MyScene::MyScene (OpenGLContext* context, ShaderProgram* colors, ShaderProgram*
     4.0f, 1.5f, 0.5f, 1.0f, 0.0f, 1.0f,    /// END BOTTOM FACE
   };
 
-  indexData (largeL, largeLMesh->getFloatsPerVertex(), data, indices);
-  largeLMesh->addGeometry (data);
-  largeLMesh->addIndices (indices);
-  //largeLMesh->yaw (25.0f);
-  largeLMesh->scaleLocal (2.0f);
-  largeLMesh->prepareVao ();
-
-  add("largeL01", largeLMesh);
-
-  data.clear ();
-  indices.clear ();
+  loader.submit ([largeL, shaders] ()
+		 {
+		   Transform world;
+		   //world.yaw (25.0f);
+		   world.scaleLocal (2.0f);
+		   std::vector<LoadedMesh> meshes;
+		   meshes.push_back (indexedMesh ("largeL01", shaders, false, largeL, world));
+		   return meshes;
+		 });
   
   /*                            A08 Meshes                              */
-  /*                         randomFaceColors                           */         
-  const std::vector<Triangle> new_cube = buildCube ();
-
-  ColorsMesh* randomFaceColors = new ColorsMesh (context, colors);
-  std::vector<Vector3> faceColors = generateRandomFaceColors (new_cube);
-  std::vector<float> fc_cube_data = dataWithFaceColors (new_cube, faceColors);
-  
-  indexData (fc_cube_data, randomFaceColors->getFloatsPerVertex(), data, indices);
-  randomFaceColors->addGeometry (data);
-  randomFaceColors->addIndices (indices);
-  randomFaceColors->moveRight (-5);
-  randomFaceColors->prepareVao ();
-
-  add("cube02", randomFaceColors);
-
-  data.clear ();
-  indices.clear ();
-
-  /*                        randomVertexColors                          */ 
-  ColorsMesh* randomVertexColors = new ColorsMesh (context, colors);
-  std::vector<Vector3> vertexColors = generateRandomVertexColors (new_cube);
-  std::vector<float> vc_cube_data = dataWithVertexColors (new_cube, vertexColors);
-  
-  indexData (vc_cube_data, randomVertexColors->getFloatsPerVertex (), data, indices);
-  randomVertexColors->addGeometry (data);
-  randomVertexColors->addIndices (indices);
-  randomVertexColors->moveRight (-5);
-  randomVertexColors->moveUp (2);
-  randomVertexColors->prepareVao ();
-
-  add ("cube03", randomVertexColors);
-
-  data.clear ();
-  indices.clear ();
-
-  /*                        computedFaceNormals                         */ 
-  NormalsMesh* computedFaceNormals = new NormalsMesh (context, normals);
-  std::vector<Vector3> faceNormals = computeFaceNormals (new_cube);
-  std::vector<float> fn_cube_data = dataWithFaceNormals (new_cube, faceNormals);
-
-  indexData (fn_cube_data, computedFaceNormals->getFloatsPerVertex (), data, indices);
-  computedFaceNormals->addGeometry (data);
-  computedFaceNormals->addIndices (indices);
-  computedFaceNormals->moveRight (-5);
-  computedFaceNormals->moveUp (4);
-  computedFaceNormals->prepareVao ();
-
-  add ("cube04", computedFaceNormals);
-
-  data.clear ();
-  indices.clear ();
-
-  /*                       computedVertexNormals                        */ 
-  NormalsMesh* computedVertexNormals = new NormalsMesh (context, normals);
-  std::vector<Vector3> vertexNormals = computeVertexNormals (new_cube, faceNormals);
-  std::vector<float> vn_cube_data = dataWithVertexNormals (new_cube, vertexNormals);
-
-  indexData (vn_cube_data, computedVertexNormals->getFloatsPerVertex (), data, indices);
-  computedVertexNormals->addGeometry (data);
-  computedVertexNormals->addIndices (indices);
-  computedVertexNormals->moveRight (-5);
-  computedVertexNormals->moveUp (6);
-  computedVertexNormals->prepareVao ();
-
-  add ("cube05", computedVertexNormals);
-
-  data.clear ();
-  indices.clear ();
+  loader.submit ([shaders] ()
+		 {
+		   const std::vector<Triangle> new_cube = buildCube ();
+		   std::vector<LoadedMesh> meshes;
+		   Transform world;
+		   // The cubes are stacked, each attached to the one below, so
+		   //   moving the bottom one moves the whole stack.
+		   Transform above;
+		   above.moveUp (2);
+
+		   /*                   randomFaceColors                      */
+		   std::vector<Vector3> faceColors = generateRandomFaceColors (new_cube);
+		   std::vector<float> fc_cube_data = dataWithFaceColors (new_cube, faceColors);
+		   world.moveRight (-5);
+		   meshes.push_back (indexedMesh ("cube02", shaders, false, fc_cube_data, world));
+
+		   /*                  randomVertexColors                     */
+		   std::vector<Vector3> vertexColors = generateRandomVertexColors (new_cube);
+		   std::vector<float> vc_cube_data = dataWithVertexColors (new_cube, vertexColors);
+		   meshes.push_back (indexedMesh ("cube03", shaders, false, vc_cube_data, above));
+		   meshes.back ().parent = "cube02";
+
+		   /*                  computedFaceNormals                    */
+		   std::vector<Vector3> faceNormals = computeFaceNormals (new_cube);
+		   std::vector<float> fn_cube_data = dataWithFaceNormals (new_cube, faceNormals);
+		   meshes.push_back (indexedMesh ("cube04", shaders, true, fn_cube_data, above));
+		   meshes.back ().parent = "cube03";
+
+		   /*                 computedVertexNormals                   */
+		   std::vector<Vector3> vertexNormals = computeVertexNormals (new_cube, faceNormals);
+		   std::vector<float> vn_cube_data = dataWithVertexNormals (new_cube, vertexNormals);
+		   meshes.push_back (indexedMesh ("cube05", shaders, true, vn_cube_data, above));
+		   meshes.back ().parent = "cube04";
+
+		   return meshes;
+		 });
 
   /// Bear
-  NormalsMesh* bearMesh = new NormalsMesh (context, normals, "models/bear.obj", 0);
-  bearMesh->prepareVao ();
-
-  add ("bear01", bearMesh);
-
-  data.clear ();
-  indices.clear ();
+  loader.submit ([shaders] ()
+		 {
+		   std::vector<LoadedMesh> meshes (1);
+		   LoadedMesh& bear = meshes[0];
+		   bear.name = "bear01";
+		   bear.variants = shaders;
+		   bear.hasNormals = true;
+		   // Prefer the pre-converted binary (see "make models"), which is
+		   //   mapped straight into the VBO instead of being parsed.
+		   const std::string BINARY_FILE = "models/bear.mesh";
+		   if (std::ifstream (BINARY_FILE))
+		   {
+		     std::unique_ptr<MappedMeshFile> mapped (new MappedMeshFile (BINARY_FILE));
+		     if (mapped->isValid ())
+		     {
+		       bear.mapped = std::move (mapped);
+		       return meshes;
+		     }
+		   }
+		   const Model* model = ModelLoader::getInstance ().load ("models/bear.obj");
+		   if (model == nullptr || model->meshes.empty ())
+		     return std::vector<LoadedMesh> ();
+		   bear.vertices = model->meshes[0].vertices;
+		   bear.indices = model->meshes[0].indices;
+		   return meshes;
+		 });
 }
-
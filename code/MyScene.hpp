@@ -11,13 +11,16 @@
 #include "Mesh.hpp"
 #include "ColorsMesh.hpp"
 #include "NormalsMesh.hpp"
+#include "AssetLoader.hpp"
 
 class MyScene : public Scene
 {
 public:
 
-    /// Creates a new MyScene class
-    MyScene (OpenGLContext* context, ShaderProgram* colors, ShaderProgram* normals);
+    /// Creates a new MyScene class, which starts out empty and fills in as
+    ///   loader finishes building its Meshes.  Each Mesh picks the variant
+    ///   of shaders that matches its vertex format
+    MyScene (AssetLoader& loader, ShaderVariants* shaders);
 
     /// Per code requirements, we are not using delete...
     MyScene (const MyScene&) = delete;
@@ -3,60 +3,80 @@
 /// \author Ethan Gingrich
 /// \version A08
 
+#include <chrono>
+
 #include "NormalsMesh.hpp"
+#include "SkinnedMesh.hpp"
 
-NormalsMesh::NormalsMesh (OpenGLContext* context, ShaderProgram* shader) : Mesh (context, shader)
+/// \brief Prints how long it took to read a model, so that the cost of
+///   importing with assimp can be compared against mapping a .mesh file.
+///   Neither includes the upload, which happens later in prepareVao.
+/// \param[in] action What was done to the file, such as "Mapped".
+/// \param[in] filename The name of the file that was read.
+/// \param[in] start When reading began.
+static void
+reportLoadTime (const std::string& action, const std::string& filename,
+		std::chrono::steady_clock::time_point start)
 {
+  std::chrono::duration<double, std::milli> elapsed =
+    std::chrono::steady_clock::now () - start;
+  std::cerr << action << " " << filename << " in " << elapsed.count () << " ms (before upload)" << std::endl;
 }
 
-NormalsMesh::NormalsMesh (OpenGLContext* context, ShaderProgram* shader, std::string filename, unsigned int meshNum)
+NormalsMesh::NormalsMesh (GlContext* context, ShaderProgram* shader) : Mesh (context, shader)
+{
+}
+
+NormalsMesh::NormalsMesh (GlContext* context, ShaderProgram* shader, std::string filename, unsigned int meshNum)
   : NormalsMesh (context, shader)
 {
-  Assimp::Importer importer;
-  unsigned int flags =
-    aiProcess_Triangulate              // convert all shapes to triangles
-    | aiProcess_GenSmoothNormals       // create vertex normals if not there
-    | aiProcess_JoinIdenticalVertices; // combine vertices for indexing
-  const aiScene* scene = importer.ReadFile (filename,
-					    flags);
-  if (scene == nullptr)
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  const std::string MESH_EXTENSION = ".mesh";
+  if (filename.size () >= MESH_EXTENSION.size ()
+      && filename.compare (filename.size () - MESH_EXTENSION.size (),
+			   MESH_EXTENSION.size (), MESH_EXTENSION) == 0)
   {
-    auto error = importer.GetErrorString ();
-    std::cerr << "Failed to load model " << filename << " with error " << error << std::endl;
+    // Pre-converted binary files hold exactly one mesh, already indexed.
+    std::unique_ptr<MappedMeshFile> file (new MappedMeshFile (filename));
+    if (!file->isValid ())
+    {
+      std::cerr << "Failed to load model " << filename << std::endl;
+    }
+    else if (meshNum != 0 || file->getHeader ().floatsPerVertex != getFloatsPerVertex ())
+    {
+      std::cerr << "Could not read mesh " << meshNum << " from " << filename << " because it holds a single mesh with " << file->getHeader ().floatsPerVertex << " floats per vertex." << std::endl;
+    }
+    else
+    {
+      addMappedGeometry (std::move (file));
+    }
+    reportLoadTime ("Mapped", filename, start);
+    return;
   }
-  else
+
+  // Every mesh of the file is built by the first request; the rest are
+  //   cache hits.
+  const Model* model = ModelLoader::getInstance ().load (filename);
+  if (model != nullptr)
   {
-    if(meshNum >= scene->mNumMeshes)
+    if (meshNum >= model->meshes.size ())
     {
-      std::cerr << "Could not read mesh " << meshNum << " from " << filename << " because it only has " << scene->mNumMeshes << " meshes." << std::endl;
+      std::cerr << "Could not read mesh " << meshNum << " from " << filename << " because it only has " << model->meshes.size () << " meshes." << std::endl;
     }
     else
     {
-      const aiMesh* mesh = scene->mMeshes[meshNum];
-      std::vector<float> vertexData;
-      std::vector<unsigned int> indexes;
-      for (unsigned vertexNum = 0; vertexNum < mesh->mNumVertices; ++vertexNum)
-      {
-	vertexData.push_back (mesh->mVertices[vertexNum].x);
-	vertexData.push_back (mesh->mVertices[vertexNum].y);
-	vertexData.push_back (mesh->mVertices[vertexNum].z);
-	vertexData.push_back (mesh->mNormals[vertexNum].x);
-	vertexData.push_back (mesh->mNormals[vertexNum].y);
-	vertexData.push_back (mesh->mNormals[vertexNum].z);
-      }
-      for (unsigned int faceNum = 0; faceNum < mesh->mNumFaces; ++faceNum)
-      {
-	const aiFace& face = mesh->mFaces[faceNum];
-	for (unsigned int indexNum = 0; indexNum < 3; ++indexNum)
-	{
-	  unsigned int vertexNum = face.mIndices[indexNum];
-	  indexes.push_back (vertexNum);
-	}
-      }
-      addGeometry (vertexData);
-      addIndices (indexes);
+      addGeometry (model->meshes[meshNum].vertices);
+      addIndices (model->meshes[meshNum].indices);
     }
   }
+  reportLoadTime ("Imported", filename, start);
+}
+
+NormalsMesh::NormalsMesh (GlContext* context, ShaderProgram* shader, const ModelMesh& data)
+  : NormalsMesh (context, shader)
+{
+  addGeometry (data.vertices);
+  addIndices (data.indices);
 }
 
 NormalsMesh::~NormalsMesh ()
@@ -69,6 +89,12 @@ NormalsMesh::getFloatsPerVertex () const
     return 6; 
 }
 
+unsigned int
+NormalsMesh::getShaderFeatures () const
+{
+    return SHADER_NORMALS;
+}
+
 void
 NormalsMesh::enableAttributes ()
 {
@@ -80,3 +106,38 @@ NormalsMesh::enableAttributes ()
     m_context->vertexAttribPointer (NORMAL_ATTRIB_INDEX, 3, GL_FLOAT, GL_FALSE, (getFloatsPerVertex() * sizeof(float)),
 				  reinterpret_cast<void*> (3 * sizeof(float)));
 }
+
+unsigned int
+addModelToScene (Scene& scene, GlContext* context, ShaderProgram* shader,
+		 const std::string& fileName, const std::string& namePrefix,
+		 ModelLoader& loader)
+{
+  const Model* model = loader.load (fileName);
+  if (model == nullptr)
+    return 0;
+  unsigned int added = 0;
+  for (unsigned int nodeNum = 0; nodeNum < model->nodes.size (); ++nodeNum)
+  {
+    const ModelNode& node = model->nodes[nodeNum];
+    for (unsigned int meshNum : node.meshes)
+    {
+      const ModelMesh& data = model->meshes[meshNum];
+      NormalsMesh* mesh;
+      if (data.bones.empty ())
+      {
+	mesh = new NormalsMesh (context, shader, data);
+	mesh->setWorld (node.world);
+      }
+      else
+      {
+	// Bones already carry it into the model's coordinates, wherever its
+	//   node is.
+	mesh = new SkinnedMesh (context, shader, data);
+      }
+      mesh->prepareVao ();
+      scene.add (namePrefix + std::to_string (nodeNum) + "_" + std::to_string (meshNum), mesh);
+      ++added;
+    }
+  }
+  return added;
+}
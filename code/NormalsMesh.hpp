@@ -6,18 +6,18 @@
 #ifndef NORMALSMESH_HPP
 #define NORMALSMESH_HPP
 
-#include <assimp/scene.h>
-#include <assimp/Importer.hpp>
-#include <assimp/postprocess.h>
+#include <string>
 
 #include "Mesh.hpp"
+#include "Scene.hpp"
+#include "ModelLoader.hpp"
 
 class NormalsMesh : public Mesh
 {
     
 public:
     // Creates a NormalsMesh class
-    NormalsMesh (OpenGLContext* context, ShaderProgram* shader);
+    NormalsMesh (GlContext* context, ShaderProgram* shader);
 
     /// \brief Constructs a NormalsMesh with triangles pulled from a file.
     /// \param[in] context A pointer to an objec tthrough which the Mesh will be
@@ -33,7 +33,21 @@ public:
     /// \post If that file exists and contains a mesh of that number, the indexes
     ///   and geometry from it have been pre-populated into this Mesh.  Otherwise
     ///   this Mesh is empty and an error message has been printed.
-    NormalsMesh (OpenGLContext* context, ShaderProgram* shader, std::string fileName, unsigned int meshNum);
+    /// Files ending in ".mesh" are memory-mapped binary files (see
+    ///   MeshFile.hpp) holding a single mesh; anything else goes through
+    ///   the shared ModelLoader, so the file is only parsed once no matter
+    ///   how many of its meshes are requested.
+    NormalsMesh (GlContext* context, ShaderProgram* shader, std::string fileName, unsigned int meshNum);
+
+    /// \brief Constructs a NormalsMesh from a mesh that was already loaded.
+    /// \param[in] context A pointer to an object through which the Mesh will be
+    ///   able to make OpenGL calls.
+    /// \param[in] shader A pointer to the shader program that should be used for
+    ///   drawing this mesh.
+    /// \param[in] data The mesh, as built by a ModelLoader.
+    /// \post The indexes and geometry of data have been pre-populated into
+    ///   this Mesh.
+    NormalsMesh (GlContext* context, ShaderProgram* shader, const ModelMesh& data);
 
     // Empty destructor
     virtual ~NormalsMesh ();
@@ -42,6 +56,10 @@ public:
     virtual unsigned int 
     getFloatsPerVertex () const;
 
+    // getShaderFeatures override
+    virtual unsigned int
+    getShaderFeatures () const;
+
     
 
 protected:
@@ -50,4 +68,22 @@ protected:
     enableAttributes ();
 };
 
+/// \brief Adds every mesh instance of a model file to a Scene, placed by
+///   the file's node hierarchy.
+/// \param[in,out] scene The Scene the meshes should be added to.
+/// \param[in] context A pointer to an object through which the Meshes will be
+///   able to make OpenGL calls.
+/// \param[in] shader A pointer to the shader program the Meshes should use.
+/// \param[in] fileName The name of the model file.
+/// \param[in] namePrefix Each Mesh is named namePrefix + "<node>_<mesh>".
+/// \param[in] loader The ModelLoader to read the file through.
+/// \return The number of Meshes added (0 if the file could not be read).
+/// \post Each Mesh has been prepared and its world transform set to its
+///   node's.  Meshes with bones become SkinnedMeshes, in their bind pose
+///   until an Animator poses them, and keep an identity world transform.
+unsigned int
+addModelToScene (Scene& scene, GlContext* context, ShaderProgram* shader,
+		 const std::string& fileName, const std::string& namePrefix,
+		 ModelLoader& loader = ModelLoader::getInstance ());
+
 #endif //NORMALSMESH_HPP
\ No newline at end of file
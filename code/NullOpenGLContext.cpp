@@ -0,0 +1,319 @@
+/// \file NullOpenGLContext.cpp
+/// \brief Definitions of NullOpenGLContext member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include "NullOpenGLContext.hpp"
+
+NullOpenGLContext::NullOpenGLContext ()
+  : m_lastName (0)
+{
+}
+
+NullOpenGLContext::~NullOpenGLContext ()
+{
+}
+
+void
+NullOpenGLContext::generateNames (GLsizei n, GLuint* names)
+{
+  for (GLsizei name = 0; name < n; ++name)
+    names[name] = ++m_lastName;
+}
+
+bool
+NullOpenGLContext::isStatus (GLenum pname)
+{
+  return pname == GL_COMPILE_STATUS || pname == GL_LINK_STATUS
+    || pname == GL_COMPLETION_STATUS_KHR;
+}
+
+void
+NullOpenGLContext::attachShader (GLuint program, GLuint shader)
+{
+}
+
+void
+NullOpenGLContext::beginQuery (GLenum target, GLuint id)
+{
+}
+
+void
+NullOpenGLContext::bindBuffer (GLenum target, GLuint buffer)
+{
+}
+
+void
+NullOpenGLContext::bindVertexArray (GLuint array)
+{
+}
+
+void
+NullOpenGLContext::bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+}
+
+void
+NullOpenGLContext::bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+}
+
+void
+NullOpenGLContext::clear (GLbitfield mask)
+{
+}
+
+void
+NullOpenGLContext::clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+}
+
+GLenum
+NullOpenGLContext::clientWaitSync (GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+  return GL_ALREADY_SIGNALED;
+}
+
+void
+NullOpenGLContext::compileShader (GLuint shader)
+{
+}
+
+GLuint
+NullOpenGLContext::createProgram ()
+{
+  return ++m_lastName;
+}
+
+GLuint
+NullOpenGLContext::createShader (GLenum shaderType)
+{
+  return ++m_lastName;
+}
+
+void
+NullOpenGLContext::cullFace (GLenum mode)
+{
+}
+
+void
+NullOpenGLContext::deleteBuffers (GLsizei n, const GLuint* buffers)
+{
+}
+
+void
+NullOpenGLContext::deleteProgram (GLuint program)
+{
+}
+
+void
+NullOpenGLContext::deleteQueries (GLsizei n, const GLuint* ids)
+{
+}
+
+void
+NullOpenGLContext::deleteShader (GLuint shader)
+{
+}
+
+void
+NullOpenGLContext::deleteSync (GLsync sync)
+{
+}
+
+void
+NullOpenGLContext::deleteVertexArrays (GLsizei n, const GLuint* arrays)
+{
+}
+
+void
+NullOpenGLContext::detachShader (GLuint program, GLuint shader)
+{
+}
+
+void
+NullOpenGLContext::drawArrays (GLenum mode, GLint first, GLsizei count)
+{
+}
+
+void
+NullOpenGLContext::drawElements (GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+}
+
+void
+NullOpenGLContext::enable (GLenum cap)
+{
+}
+
+void
+NullOpenGLContext::enableVertexAttribArray (GLuint index)
+{
+}
+
+void
+NullOpenGLContext::endQuery (GLenum target)
+{
+}
+
+GLsync
+NullOpenGLContext::fenceSync (GLenum condition, GLbitfield flags)
+{
+  return nullptr;
+}
+
+void
+NullOpenGLContext::finish ()
+{
+}
+
+void
+NullOpenGLContext::flush ()
+{
+}
+
+void
+NullOpenGLContext::frontFace (GLenum mode)
+{
+}
+
+void
+NullOpenGLContext::genBuffers (GLsizei n, GLuint* buffers)
+{
+  generateNames (n, buffers);
+}
+
+void
+NullOpenGLContext::genQueries (GLsizei n, GLuint* ids)
+{
+  generateNames (n, ids);
+}
+
+void
+NullOpenGLContext::genVertexArrays (GLsizei n, GLuint* arrays)
+{
+  generateNames (n, arrays);
+}
+
+GLint
+NullOpenGLContext::getAttribLocation (GLuint program, const GLchar* name)
+{
+  return 0;
+}
+
+void
+NullOpenGLContext::getIntegerv (GLenum pname, GLint* data)
+{
+  *data = 0;
+}
+
+void
+NullOpenGLContext::getProgramBinary (GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary)
+{
+  if (length != nullptr)
+    *length = 0;
+}
+
+void
+NullOpenGLContext::getProgramInfoLog (GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog)
+{
+  if (length != nullptr)
+    *length = 0;
+  if (maxLength > 0)
+    infoLog[0] = '\0';
+}
+
+void
+NullOpenGLContext::getProgramiv (GLuint program, GLenum pname, GLint* params)
+{
+  *params = isStatus (pname) ? GL_TRUE : 0;
+}
+
+void
+NullOpenGLContext::getQueryObjectiv (GLuint id, GLenum pname, GLint* params)
+{
+  *params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+}
+
+void
+NullOpenGLContext::getQueryObjectui64v (GLuint id, GLenum pname, GLuint64* params)
+{
+  *params = 0;
+}
+
+void
+NullOpenGLContext::getShaderInfoLog (GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog)
+{
+  if (length != nullptr)
+    *length = 0;
+  if (maxLength > 0)
+    infoLog[0] = '\0';
+}
+
+void
+NullOpenGLContext::getShaderiv (GLuint shader, GLenum pname, GLint* params)
+{
+  *params = isStatus (pname) ? GL_TRUE : 0;
+}
+
+const GLubyte*
+NullOpenGLContext::getString (GLenum name)
+{
+  return reinterpret_cast<const GLubyte*> ("Null");
+}
+
+GLint
+NullOpenGLContext::getUniformLocation (GLuint program, const GLchar* name)
+{
+  return 0;
+}
+
+void
+NullOpenGLContext::linkProgram (GLuint program)
+{
+}
+
+void
+NullOpenGLContext::maxShaderCompilerThreadsKHR (GLuint count)
+{
+}
+
+void
+NullOpenGLContext::programBinary (GLuint program, GLenum binaryFormat, const void* binary, GLsizei length)
+{
+}
+
+void
+NullOpenGLContext::programParameteri (GLuint program, GLenum pname, GLint value)
+{
+}
+
+void
+NullOpenGLContext::queryCounter (GLuint id, GLenum target)
+{
+}
+
+void
+NullOpenGLContext::shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length)
+{
+}
+
+void
+NullOpenGLContext::uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+}
+
+void
+NullOpenGLContext::useProgram (GLuint program)
+{
+}
+
+void
+NullOpenGLContext::vertexAttribPointer (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer)
+{
+}
+
+void
+NullOpenGLContext::viewport (GLint x, GLint y, GLsizei width, GLsizei height)
+{
+}
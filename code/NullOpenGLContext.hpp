@@ -0,0 +1,214 @@
+/// \file NullOpenGLContext.hpp
+/// \brief Declaration of NullOpenGLContext.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef NULL_OPENGL_CONTEXT_HPP
+#define NULL_OPENGL_CONTEXT_HPP
+
+#include "OpenGLContext.hpp"
+
+/// \brief A subclass of OpenGLContext that makes no OpenGL calls at all.
+///
+/// Objects get fresh names, every compile, link, and query succeeds at
+///   once, and everything else is ignored.  This lets tests and benchmarks
+///   run code that draws without a window or a driver.
+class NullOpenGLContext : public OpenGLContext
+{
+public:
+
+  /// Constructs a NullOpenGLContext.
+  NullOpenGLContext ();
+
+  /// Destructs a NullOpenGLContext.
+  virtual
+  ~NullOpenGLContext ();
+
+  /// Copy constructor deleted because you should not be copying
+  ///   OpenGLContexts.
+  NullOpenGLContext (const NullOpenGLContext&) = delete;
+
+  /// Assignment operator deleted because you should not be assigning
+  ///   OpenGLContexts.
+  NullOpenGLContext&
+  operator= (const NullOpenGLContext&) = delete;
+
+  virtual void
+  attachShader (GLuint program, GLuint shader);
+
+  virtual void
+  beginQuery (GLenum target, GLuint id);
+
+  virtual void
+  bindBuffer (GLenum target, GLuint buffer);
+
+  virtual void
+  bindVertexArray (GLuint array);
+
+  virtual void
+  bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage);
+
+  virtual void
+  bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data);
+
+  virtual void
+  clear (GLbitfield mask);
+
+  virtual void
+  clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+
+  virtual GLenum
+  clientWaitSync (GLsync sync, GLbitfield flags, GLuint64 timeout);
+
+  virtual void
+  compileShader (GLuint shader);
+
+  virtual GLuint
+  createProgram ();
+
+  virtual GLuint
+  createShader (GLenum shaderType);
+
+  virtual void
+  cullFace (GLenum mode);
+
+  virtual void
+  deleteBuffers (GLsizei n, const GLuint* buffers);
+
+  virtual void
+  deleteProgram (GLuint program);
+
+  virtual void
+  deleteQueries (GLsizei n, const GLuint* ids);
+
+  virtual void
+  deleteShader (GLuint shader);
+
+  virtual void
+  deleteSync (GLsync sync);
+
+  virtual void
+  deleteVertexArrays (GLsizei n, const GLuint* arrays);
+
+  virtual void
+  detachShader (GLuint program, GLuint shader);
+
+  virtual void
+  drawArrays (GLenum mode, GLint first, GLsizei count);
+
+  virtual void
+  drawElements (GLenum mode, GLsizei count, GLenum type, const void* indices);
+
+  virtual void
+  enable (GLenum cap);
+
+  virtual void
+  enableVertexAttribArray (GLuint index);
+
+  virtual void
+  endQuery (GLenum target);
+
+  virtual GLsync
+  fenceSync (GLenum condition, GLbitfield flags);
+
+  virtual void
+  finish ();
+
+  virtual void
+  flush ();
+
+  virtual void
+  frontFace (GLenum mode);
+
+  virtual void
+  genBuffers (GLsizei n, GLuint* buffers);
+
+  virtual void
+  genQueries (GLsizei n, GLuint* ids);
+
+  virtual void
+  genVertexArrays (GLsizei n, GLuint* arrays);
+
+  virtual GLint
+  getAttribLocation (GLuint program, const GLchar* name);
+
+  virtual void
+  getIntegerv (GLenum pname, GLint* data);
+
+  virtual void
+  getProgramBinary (GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+
+  virtual void
+  getProgramInfoLog (GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
+
+  virtual void
+  getProgramiv (GLuint program, GLenum pname, GLint* params);
+
+  virtual void
+  getQueryObjectiv (GLuint id, GLenum pname, GLint* params);
+
+  virtual void
+  getQueryObjectui64v (GLuint id, GLenum pname, GLuint64* params);
+
+  virtual void
+  getShaderInfoLog (GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
+
+  virtual void
+  getShaderiv (GLuint shader, GLenum pname, GLint* params);
+
+  virtual const GLubyte*
+  getString (GLenum name);
+
+  virtual GLint
+  getUniformLocation (GLuint program, const GLchar* name);
+
+  virtual void
+  linkProgram (GLuint program);
+
+  virtual void
+  maxShaderCompilerThreadsKHR (GLuint count);
+
+  virtual void
+  programBinary (GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+
+  virtual void
+  programParameteri (GLuint program, GLenum pname, GLint value);
+
+  virtual void
+  queryCounter (GLuint id, GLenum target);
+
+  virtual void
+  shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length);
+
+  virtual void
+  uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+
+  virtual void
+  useProgram (GLuint program);
+
+  virtual void
+  vertexAttribPointer (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer);
+
+  virtual void
+  viewport (GLint x, GLint y, GLsizei width, GLsizei height);
+
+private:
+
+  /// \brief Hands out unused object names.
+  /// \param[in] n The number of names.
+  /// \param[out] names Receives the names.
+  void
+  generateNames (GLsizei n, GLuint* names);
+
+  /// \brief Tests whether a parameter is one whose success is reported by
+  ///   a GL_TRUE, like GL_COMPILE_STATUS.
+  /// \param[in] pname The parameter.
+  /// \return True if it is a status.
+  static bool
+  isStatus (GLenum pname);
+
+  /// The most recently handed out object name.
+  GLuint m_lastName;
+};
+
+#endif//NULL_OPENGL_CONTEXT_HPP
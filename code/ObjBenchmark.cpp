@@ -0,0 +1,135 @@
+/// \file ObjBenchmark.cpp
+/// \brief A command-line tool that compares the native OBJ reader against
+///   assimp's OBJ importer.
+/// \author Ethan Gingrich
+/// \version A08
+///
+/// Usage:
+///   ObjBenchmark.out file.obj [more.obj ...]
+///     Times assimp, the native reader on one thread, and the native reader
+///     on every hardware thread for each file.
+///   ObjBenchmark.out --generate file.obj megabytes
+///     Writes a synthetic OBJ (a bumpy grid with normals and quads) of
+///     roughly that size, for benchmarking big scanned-asset loads.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <assimp/scene.h>
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+
+#include "ObjReader.hpp"
+
+/// \brief Writes a synthetic OBJ file.
+/// \param[in] fileName The file to create.
+/// \param[in] megabytes About how large the file should be.
+/// \return True if the file was written.
+static bool
+generateObj (const std::string& fileName, double megabytes)
+{
+  std::FILE* out = std::fopen (fileName.c_str (), "w");
+  if (out == nullptr)
+  {
+    std::cerr << "Could not open " << fileName << " for writing" << std::endl;
+    return false;
+  }
+  // Each grid point costs about 80 bytes of "v"/"vn" text plus one quad of
+  //   about 55 bytes.
+  const double BYTES_PER_POINT = 134.0;
+  unsigned int side = static_cast<unsigned int> (std::sqrt (megabytes * 1024 * 1024 / BYTES_PER_POINT));
+  side = std::max (side, 2u);
+  std::fprintf (out, "# synthetic %ux%u grid\no grid\n", side, side);
+  for (unsigned int y = 0; y < side; ++y)
+  {
+    for (unsigned int x = 0; x < side; ++x)
+    {
+      float height = std::sin (x * 0.05f) * std::cos (y * 0.05f);
+      std::fprintf (out, "v %.6f %.6f %.6f\nvn %.6f %.6f %.6f\n",
+		    x * 0.01f, height, y * 0.01f, 0.0f, 1.0f, 0.0f);
+    }
+  }
+  for (unsigned int y = 0; y + 1 < side; ++y)
+  {
+    for (unsigned int x = 0; x + 1 < side; ++x)
+    {
+      unsigned int a = y * side + x + 1, b = a + 1, c = a + side + 1, d = a + side;
+      std::fprintf (out, "f %u//%u %u//%u %u//%u %u//%u\n", a, a, d, d, c, c, b, b);
+    }
+  }
+  bool ok = std::ferror (out) == 0;
+  std::fclose (out);
+  return ok;
+}
+
+/// \brief Times a function.
+/// \param[in] work The function to time.
+/// \return The elapsed time in milliseconds.
+template<typename Function>
+static double
+timeMs (Function work)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  work ();
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now () - start;
+  return elapsed.count ();
+}
+
+/// \brief Runs the benchmark.
+/// \param[in] argc The number of command-line arguments.
+/// \param[in] argv The files to load, or --generate and its arguments.
+/// \return EXIT_SUCCESS if everything loaded, otherwise EXIT_FAILURE.
+int
+main (int argc, char* argv[])
+{
+  if (argc == 4 && std::string (argv[1]) == "--generate")
+    return generateObj (argv[2], std::atof (argv[3])) ? EXIT_SUCCESS : EXIT_FAILURE;
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " file.obj [more.obj ...]" << std::endl
+	      << "       " << argv[0] << " --generate file.obj megabytes" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  unsigned int threads = std::max (std::thread::hardware_concurrency (), 1u);
+  int status = EXIT_SUCCESS;
+  for (int arg = 1; arg < argc; ++arg)
+  {
+    std::string fileName = argv[arg];
+    std::vector<ModelMesh> meshes;
+    size_t triangles = 0;
+    bool ok = true;
+
+    double nativeParallelMs = timeMs ([&] () { ok = readObj (fileName, meshes, threads) && ok; });
+    for (const ModelMesh& mesh : meshes)
+      triangles += mesh.indices.size () / 3;
+    double nativeSerialMs = timeMs ([&] () { ok = readObj (fileName, meshes, 1) && ok; });
+
+    double assimpMs = timeMs ([&] ()
+			      {
+				Assimp::Importer importer;
+				unsigned int flags = aiProcess_Triangulate
+				  | aiProcess_GenSmoothNormals
+				  | aiProcess_JoinIdenticalVertices;
+				ok = importer.ReadFile (fileName, flags) != nullptr && ok;
+			      });
+
+    if (!ok)
+    {
+      std::cerr << "Failed to load " << fileName << std::endl;
+      status = EXIT_FAILURE;
+      continue;
+    }
+    std::printf ("%s: %zu meshes, %zu triangles\n", fileName.c_str (), meshes.size (), triangles);
+    std::printf ("  assimp              %10.1f ms\n", assimpMs);
+    std::printf ("  native, 1 thread    %10.1f ms (%.1fx)\n", nativeSerialMs, assimpMs / nativeSerialMs);
+    std::printf ("  native, %2u threads  %10.1f ms (%.1fx)\n", threads, nativeParallelMs, assimpMs / nativeParallelMs);
+  }
+  return status;
+}
@@ -0,0 +1,568 @@
+/// \file ObjReader.cpp
+/// \brief Definitions of global functions for reading Wavefront OBJ files
+///   without assimp.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "CpuProfiler.hpp"
+#include "JobSystem.hpp"
+#include "ObjReader.hpp"
+#include "Vector3.hpp"
+
+/// Marks a corner that has no normal of its own.
+static const uint32_t NO_NORMAL = 0xFFFFFFFFu;
+/// Chunks smaller than this aren't worth a thread of their own.
+static const size_t MIN_CHUNK_BYTES = 256 * 1024;
+
+/// \brief One "f" line, before its indices have been resolved.
+struct ObjFace
+{
+  /// The position of the face's first corner in ObjChunk::corners (pairs).
+  uint32_t firstCorner;
+  /// The number of corners (3 for a triangle, more for a polygon).
+  uint32_t cornerCount;
+  /// The number of "v" lines earlier in the same chunk.
+  uint32_t positionsBefore;
+  /// The number of "vn" lines earlier in the same chunk.
+  uint32_t normalsBefore;
+};
+
+/// \brief An "o", "g", or "usemtl" line, which starts a new mesh.
+struct ObjBreak
+{
+  /// The number of faces earlier in the same chunk.
+  uint32_t faceIndex;
+  /// Whether or not the line names the new mesh ("usemtl" doesn't).
+  bool hasName;
+  /// The new mesh's name.
+  std::string name;
+};
+
+/// \brief A run of consecutive faces from one chunk that all belong to the
+///   same mesh, indexed locally.
+struct ObjSegment
+{
+  /// Whether or not a new mesh starts with this segment.
+  bool startsMesh;
+  /// Whether or not name should replace the current mesh name.
+  bool hasName;
+  /// The name given by the break that started this segment.
+  std::string name;
+  /// Each unique (position << 32 | normal) pair used in the segment.
+  std::vector<uint64_t> keys;
+  /// Three entries per triangle, indexing keys.
+  std::vector<uint32_t> indices;
+  /// Which output mesh the segment was merged into.
+  unsigned int mesh;
+  /// Maps positions in keys to vertex numbers in that mesh.
+  std::vector<uint32_t> remap;
+  /// Where this segment's indices go in that mesh's index array.
+  size_t indexOffset;
+};
+
+/// \brief Everything parsed from one line-aligned slice of the file.
+struct ObjChunk
+{
+  /// The first character of the slice.
+  const char* begin;
+  /// One past the last character of the slice.
+  const char* end;
+  /// Three floats per "v" line.
+  std::vector<float> positions;
+  /// Three floats per "vn" line.
+  std::vector<float> normals;
+  /// Two raw (1-based or negative) indices per face corner: position,
+  ///   normal.  A normal of 0 means the corner had none.
+  std::vector<int> corners;
+  /// Every "f" line.
+  std::vector<ObjFace> faces;
+  /// Every line that starts a new mesh.
+  std::vector<ObjBreak> breaks;
+  /// A description of the first problem found, or empty if none.
+  std::string error;
+  /// The number of "v" lines in all earlier chunks.
+  uint32_t positionBase;
+  /// The number of "vn" lines in all earlier chunks.
+  uint32_t normalBase;
+  /// The faces, resolved, triangulated, and split by mesh.
+  std::vector<ObjSegment> segments;
+};
+
+/// \brief Runs a function for every number in [0, count), on the shared
+///   JobSystem unless asked for one thread.
+/// \param[in] count The number of work items.
+/// \param[in] threadCount 1 to run everything on the calling thread.
+/// \param[in] work The function to call with each work item's number.
+template<typename Function>
+static void
+parallelFor (size_t count, unsigned int threadCount, Function work)
+{
+  if (threadCount <= 1)
+  {
+    for (size_t item = 0; item < count; ++item)
+      work (item);
+    return;
+  }
+  JobSystem::getShared ().parallelFor (count, 1, [&work] (size_t begin, size_t end)
+  {
+    for (size_t item = begin; item < end; ++item)
+      work (item);
+  });
+}
+
+static bool
+isBlank (char c)
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+static const char*
+skipBlanks (const char* p, const char* end)
+{
+  while (p < end && isBlank (*p))
+    ++p;
+  return p;
+}
+
+/// \brief Parses a number, skipping leading blanks and an optional '+'.
+/// \param[in,out] p The first character to look at; left just past the
+///   number.
+/// \param[in] end The end of the line.
+/// \param[out] value The number.
+/// \return True if a number was found, otherwise false.
+template<typename Number>
+static bool
+parseNumber (const char*& p, const char* end, Number& value)
+{
+  p = skipBlanks (p, end);
+  if (p < end && *p == '+')
+    ++p;
+  std::from_chars_result result = std::from_chars (p, end, value);
+  if (result.ec != std::errc ())
+    return false;
+  p = result.ptr;
+  return true;
+}
+
+/// \brief Parses every line of a chunk.
+/// \param[in,out] chunk The chunk, whose begin and end must be set.
+/// \post Everything but positionBase, normalBase, and segments is filled in.
+static void
+parseChunk (ObjChunk& chunk)
+{
+  PROFILE_FUNCTION ();
+  const char* p = chunk.begin;
+  while (p < chunk.end)
+  {
+    const char* lineStart = p;
+    const char* lineEnd =
+      static_cast<const char*> (std::memchr (p, '\n', chunk.end - p));
+    if (lineEnd == nullptr)
+      lineEnd = chunk.end;
+    p = skipBlanks (p, lineEnd);
+    size_t length = lineEnd - p;
+    bool ok = true;
+
+    if (length >= 2 && p[0] == 'v' && isBlank (p[1]))
+    {
+      float x = 0.0f, y = 0.0f, z = 0.0f;
+      p += 1;
+      ok = parseNumber (p, lineEnd, x) && parseNumber (p, lineEnd, y)
+	&& parseNumber (p, lineEnd, z);
+      chunk.positions.insert (chunk.positions.end (), { x, y, z });
+    }
+    else if (length >= 3 && p[0] == 'v' && p[1] == 'n' && isBlank (p[2]))
+    {
+      float x = 0.0f, y = 0.0f, z = 0.0f;
+      p += 2;
+      ok = parseNumber (p, lineEnd, x) && parseNumber (p, lineEnd, y)
+	&& parseNumber (p, lineEnd, z);
+      chunk.normals.insert (chunk.normals.end (), { x, y, z });
+    }
+    else if (length >= 2 && p[0] == 'f' && isBlank (p[1]))
+    {
+      ObjFace face { uint32_t (chunk.corners.size () / 2), 0,
+		     uint32_t (chunk.positions.size () / 3),
+		     uint32_t (chunk.normals.size () / 3) };
+      p += 1;
+      for (p = skipBlanks (p, lineEnd); ok && p < lineEnd; p = skipBlanks (p, lineEnd))
+      {
+	// v, v/vt, v//vn, or v/vt/vn.  Texture coordinates are ignored.
+	int position = 0, texCoord = 0, normal = 0;
+	ok = parseNumber (p, lineEnd, position) && position != 0;
+	if (ok && p < lineEnd && *p == '/')
+	{
+	  ++p;
+	  if (p < lineEnd && *p != '/')
+	    ok = parseNumber (p, lineEnd, texCoord);
+	  if (ok && p < lineEnd && *p == '/')
+	  {
+	    ++p;
+	    ok = parseNumber (p, lineEnd, normal) && normal != 0;
+	  }
+	}
+	chunk.corners.push_back (position);
+	chunk.corners.push_back (normal);
+	++face.cornerCount;
+      }
+      ok = ok && face.cornerCount >= 3;
+      chunk.faces.push_back (face);
+    }
+    else if (length >= 1 && (p[0] == 'o' || p[0] == 'g')
+	     && (length == 1 || isBlank (p[1])))
+    {
+      const char* nameStart = skipBlanks (p + 1, lineEnd);
+      const char* nameEnd = lineEnd;
+      while (nameEnd > nameStart && isBlank (nameEnd[-1]))
+	--nameEnd;
+      chunk.breaks.push_back (ObjBreak { uint32_t (chunk.faces.size ()), true,
+					 std::string (nameStart, nameEnd) });
+    }
+    else if (length >= 7 && std::memcmp (p, "usemtl", 6) == 0 && isBlank (p[6]))
+    {
+      chunk.breaks.push_back (ObjBreak { uint32_t (chunk.faces.size ()), false, "" });
+    }
+    // Everything else (comments, vt, s, mtllib, ...) is ignored.
+
+    if (!ok)
+    {
+      chunk.error = "malformed line \""
+	+ std::string (lineStart, std::min (lineEnd, lineStart + 60)) + "\"";
+      return;
+    }
+    p = lineEnd + 1;
+  }
+}
+
+/// \brief Turns a raw OBJ index into a 0-based one.
+/// \param[in] raw The index from the file (1-based, or negative to count
+///   back from the most recent element).
+/// \param[in] before The number of elements defined before the face.
+/// \param[in] total The number of elements in the whole file.
+/// \param[out] resolved The 0-based index.
+/// \return True if the index refers to an existing element.
+static bool
+resolveIndex (int raw, int64_t before, int64_t total, uint32_t& resolved)
+{
+  int64_t index = raw > 0 ? int64_t (raw) - 1 : before + raw;
+  if (index < 0 || index >= total)
+    return false;
+  resolved = uint32_t (index);
+  return true;
+}
+
+/// \brief Resolves, triangulates, and locally indexes a chunk's faces.
+/// \param[in,out] chunk A parsed chunk whose bases have been set.
+/// \param[in] totalPositions The number of "v" lines in the whole file.
+/// \param[in] totalNormals The number of "vn" lines in the whole file.
+/// \post chunk.segments is filled in, or chunk.error is set.
+static void
+resolveChunk (ObjChunk& chunk, uint32_t totalPositions, uint32_t totalNormals)
+{
+  PROFILE_FUNCTION ();
+  std::unordered_map<uint64_t, uint32_t> lookup;
+  std::vector<uint32_t> faceIndices;
+  size_t breakNum = 0;
+  // The first segment continues whatever mesh the previous chunk ended in.
+  chunk.segments.push_back (ObjSegment ());
+  chunk.segments.back ().startsMesh = false;
+  chunk.segments.back ().hasName = false;
+
+  for (size_t faceNum = 0; faceNum <= chunk.faces.size (); ++faceNum)
+  {
+    for (; breakNum < chunk.breaks.size () && chunk.breaks[breakNum].faceIndex == faceNum; ++breakNum)
+    {
+      if (!chunk.segments.back ().indices.empty ())
+      {
+	chunk.segments.push_back (ObjSegment ());
+	chunk.segments.back ().hasName = false;
+	lookup.clear ();
+      }
+      ObjSegment& segment = chunk.segments.back ();
+      segment.startsMesh = true;
+      if (chunk.breaks[breakNum].hasName)
+      {
+	segment.hasName = true;
+	segment.name = chunk.breaks[breakNum].name;
+      }
+    }
+    if (faceNum == chunk.faces.size ())
+      break;
+
+    const ObjFace& face = chunk.faces[faceNum];
+    ObjSegment& segment = chunk.segments.back ();
+    faceIndices.clear ();
+    for (uint32_t corner = 0; corner < face.cornerCount; ++corner)
+    {
+      int rawPosition = chunk.corners[2 * (face.firstCorner + corner)];
+      int rawNormal = chunk.corners[2 * (face.firstCorner + corner) + 1];
+      uint32_t position, normal = NO_NORMAL;
+      if (!resolveIndex (rawPosition, int64_t (chunk.positionBase) + face.positionsBefore,
+			 totalPositions, position)
+	  || (rawNormal != 0
+	      && !resolveIndex (rawNormal, int64_t (chunk.normalBase) + face.normalsBefore,
+				totalNormals, normal)))
+      {
+	chunk.error = "face refers to a vertex or normal that does not exist";
+	return;
+      }
+      uint64_t key = (uint64_t (position) << 32) | normal;
+      std::pair<std::unordered_map<uint64_t, uint32_t>::iterator, bool> inserted =
+	lookup.emplace (key, uint32_t (segment.keys.size ()));
+      if (inserted.second)
+	segment.keys.push_back (key);
+      faceIndices.push_back (inserted.first->second);
+    }
+    // Polygons become fans around their first corner.
+    for (uint32_t corner = 1; corner + 1 < face.cornerCount; ++corner)
+    {
+      segment.indices.push_back (faceIndices[0]);
+      segment.indices.push_back (faceIndices[corner]);
+      segment.indices.push_back (faceIndices[corner + 1]);
+    }
+  }
+}
+
+bool
+parseObj (const char* begin, const char* end, std::vector<ModelMesh>& meshes,
+	  unsigned int threadCount)
+{
+  PROFILE_FUNCTION ();
+  meshes.clear ();
+  if (threadCount == 0)
+    threadCount = JobSystem::getShared ().getThreadCount ();
+
+  // Split into line-aligned chunks.
+  size_t size = end - begin;
+  size_t chunkCount = std::max<size_t> (1, std::min<size_t> (threadCount, size / MIN_CHUNK_BYTES));
+  std::vector<ObjChunk> chunks (chunkCount);
+  const char* chunkStart = begin;
+  for (size_t chunkNum = 0; chunkNum < chunkCount; ++chunkNum)
+  {
+    const char* chunkEnd = end;
+    if (chunkNum + 1 < chunkCount)
+    {
+      chunkEnd = std::max (chunkStart, begin + size * (chunkNum + 1) / chunkCount);
+      const char* newline =
+	static_cast<const char*> (std::memchr (chunkEnd, '\n', end - chunkEnd));
+      chunkEnd = newline == nullptr ? end : newline + 1;
+    }
+    chunks[chunkNum].begin = chunkStart;
+    chunks[chunkNum].end = chunkEnd;
+    chunkStart = chunkEnd;
+  }
+
+  // Pass 1: parse numbers.
+  parallelFor (chunkCount, threadCount,
+	       [&] (size_t chunkNum) { parseChunk (chunks[chunkNum]); });
+  uint32_t totalPositions = 0, totalNormals = 0;
+  for (ObjChunk& chunk : chunks)
+  {
+    if (!chunk.error.empty ())
+    {
+      std::cerr << "Failed to parse OBJ: " << chunk.error << std::endl;
+      return false;
+    }
+    chunk.positionBase = totalPositions;
+    chunk.normalBase = totalNormals;
+    totalPositions += chunk.positions.size () / 3;
+    totalNormals += chunk.normals.size () / 3;
+  }
+
+  // Pass 2: resolve indices now that every chunk knows how many elements
+  //   came before it.
+  parallelFor (chunkCount, threadCount, [&] (size_t chunkNum)
+	       { resolveChunk (chunks[chunkNum], totalPositions, totalNormals); });
+  for (const ObjChunk& chunk : chunks)
+  {
+    if (!chunk.error.empty ())
+    {
+      std::cerr << "Failed to parse OBJ: " << chunk.error << std::endl;
+      return false;
+    }
+  }
+
+  // Gather positions and normals into single arrays.
+  std::vector<float> positions (size_t (totalPositions) * 3);
+  std::vector<float> normals (size_t (totalNormals) * 3);
+  parallelFor (chunkCount, threadCount, [&] (size_t chunkNum)
+	       {
+		 const ObjChunk& chunk = chunks[chunkNum];
+		 std::copy (chunk.positions.begin (), chunk.positions.end (),
+			    positions.begin () + size_t (chunk.positionBase) * 3);
+		 std::copy (chunk.normals.begin (), chunk.normals.end (),
+			    normals.begin () + size_t (chunk.normalBase) * 3);
+	       });
+
+  // Merge segments into meshes.  Only unique keys pass through here, so
+  //   this serial step is much smaller than the file.
+  std::vector<std::vector<uint64_t>> meshKeys;
+  std::vector<std::unordered_map<uint64_t, uint32_t>> meshLookups;
+  std::vector<ObjSegment*> segments;
+  bool startNewMesh = true;
+  std::string currentName;
+  for (ObjChunk& chunk : chunks)
+  {
+    for (ObjSegment& segment : chunk.segments)
+    {
+      if (segment.startsMesh)
+	startNewMesh = true;
+      if (segment.hasName)
+	currentName = segment.name;
+      if (segment.indices.empty ())
+	continue;
+      if (startNewMesh)
+      {
+	meshes.push_back (ModelMesh ());
+	meshes.back ().name = currentName;
+	meshKeys.push_back (std::vector<uint64_t> ());
+	meshLookups.push_back (std::unordered_map<uint64_t, uint32_t> ());
+	startNewMesh = false;
+      }
+      segment.mesh = meshes.size () - 1;
+      std::vector<uint64_t>& keys = meshKeys.back ();
+      std::unordered_map<uint64_t, uint32_t>& lookup = meshLookups.back ();
+      segment.remap.resize (segment.keys.size ());
+      for (size_t keyNum = 0; keyNum < segment.keys.size (); ++keyNum)
+      {
+	std::pair<std::unordered_map<uint64_t, uint32_t>::iterator, bool> inserted =
+	  lookup.emplace (segment.keys[keyNum], uint32_t (keys.size ()));
+	if (inserted.second)
+	  keys.push_back (segment.keys[keyNum]);
+	segment.remap[keyNum] = inserted.first->second;
+      }
+      segment.indexOffset = meshes.back ().indices.size ();
+      meshes.back ().indices.resize (segment.indexOffset + segment.indices.size ());
+      segments.push_back (&segment);
+    }
+  }
+  meshLookups.clear ();
+
+  // Write final indices.
+  parallelFor (segments.size (), threadCount, [&] (size_t segmentNum)
+	       {
+		 const ObjSegment& segment = *segments[segmentNum];
+		 unsigned int* out = meshes[segment.mesh].indices.data () + segment.indexOffset;
+		 for (uint32_t index : segment.indices)
+		   *out++ = segment.remap[index];
+	       });
+
+  // Corners without normals get smooth normals: the area-weighted sum of
+  //   the normals of every such face of the same mesh touching that
+  //   position.  Within a mesh, those corners share one vertex per
+  //   position, so the sums are kept per vertex.
+  std::vector<std::vector<Vector3>> smoothNormals (meshes.size ());
+  for (size_t meshNum = 0; meshNum < meshes.size (); ++meshNum)
+  {
+    const std::vector<uint64_t>& keys = meshKeys[meshNum];
+    const std::vector<unsigned int>& indices = meshes[meshNum].indices;
+    std::vector<Vector3>& smooth = smoothNormals[meshNum];
+    for (size_t i = 0; i < indices.size (); i += 3)
+    {
+      uint64_t corners[3] = { keys[indices[i]], keys[indices[i + 1]], keys[indices[i + 2]] };
+      if (uint32_t (corners[0]) != NO_NORMAL && uint32_t (corners[1]) != NO_NORMAL
+	  && uint32_t (corners[2]) != NO_NORMAL)
+	continue;
+      if (smooth.empty ())
+	smooth.resize (keys.size (), Vector3 (0.0f));
+      Vector3 points[3];
+      for (unsigned int c = 0; c < 3; ++c)
+      {
+	const float* p = &positions[size_t (corners[c] >> 32) * 3];
+	points[c] = Vector3 (p[0], p[1], p[2]);
+      }
+      // Not normalized, so larger faces count for more.
+      Vector3 faceNormal = (points[1] - points[0]).cross (points[2] - points[0]);
+      for (unsigned int c = 0; c < 3; ++c)
+	if (uint32_t (corners[c]) == NO_NORMAL)
+	  smooth[indices[i + c]] += faceNormal;
+    }
+    for (Vector3& normal : smooth)
+      if (normal.length () > 0.0f)
+	normal.normalize ();
+  }
+
+  // Build interleaved position / normal vertices.
+  for (size_t meshNum = 0; meshNum < meshes.size (); ++meshNum)
+  {
+    const std::vector<uint64_t>& keys = meshKeys[meshNum];
+    const std::vector<Vector3>& smooth = smoothNormals[meshNum];
+    std::vector<float>& vertices = meshes[meshNum].vertices;
+    vertices.resize (keys.size () * 6);
+    const size_t BLOCK = 16384;
+    parallelFor ((keys.size () + BLOCK - 1) / BLOCK, threadCount, [&] (size_t block)
+		 {
+		   size_t last = std::min (keys.size (), (block + 1) * BLOCK);
+		   for (size_t v = block * BLOCK; v < last; ++v)
+		   {
+		     size_t position = keys[v] >> 32;
+		     uint32_t normal = uint32_t (keys[v]);
+		     float* out = &vertices[v * 6];
+		     std::copy_n (&positions[position * 3], 3, out);
+		     if (normal == NO_NORMAL)
+		     {
+		       out[3] = smooth[v].m_x;
+		       out[4] = smooth[v].m_y;
+		       out[5] = smooth[v].m_z;
+		     }
+		     else
+		     {
+		       std::copy_n (&normals[size_t (normal) * 3], 3, out + 3);
+		     }
+		   }
+		 });
+  }
+  return true;
+}
+
+bool
+readObj (const std::string& fileName, std::vector<ModelMesh>& meshes,
+	 unsigned int threadCount)
+{
+  PROFILE_FUNCTION ();
+  int fd = open (fileName.c_str (), O_RDONLY);
+  if (fd < 0)
+  {
+    std::cerr << "Failed to open OBJ file " << fileName << std::endl;
+    return false;
+  }
+  struct stat info;
+  if (fstat (fd, &info) != 0)
+  {
+    std::cerr << "Failed to read OBJ file " << fileName << std::endl;
+    close (fd);
+    return false;
+  }
+  if (info.st_size == 0)
+  {
+    close (fd);
+    meshes.clear ();
+    return true;
+  }
+  void* mapping = mmap (nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (mapping == MAP_FAILED)
+  {
+    std::cerr << "Failed to map OBJ file " << fileName << std::endl;
+    return false;
+  }
+  madvise (mapping, info.st_size, MADV_WILLNEED);
+  const char* text = static_cast<const char*> (mapping);
+  bool ok = parseObj (text, text + info.st_size, meshes, threadCount);
+  if (!ok)
+    std::cerr << "(while reading " << fileName << ")" << std::endl;
+  munmap (mapping, info.st_size);
+  return ok;
+}
@@ -0,0 +1,52 @@
+/// \file ObjReader.hpp
+/// \brief Declarations of global functions for reading Wavefront OBJ files
+///   without assimp.
+/// \author Ethan Gingrich
+/// \version A08
+///
+/// The reader maps the file into memory, splits it into line-aligned chunks,
+///   and parses the chunks at once as jobs on the shared JobSystem.  It
+///   understands "v", "vn", and "f" lines (including negative indices and
+///   polygons, which are triangulated as fans), starts a new mesh at every
+///   "o", "g", or "usemtl" line that follows some faces, and ignores
+///   everything else.  Vertices are indexed by their (position, normal)
+///   pair.  Faces without normals get smooth normals averaged from the faces
+///   around each position, like assimp's aiProcess_GenSmoothNormals.
+
+#ifndef OBJ_READER_HPP
+#define OBJ_READER_HPP
+
+#include <string>
+#include <vector>
+
+#include "ModelLoader.hpp"
+
+/// \brief Reads every mesh from an OBJ file.
+/// \param[in] fileName The name of the file to read.
+/// \param[out] meshes A collection that will be replaced by the meshes in
+///   the file, each in the interleaved position / normal layout NormalsMesh
+///   uses.
+/// \param[in] threadCount The number of pieces to parse at once on the
+///   shared JobSystem, or 0 for one per thread it has.  With 1 everything
+///   is parsed on the calling thread.
+/// \return True if the file was read, otherwise false (and an error message
+///   has been printed).
+bool
+readObj (const std::string& fileName, std::vector<ModelMesh>& meshes,
+	 unsigned int threadCount = 0);
+
+/// \brief Reads every mesh from OBJ text that is already in memory.
+/// \param[in] begin The first character of the text.
+/// \param[in] end One past the last character of the text.
+/// \param[out] meshes A collection that will be replaced by the meshes in
+///   the text.
+/// \param[in] threadCount The number of pieces to parse at once on the
+///   shared JobSystem, or 0 for one per thread it has.  With 1 everything
+///   is parsed on the calling thread.
+/// \return True if the text was valid, otherwise false (and an error message
+///   has been printed).
+bool
+parseObj (const char* begin, const char* end, std::vector<ModelMesh>& meshes,
+	  unsigned int threadCount = 0);
+
+#endif//OBJ_READER_HPP
@@ -32,6 +32,10 @@ public:
   virtual void
   attachShader (GLuint program, GLuint shader) = 0;
 
+  /// See documentation of glBeginQuery.
+  virtual void
+  beginQuery (GLenum target, GLuint id) = 0;
+
   /// See documentation of glBindBuffer.
   virtual void
   bindBuffer (GLenum target, GLuint buffer) = 0;
@@ -44,6 +48,10 @@ public:
   virtual void
   bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage) = 0;
 
+  /// See documentation of glBufferSubData.
+  virtual void
+  bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data) = 0;
+
   /// See documentation of glClear.
   virtual void
   clear (GLbitfield mask) = 0;
@@ -52,6 +60,10 @@ public:
   virtual void
   clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) = 0;
 
+  /// See documentation of glClientWaitSync.
+  virtual GLenum
+  clientWaitSync (GLsync sync, GLbitfield flags, GLuint64 timeout) = 0;
+
   /// See documentation of glCompileShader.
   virtual void
   compileShader (GLuint shader) = 0;
@@ -76,10 +88,18 @@ public:
   virtual void
   deleteProgram (GLuint program) = 0;
 
+  /// See documentation of glDeleteQueries.
+  virtual void
+  deleteQueries (GLsizei n, const GLuint* ids) = 0;
+
   /// See documentation of glDeleteShader.
   virtual void
   deleteShader (GLuint shader) = 0;
 
+  /// See documentation of glDeleteSync.
+  virtual void
+  deleteSync (GLsync sync) = 0;
+
   /// See documentation of glDeleteVertexArrays.
   virtual void
   deleteVertexArrays (GLsizei n, const GLuint* arrays) = 0;
@@ -104,6 +124,22 @@ public:
   virtual void
   enableVertexAttribArray (GLuint index) = 0;
 
+  /// See documentation of glEndQuery.
+  virtual void
+  endQuery (GLenum target) = 0;
+
+  /// See documentation of glFenceSync.
+  virtual GLsync
+  fenceSync (GLenum condition, GLbitfield flags) = 0;
+
+  /// See documentation of glFinish.
+  virtual void
+  finish () = 0;
+
+  /// See documentation of glFlush.
+  virtual void
+  flush () = 0;
+
   /// See documentation of glFrontFace.
   virtual void
   frontFace (GLenum mode) = 0;
@@ -112,6 +148,10 @@ public:
   virtual void
   genBuffers (GLsizei n, GLuint* buffers) = 0;
 
+  /// See documentation of glGenQueries.
+  virtual void
+  genQueries (GLsizei n, GLuint* ids) = 0;
+
   /// See documentation of glGenVertexArrays.
   virtual void
   genVertexArrays (GLsizei n, GLuint* arrays) = 0;
@@ -120,6 +160,14 @@ public:
   virtual GLint
   getAttribLocation (GLuint program, const GLchar* name) = 0;
 
+  /// See documentation of glGetIntegerv.
+  virtual void
+  getIntegerv (GLenum pname, GLint* data) = 0;
+
+  /// See documentation of glGetProgramBinary.
+  virtual void
+  getProgramBinary (GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary) = 0;
+
   /// See documentation of glGetProgramInfoLog.
   virtual void
   getProgramInfoLog (GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog) = 0;
@@ -128,6 +176,14 @@ public:
   virtual void
   getProgramiv (GLuint program, GLenum pname, GLint* params) = 0;
 
+  /// See documentation of glGetQueryObjectiv.
+  virtual void
+  getQueryObjectiv (GLuint id, GLenum pname, GLint* params) = 0;
+
+  /// See documentation of glGetQueryObjectui64v.
+  virtual void
+  getQueryObjectui64v (GLuint id, GLenum pname, GLuint64* params) = 0;
+
   /// See documentation of glGetShaderInfoLog.
   virtual void
   getShaderInfoLog (GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog) = 0;
@@ -148,6 +204,22 @@ public:
   virtual void
   linkProgram (GLuint program) = 0;
 
+  /// See documentation of glMaxShaderCompilerThreadsKHR.
+  virtual void
+  maxShaderCompilerThreadsKHR (GLuint count) = 0;
+
+  /// See documentation of glProgramBinary.
+  virtual void
+  programBinary (GLuint program, GLenum binaryFormat, const void* binary, GLsizei length) = 0;
+
+  /// See documentation of glProgramParameteri.
+  virtual void
+  programParameteri (GLuint program, GLenum pname, GLint value) = 0;
+
+  /// See documentation of glQueryCounter.
+  virtual void
+  queryCounter (GLuint id, GLenum target) = 0;
+
   /// See documentation of glShaderSource.
   virtual void
   shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length) = 0;
@@ -0,0 +1,91 @@
+/// \file Quaternion.cpp
+/// \brief Definitions of Quaternion member and associated global functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <cmath>
+#include <iomanip>
+
+#include "Quaternion.hpp"
+
+Quaternion::Quaternion ()
+  : m_w (1.0f), m_x (0.0f), m_y (0.0f), m_z (0.0f)
+{
+}
+
+Quaternion::Quaternion (float w, float x, float y, float z)
+  : m_w (w), m_x (x), m_y (y), m_z (z)
+{
+}
+
+Quaternion::Quaternion (float angleDegrees, const Vector3& axis)
+{
+  Vector3 unitAxis = axis;
+  unitAxis.normalize ();
+  float halfAngle = angleDegrees * static_cast<float> (M_PI) / 360.0f;
+  float s = std::sin (halfAngle);
+  m_w = std::cos (halfAngle);
+  m_x = unitAxis.m_x * s;
+  m_y = unitAxis.m_y * s;
+  m_z = unitAxis.m_z * s;
+}
+
+float
+Quaternion::dot (const Quaternion& q) const
+{
+  return m_w * q.m_w + m_x * q.m_x + m_y * q.m_y + m_z * q.m_z;
+}
+
+void
+Quaternion::normalize ()
+{
+  float inverseLength = 1.0f / std::sqrt (dot (*this));
+  m_w *= inverseLength;
+  m_x *= inverseLength;
+  m_y *= inverseLength;
+  m_z *= inverseLength;
+}
+
+Matrix3
+Quaternion::toMatrix3 () const
+{
+  float xx = m_x * m_x, yy = m_y * m_y, zz = m_z * m_z;
+  float xy = m_x * m_y, xz = m_x * m_z, yz = m_y * m_z;
+  float wx = m_w * m_x, wy = m_w * m_y, wz = m_w * m_z;
+  return Matrix3 (1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy),
+		  2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx),
+		  2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy));
+}
+
+Quaternion
+nlerp (const Quaternion& q1, const Quaternion& q2, float amount)
+{
+  // q and -q are the same rotation; blending toward whichever is nearer
+  //   keeps the result from swinging the long way around.
+  float sign = q1.dot (q2) < 0.0f ? -1.0f : 1.0f;
+  float a = 1.0f - amount;
+  float b = amount * sign;
+  Quaternion result (q1.m_w * a + q2.m_w * b, q1.m_x * a + q2.m_x * b,
+		     q1.m_y * a + q2.m_y * b, q1.m_z * a + q2.m_z * b);
+  result.normalize ();
+  return result;
+}
+
+Quaternion
+operator* (const Quaternion& q1, const Quaternion& q2)
+{
+  return Quaternion (q1.m_w * q2.m_w - q1.m_x * q2.m_x - q1.m_y * q2.m_y - q1.m_z * q2.m_z,
+		     q1.m_w * q2.m_x + q1.m_x * q2.m_w + q1.m_y * q2.m_z - q1.m_z * q2.m_y,
+		     q1.m_w * q2.m_y - q1.m_x * q2.m_z + q1.m_y * q2.m_w + q1.m_z * q2.m_x,
+		     q1.m_w * q2.m_z + q1.m_x * q2.m_y - q1.m_y * q2.m_x + q1.m_z * q2.m_w);
+}
+
+std::ostream&
+operator<< (std::ostream& out, const Quaternion& q)
+{
+  out.setf (std::ios::fixed, std::ios::floatfield);
+  out.precision (2);
+  out << std::setw (10) << q.m_w << " " << std::setw (10) << q.m_x << " "
+      << std::setw (10) << q.m_y << " " << std::setw (10) << q.m_z;
+  return out;
+}
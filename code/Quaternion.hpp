@@ -0,0 +1,94 @@
+/// \file Quaternion.hpp
+/// \brief Declaration of Quaternion class and any associated global
+///   functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef QUATERNION_HPP
+#define QUATERNION_HPP
+
+#include "Matrix3.hpp"
+#include "Vector3.hpp"
+
+/// \brief A rotation, stored as a unit quaternion w + xi + yj + zk.
+/// Animation keys store rotations this way rather than as matrices because
+///   two of them can be blended without shearing, and because they take 4
+///   floats instead of 9.  Like Vector3, the members are public.
+class Quaternion
+{
+ public:
+
+  /// \brief Initializes a new quaternion to no rotation.
+  /// \post w is 1.0f and x, y, and z are 0.0f.
+  Quaternion ();
+
+  /// \brief Initializes a new quaternion from its four parts.
+  /// \param[in] w The real part.
+  /// \param[in] x The coefficient of i.
+  /// \param[in] y The coefficient of j.
+  /// \param[in] z The coefficient of k.
+  /// \post The parts are equal to w, x, y, and z respectively.
+  Quaternion (float w, float x, float y, float z);
+
+  /// \brief Initializes a new quaternion as a rotation around an axis.
+  /// \param[in] angleDegrees How much to rotate.
+  /// \param[in] axis The direction to rotate around, which need not be
+  ///   normalized.
+  Quaternion (float angleDegrees, const Vector3& axis);
+
+  /// \brief Computes the dot product of this and another quaternion.
+  /// \param[in] q The other quaternion.
+  /// \return The dot product.
+  float
+  dot (const Quaternion& q) const;
+
+  /// \brief Scales this quaternion to unit length.
+  /// \pre This quaternion is not all zeros.
+  /// \post The length of this quaternion is 1.0f.
+  void
+  normalize ();
+
+  /// \brief Gets the rotation matrix this quaternion represents.
+  /// \return The matrix.
+  /// \pre This quaternion has unit length.
+  Matrix3
+  toMatrix3 () const;
+
+  /// The real part.
+  float m_w;
+  /// The coefficient of i.
+  float m_x;
+  /// The coefficient of j.
+  float m_y;
+  /// The coefficient of k.
+  float m_z;
+};
+
+/// \brief Blends two rotations by normalized linear interpolation, taking
+///   the shorter way around.
+/// Between animation keys, which are close together, this is
+///   indistinguishable from slerp and much cheaper.
+/// \param[in] q1 The rotation at amount 0.
+/// \param[in] q2 The rotation at amount 1.
+/// \param[in] amount How far to go from q1 toward q2.
+/// \return The blended rotation, with unit length.
+Quaternion
+nlerp (const Quaternion& q1, const Quaternion& q2, float amount);
+
+/// \brief Combines two rotations.
+/// \param[in] q1 The rotation applied second.
+/// \param[in] q2 The rotation applied first.
+/// \return The combined rotation.
+Quaternion
+operator* (const Quaternion& q1, const Quaternion& q2);
+
+/// \brief Inserts a quaternion into an output stream.
+/// Each part is printed with a precision of 2, a field width of 10, and
+///   separated by spaces, in the order w, x, y, z.
+/// \param[inout] out An output stream.
+/// \param[in] q A quaternion.
+/// \return The output stream.
+std::ostream&
+operator<< (std::ostream& out, const Quaternion& q);
+
+#endif//QUATERNION_HPP
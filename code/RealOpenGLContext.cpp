@@ -21,6 +21,12 @@ RealOpenGLContext::attachShader (GLuint program, GLuint shader)
   glAttachShader (program, shader);
 }
 
+void
+RealOpenGLContext::beginQuery (GLenum target, GLuint id)
+{
+  glBeginQuery (target, id);
+}
+
 void
 RealOpenGLContext::bindBuffer (GLenum target, GLuint buffer)
 {
@@ -39,6 +45,12 @@ RealOpenGLContext::bufferData (GLenum target, GLsizeiptr size, const GLvoid* dat
   glBufferData (target, size, data, usage);
 }
 
+void
+RealOpenGLContext::bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+  glBufferSubData (target, offset, size, data);
+}
+
 void
 RealOpenGLContext::clear (GLbitfield mask)
 {
@@ -51,6 +63,12 @@ RealOpenGLContext::clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat
   glClearColor (red, green, blue, alpha);
 }
 
+GLenum
+RealOpenGLContext::clientWaitSync (GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+  return glClientWaitSync (sync, flags, timeout);
+}
+
 void
 RealOpenGLContext::compileShader (GLuint shader)
 {
@@ -87,12 +105,24 @@ RealOpenGLContext::deleteProgram (GLuint program)
   glDeleteProgram (program);
 }
 
+void
+RealOpenGLContext::deleteQueries (GLsizei n, const GLuint* ids)
+{
+  glDeleteQueries (n, ids);
+}
+
 void
 RealOpenGLContext::deleteShader (GLuint shader)
 {
   glDeleteShader (shader);
 }
 
+void
+RealOpenGLContext::deleteSync (GLsync sync)
+{
+  glDeleteSync (sync);
+}
+
 void
 RealOpenGLContext::deleteVertexArrays (GLsizei n, const GLuint* arrays)
 {
@@ -129,6 +159,30 @@ RealOpenGLContext::enableVertexAttribArray (GLuint index)
   glEnableVertexAttribArray (index);
 }
 
+void
+RealOpenGLContext::endQuery (GLenum target)
+{
+  glEndQuery (target);
+}
+
+GLsync
+RealOpenGLContext::fenceSync (GLenum condition, GLbitfield flags)
+{
+  return glFenceSync (condition, flags);
+}
+
+void
+RealOpenGLContext::finish ()
+{
+  glFinish ();
+}
+
+void
+RealOpenGLContext::flush ()
+{
+  glFlush ();
+}
+
 void
 RealOpenGLContext::frontFace (GLenum mode)
 {
@@ -141,6 +195,12 @@ RealOpenGLContext::genBuffers (GLsizei n, GLuint* buffers)
   glGenBuffers (n, buffers);
 }
 
+void
+RealOpenGLContext::genQueries (GLsizei n, GLuint* ids)
+{
+  glGenQueries (n, ids);
+}
+
 void
 RealOpenGLContext::genVertexArrays (GLsizei n, GLuint* arrays)
 {
@@ -153,6 +213,18 @@ RealOpenGLContext::getAttribLocation (GLuint program, const GLchar* name)
   return glGetAttribLocation (program, name);
 }
 
+void
+RealOpenGLContext::getIntegerv (GLenum pname, GLint* data)
+{
+  glGetIntegerv (pname, data);
+}
+
+void
+RealOpenGLContext::getProgramBinary (GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary)
+{
+  glGetProgramBinary (program, bufSize, length, binaryFormat, binary);
+}
+
 void
 RealOpenGLContext::getProgramInfoLog (GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog)
 {
@@ -165,6 +237,18 @@ RealOpenGLContext::getProgramiv (GLuint program, GLenum pname, GLint* params)
   glGetProgramiv (program, pname, params);
 }
 
+void
+RealOpenGLContext::getQueryObjectiv (GLuint id, GLenum pname, GLint* params)
+{
+  glGetQueryObjectiv (id, pname, params);
+}
+
+void
+RealOpenGLContext::getQueryObjectui64v (GLuint id, GLenum pname, GLuint64* params)
+{
+  glGetQueryObjectui64v (id, pname, params);
+}
+
 void
 RealOpenGLContext::getShaderInfoLog (GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog)
 {
@@ -195,6 +279,30 @@ RealOpenGLContext::linkProgram (GLuint program)
   glLinkProgram (program);
 }
 
+void
+RealOpenGLContext::maxShaderCompilerThreadsKHR (GLuint count)
+{
+  glMaxShaderCompilerThreadsKHR (count);
+}
+
+void
+RealOpenGLContext::programBinary (GLuint program, GLenum binaryFormat, const void* binary, GLsizei length)
+{
+  glProgramBinary (program, binaryFormat, binary, length);
+}
+
+void
+RealOpenGLContext::programParameteri (GLuint program, GLenum pname, GLint value)
+{
+  glProgramParameteri (program, pname, value);
+}
+
+void
+RealOpenGLContext::queryCounter (GLuint id, GLenum target)
+{
+  glQueryCounter (id, target);
+}
+
 void
 RealOpenGLContext::shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length)
 {
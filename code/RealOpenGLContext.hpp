@@ -15,7 +15,7 @@
 /// For normal applications, this is the only subclass of OpenGLContext that
 ///   will be needed.  All OpenGL calls should be made through an instance of
 ///   this class.
-class RealOpenGLContext : public OpenGLContext
+class RealOpenGLContext final : public OpenGLContext
 {
 public:
 
@@ -38,6 +38,9 @@ public:
 
   virtual void
   attachShader (GLuint program, GLuint shader);
+
+  virtual void
+  beginQuery (GLenum target, GLuint id);
   
   virtual void
   bindBuffer (GLenum target, GLuint buffer);
@@ -48,12 +51,18 @@ public:
   virtual void
   bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage);
 
+  virtual void
+  bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data);
+
   virtual void
   clear (GLbitfield mask);
 
   virtual void
   clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
 
+  virtual GLenum
+  clientWaitSync (GLsync sync, GLbitfield flags, GLuint64 timeout);
+
   virtual void
   compileShader (GLuint shader);
 
@@ -72,9 +81,15 @@ public:
   virtual void
   deleteProgram (GLuint program);
 
+  virtual void
+  deleteQueries (GLsizei n, const GLuint* ids);
+
   virtual void
   deleteShader (GLuint shader);
 
+  virtual void
+  deleteSync (GLsync sync);
+
   virtual void
   deleteVertexArrays (GLsizei n, const GLuint* arrays);
 
@@ -93,24 +108,51 @@ public:
   virtual void
   enableVertexAttribArray (GLuint index);
 
+  virtual void
+  endQuery (GLenum target);
+
+  virtual GLsync
+  fenceSync (GLenum condition, GLbitfield flags);
+
+  virtual void
+  finish ();
+
+  virtual void
+  flush ();
+
   virtual void
   frontFace (GLenum mode);
 
   virtual void
   genBuffers (GLsizei n, GLuint* buffers);
 
+  virtual void
+  genQueries (GLsizei n, GLuint* ids);
+
   virtual void
   genVertexArrays (GLsizei n, GLuint* arrays);
 
   virtual GLint
   getAttribLocation (GLuint program, const GLchar* name);
 
+  virtual void
+  getIntegerv (GLenum pname, GLint* data);
+
+  virtual void
+  getProgramBinary (GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+
   virtual void
   getProgramInfoLog (GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
 
   virtual void
   getProgramiv (GLuint program, GLenum pname, GLint* params);
 
+  virtual void
+  getQueryObjectiv (GLuint id, GLenum pname, GLint* params);
+
+  virtual void
+  getQueryObjectui64v (GLuint id, GLenum pname, GLuint64* params);
+
   virtual void
   getShaderInfoLog (GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
   
@@ -126,6 +168,18 @@ public:
   virtual void
   linkProgram (GLuint program);
 
+  virtual void
+  maxShaderCompilerThreadsKHR (GLuint count);
+
+  virtual void
+  programBinary (GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+
+  virtual void
+  programParameteri (GLuint program, GLenum pname, GLint value);
+
+  virtual void
+  queryCounter (GLuint id, GLenum target);
+
   virtual void
   shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length);
 
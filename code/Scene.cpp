@@ -3,10 +3,12 @@
 /// \author Ethan Gingrich
 /// \version A02
 
+#include "JobSystem.hpp"
 #include "Scene.hpp"
 
 // Scene Constructor
 Scene::Scene ()
+  : m_profiler (nullptr), m_revision (0), m_captures (0)
 {
 }
 
@@ -14,13 +16,26 @@ Scene::Scene ()
 Scene::~Scene ()
 {
     Scene::clear ();
+    std::lock_guard<std::mutex> lock (m_retiredMutex);
+    for (Retired& retired : m_retired)
+        delete retired.entry.mapped ();
 }
 
 // Adds a Mesh to the Scene using the Meshes map
 void
-Scene::add (const std::string& meshName, Mesh* mesh)
+Scene::add (const std::string& meshName, Mesh* mesh, const std::string& parentName)
 {
     meshes.insert (std::pair<std::string, Mesh*>(meshName, mesh));
+    unsigned int parent = SceneGraph::NO_PARENT;
+    std::map<std::string, unsigned int>::iterator parentItr = m_nodes.find (parentName);
+    if (!parentName.empty () && parentItr != m_nodes.end ())
+        parent = parentItr->second;
+    unsigned int node = m_graph.addNode (mesh->getWorld (), parent);
+    m_nodes.insert (std::pair<std::string, unsigned int>(meshName, node));
+    if (node >= m_syncedRevisions.size ())
+        m_syncedRevisions.resize (node + 1);
+    m_syncedRevisions[node] = mesh->getRevision ();
+    ++m_revision;
     if (meshes.size () == 1)
         setActiveMesh (meshName);
 }
@@ -29,10 +44,32 @@ Scene::add (const std::string& meshName, Mesh* mesh)
 void
 Scene::remove (const std::string& meshName)
 {
+    // Anything attached must be carried from where it really is
+    updateWorlds ();
     std::map<std::string, Mesh*>::iterator itr;
     itr = meshes.find(meshName);
-    delete itr->second;
-    meshes.erase (meshName);
+    unsigned int node = m_nodes[meshName];
+    m_nodes.erase (meshName);
+    std::vector<std::string> children;
+    std::map<std::string, unsigned int>::iterator child;
+    for (child = m_nodes.begin (); child != m_nodes.end (); ++child)
+        if (m_graph.getParent (child->second) == node)
+            children.push_back (child->first);
+    // Attached Meshes move up to its parent, their transforms now carrying
+    //   its own so they stay where they are.
+    m_graph.removeNode (node);
+    for (const std::string& childName : children)
+    {
+        unsigned int childNode = m_nodes[childName];
+        Mesh* childMesh = meshes[childName];
+        childMesh->moveTo (m_graph.getLocal (childNode));
+        m_syncedRevisions[childNode] = childMesh->getRevision ();
+    }
+    // Last, since meshName may be the key it frees
+    bool wasActive = activeMesh == itr;
+    retire (itr);
+    if (wasActive && !meshes.empty ())
+        activeMesh = meshes.begin ();
 }
 
 // Clears all Mesh pointers and key names from the Map
@@ -40,22 +77,156 @@ Scene::remove (const std::string& meshName)
 void
 Scene::clear ()
 {
-    std::map<std::string, Mesh*>::iterator itr;
-    for (itr = meshes.begin(); itr != meshes.end(); ++itr) 
+    while (!meshes.empty ())
+        retire (meshes.begin ());
+    m_nodes.clear ();
+    m_graph.clear ();
+    m_syncedRevisions.clear ();
+}
+
+// Frees the removed Meshes that no snapshot from drawnCapture on mentions
+void
+Scene::releaseRetired (unsigned long drawnCapture)
+{
+    std::lock_guard<std::mutex> lock (m_retiredMutex);
+    std::vector<Retired>::iterator kept = m_retired.begin ();
+    for (Retired& retired : m_retired)
     {
-        delete itr->second;
+        if (retired.capture < drawnCapture)
+            delete retired.entry.mapped ();
+        else
+            *kept++ = std::move (retired);
     }
-    meshes.clear();
+    m_retired.erase (kept, m_retired.end ());
+}
+
+// Takes a Mesh out of meshes, freeing it now if no snapshot was ever taken
+//   and otherwise once releaseRetired says none still mentions it
+void
+Scene::retire (std::map<std::string, Mesh*>::iterator itr)
+{
+    m_revision += itr->second->getRevision () + 1;
+    // Extracting keeps the name where snapshots point to it
+    Retired retired { m_captures, meshes.extract (itr) };
+    if (m_captures == 0)
+    {
+        delete retired.entry.mapped ();
+        return;
+    }
+    std::lock_guard<std::mutex> lock (m_retiredMutex);
+    m_retired.push_back (std::move (retired));
 }
 
 // Draws all Meshes from this Scene
 void
 Scene::draw (const Transform viewMatrix, const Matrix4& projectionMatrix)
 {
-    std::map<std::string, Mesh*>::iterator itr;
-    for (itr = meshes.begin (); itr != meshes.end(); ++itr)
+    updateWorlds ();
+    std::map<std::string, Mesh*>::iterator itr = meshes.begin ();
+    std::map<std::string, unsigned int>::iterator node = m_nodes.begin ();
+    for (; itr != meshes.end(); ++itr, ++node)
+    {
+        GpuProfiler::Scope scope (m_profiler, itr->first);
+        itr->second->copyBonePalette (m_bones);
+        itr->second->draw(viewMatrix, projectionMatrix, m_graph.getWorld (node->second),
+                          &m_bones);
+    }
+}
+
+// Draws every Mesh in a snapshot of this Scene
+void
+Scene::draw (const SceneSnapshot& snapshot, float alpha)
+{
+    const Transform view = snapshot.getView (alpha);
+    for (const SceneSnapshot::Instance& instance : snapshot.instances)
+    {
+        GpuProfiler::Scope scope (m_profiler, *instance.name);
+        instance.mesh->draw (view, snapshot.projection, instance.getWorld (alpha),
+                             &instance.bones);
+    }
+}
+
+// Records the calls that draw a snapshot of this Scene, as jobs
+void
+Scene::recordDraw (const SceneSnapshot& snapshot, float alpha,
+                   const std::vector<CommandBufferContext*>& buffers)
+{
+    const Transform view = snapshot.getView (alpha);
+    m_drawList.clear ();
+    for (const SceneSnapshot::Instance& instance : snapshot.instances)
+    {
+        if (instance.mesh->prepareDraw ())
+            m_drawList.push_back (&instance);
+    }
+
+    size_t slices = buffers.size ();
+    auto recordSlice = [&] (size_t slice)
+    {
+        CommandBufferContext* buffer = buffers[slice];
+        buffer->reset ();
+        size_t end = m_drawList.size () * (slice + 1) / slices;
+        for (size_t mesh = m_drawList.size () * slice / slices; mesh < end; ++mesh)
+        {
+            const SceneSnapshot::Instance* instance = m_drawList[mesh];
+            instance->mesh->recordDraw (buffer, view, snapshot.projection,
+                                        instance->getWorld (alpha), &instance->bones);
+        }
+    };
+    JobSystem::getShared ().parallelFor (slices, 1, [&] (size_t begin, size_t end)
+    {
+        for (size_t slice = begin; slice < end; ++slice)
+            recordSlice (slice);
+    });
+}
+
+// Copies in the transforms of Meshes that moved, and recomposes their
+//   subtrees
+unsigned int
+Scene::updateWorlds ()
+{
+    std::map<std::string, Mesh*>::iterator itr = meshes.begin ();
+    std::map<std::string, unsigned int>::iterator node = m_nodes.begin ();
+    for (; itr != meshes.end (); ++itr, ++node)
+    {
+        unsigned long revision = itr->second->getRevision ();
+        if (revision != m_syncedRevisions[node->second])
+        {
+            m_graph.setLocal (node->second, itr->second->getWorld ());
+            // Jumps aren't blended across a frame
+            if (itr->second->getTeleportRevision () > m_syncedRevisions[node->second])
+                m_graph.snap (node->second);
+            m_syncedRevisions[node->second] = revision;
+        }
+    }
+    return m_graph.update ();
+}
+
+// Has every Mesh remember where it is as where it was
+void
+Scene::savePreviousWorlds ()
+{
+    updateWorlds ();
+    m_graph.savePreviousWorlds ();
+}
+
+// Copies where every Mesh is and was into a snapshot
+void
+Scene::capture (SceneSnapshot& snapshot)
+{
+    updateWorlds ();
+    snapshot.capture = ++m_captures;
+    snapshot.instances.resize (meshes.size ());
+    size_t index = 0;
+    std::map<std::string, Mesh*>::const_iterator itr = meshes.begin ();
+    std::map<std::string, unsigned int>::const_iterator node = m_nodes.begin ();
+    for (; itr != meshes.end (); ++itr, ++node, ++index)
     {
-        itr->second->draw(viewMatrix, projectionMatrix);
+        SceneSnapshot::Instance& instance = snapshot.instances[index];
+        instance.mesh = itr->second;
+        instance.name = &itr->first;
+        instance.previousWorld = m_graph.getPreviousWorld (node->second);
+        instance.world = m_graph.getWorld (node->second);
+        itr->second->copyBonePalette (instance.bones);
     }
 }
 
@@ -63,15 +234,45 @@ Scene::draw (const Transform viewMatrix, const Matrix4& projectionMatrix)
 bool
 Scene::hasMesh (const std::string& meshName)
 {
-    std::map<std::string, Mesh*>::iterator itr;
+    return meshes.find (meshName) != meshes.end ();
+}
+
+// Counts the Meshes in this Scene
+unsigned int
+Scene::getMeshCount () const
+{
+    return meshes.size ();
+}
+
+// Counts the triangles in all Meshes in this Scene
+unsigned long
+Scene::getTriangleCount () const
+{
+    unsigned long triangles = 0;
+    std::map<std::string, Mesh*>::const_iterator itr;
     for (itr = meshes.begin (); itr != meshes.end(); ++itr)
     {
-        if (itr->first == meshName)
-        {
-            return true;
-        }
+        triangles += itr->second->getIndexCount () / 3;
     }
-    return false;
+    return triangles;
+}
+
+// Sums this Scene's own revision and every Mesh's
+unsigned long
+Scene::getRevision () const
+{
+    unsigned long revision = m_revision;
+    std::map<std::string, Mesh*>::const_iterator itr;
+    for (itr = meshes.begin (); itr != meshes.end (); ++itr)
+        revision += itr->second->getRevision ();
+    return revision;
+}
+
+// Sets the profiler that times each Mesh's draw
+void
+Scene::setGpuProfiler (GpuProfiler* profiler)
+{
+    m_profiler = profiler;
 }
 
 // Find and return a certain Mesh from this scene
@@ -97,33 +298,36 @@ Scene::setActiveMesh (const std::string& meshName)
 }
 
 /// \brief Gets the active mesh.
-/// \pre The scene has at least one mesh.
-/// \return The active mesh.
+/// \return The active mesh, or nullptr if the scene is empty.
 Mesh*
 Scene::getActiveMesh ()
 {
+    if (meshes.empty ())
+        return nullptr;
     return activeMesh->second;
 }
 
 /// \brief Switches active meshes in the forward direction.
-/// \pre The scene has at least one mesh.
 /// \post The next mesh becomes active.  If the last mesh was active, the
 ///   first mesh becomes active.
 void
 Scene::activateNextMesh ()
 {
+    if (meshes.empty ())
+        return;
     activeMesh++;
     if (activeMesh == meshes.end ())
         activeMesh = meshes.begin ();
 }
 
 /// \brief Switches active meshes in the backward direction.
-/// \pre The scene has at least one mesh.
 /// \post The previous mesh becomes active.  If the first mesh was active,
 ///   the last mesh becomes active.
 void
 Scene::activatePreviousMesh ()
 {
+    if (meshes.empty ())
+        return;
     if (activeMesh == meshes.begin ())
     {
         activeMesh = meshes.end ();
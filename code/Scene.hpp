@@ -8,13 +8,24 @@
 
 #include <string>
 #include <map>
+#include <vector>
+#include <mutex>
 
 #include "Mesh.hpp"
 #include "ShaderProgram.hpp"
 #include "Matrix4.hpp"
 #include "Camera.hpp"
+#include "GpuProfiler.hpp"
+#include "CommandBufferContext.hpp"
+#include "SceneSnapshot.hpp"
+#include "SceneGraph.hpp"
 
 /// \brief A collection of all the objects that exist in the world.
+/// Meshes can be attached to other Meshes, in which case a Mesh's world
+///   matrix (see Mesh::getWorld) is taken as relative to its parent's, and
+///   moving the parent carries it along.  The Scene keeps the composed
+///   transforms in a SceneGraph, which recomputes only the subtrees of
+///   Meshes that moved.
 class Scene
 {
 public:
@@ -41,25 +52,42 @@ public:
   /// \param[in] mesh A pointer to the Mesh that should be added.  This Mesh
   ///   must have been dynamically allocated.  The Scene will now own this Mesh
   ///   and be responsible for de-allocating it.
+  /// \param[in] parentName The name of the Mesh this one is attached to,
+  ///   or empty (or a name not in the Scene) to attach it to nothing.
   /// \pre The Scene does not contain any Mesh associated with meshName.
   /// \post The Scene contains the mesh, associated with the meshName.
   void
-  add (const std::string& meshName, Mesh* mesh);
+  add (const std::string& meshName, Mesh* mesh, const std::string& parentName = "");
 
   /// \brief Removes a Mesh from this Scene.
   /// \param[in] meshName The name of the Mesh that should be removed.
   /// \pre This Scene contains a Mesh associated with meshName.
   /// \post This Scene no longer associates meshName with anything.
-  /// \post The Mesh that had been associated with meshName has been freed.
+  /// \post The Mesh that had been associated with meshName has been freed,
+  ///   or, if a snapshot has ever been captured, will be freed by the
+  ///   first releaseRetired that says no snapshot in use mentions it.
+  ///   Meshes attached to it are attached to its parent instead, and their
+  ///   world matrices changed so they stay where they are.
   void
   remove (const std::string& meshName);
 
   /// \brief Removes all Meshes from this Scene.
   /// \post This Scene is empty.
-  /// \post All Meshes that had been part of this Scene have been freed.
+  /// \post All Meshes that had been part of this Scene have been freed, or
+  ///   will be as remove describes.
   void
   clear ();
 
+  /// \brief Frees the removed Meshes that no snapshot still in use
+  ///   mentions.  Called by the thread that draws snapshots, which is also
+  ///   the one their GL objects belong to, once it has picked up the one it
+  ///   will draw next.  Safe to call while another thread changes the
+  ///   Scene.
+  /// \param[in] drawnCapture The SceneSnapshot::capture of the snapshot
+  ///   being drawn.  Every snapshot it reads later must be newer.
+  void
+  releaseRetired (unsigned long drawnCapture);
+
   /// \brief Draws all of the elements in this Scene.
   /// \param[in] shaderProgram The ShaderProgram that should be used for
   ///   drawing.
@@ -70,6 +98,48 @@ public:
   void
   draw (Transform viewMatrix, const Matrix4& projectionMatrix);
 
+  /// \brief Draws a snapshot of this Scene, ignoring where its Meshes are
+  ///   now.
+  /// \param[in] snapshot The snapshot, taken with capture.
+  /// \param[in] alpha How far through the snapshot's tick to draw, from 0
+  ///   to 1.
+  /// \pre Every Mesh in the snapshot is still in this Scene.
+  void
+  draw (const SceneSnapshot& snapshot, float alpha);
+
+  /// \brief Records the calls that draw a snapshot of this Scene into
+  ///   command buffers, splitting the Meshes into one contiguous slice per
+  ///   buffer and recording the slices as jobs on the shared JobSystem.
+  ///   Replaying the buffers in order draws the same thing as draw.
+  /// \param[in] snapshot The snapshot, taken with capture.
+  /// \param[in] alpha How far through the snapshot's tick to draw.
+  /// \param[in] buffers The buffers to record into, which are reset first.
+  ///   The calling thread records the first slice.
+  /// \pre Called on the thread that owns the OpenGL context, since each
+  ///   Mesh's prepareDraw is run first.
+  void
+  recordDraw (const SceneSnapshot& snapshot, float alpha,
+	      const std::vector<CommandBufferContext*>& buffers);
+
+  /// \brief Brings every Mesh's composed world transform up to date with
+  ///   the Meshes' own.  Only the subtrees of Meshes that moved since the
+  ///   last call are recomputed.
+  /// \return The number of transforms recomputed.
+  unsigned int
+  updateWorlds ();
+
+  /// \brief Has every Mesh remember its world transform as its previous
+  ///   one.  Called at the start of each simulation step.
+  void
+  savePreviousWorlds ();
+
+  /// \brief Copies every Mesh's current and previous composed world
+  ///   transforms into a snapshot, updating them first.
+  /// \param[in,out] snapshot The snapshot whose instances and capture are
+  ///   replaced.  Its other members are left for the caller to fill in.
+  void
+  capture (SceneSnapshot& snapshot);
+
   /// \brief Tests whether or not this Scene contains a Mesh associated with a
   ///   name.
   /// \param[in] meshName The name of the requested Mesh.
@@ -78,6 +148,29 @@ public:
   bool
   hasMesh (const std::string& meshName);
 
+  /// \brief Gets the number of Meshes in this Scene.
+  /// \return The number of Meshes.
+  unsigned int
+  getMeshCount () const;
+
+  /// \brief Gets the number of triangles in all of this Scene's Meshes.
+  /// \return The number of triangles.
+  unsigned long
+  getTriangleCount () const;
+
+  /// \brief Gets a number that grows whenever a Mesh is added or removed
+  ///   or any Mesh's world transform changes, so a renderer can tell
+  ///   whether there is anything new to draw.
+  /// \return The revision.
+  unsigned long
+  getRevision () const;
+
+  /// \brief Sets the profiler that times each Mesh's draw on the GPU.
+  /// \param[in] profiler The profiler, or nullptr to stop timing.  The Scene
+  ///   does not own it.
+  void
+  setGpuProfiler (GpuProfiler* profiler);
+
   /// \brief Gets the Mesh associated with a name.
   /// \param[in] meshName The name of the requested Mesh.
   /// \return A pointer to the Mesh associated with meshName.  This pointer
@@ -100,21 +193,19 @@ public:
   setActiveMesh (const std::string& meshName);
 
   /// \brief Gets the active mesh.
-  /// \pre The scene has at least one mesh.
-  /// \return The active mesh.
+  /// \return The active mesh, or nullptr if the scene is empty (for
+  ///   example, while its Meshes are still loading).
   Mesh*
   getActiveMesh ();
 
   /// \brief Switches active meshes in the forward direction.
-  /// \pre The scene has at least one mesh.
-  /// \post The next mesh becomes active.  If the last mesh was active, the
+  /// \post Does nothing if the scene is empty.  Otherwise the next mesh becomes active.  If the last mesh was active, the
   ///   first mesh becomes active.
   void
   activateNextMesh ();
 
   /// \brief Switches active meshes in the backward direction.
-  /// \pre The scene has at least one mesh.
-  /// \post The previous mesh becomes active.  If the first mesh was active,
+  /// \post Does nothing if the scene is empty.  Otherwise the previous mesh becomes active.  If the first mesh was active,
   ///   the last mesh becomes active.
   void
   activatePreviousMesh ();
@@ -125,9 +216,54 @@ private:
 /// Map of meshes in the scene
 std::map<std::string, Mesh*> meshes;
 
+/// Each Mesh's node in m_graph, under the same names as meshes
+std::map<std::string, unsigned int> m_nodes;
+
+/// The Meshes' composed world transforms
+SceneGraph m_graph;
+
+/// For each node, the revision of its Mesh last copied into m_graph
+std::vector<unsigned long> m_syncedRevisions;
+
 /// Points to the active mesh
 std::map<std::string, Mesh*>::iterator activeMesh;
 
+/// Times each Mesh's draw, or nullptr
+GpuProfiler* m_profiler;
+
+/// The Meshes recordDraw found ready, kept to reuse its memory
+std::vector<const SceneSnapshot::Instance*> m_drawList;
+
+/// The bone palette of the Mesh draw is drawing, kept to reuse its memory
+std::vector<float> m_bones;
+
+/// Counts Meshes added, plus the revisions of Meshes removed, so that
+///   getRevision never goes back
+unsigned long m_revision;
+
+/// \brief A removed Mesh that a snapshot may still mention.
+struct Retired
+{
+  /// The number of snapshots captured before it was removed
+  unsigned long capture;
+  /// Its entry from meshes, which keeps the name snapshots point to
+  std::map<std::string, Mesh*>::node_type entry;
+};
+
+/// \brief Takes a Mesh out of meshes and retires it.
+/// \param[in] itr The Mesh's entry.
+void
+retire (std::map<std::string, Mesh*>::iterator itr);
+
+/// The number of snapshots captured so far
+unsigned long m_captures;
+
+/// Removed Meshes waiting for releaseRetired, oldest first
+std::vector<Retired> m_retired;
+
+/// Guards m_retired, which the drawing thread empties
+std::mutex m_retiredMutex;
+
 };
 
 #endif//SCENE_HPP
@@ -0,0 +1,224 @@
+/// \file SceneGraph.cpp
+/// \brief Definitions of SceneGraph member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <algorithm>
+#include <cassert>
+
+#include "SceneGraph.hpp"
+
+const unsigned int SceneGraph::NO_PARENT;
+const unsigned int SceneGraph::NO_POSITION;
+
+SceneGraph::SceneGraph ()
+{
+}
+
+unsigned int
+SceneGraph::addNode (const Transform& local, unsigned int parent)
+{
+  unsigned int id = m_positions.size ();
+  if (!m_freeIds.empty ())
+  {
+    id = m_freeIds.back ();
+    m_freeIds.pop_back ();
+  }
+  unsigned int position = m_ids.size ();
+  unsigned int parentPosition = NO_PARENT;
+  if (parent != NO_PARENT)
+  {
+    assert (parent < m_positions.size () && m_positions[parent] != NO_POSITION);
+    // The new node goes at the end of its parent's subtree, which grows by
+    //   one, as do all of the parent's ancestors'.
+    parentPosition = m_positions[parent];
+    position = parentPosition + m_subtreeSizes[parentPosition];
+    for (unsigned int ancestor = parentPosition; ancestor != NO_PARENT; ancestor = m_parents[ancestor])
+      ++m_subtreeSizes[ancestor];
+  }
+  if (position < m_ids.size ())
+  {
+    // Everything from there on moves up one.  Ancestors come earlier, so
+    //   none of them move.
+    for (unsigned int& other : m_parents)
+      if (other != NO_PARENT && other >= position)
+	++other;
+    for (unsigned int& other : m_positions)
+      if (other != NO_POSITION && other >= position)
+	++other;
+  }
+
+  m_parents.insert (m_parents.begin () + position, parentPosition);
+  m_subtreeSizes.insert (m_subtreeSizes.begin () + position, 1);
+  m_locals.insert (m_locals.begin () + position, local);
+  m_worlds.insert (m_worlds.begin () + position, local);
+  m_previousWorlds.insert (m_previousWorlds.begin () + position, local);
+  m_ids.insert (m_ids.begin () + position, id);
+  if (id == m_positions.size ())
+    m_positions.push_back (position);
+  else
+    m_positions[id] = position;
+  m_dirtyNodes.push_back (id);
+  m_snappedNodes.push_back (id);
+  return id;
+}
+
+void
+SceneGraph::removeNode (unsigned int node)
+{
+  assert (node < m_positions.size () && m_positions[node] != NO_POSITION);
+  unsigned int position = m_positions[node];
+  unsigned int parentPosition = m_parents[position];
+  unsigned int end = position + m_subtreeSizes[position];
+
+  // The children's subtrees follow the node in order, so once it is gone
+  //   they are still a depth-first run inside its parent's.
+  for (unsigned int child = position + 1; child < end; child += m_subtreeSizes[child])
+  {
+    m_locals[child] = m_locals[position] * m_locals[child];
+    markDirty (m_ids[child]);
+  }
+  for (unsigned int ancestor = parentPosition; ancestor != NO_PARENT; ancestor = m_parents[ancestor])
+    --m_subtreeSizes[ancestor];
+
+  // Everything after it moves down one.  Ancestors come earlier, so none
+  //   of them move.
+  for (unsigned int& other : m_parents)
+    if (other == position)
+      other = parentPosition;
+    else if (other != NO_PARENT && other > position)
+      --other;
+  for (unsigned int& other : m_positions)
+    if (other != NO_POSITION && other > position)
+      --other;
+
+  m_parents.erase (m_parents.begin () + position);
+  m_subtreeSizes.erase (m_subtreeSizes.begin () + position);
+  m_locals.erase (m_locals.begin () + position);
+  m_worlds.erase (m_worlds.begin () + position);
+  m_previousWorlds.erase (m_previousWorlds.begin () + position);
+  m_ids.erase (m_ids.begin () + position);
+  m_positions[node] = NO_POSITION;
+  m_freeIds.push_back (node);
+  m_dirtyNodes.erase (std::remove (m_dirtyNodes.begin (), m_dirtyNodes.end (), node),
+		      m_dirtyNodes.end ());
+  m_snappedNodes.erase (std::remove (m_snappedNodes.begin (), m_snappedNodes.end (), node),
+			m_snappedNodes.end ());
+}
+
+void
+SceneGraph::snap (unsigned int node)
+{
+  m_snappedNodes.push_back (node);
+}
+
+void
+SceneGraph::setLocal (unsigned int node, const Transform& local)
+{
+  m_locals[m_positions[node]] = local;
+  markDirty (node);
+}
+
+const Transform&
+SceneGraph::getLocal (unsigned int node) const
+{
+  return m_locals[m_positions[node]];
+}
+
+const Transform&
+SceneGraph::getWorld (unsigned int node) const
+{
+  return m_worlds[m_positions[node]];
+}
+
+const Transform&
+SceneGraph::getPreviousWorld (unsigned int node) const
+{
+  return m_previousWorlds[m_positions[node]];
+}
+
+unsigned int
+SceneGraph::getParent (unsigned int node) const
+{
+  unsigned int parentPosition = m_parents[m_positions[node]];
+  return parentPosition == NO_PARENT ? NO_PARENT : m_ids[parentPosition];
+}
+
+unsigned int
+SceneGraph::getNodeCount () const
+{
+  return m_ids.size ();
+}
+
+unsigned int
+SceneGraph::update ()
+{
+  if (m_dirtyNodes.empty () && m_snappedNodes.empty ())
+    return 0;
+
+  // Each changed subtree is one run of positions.  Two subtrees are either
+  //   nested or apart, so once the runs are sorted, any that starts inside
+  //   the one before is inside it and already covered.
+  m_runs.clear ();
+  for (unsigned int node : m_dirtyNodes)
+  {
+    unsigned int position = m_positions[node];
+    m_runs.push_back (std::make_pair (position, position + m_subtreeSizes[position]));
+  }
+  std::sort (m_runs.begin (), m_runs.end ());
+
+  unsigned int recomputed = 0;
+  unsigned int covered = 0;
+  for (const std::pair<unsigned int, unsigned int>& run : m_runs)
+  {
+    // Parents come before children, so each parent's world is current by
+    //   the time its children read it.
+    for (unsigned int position = std::max (run.first, covered); position < run.second; ++position)
+    {
+      unsigned int parent = m_parents[position];
+      if (parent == NO_PARENT)
+	m_worlds[position] = m_locals[position];
+      else
+	m_worlds[position] = m_worlds[parent] * m_locals[position];
+      ++recomputed;
+    }
+    covered = std::max (covered, run.second);
+  }
+
+  for (unsigned int node : m_snappedNodes)
+  {
+    unsigned int position = m_positions[node];
+    std::copy (m_worlds.begin () + position, m_worlds.begin () + position + m_subtreeSizes[position],
+	       m_previousWorlds.begin () + position);
+  }
+  m_dirtyNodes.clear ();
+  m_snappedNodes.clear ();
+  return recomputed;
+}
+
+void
+SceneGraph::savePreviousWorlds ()
+{
+  m_previousWorlds = m_worlds;
+}
+
+void
+SceneGraph::clear ()
+{
+  m_parents.clear ();
+  m_subtreeSizes.clear ();
+  m_locals.clear ();
+  m_worlds.clear ();
+  m_previousWorlds.clear ();
+  m_ids.clear ();
+  m_positions.clear ();
+  m_freeIds.clear ();
+  m_dirtyNodes.clear ();
+  m_snappedNodes.clear ();
+}
+
+void
+SceneGraph::markDirty (unsigned int node)
+{
+  m_dirtyNodes.push_back (node);
+}
@@ -0,0 +1,152 @@
+/// \file SceneGraph.hpp
+/// \brief Declaration of SceneGraph class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef SCENE_GRAPH_HPP
+#define SCENE_GRAPH_HPP
+
+#include <utility>
+#include <vector>
+
+#include "Transform.hpp"
+
+/// \brief A hierarchy of transforms, where each node's world transform is
+///   its parent's world transform times its own local one.
+/// Nodes are stored depth first in flat arrays, so every subtree is one
+///   contiguous run with its root first.  Changing a node's local transform
+///   only marks its subtree; update then recomputes each marked run in one
+///   linear pass, parents before children, and leaves everything else
+///   alone.  Nodes are named by ids that stay the same however the arrays
+///   shift.
+class SceneGraph
+{
+public:
+
+  /// The parent of a root node.
+  static const unsigned int NO_PARENT = ~0u;
+
+  /// The position of a removed node.
+  static const unsigned int NO_POSITION = ~0u;
+
+  /// \brief Constructs an empty SceneGraph.
+  SceneGraph ();
+
+  /// \brief Adds a node.
+  /// \param[in] local The node's transform relative to its parent.
+  /// \param[in] parent The parent's id, or NO_PARENT for a root.
+  /// \return The new node's id.
+  /// \post The node's world transform is computed by the next update, and
+  ///   it is snapped, so its appearance isn't blended in from somewhere
+  ///   else.
+  /// Adding a root, or a child of the node added last or one of its
+  ///   ancestors (as a depth-first walk of a model does), appends; adding a
+  ///   child anywhere else shifts the nodes after it, which takes time
+  ///   linear in their number.
+  unsigned int
+  addNode (const Transform& local, unsigned int parent = NO_PARENT);
+
+  /// \brief Removes a node, attaching its children to its parent.
+  /// \param[in] node The node's id, which addNode may hand out again.
+  /// \post Each child's local transform is its old parent's local transform
+  ///   times its own, so it stays where it is in the world.
+  /// Takes time linear in the number of nodes.
+  void
+  removeNode (unsigned int node);
+
+  /// \brief Makes the next update set a node's previous world transform,
+  ///   and its descendants', to match its new world transform, so a jump
+  ///   isn't blended across a frame.
+  /// \param[in] node The node's id.
+  void
+  snap (unsigned int node);
+
+  /// \brief Replaces a node's local transform.
+  /// \param[in] node The node's id.
+  /// \param[in] local The new transform.
+  /// \post The node and its descendants are recomputed by the next update.
+  void
+  setLocal (unsigned int node, const Transform& local);
+
+  /// \brief Gets a node's local transform.
+  /// \param[in] node The node's id.
+  /// \return The transform.
+  const Transform&
+  getLocal (unsigned int node) const;
+
+  /// \brief Gets a node's world transform as of the last update.
+  /// \param[in] node The node's id.
+  /// \return The transform.
+  const Transform&
+  getWorld (unsigned int node) const;
+
+  /// \brief Gets a node's world transform as of the last
+  ///   savePreviousWorlds.
+  /// \param[in] node The node's id.
+  /// \return The transform.
+  const Transform&
+  getPreviousWorld (unsigned int node) const;
+
+  /// \brief Gets a node's parent.
+  /// \param[in] node The node's id.
+  /// \return The parent's id, or NO_PARENT for a root.
+  unsigned int
+  getParent (unsigned int node) const;
+
+  /// \brief Gets the number of nodes.
+  /// \return The number of nodes.
+  unsigned int
+  getNodeCount () const;
+
+  /// \brief Recomputes the world transforms of every node whose local
+  ///   transform, or an ancestor's, changed since the last update.
+  /// \return The number of nodes recomputed.
+  unsigned int
+  update ();
+
+  /// \brief Remembers every node's world transform as its previous one.
+  ///   Called at the start of each simulation step, after update, so that
+  ///   drawing can blend between the last two.
+  void
+  savePreviousWorlds ();
+
+  /// \brief Removes every node.
+  void
+  clear ();
+
+private:
+
+  /// \brief Marks a node's subtree for the next update.
+  /// \param[in] node The node's id.
+  void
+  markDirty (unsigned int node);
+
+  // Indexed by position in depth-first order:
+  /// The position of each node's parent, or NO_PARENT.
+  std::vector<unsigned int> m_parents;
+  /// The number of nodes in each node's subtree, counting itself.
+  std::vector<unsigned int> m_subtreeSizes;
+  /// Each node's transform relative to its parent.
+  std::vector<Transform> m_locals;
+  /// Each node's world transform as of the last update.
+  std::vector<Transform> m_worlds;
+  /// Each node's world transform as of the last savePreviousWorlds.
+  std::vector<Transform> m_previousWorlds;
+  /// Each node's id.
+  std::vector<unsigned int> m_ids;
+
+  /// Indexed by id: each node's position, or NO_POSITION if the id is
+  ///   free.
+  std::vector<unsigned int> m_positions;
+  /// Ids of removed nodes, to hand out again.
+  std::vector<unsigned int> m_freeIds;
+
+  /// The ids of the roots of subtrees changed since the last update.
+  std::vector<unsigned int> m_dirtyNodes;
+  /// The ids of the roots of subtrees snapped since the last update.
+  std::vector<unsigned int> m_snappedNodes;
+  /// The runs of positions update recomputes, kept to reuse its memory.
+  std::vector<std::pair<unsigned int, unsigned int>> m_runs;
+};
+
+#endif//SCENE_GRAPH_HPP
@@ -0,0 +1,112 @@
+/// \file SceneSnapshot.hpp
+/// \brief Declaration of the SceneSnapshot struct.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef SCENE_SNAPSHOT_HPP
+#define SCENE_SNAPSHOT_HPP
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "Matrix4.hpp"
+#include "Transform.hpp"
+
+class Mesh;
+
+/// \brief Everything the renderer needs from one simulation tick: where the
+///   camera and each Mesh were at its start and at its end.
+/// The update thread fills one of these at the end of every tick and hands
+///   it over through a TripleBuffer, so the render thread draws a consistent
+///   picture without ever reading a Transform the update thread is writing.
+///   Drawing blends the two ends of the tick, so motion stays smooth
+///   whether frames come faster or slower than ticks.
+struct SceneSnapshot
+{
+  /// \brief One Mesh and where to draw it.
+  struct Instance
+  {
+    /// The Mesh, which the Scene still owns.  It stays alive after being
+    ///   removed until Scene::releaseRetired is passed a newer capture.
+    Mesh* mesh;
+    /// The Mesh's name in the Scene, for profiling.
+    const std::string* name;
+    /// The Mesh's world transform at the start of the tick.
+    Transform previousWorld;
+    /// The Mesh's world transform at the end of the tick.
+    Transform world;
+    /// The Mesh's bone palette at the end of the tick (see
+    ///   Mesh::copyBonePalette), or empty.  Poses aren't blended, so a
+    ///   skinned Mesh's pose moves on at the tick rate while its world
+    ///   transform moves smoothly.
+    std::vector<float> bones;
+
+    /// \brief Gets the Mesh's world transform part way through the tick.
+    /// \param[in] alpha How far through the tick, from 0 to 1.
+    /// \return The blended world transform.
+    Transform
+    getWorld (float alpha) const
+    {
+      return lerp (previousWorld, world, alpha);
+    }
+  };
+
+  /// \brief Gets the camera's view matrix part way through the tick.
+  /// \param[in] alpha How far through the tick, from 0 to 1.
+  /// \return The blended view matrix.
+  Transform
+  getView (float alpha) const
+  {
+    return lerp (previousView, view, alpha);
+  }
+
+  /// The camera's view matrix at the start of the tick.
+  Transform previousView;
+  /// The camera's view matrix at the end of the tick.
+  Transform view;
+  /// The camera's projection matrix.
+  Matrix4 projection;
+  /// Every Mesh in the Scene, in drawing order.
+  std::vector<Instance> instances;
+  /// The Scene's count of captures, including this one, so the drawing
+  ///   thread can tell it which removed Meshes are safe to free (see
+  ///   Scene::releaseRetired).  0 means nothing has been captured.
+  unsigned long capture = 0;
+  /// The number of the tick this was taken at, counting from 1.  0 means
+  ///   nothing has been captured.
+  unsigned long tick = 0;
+  /// The simulation time at the end of the tick, in seconds.
+  double time = 0.0;
+  /// The length of the tick, in seconds, or 0 if there was no tick and
+  ///   there is nothing to blend.
+  double tickSeconds = 0.0;
+  /// When the tick was due to finish.  Drawing shows the start of the tick
+  ///   then and its end one tick later, so it stays exactly one tick behind
+  ///   the simulation however the two threads happen to be scheduled.
+  std::chrono::steady_clock::time_point due;
+  /// When the oldest input event first taken in by the ticks since the
+  ///   previous snapshot happened, in glfwGetTime seconds, or a negative
+  ///   number if they took in none.
+  double oldestInput = -1.0;
+  /// The sum of the Camera's and the Scene's revisions at the end of the
+  ///   tick.  Equal revisions mean equal pictures.
+  unsigned long revision = 0;
+  /// Whether anything changed during the tick, so drawing part way through
+  ///   it differs from drawing its end.
+  bool moving = false;
+
+  /// \brief Gets how far through the tick drawing should be at some time.
+  /// \param[in] now The time.
+  /// \return From 0 (the start of the tick) to 1 (its end).
+  float
+  getAlpha (std::chrono::steady_clock::time_point now) const
+  {
+    if (tickSeconds <= 0.0)
+      return 1.0f;
+    double alpha = std::chrono::duration<double> (now - due).count () / tickSeconds;
+    return static_cast<float> (alpha < 0.0 ? 0.0 : alpha > 1.0 ? 1.0 : alpha);
+  }
+};
+
+#endif//SCENE_SNAPSHOT_HPP
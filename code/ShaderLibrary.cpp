@@ -0,0 +1,140 @@
+/// \file ShaderLibrary.cpp
+/// \brief Definitions of ShaderLibrary member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "ShaderLibrary.hpp"
+
+ShaderLibrary::ShaderLibrary (GlContext* context, bool parallelCompile)
+  : m_context (context), m_parallelCompile (parallelCompile), m_submitted (0),
+    m_unfinished (0), m_cachedPrograms (0)
+{
+  // Let the driver pick how many compiler threads to use.
+  if (m_parallelCompile)
+    m_context->maxShaderCompilerThreadsKHR (0xFFFFFFFF);
+}
+
+ShaderLibrary::~ShaderLibrary ()
+{
+  m_programs.clear ();
+  for (std::pair<const std::pair<GLenum, std::string>, Shader>& entry : m_shaders)
+    m_context->deleteShader (entry.second.id);
+}
+
+ShaderProgram*
+ShaderLibrary::add (const std::string& vertexShaderFilename,
+		    const std::string& fragmentShaderFilename,
+		    const std::string& vertexDefines,
+		    const std::string& fragmentDefines)
+{
+  ShaderProgram* program = new ShaderProgram (m_context);
+  program->createVertexShader (vertexShaderFilename, vertexDefines);
+  program->createFragmentShader (fragmentShaderFilename, fragmentDefines);
+  m_programs.emplace_back (program);
+  return program;
+}
+
+void
+ShaderLibrary::submit ()
+{
+  m_linking.resize (m_programs.size (), std::pair<Shader*, Shader*> (nullptr, nullptr));
+
+  // Every compile goes in before any link, so the driver sees all the work
+  //   before it is asked to finish any of it.
+  for (unsigned int programNum = m_submitted; programNum < m_programs.size (); ++programNum)
+  {
+    ShaderProgram& program = *m_programs[programNum];
+    if (program.loadFromBinaryCache ())
+    {
+      ++m_cachedPrograms;
+      continue;
+    }
+    m_linking[programNum].first = &getShader (GL_VERTEX_SHADER,
+					      program.getVertexShaderFilename (),
+					      program.getVertexSource ());
+    m_linking[programNum].second = &getShader (GL_FRAGMENT_SHADER,
+					       program.getFragmentShaderFilename (),
+					       program.getFragmentSource ());
+    ++m_unfinished;
+  }
+
+  for (unsigned int programNum = m_submitted; programNum < m_programs.size (); ++programNum)
+  {
+    if (m_linking[programNum].first != nullptr)
+      m_programs[programNum]->beginLink (m_linking[programNum].first->id,
+					 m_linking[programNum].second->id);
+  }
+  m_submitted = m_programs.size ();
+}
+
+bool
+ShaderLibrary::poll ()
+{
+  if (m_unfinished == 0)
+    return true;
+  for (unsigned int programNum = 0; programNum < m_programs.size (); ++programNum)
+  {
+    std::pair<Shader*, Shader*>& shaders = m_linking[programNum];
+    if (shaders.first == nullptr)
+      continue;
+    ShaderProgram& program = *m_programs[programNum];
+    if (m_parallelCompile && !program.isLinkComplete ())
+      continue;
+    // The link has finished, so its shaders have too; none of these block.
+    checkShader (*shaders.first);
+    checkShader (*shaders.second);
+    program.finishLink ();
+    shaders = std::pair<Shader*, Shader*> (nullptr, nullptr);
+    --m_unfinished;
+  }
+  return m_unfinished == 0;
+}
+
+unsigned int
+ShaderLibrary::getCompiledShaderCount () const
+{
+  return m_shaders.size ();
+}
+
+unsigned int
+ShaderLibrary::getCachedProgramCount () const
+{
+  return m_cachedPrograms;
+}
+
+ShaderLibrary::Shader&
+ShaderLibrary::getShader (GLenum type, const std::string& filename,
+			  const std::string& source)
+{
+  std::pair<GLenum, std::string> key (type, source);
+  std::map<std::pair<GLenum, std::string>, Shader>::iterator itr = m_shaders.find (key);
+  if (itr != m_shaders.end ())
+    return itr->second;
+
+  Shader shader;
+  shader.id = m_context->createShader (type);
+  if (shader.id == 0)
+  {
+    fprintf (stderr, "Failed to create shader object for %s; exiting\n", filename.c_str ());
+    exit (-1);
+  }
+  shader.filename = filename;
+  shader.checked = false;
+  const GLchar* sourcePtr = source.c_str ();
+  m_context->shaderSource (shader.id, 1, &sourcePtr, nullptr);
+  m_context->compileShader (shader.id);
+  return m_shaders[key] = shader;
+}
+
+void
+ShaderLibrary::checkShader (Shader& shader)
+{
+  if (shader.checked)
+    return;
+  // Any program can write a shader's log; the first one is as good as any.
+  m_programs.front ()->checkCompileStatus (shader.filename, shader.id);
+  shader.checked = true;
+}
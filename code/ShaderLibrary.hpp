@@ -0,0 +1,134 @@
+/// \file ShaderLibrary.hpp
+/// \brief Declaration of ShaderLibrary class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef SHADER_LIBRARY_HPP
+#define SHADER_LIBRARY_HPP
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "GlContext.hpp"
+#include "ShaderProgram.hpp"
+
+/// \brief Owns every ShaderProgram and builds them all at once.
+/// Programs are added first, then submit hands every compile and link to
+///   the driver before asking about any of them, so a driver that compiles
+///   on background threads (KHR_parallel_shader_compile) can work on all of
+///   them together while the scene loads.  poll reports when they are done
+///   without ever waiting.  Identical shader sources are compiled once and
+///   shared between programs.  More programs can be added and submitted
+///   later (see ShaderVariants); only the new ones are started.
+class ShaderLibrary
+{
+public:
+
+  /// \brief Constructs an empty ShaderLibrary.
+  /// \param[in] context The object through which OpenGL calls are made.
+  /// \param[in] parallelCompile Whether KHR_parallel_shader_compile is
+  ///   supported.  Without it everything is still submitted up front, but
+  ///   the first poll after submit waits for the results.
+  ShaderLibrary (GlContext* context, bool parallelCompile);
+
+  /// \brief Destructs this ShaderLibrary, deleting its programs and shaders.
+  ~ShaderLibrary ();
+
+  /// \brief Copy constructor removed because you shouldn't be copying
+  ///   ShaderLibraries.
+  ShaderLibrary (const ShaderLibrary&) = delete;
+
+  /// \brief Assignment operator removed because you shouldn't be assigning
+  ///   ShaderLibraries.
+  ShaderLibrary&
+  operator= (const ShaderLibrary&) = delete;
+
+  /// \brief Adds a program made of two shader files.
+  /// \param[in] vertexShaderFilename The vertex shader's file.
+  /// \param[in] fragmentShaderFilename The fragment shader's file.
+  /// \param[in] vertexDefines Lines to insert after the vertex shader's
+  ///   #version line.
+  /// \param[in] fragmentDefines Lines to insert after the fragment shader's
+  ///   #version line.  Programs whose fragment shaders end up with the same
+  ///   source share one compile, so pass only what it actually reads.
+  /// \return The program, which this ShaderLibrary owns.  It can be handed
+  ///   to Meshes right away but must not be drawn with until it isLinked.
+  ShaderProgram*
+  add (const std::string& vertexShaderFilename,
+       const std::string& fragmentShaderFilename,
+       const std::string& vertexDefines = "",
+       const std::string& fragmentDefines = "");
+
+  /// \brief Starts building every program added since the last submit:
+  ///   loads what it can from the binary cache, then submits a compile for
+  ///   each distinct shader the rest need and a link for each of them.
+  ///   Nothing is checked yet.
+  void
+  submit ();
+
+  /// \brief Finishes every program whose link is complete.  Never blocks if
+  ///   KHR_parallel_shader_compile is supported.
+  /// \return True once every submitted program is ready to use.
+  bool
+  poll ();
+
+  /// \brief Gets the number of shaders that were actually compiled.
+  /// \return The number of distinct shader objects created.
+  unsigned int
+  getCompiledShaderCount () const;
+
+  /// \brief Gets the number of programs that came from the binary cache.
+  /// \return The number of cached programs.
+  unsigned int
+  getCachedProgramCount () const;
+
+private:
+
+  /// \brief A compiled shader that may be shared by several programs.
+  struct Shader
+  {
+    /// The shader object.
+    GLuint id;
+    /// The file the source came from (the first one, if several match).
+    std::string filename;
+    /// Whether its compile status has been checked.
+    bool checked;
+  };
+
+  /// \brief Gets the shader compiled from some source, submitting a compile
+  ///   if this is the first time the source has been seen.
+  /// \param[in] type GL_VERTEX_SHADER or GL_FRAGMENT_SHADER.
+  /// \param[in] filename The file the source came from.
+  /// \param[in] source The source code.
+  /// \return The shader.
+  Shader&
+  getShader (GLenum type, const std::string& filename, const std::string& source);
+
+  /// \brief Checks a shader's compile status, if it hasn't been already.
+  /// \param[in,out] shader The shader.
+  void
+  checkShader (Shader& shader);
+
+  /// The object through which OpenGL calls are made.
+  GlContext* m_context;
+  /// Whether the driver can report completion without blocking.
+  bool m_parallelCompile;
+  /// Every program, in the order they were added.
+  std::vector<std::unique_ptr<ShaderProgram>> m_programs;
+  /// For each program, the shaders it is being linked from (null if it came
+  ///   from the binary cache or is already finished).
+  std::vector<std::pair<Shader*, Shader*>> m_linking;
+  /// Compiled shaders, keyed by type and source code.
+  std::map<std::pair<GLenum, std::string>, Shader> m_shaders;
+  /// The number of programs that have been submitted.
+  unsigned int m_submitted;
+  /// The number of programs still being linked.
+  unsigned int m_unfinished;
+  /// The number of programs loaded from the binary cache.
+  unsigned int m_cachedPrograms;
+};
+
+#endif//SHADER_LIBRARY_HPP
@@ -9,18 +9,30 @@
 #include <string>
 #include <cstdio>
 #include <memory>
+#include <vector>
+#include <cstdint>
+
+#include <sys/stat.h>
 
 #include "ShaderProgram.hpp"
 
-ShaderProgram::ShaderProgram (OpenGLContext* context)
-  : m_context (context), m_programId (m_context->createProgram ()), m_vertexShaderId (0), m_fragmentShaderId (0)
+std::string ShaderProgram::s_binaryCacheDirectory;
+
+/// \brief The first word of a program binary file, which is followed by the
+///   binary's format, its length in bytes, and then the binary itself.
+const uint32_t SHADER_BINARY_MAGIC = 0x42505347; // "GSPB"
+
+ShaderProgram::ShaderProgram (GlContext* context)
+  : m_context (context), m_programId (m_context->createProgram ()), m_vertexShaderId (0), m_fragmentShaderId (0),
+    m_linkedVertexShaderId (0), m_linkedFragmentShaderId (0), m_linked (false), m_fromBinaryCache (false)
 {
 }
 
 ShaderProgram::~ShaderProgram ()
 {
   // Delete shaders and delete the program object.
-  // We assume shaders are not shared among multiple programs.
+  // Shaders this program compiled itself (in link) are its own; ones handed
+  //   to beginLink belong to whoever compiled them, and are left alone.
   m_context->deleteShader (m_vertexShaderId);
   m_context->deleteShader (m_fragmentShaderId);
   m_context->deleteProgram (m_programId);
@@ -46,38 +58,36 @@ ShaderProgram::setUniformMatrix (const std::string& uniform, const Matrix4& valu
 }
 
 void
-ShaderProgram::createVertexShader (const std::string& vertexShaderFilename)
+ShaderProgram::createVertexShader (const std::string& vertexShaderFilename,
+				   const std::string& defines)
 {
-  m_vertexShaderId = m_context->createShader (GL_VERTEX_SHADER);
-  if (m_vertexShaderId == 0)
-  {
-    fprintf (stderr, "Failed to create vertex shader object; exiting\n");
-    exit (-1);
-  }
-  compileShader (vertexShaderFilename, m_vertexShaderId);
+  m_vertexShaderFilename = vertexShaderFilename;
+  m_vertexSource = injectDefines (readShaderSource (vertexShaderFilename), defines);
 }
 
 void
-ShaderProgram::createFragmentShader (const std::string& fragmentShaderFilename)
+ShaderProgram::createFragmentShader (const std::string& fragmentShaderFilename,
+				     const std::string& defines)
 {
-  m_fragmentShaderId = m_context->createShader (GL_FRAGMENT_SHADER);
-  if (m_fragmentShaderId == 0)
-  {
-    fprintf (stderr, "Failed to create fragment shader object; exiting\n");
-    exit (-1);
-  }
-  compileShader (fragmentShaderFilename, m_fragmentShaderId);
+  m_fragmentShaderFilename = fragmentShaderFilename;
+  m_fragmentSource = injectDefines (readShaderSource (fragmentShaderFilename), defines);
 }
 
 void
 ShaderProgram::compileShader (const std::string& shaderFilename,
-			      GLuint shaderId)
+			      const std::string& sourceCode, GLuint shaderId)
 {
-  std::string sourceCode = readShaderSource (shaderFilename);
   const GLchar* sourceCodePtr = sourceCode.c_str ();
   // One array of char*. Do not need to specify length if null-terminated.
   m_context->shaderSource (shaderId, 1, &sourceCodePtr, nullptr);
   m_context->compileShader (shaderId);
+  checkCompileStatus (shaderFilename, shaderId);
+}
+
+void
+ShaderProgram::checkCompileStatus (const std::string& shaderFilename,
+				   GLuint shaderId) const
+{
   GLint isCompiled;
   m_context->getShaderiv (shaderId, GL_COMPILE_STATUS, &isCompiled);
   if (isCompiled == GL_FALSE)
@@ -88,14 +98,72 @@ ShaderProgram::compileShader (const std::string& shaderFilename,
 	     shaderFilename.c_str ());
     exit (-1);
   }
-  m_context->attachShader (m_programId, shaderId);
 }
 
 void
-ShaderProgram::link () const
+ShaderProgram::link ()
 {
-  fprintf (stdout, "Linking shader program %d\n", m_programId);
+  if (loadFromBinaryCache ())
+    return;
+
+  m_vertexShaderId = m_context->createShader (GL_VERTEX_SHADER);
+  if (m_vertexShaderId == 0)
+  {
+    fprintf (stderr, "Failed to create vertex shader object; exiting\n");
+    exit (-1);
+  }
+  compileShader (m_vertexShaderFilename, m_vertexSource, m_vertexShaderId);
+  m_fragmentShaderId = m_context->createShader (GL_FRAGMENT_SHADER);
+  if (m_fragmentShaderId == 0)
+  {
+    fprintf (stderr, "Failed to create fragment shader object; exiting\n");
+    exit (-1);
+  }
+  compileShader (m_fragmentShaderFilename, m_fragmentSource, m_fragmentShaderId);
+
+  beginLink (m_vertexShaderId, m_fragmentShaderId);
+  finishLink ();
+}
+
+bool
+ShaderProgram::loadFromBinaryCache ()
+{
+  if (s_binaryCacheDirectory.empty ())
+    return false;
+  m_cacheFilename = getBinaryCacheFilename ();
+  if (!loadBinary (m_cacheFilename))
+    return false;
+  m_linked = true;
+  m_fromBinaryCache = true;
+  fprintf (stderr, "Loaded shader program %d from %s\n", m_programId,
+	   m_cacheFilename.c_str ());
+  return true;
+}
+
+void
+ShaderProgram::beginLink (GLuint vertexShaderId, GLuint fragmentShaderId)
+{
+  fprintf (stderr, "Linking shader program %d\n", m_programId);
+  m_linkedVertexShaderId = vertexShaderId;
+  m_linkedFragmentShaderId = fragmentShaderId;
+  m_context->attachShader (m_programId, vertexShaderId);
+  m_context->attachShader (m_programId, fragmentShaderId);
+  if (!m_cacheFilename.empty ())
+    m_context->programParameteri (m_programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
   m_context->linkProgram (m_programId);
+}
+
+bool
+ShaderProgram::isLinkComplete () const
+{
+  GLint isComplete;
+  m_context->getProgramiv (m_programId, GL_COMPLETION_STATUS_KHR, &isComplete);
+  return isComplete == GL_TRUE;
+}
+
+void
+ShaderProgram::finishLink ()
+{
   GLint isLinked;
   m_context->getProgramiv (m_programId, GL_LINK_STATUS, &isLinked);
   if (isLinked == GL_FALSE)
@@ -106,8 +174,65 @@ ShaderProgram::link () const
   }
   // After linking, the shader objects no longer need to be attached.
   // A shader won't be deleted until it is detached.
-  m_context->detachShader (m_programId, m_vertexShaderId);
-  m_context->detachShader (m_programId, m_fragmentShaderId);
+  m_context->detachShader (m_programId, m_linkedVertexShaderId);
+  m_context->detachShader (m_programId, m_linkedFragmentShaderId);
+
+  m_linked = true;
+
+  if (!m_cacheFilename.empty ())
+    saveBinary (m_cacheFilename);
+}
+
+const std::string&
+ShaderProgram::getVertexSource () const
+{
+  return m_vertexSource;
+}
+
+const std::string&
+ShaderProgram::getFragmentSource () const
+{
+  return m_fragmentSource;
+}
+
+const std::string&
+ShaderProgram::getVertexShaderFilename () const
+{
+  return m_vertexShaderFilename;
+}
+
+const std::string&
+ShaderProgram::getFragmentShaderFilename () const
+{
+  return m_fragmentShaderFilename;
+}
+
+bool
+ShaderProgram::isLinked () const
+{
+  return m_linked;
+}
+
+bool
+ShaderProgram::isFromBinaryCache () const
+{
+  return m_fromBinaryCache;
+}
+
+void
+ShaderProgram::setBinaryCacheDirectory (const std::string& directory)
+{
+  s_binaryCacheDirectory = directory;
+  // Fails harmlessly if it already exists; a real failure shows up when
+  //   the first binary can't be saved.
+  if (!directory.empty ())
+    mkdir (directory.c_str (), 0755);
+}
+
+GLuint
+ShaderProgram::getProgramId () const
+{
+  return m_programId;
 }
 
 void
@@ -122,6 +247,100 @@ ShaderProgram::disable ()
   m_context->useProgram (0);
 }
 
+std::string
+ShaderProgram::getBinaryCacheFilename () const
+{
+  // 64-bit FNV-1a.  Each part is followed by a 0 byte so that moving text
+  //   from the end of one part to the start of the next changes the hash.
+  uint64_t hash = 14695981039346656037ULL;
+  auto addString = [&hash] (const char* text)
+  {
+    for (const char* c = text == nullptr ? "" : text; ; ++c)
+    {
+      hash = (hash ^ static_cast<unsigned char> (*c)) * 1099511628211ULL;
+      if (*c == '\0')
+	break;
+    }
+  };
+  addString (m_vertexSource.c_str ());
+  addString (m_fragmentSource.c_str ());
+  // A binary is only valid for the driver build that produced it.
+  addString (reinterpret_cast<const char*> (m_context->getString (GL_VENDOR)));
+  addString (reinterpret_cast<const char*> (m_context->getString (GL_RENDERER)));
+  addString (reinterpret_cast<const char*> (m_context->getString (GL_VERSION)));
+
+  char name[32];
+  snprintf (name, sizeof (name), "%016llx.bin", static_cast<unsigned long long> (hash));
+  return s_binaryCacheDirectory + "/" + name;
+}
+
+bool
+ShaderProgram::loadBinary (const std::string& filename)
+{
+  GLint formatCount = 0;
+  m_context->getIntegerv (GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+  if (formatCount == 0)
+    return false;
+
+  std::ifstream inFile (filename, std::ios::binary);
+  uint32_t header[3];
+  if (!inFile.read (reinterpret_cast<char*> (header), sizeof (header))
+      || header[0] != SHADER_BINARY_MAGIC)
+    return false;
+  GLenum format = header[1];
+  std::vector<char> binary (header[2]);
+  if (!inFile.read (binary.data (), binary.size ()))
+    return false;
+
+  m_context->programBinary (m_programId, format, binary.data (), binary.size ());
+  GLint isLinked;
+  m_context->getProgramiv (m_programId, GL_LINK_STATUS, &isLinked);
+  // A driver update can make old binaries unusable; link then recompiles
+  //   and overwrites the file.
+  return isLinked == GL_TRUE;
+}
+
+void
+ShaderProgram::saveBinary (const std::string& filename) const
+{
+  GLint length = 0;
+  m_context->getProgramiv (m_programId, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0)
+    return;
+  std::vector<char> binary (length);
+  GLenum format;
+  m_context->getProgramBinary (m_programId, length, &length, &format, binary.data ());
+
+  // Written to a temporary name first so a crash can't leave a truncated
+  //   binary behind.
+  std::string tempFilename = filename + ".tmp";
+  {
+    std::ofstream outFile (tempFilename, std::ios::binary);
+    uint32_t header[3] = { SHADER_BINARY_MAGIC, format, static_cast<uint32_t> (length) };
+    outFile.write (reinterpret_cast<const char*> (header), sizeof (header));
+    outFile.write (binary.data (), length);
+    if (!outFile)
+    {
+      fprintf (stderr, "Failed to write shader binary %s\n", filename.c_str ());
+      return;
+    }
+  }
+  std::rename (tempFilename.c_str (), filename.c_str ());
+}
+
+std::string
+ShaderProgram::injectDefines (const std::string& source, const std::string& defines)
+{
+  if (defines.empty ())
+    return source;
+  std::string::size_type lineEnd = source.find ('\n');
+  if (lineEnd == std::string::npos)
+    return source + "\n" + defines;
+  // #line keeps compiler messages pointing at the lines in the file.
+  return source.substr (0, lineEnd + 1) + defines + "#line 2\n"
+    + source.substr (lineEnd + 1);
+}
+
 std::string
 ShaderProgram::readShaderSource (const std::string& filename) const
 {
@@ -11,11 +11,14 @@
 
 #include <glm/mat4x4.hpp>
 
-#include "OpenGLContext.hpp"
+#include "GlContext.hpp"
 
 #include "Matrix4.hpp"
 
 /// \brief A class that simplifies creation of and access to shaders.
+/// If a binary cache directory has been set, link first looks there for a
+///   program binary saved by an earlier run with the same sources and the
+///   same driver, and only compiles when there isn't a usable one.
 class ShaderProgram
 {
 public:
@@ -23,7 +26,7 @@ public:
   /// \brief Constructs a new ShaderProgram with no attached shaders.
   /// \param[in] context A pointer to an object through which the
   ///   ShaderProgram can make OpenGL calls.
-  ShaderProgram (OpenGLContext* context);
+  ShaderProgram (GlContext* context);
 
   /// \brief Destructs this ShaderProgram, which deletes all OpenGL resources
   ///   used by it.
@@ -62,25 +65,122 @@ public:
   void
   setUniformMatrix (const std::string& uniform, const Matrix4& value);
 
-  /// \brief Creates and attaches a vertex shader.
+  /// \brief Sets the vertex shader.  It is read now but not compiled until
+  ///   link, and then only if the program isn't in the binary cache.
   /// \param[in] vertexShaderFilename The name of a file that contains the
   ///   vertex shader's source code.
+  /// \param[in] defines Lines (such as "#define HAS_NORMALS\n") to insert
+  ///   right after the source's #version line.
   /// \pre No vertex shader was previously created.
   void
-  createVertexShader (const std::string& vertexShaderFilename);
+  createVertexShader (const std::string& vertexShaderFilename,
+		      const std::string& defines = "");
 
-  /// \brief Creates and attaches a fragment shader.
+  /// \brief Sets the fragment shader.  It is read now but not compiled until
+  ///   link, and then only if the program isn't in the binary cache.
   /// \param[in] fragmentShaderFilename The name of a file that contains the
   ///   fragment shader's source code.
+  /// \param[in] defines Lines to insert right after the #version line.
   /// \pre No fragment shader was previously created.
   void
-  createFragmentShader (const std::string& fragmentShaderFilename);
+  createFragmentShader (const std::string& fragmentShaderFilename,
+			const std::string& defines = "");
 
-  /// \brief Links the attached shaders into this ShaderProgram.
+  /// \brief Links the shaders into this ShaderProgram, loading a cached
+  ///   binary instead when there is a valid one, and saving one when there
+  ///   isn't.
   /// \pre A vertex and fragment shader had been created.
   /// \pre This ShaderProgram had not already been linked.
   void
-  link () const;
+  link ();
+
+  /****************************************************************/
+                        // DEFERRED LINKING //
+  /****************************************************************/
+  // link does everything below in one blocking call.  ShaderLibrary calls
+  //   these pieces itself so many programs can compile and link at once.
+
+  /// \brief Tries to link this program from the binary cache.
+  /// \return True if this program is now linked and ready to use.
+  /// \pre A vertex and fragment shader had been created.
+  bool
+  loadFromBinaryCache ();
+
+  /// \brief Attaches compiled shaders and starts linking, without waiting for
+  ///   or checking the result.
+  /// \param[in] vertexShaderId A vertex shader that has been compiled (or
+  ///   whose compile has at least been submitted).  The caller keeps
+  ///   ownership of it.
+  /// \param[in] fragmentShaderId Likewise for a fragment shader.
+  /// \post finishLink must be called before this program is used.
+  void
+  beginLink (GLuint vertexShaderId, GLuint fragmentShaderId);
+
+  /// \brief Asks the driver whether linking has finished, without waiting.
+  /// \return True if it has.
+  /// \pre beginLink has been called, and KHR_parallel_shader_compile is
+  ///   supported.
+  bool
+  isLinkComplete () const;
+
+  /// \brief Checks the result of beginLink (waiting for it if need be),
+  ///   detaches the shaders, and saves the binary if caching is enabled.
+  ///   Exits if linking failed, just like link.
+  /// \pre beginLink has been called.
+  void
+  finishLink ();
+
+  /// \brief Checks that a shader compiled, exiting with its log written to
+  ///   shaderFilename + ".log" if it did not.
+  /// \param[in] shaderFilename The name of the file the shader came from.
+  /// \param[in] shaderId The shader.
+  void
+  checkCompileStatus (const std::string& shaderFilename, GLuint shaderId) const;
+
+  /// \brief Gets the vertex shader's source code.
+  /// \return The source code.
+  const std::string&
+  getVertexSource () const;
+
+  /// \brief Gets the fragment shader's source code.
+  /// \return The source code.
+  const std::string&
+  getFragmentSource () const;
+
+  /// \brief Gets the name of the vertex shader's file.
+  /// \return The file name.
+  const std::string&
+  getVertexShaderFilename () const;
+
+  /// \brief Gets the name of the fragment shader's file.
+  /// \return The file name.
+  const std::string&
+  getFragmentShaderFilename () const;
+
+  /// \brief Tests whether this program has been linked successfully and can
+  ///   be drawn with.
+  /// \return True once link, loadFromBinaryCache or finishLink has
+  ///   succeeded.
+  bool
+  isLinked () const;
+
+  /// \brief Tests whether link used a cached binary rather than compiling.
+  /// \return True if this program came from the binary cache.
+  bool
+  isFromBinaryCache () const;
+
+  /// \brief Sets where every ShaderProgram caches its linked binaries.
+  /// \param[in] directory The directory, which is created if needed, or ""
+  ///   (the default) to disable the cache.
+  /// \post Later calls to link use this directory.
+  static void
+  setBinaryCacheDirectory (const std::string& directory);
+
+  /// \brief Gets the OpenGL name of this program, for making calls about it
+  ///   through some other OpenGLContext.
+  /// \return The program's name.
+  GLuint
+  getProgramId () const;
 
   /// \brief Makes this ShaderProgram the one that will be used by future
   ///   OpenGL calls.
@@ -94,12 +194,40 @@ public:
 
 private:
 
-  /// \brief Compiles a shader.
-  /// \param[in] shaderFilename The name of a file that contains the shader's
-  ///   source code.
+  /// \brief Compiles a shader and attaches it to this program.
+  /// \param[in] shaderFilename The name of the file the shader's source code
+  ///   came from, used for error messages and the log file's name.
+  /// \param[in] sourceCode The shader's source code.
   /// \param[in] shaderId The OpenGL identifier associated with the shader.
   void
-  compileShader (const std::string& shaderFilename, GLuint shaderId);
+  compileShader (const std::string& shaderFilename,
+		 const std::string& sourceCode, GLuint shaderId);
+
+  /// \brief Makes a file name from everything a program binary depends on:
+  ///   both sources and the driver that compiled them.
+  /// \return The name of this program's file in the cache directory.
+  std::string
+  getBinaryCacheFilename () const;
+
+  /// \brief Tries to load this program from the binary cache.
+  /// \param[in] filename The cache file to load.
+  /// \return True if the binary was found and the driver accepted it.
+  bool
+  loadBinary (const std::string& filename);
+
+  /// \brief Saves this program to the binary cache.
+  /// \param[in] filename The cache file to write.
+  /// \pre This program has been linked successfully.
+  void
+  saveBinary (const std::string& filename) const;
+
+  /// \brief Inserts lines into shader source code after its #version line
+  ///   (which must come before anything else).
+  /// \param[in] source The source code.
+  /// \param[in] defines The lines to insert.
+  /// \return The modified source code.
+  static std::string
+  injectDefines (const std::string& source, const std::string& defines);
 
   /// \brief Reads the source code for a shader from a file.
   /// \param[in] filename The name of a file that contains the shader's source
@@ -124,13 +252,33 @@ private:
 private:
 
   /// An object through which this ShaderProgram can make OpenGL calls.
-  OpenGLContext* m_context;
+  GlContext* m_context;
   /// The OpenGL identifier given to this ShaderProgram.
   GLuint m_programId;
   /// The OpenGL identifier given to the vertex shader.
   GLuint m_vertexShaderId;
   /// The OpenGL identifier given to the fragment shader.
   GLuint m_fragmentShaderId;
+  /// The vertex shader passed to beginLink, which is detached after linking.
+  GLuint m_linkedVertexShaderId;
+  /// The fragment shader passed to beginLink.
+  GLuint m_linkedFragmentShaderId;
+  /// The name of the vertex shader's file.
+  std::string m_vertexShaderFilename;
+  /// The name of the fragment shader's file.
+  std::string m_fragmentShaderFilename;
+  /// The vertex shader's source code.
+  std::string m_vertexSource;
+  /// The fragment shader's source code.
+  std::string m_fragmentSource;
+  /// Whether this program has been linked successfully.
+  bool m_linked;
+  /// Whether link loaded this program from the binary cache.
+  bool m_fromBinaryCache;
+  /// The file this program's binary is cached in, or "" if caching is off.
+  std::string m_cacheFilename;
+  /// The directory binaries are cached in, or "" for no cache.
+  static std::string s_binaryCacheDirectory;
 };
 
 #endif//SHADER_PROGRAM_HPP
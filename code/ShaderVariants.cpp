@@ -0,0 +1,51 @@
+/// \file ShaderVariants.cpp
+/// \brief Definitions of ShaderVariants member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include "ShaderVariants.hpp"
+
+ShaderVariants::ShaderVariants (ShaderLibrary& library,
+				const std::string& vertexShaderFilename,
+				const std::string& fragmentShaderFilename)
+  : m_library (library), m_vertexShaderFilename (vertexShaderFilename),
+    m_fragmentShaderFilename (fragmentShaderFilename)
+{
+}
+
+ShaderProgram*
+ShaderVariants::get (unsigned int features)
+{
+  std::map<unsigned int, ShaderProgram*>::iterator itr = m_variants.find (features);
+  if (itr != m_variants.end ())
+    return itr->second;
+
+  // Only the vertex shader reads the features, so every variant shares
+  //   one fragment shader compile.
+  ShaderProgram* program = m_library.add (m_vertexShaderFilename, m_fragmentShaderFilename,
+					  getDefines (features));
+  // Starts the compile without waiting for it; the library's poll finishes
+  //   it a frame or two later.
+  m_library.submit ();
+  m_variants[features] = program;
+  return program;
+}
+
+unsigned int
+ShaderVariants::getVariantCount () const
+{
+  return m_variants.size ();
+}
+
+std::string
+ShaderVariants::getDefines (unsigned int features)
+{
+  std::string defines;
+  if (features & SHADER_VERTEX_COLOR)
+    defines += "#define HAS_VERTEX_COLOR\n";
+  if (features & SHADER_NORMALS)
+    defines += "#define HAS_NORMALS\n";
+  if (features & SHADER_SKINNED)
+    defines += "#define SKINNED\n";
+  return defines;
+}
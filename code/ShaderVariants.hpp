@@ -0,0 +1,85 @@
+/// \file ShaderVariants.hpp
+/// \brief Declaration of ShaderVariants class and the ShaderFeature flags.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef SHADER_VARIANTS_HPP
+#define SHADER_VARIANTS_HPP
+
+#include <map>
+#include <string>
+
+#include "ShaderLibrary.hpp"
+#include "ShaderProgram.hpp"
+
+/// \brief Optional parts of a shader, combined into a feature mask.  Each
+///   one is turned on by the #define named in its comment.
+enum ShaderFeature : unsigned int
+{
+  /// HAS_VERTEX_COLOR: the vertices carry a color.
+  SHADER_VERTEX_COLOR = 1u << 0,
+  /// HAS_NORMALS: the vertices carry a normal and are lit.
+  SHADER_NORMALS = 1u << 1,
+  /// SKINNED: the vertices carry bone indices and weights and are moved by
+  ///   the uBones palette.
+  SHADER_SKINNED = 1u << 2
+};
+
+/// \brief Every specialization of one pair of shader files.
+/// A variant is compiled the first time something asks for its feature
+///   mask, and is shared by everything that asks for the same mask after
+///   that, so startup only pays for the vertex formats actually in use.
+class ShaderVariants
+{
+public:
+
+  /// \brief Constructs a ShaderVariants with no variants built yet.
+  /// \param[in] library The ShaderLibrary that compiles and owns the
+  ///   variants.  It must outlive this ShaderVariants.
+  /// \param[in] vertexShaderFilename The vertex shader every variant uses.
+  /// \param[in] fragmentShaderFilename The fragment shader every variant
+  ///   uses.  It gets no #defines, so it is compiled once for all of them.
+  ShaderVariants (ShaderLibrary& library, const std::string& vertexShaderFilename,
+		  const std::string& fragmentShaderFilename);
+
+  /// \brief Copy constructor removed because you shouldn't be copying
+  ///   ShaderVariants.
+  ShaderVariants (const ShaderVariants&) = delete;
+
+  /// \brief Assignment operator removed because you shouldn't be assigning
+  ///   ShaderVariants.
+  ShaderVariants&
+  operator= (const ShaderVariants&) = delete;
+
+  /// \brief Gets the variant with exactly some features, starting to build
+  ///   it if this is the first request for them.
+  /// \param[in] features A combination of ShaderFeature flags.
+  /// \return The variant.  It may still be compiling; see
+  ///   ShaderProgram::isLinked.
+  ShaderProgram*
+  get (unsigned int features);
+
+  /// \brief Gets the number of distinct variants requested so far.
+  /// \return The number of variants.
+  unsigned int
+  getVariantCount () const;
+
+  /// \brief Builds the #define lines for a feature mask.
+  /// \param[in] features A combination of ShaderFeature flags.
+  /// \return One #define line per feature.
+  static std::string
+  getDefines (unsigned int features);
+
+private:
+
+  /// The library that compiles and owns every variant.
+  ShaderLibrary& m_library;
+  /// The vertex shader every variant uses.
+  std::string m_vertexShaderFilename;
+  /// The fragment shader every variant uses.
+  std::string m_fragmentShaderFilename;
+  /// The variants built so far, keyed by feature mask.
+  std::map<unsigned int, ShaderProgram*> m_variants;
+};
+
+#endif//SHADER_VARIANTS_HPP
@@ -0,0 +1,94 @@
+/// \file SkinnedMesh.cpp
+/// \brief Definitions of SkinnedMesh member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <cassert>
+
+#include "SkinnedMesh.hpp"
+
+SkinnedMesh::SkinnedMesh (GlContext* context, ShaderProgram* shader, unsigned int boneCount)
+  : NormalsMesh (context, shader)
+{
+  assert (boneCount <= ModelMesh::MAX_BONES);
+  Matrix4 identity;
+  m_palette.reserve (boneCount * 16);
+  for (unsigned int boneNum = 0; boneNum < boneCount; ++boneNum)
+    m_palette.insert (m_palette.end (), identity.data (), identity.data () + 16);
+}
+
+SkinnedMesh::SkinnedMesh (GlContext* context, ShaderProgram* shader, const ModelMesh& data)
+  : SkinnedMesh (context, shader, data.bones.size ())
+{
+  addGeometry (interleave (data.vertices, data.skinning));
+  addIndices (data.indices);
+}
+
+SkinnedMesh::~SkinnedMesh ()
+{
+}
+
+unsigned int
+SkinnedMesh::getFloatsPerVertex () const
+{
+  return 6 + 2 * ModelMesh::BONES_PER_VERTEX;
+}
+
+unsigned int
+SkinnedMesh::getShaderFeatures () const
+{
+  return SHADER_NORMALS | SHADER_SKINNED;
+}
+
+void
+SkinnedMesh::setBonePalette (const std::vector<float>& palette)
+{
+  assert (palette.size () <= ModelMesh::MAX_BONES * 16);
+  m_palette = palette;
+  countChange ();
+}
+
+void
+SkinnedMesh::copyBonePalette (std::vector<float>& palette) const
+{
+  palette = m_palette;
+}
+
+std::vector<float>
+SkinnedMesh::interleave (const std::vector<float>& vertices, const std::vector<float>& skinning)
+{
+  const unsigned int SKIN_FLOATS = 2 * ModelMesh::BONES_PER_VERTEX;
+  size_t vertexCount = vertices.size () / 6;
+  assert (skinning.size () == vertexCount * SKIN_FLOATS);
+  std::vector<float> interleaved;
+  interleaved.reserve (vertexCount * (6 + SKIN_FLOATS));
+  for (size_t vertexNum = 0; vertexNum < vertexCount; ++vertexNum)
+  {
+    interleaved.insert (interleaved.end (), vertices.begin () + vertexNum * 6,
+			vertices.begin () + (vertexNum + 1) * 6);
+    interleaved.insert (interleaved.end (), skinning.begin () + vertexNum * SKIN_FLOATS,
+			skinning.begin () + (vertexNum + 1) * SKIN_FLOATS);
+  }
+  return interleaved;
+}
+
+void
+SkinnedMesh::enableAttributes ()
+{
+  const GLint BONE_INDEX_ATTRIB_INDEX = 8;
+  const GLint BONE_WEIGHT_ATTRIB_INDEX = 9;
+  const GLsizei STRIDE = getFloatsPerVertex () * sizeof (float);
+
+  NormalsMesh::enableAttributes ();
+  // Indices are floats like everything else in the VBO; the shader rounds
+  //   them back to ints.
+  m_context->enableVertexAttribArray (BONE_INDEX_ATTRIB_INDEX);
+  m_context->vertexAttribPointer (BONE_INDEX_ATTRIB_INDEX, ModelMesh::BONES_PER_VERTEX,
+				  GL_FLOAT, GL_FALSE, STRIDE,
+				  reinterpret_cast<void*> (6 * sizeof (float)));
+  m_context->enableVertexAttribArray (BONE_WEIGHT_ATTRIB_INDEX);
+  m_context->vertexAttribPointer (BONE_WEIGHT_ATTRIB_INDEX, ModelMesh::BONES_PER_VERTEX,
+				  GL_FLOAT, GL_FALSE, STRIDE,
+				  reinterpret_cast<void*> ((6 + ModelMesh::BONES_PER_VERTEX)
+							   * sizeof (float)));
+}
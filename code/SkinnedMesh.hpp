@@ -0,0 +1,91 @@
+/// \file SkinnedMesh.hpp
+/// \brief Declaration of SkinnedMesh class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef SKINNEDMESH_HPP
+#define SKINNEDMESH_HPP
+
+#include <vector>
+
+#include "NormalsMesh.hpp"
+
+/// \brief A NormalsMesh whose vertices follow the bones of an animated
+///   skeleton.  Each vertex adds the indices of up to
+///   ModelMesh::BONES_PER_VERTEX bones and how much it follows each, and
+///   the SKINNED shader variant blends those bones' matrices to move it.
+/// The matrices come from an Animator (see setBonePalette); this class only
+///   holds the latest set and hands it over to be drawn.
+class SkinnedMesh : public NormalsMesh
+{
+public:
+
+  /// \brief Constructs an empty SkinnedMesh.
+  /// \param[in] context A pointer to an object through which the Mesh will be
+  ///   able to make OpenGL calls.
+  /// \param[in] shader A pointer to the shader program that should be used for
+  ///   drawing this mesh.
+  /// \param[in] boneCount The number of bones that will pose it.
+  /// \post It is posed with every bone at the identity, which is how it was
+  ///   modeled, until an Animator says otherwise.
+  SkinnedMesh (GlContext* context, ShaderProgram* shader, unsigned int boneCount);
+
+  /// \brief Constructs a SkinnedMesh from a mesh that was already loaded.
+  /// \param[in] context A pointer to an object through which the Mesh will be
+  ///   able to make OpenGL calls.
+  /// \param[in] shader A pointer to the shader program that should be used for
+  ///   drawing this mesh.
+  /// \param[in] data The mesh, as built by a ModelLoader.  It must have
+  ///   bones.
+  /// \post The geometry of data, with its skinning interleaved, and its
+  ///   indexes have been pre-populated into this Mesh, and it is posed
+  ///   with every bone at the identity.
+  SkinnedMesh (GlContext* context, ShaderProgram* shader, const ModelMesh& data);
+
+  /// \brief Destructs this SkinnedMesh.
+  virtual ~SkinnedMesh ();
+
+  /// \brief Gets the number of floats used to represent each vertex.
+  /// \return 14: position, normal, 4 bone indices, and 4 weights.
+  virtual unsigned int
+  getFloatsPerVertex () const;
+
+  /// \brief Gets the shader features this Mesh's vertex format needs.
+  /// \return SHADER_NORMALS | SHADER_SKINNED.
+  virtual unsigned int
+  getShaderFeatures () const;
+
+  /// \brief Replaces the matrices that pose this Mesh.
+  /// \param[in] palette 16 floats per bone, as from Animator::getPalette.
+  /// \pre palette holds at most ModelMesh::MAX_BONES matrices.
+  /// \post The next snapshot draws this Mesh in the new pose.
+  void
+  setBonePalette (const std::vector<float>& palette);
+
+  /// \brief Copies the matrices that currently pose this Mesh.
+  /// \param[out] palette Receives 16 floats per bone.
+  virtual void
+  copyBonePalette (std::vector<float>& palette) const;
+
+  /// \brief Interleaves position / normal data with skinning data.
+  /// \param[in] vertices Position / normal data, 6 floats per vertex.
+  /// \param[in] skinning Bone indices and weights, laid out as in
+  ///   ModelMesh::skinning.
+  /// \return Vertex data in the layout this class uses.
+  static std::vector<float>
+  interleave (const std::vector<float>& vertices, const std::vector<float>& skinning);
+
+protected:
+
+  /// \brief Enables the position, normal, bone index, and weight
+  ///   attributes.
+  virtual void
+  enableAttributes ();
+
+private:
+
+  /// The matrices that pose this Mesh, 16 floats per bone.
+  std::vector<float> m_palette;
+};
+
+#endif //SKINNEDMESH_HPP
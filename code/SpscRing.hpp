@@ -0,0 +1,105 @@
+/// \file SpscRing.hpp
+/// \brief Declaration and definition of the SpscRing class template.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <atomic>
+
+/// \brief A fixed-size lock-free queue between exactly one producer thread
+///   and one consumer thread.
+/// Each side owns one index and only reads the other's, so a push or pop
+///   is a couple of loads and one release store, with no allocation: cheap
+///   and constant enough to call from an input callback.  When the ring is
+///   full, pushes fail rather than wait.
+/// \tparam T The type of value stored.  It must be default-constructible
+///   and copyable.
+/// \tparam Capacity The number of slots, which must be a power of two.
+template<typename T, unsigned int Capacity>
+class SpscRing
+{
+  static_assert (Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+		 "SpscRing capacity must be a power of two");
+
+public:
+
+  /// \brief Constructs an empty ring.
+  SpscRing ()
+    : m_slots (), m_head (0), m_tail (0)
+  {
+  }
+
+  /// \brief Copy constructor removed because rings are shared between
+  ///   threads.
+  SpscRing (const SpscRing&) = delete;
+
+  /// \brief Assignment operator removed because rings are shared between
+  ///   threads.
+  SpscRing&
+  operator= (const SpscRing&) = delete;
+
+  /// \brief Adds a value to the back of the ring.  Producer thread only.
+  /// \param[in] value The value.
+  /// \return True if it was added, or false if the ring was full.
+  bool
+  push (const T& value)
+  {
+    unsigned int head = m_head.load (std::memory_order_relaxed);
+    if (head - m_tail.load (std::memory_order_acquire) == Capacity)
+      return false;
+    m_slots[head & (Capacity - 1)] = value;
+    m_head.store (head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// \brief Removes the value at the front of the ring, if any.  Consumer
+  ///   thread only.
+  /// \param[out] value Receives the value that was removed.
+  /// \return True if a value was removed, or false if the ring was empty.
+  bool
+  tryPop (T& value)
+  {
+    unsigned int tail = m_tail.load (std::memory_order_relaxed);
+    if (tail == m_head.load (std::memory_order_acquire))
+      return false;
+    value = m_slots[tail & (Capacity - 1)];
+    m_tail.store (tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// \brief Copies the value at the front of the ring, if any, leaving it
+  ///   there.  Consumer thread only.
+  /// \param[out] value Receives the value.
+  /// \return True if there was a value, or false if the ring was empty.
+  bool
+  tryPeek (T& value) const
+  {
+    unsigned int tail = m_tail.load (std::memory_order_relaxed);
+    if (tail == m_head.load (std::memory_order_acquire))
+      return false;
+    value = m_slots[tail & (Capacity - 1)];
+    return true;
+  }
+
+  /// \brief Tests whether the ring looks empty.  Consumer thread only.
+  /// \return True if tryPop would currently fail.
+  bool
+  empty () const
+  {
+    return m_tail.load (std::memory_order_relaxed) == m_head.load (std::memory_order_acquire);
+  }
+
+private:
+
+  /// The values.  Indices wrap at Capacity.
+  T m_slots[Capacity];
+  /// The number of values ever pushed.  Written by the producer, on its own
+  ///   cache line so the two threads don't share one.
+  alignas (64) std::atomic<unsigned int> m_head;
+  /// The number of values ever popped.  Written by the consumer.
+  alignas (64) std::atomic<unsigned int> m_tail;
+};
+
+#endif//SPSC_RING_HPP
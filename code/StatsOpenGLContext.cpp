@@ -0,0 +1,582 @@
+/// \file StatsOpenGLContext.cpp
+/// \brief Definitions of StatsOpenGLContext and GlStats member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <algorithm>
+#include <cstdio>
+
+#include "StatsOpenGLContext.hpp"
+
+/// The names of the calls, in the order of GlStats::Call.
+static const char* const CALL_NAMES[GlStats::CALL_COUNT] =
+{
+  "attachShader",
+  "beginQuery",
+  "bindBuffer",
+  "bindVertexArray",
+  "bufferData",
+  "bufferSubData",
+  "clear",
+  "clearColor",
+  "clientWaitSync",
+  "compileShader",
+  "createProgram",
+  "createShader",
+  "cullFace",
+  "deleteBuffers",
+  "deleteProgram",
+  "deleteQueries",
+  "deleteShader",
+  "deleteSync",
+  "deleteVertexArrays",
+  "detachShader",
+  "drawArrays",
+  "drawElements",
+  "enable",
+  "enableVertexAttribArray",
+  "endQuery",
+  "fenceSync",
+  "finish",
+  "flush",
+  "frontFace",
+  "genBuffers",
+  "genQueries",
+  "genVertexArrays",
+  "getAttribLocation",
+  "getIntegerv",
+  "getProgramBinary",
+  "getProgramInfoLog",
+  "getProgramiv",
+  "getQueryObjectiv",
+  "getQueryObjectui64v",
+  "getShaderInfoLog",
+  "getShaderiv",
+  "getString",
+  "getUniformLocation",
+  "linkProgram",
+  "maxShaderCompilerThreadsKHR",
+  "programBinary",
+  "programParameteri",
+  "queryCounter",
+  "shaderSource",
+  "uniformMatrix4fv",
+  "useProgram",
+  "vertexAttribPointer",
+  "viewport",
+};
+
+GlStats::GlStats ()
+  : calls (), drawCalls (0), triangles (0), uploadBytes (0)
+{
+}
+
+void
+GlStats::add (const GlStats& other)
+{
+  for (unsigned int call = 0; call < CALL_COUNT; ++call)
+    calls[call] += other.calls[call];
+  drawCalls += other.drawCalls;
+  triangles += other.triangles;
+  uploadBytes += other.uploadBytes;
+}
+
+unsigned long
+GlStats::getTotalCalls () const
+{
+  unsigned long total = 0;
+  for (unsigned int call = 0; call < CALL_COUNT; ++call)
+    total += calls[call];
+  return total;
+}
+
+const char*
+GlStats::getCallName (Call call)
+{
+  return CALL_NAMES[call];
+}
+
+StatsOpenGLContext::StatsOpenGLContext (OpenGLContext* inner)
+  : m_inner (inner), m_frameCount (0), m_logInterval (0), m_log (nullptr)
+{
+}
+
+StatsOpenGLContext::~StatsOpenGLContext ()
+{
+  delete m_inner;
+}
+
+OpenGLContext*
+StatsOpenGLContext::getInner () const
+{
+  return m_inner;
+}
+
+void
+StatsOpenGLContext::endFrame ()
+{
+  m_frame = m_current;
+  m_total.add (m_current);
+  m_logged.add (m_current);
+  m_current = GlStats ();
+  ++m_frameCount;
+  if (m_logInterval != 0 && m_frameCount % m_logInterval == 0)
+  {
+    writeLogLine (*m_log, m_logged, m_logInterval);
+    m_logged = GlStats ();
+  }
+}
+
+const GlStats&
+StatsOpenGLContext::getCurrentStats () const
+{
+  return m_current;
+}
+
+const GlStats&
+StatsOpenGLContext::getFrameStats () const
+{
+  return m_frame;
+}
+
+const GlStats&
+StatsOpenGLContext::getTotalStats () const
+{
+  return m_total;
+}
+
+unsigned long
+StatsOpenGLContext::getFrameCount () const
+{
+  return m_frameCount;
+}
+
+void
+StatsOpenGLContext::reset ()
+{
+  m_current = m_frame = m_total = m_logged = GlStats ();
+  m_frameCount = 0;
+}
+
+void
+StatsOpenGLContext::setLogInterval (unsigned int frames, std::ostream& out)
+{
+  m_logInterval = frames;
+  m_log = &out;
+  m_logged = GlStats ();
+}
+
+void
+StatsOpenGLContext::writeLogLine (std::ostream& out, const GlStats& stats, unsigned long frames)
+{
+  frames = std::max (frames, 1ul);
+  char line[256];
+  std::snprintf (line, sizeof (line), "GL per frame over %lu frame(s): %.1f draws, %.0f triangles, %.0f upload bytes, %.1f calls",
+		 frames, static_cast<double> (stats.drawCalls) / frames,
+		 static_cast<double> (stats.triangles) / frames,
+		 static_cast<double> (stats.uploadBytes) / frames,
+		 static_cast<double> (stats.getTotalCalls ()) / frames);
+  out << line;
+
+  // The few most frequent calls are usually where the overhead is.
+  const unsigned int TOP_CALLS = 3;
+  unsigned int order[GlStats::CALL_COUNT];
+  for (unsigned int call = 0; call < GlStats::CALL_COUNT; ++call)
+    order[call] = call;
+  std::partial_sort (order, order + TOP_CALLS, order + GlStats::CALL_COUNT,
+		     [&stats] (unsigned int a, unsigned int b) { return stats.calls[a] > stats.calls[b]; });
+  const char* separator = " (";
+  for (unsigned int rank = 0; rank < TOP_CALLS && stats.calls[order[rank]] > 0; ++rank)
+  {
+    std::snprintf (line, sizeof (line), "%s%s %.1f", separator, CALL_NAMES[order[rank]],
+		   static_cast<double> (stats.calls[order[rank]]) / frames);
+    out << line;
+    separator = ", ";
+  }
+  out << (stats.getTotalCalls () > 0 ? ")\n" : "\n");
+}
+
+void
+StatsOpenGLContext::countDraw (GLenum mode, GLsizei count)
+{
+  ++m_current.drawCalls;
+  if (mode == GL_TRIANGLES)
+    m_current.triangles += count / 3;
+  else if ((mode == GL_TRIANGLE_STRIP || mode == GL_TRIANGLE_FAN) && count >= 3)
+    m_current.triangles += count - 2;
+}
+
+void
+StatsOpenGLContext::attachShader (GLuint program, GLuint shader)
+{
+  ++m_current.calls[GlStats::CALL_ATTACH_SHADER];
+  m_inner->attachShader (program, shader);
+}
+
+void
+StatsOpenGLContext::beginQuery (GLenum target, GLuint id)
+{
+  ++m_current.calls[GlStats::CALL_BEGIN_QUERY];
+  m_inner->beginQuery (target, id);
+}
+
+void
+StatsOpenGLContext::bindBuffer (GLenum target, GLuint buffer)
+{
+  ++m_current.calls[GlStats::CALL_BIND_BUFFER];
+  m_inner->bindBuffer (target, buffer);
+}
+
+void
+StatsOpenGLContext::bindVertexArray (GLuint array)
+{
+  ++m_current.calls[GlStats::CALL_BIND_VERTEX_ARRAY];
+  m_inner->bindVertexArray (array);
+}
+
+void
+StatsOpenGLContext::bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+  ++m_current.calls[GlStats::CALL_BUFFER_DATA];
+  m_current.uploadBytes += size;
+  m_inner->bufferData (target, size, data, usage);
+}
+
+void
+StatsOpenGLContext::bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+  ++m_current.calls[GlStats::CALL_BUFFER_SUB_DATA];
+  m_current.uploadBytes += size;
+  m_inner->bufferSubData (target, offset, size, data);
+}
+
+void
+StatsOpenGLContext::clear (GLbitfield mask)
+{
+  ++m_current.calls[GlStats::CALL_CLEAR];
+  m_inner->clear (mask);
+}
+
+void
+StatsOpenGLContext::clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+  ++m_current.calls[GlStats::CALL_CLEAR_COLOR];
+  m_inner->clearColor (red, green, blue, alpha);
+}
+
+GLenum
+StatsOpenGLContext::clientWaitSync (GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+  ++m_current.calls[GlStats::CALL_CLIENT_WAIT_SYNC];
+  return m_inner->clientWaitSync (sync, flags, timeout);
+}
+
+void
+StatsOpenGLContext::compileShader (GLuint shader)
+{
+  ++m_current.calls[GlStats::CALL_COMPILE_SHADER];
+  m_inner->compileShader (shader);
+}
+
+GLuint
+StatsOpenGLContext::createProgram ()
+{
+  ++m_current.calls[GlStats::CALL_CREATE_PROGRAM];
+  return m_inner->createProgram ();
+}
+
+GLuint
+StatsOpenGLContext::createShader (GLenum shaderType)
+{
+  ++m_current.calls[GlStats::CALL_CREATE_SHADER];
+  return m_inner->createShader (shaderType);
+}
+
+void
+StatsOpenGLContext::cullFace (GLenum mode)
+{
+  ++m_current.calls[GlStats::CALL_CULL_FACE];
+  m_inner->cullFace (mode);
+}
+
+void
+StatsOpenGLContext::deleteBuffers (GLsizei n, const GLuint* buffers)
+{
+  ++m_current.calls[GlStats::CALL_DELETE_BUFFERS];
+  m_inner->deleteBuffers (n, buffers);
+}
+
+void
+StatsOpenGLContext::deleteProgram (GLuint program)
+{
+  ++m_current.calls[GlStats::CALL_DELETE_PROGRAM];
+  m_inner->deleteProgram (program);
+}
+
+void
+StatsOpenGLContext::deleteQueries (GLsizei n, const GLuint* ids)
+{
+  ++m_current.calls[GlStats::CALL_DELETE_QUERIES];
+  m_inner->deleteQueries (n, ids);
+}
+
+void
+StatsOpenGLContext::deleteShader (GLuint shader)
+{
+  ++m_current.calls[GlStats::CALL_DELETE_SHADER];
+  m_inner->deleteShader (shader);
+}
+
+void
+StatsOpenGLContext::deleteSync (GLsync sync)
+{
+  ++m_current.calls[GlStats::CALL_DELETE_SYNC];
+  m_inner->deleteSync (sync);
+}
+
+void
+StatsOpenGLContext::deleteVertexArrays (GLsizei n, const GLuint* arrays)
+{
+  ++m_current.calls[GlStats::CALL_DELETE_VERTEX_ARRAYS];
+  m_inner->deleteVertexArrays (n, arrays);
+}
+
+void
+StatsOpenGLContext::detachShader (GLuint program, GLuint shader)
+{
+  ++m_current.calls[GlStats::CALL_DETACH_SHADER];
+  m_inner->detachShader (program, shader);
+}
+
+void
+StatsOpenGLContext::drawArrays (GLenum mode, GLint first, GLsizei count)
+{
+  ++m_current.calls[GlStats::CALL_DRAW_ARRAYS];
+  countDraw (mode, count);
+  m_inner->drawArrays (mode, first, count);
+}
+
+void
+StatsOpenGLContext::drawElements (GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+  ++m_current.calls[GlStats::CALL_DRAW_ELEMENTS];
+  countDraw (mode, count);
+  m_inner->drawElements (mode, count, type, indices);
+}
+
+void
+StatsOpenGLContext::enable (GLenum cap)
+{
+  ++m_current.calls[GlStats::CALL_ENABLE];
+  m_inner->enable (cap);
+}
+
+void
+StatsOpenGLContext::enableVertexAttribArray (GLuint index)
+{
+  ++m_current.calls[GlStats::CALL_ENABLE_VERTEX_ATTRIB_ARRAY];
+  m_inner->enableVertexAttribArray (index);
+}
+
+void
+StatsOpenGLContext::endQuery (GLenum target)
+{
+  ++m_current.calls[GlStats::CALL_END_QUERY];
+  m_inner->endQuery (target);
+}
+
+GLsync
+StatsOpenGLContext::fenceSync (GLenum condition, GLbitfield flags)
+{
+  ++m_current.calls[GlStats::CALL_FENCE_SYNC];
+  return m_inner->fenceSync (condition, flags);
+}
+
+void
+StatsOpenGLContext::finish ()
+{
+  ++m_current.calls[GlStats::CALL_FINISH];
+  m_inner->finish ();
+}
+
+void
+StatsOpenGLContext::flush ()
+{
+  ++m_current.calls[GlStats::CALL_FLUSH];
+  m_inner->flush ();
+}
+
+void
+StatsOpenGLContext::frontFace (GLenum mode)
+{
+  ++m_current.calls[GlStats::CALL_FRONT_FACE];
+  m_inner->frontFace (mode);
+}
+
+void
+StatsOpenGLContext::genBuffers (GLsizei n, GLuint* buffers)
+{
+  ++m_current.calls[GlStats::CALL_GEN_BUFFERS];
+  m_inner->genBuffers (n, buffers);
+}
+
+void
+StatsOpenGLContext::genQueries (GLsizei n, GLuint* ids)
+{
+  ++m_current.calls[GlStats::CALL_GEN_QUERIES];
+  m_inner->genQueries (n, ids);
+}
+
+void
+StatsOpenGLContext::genVertexArrays (GLsizei n, GLuint* arrays)
+{
+  ++m_current.calls[GlStats::CALL_GEN_VERTEX_ARRAYS];
+  m_inner->genVertexArrays (n, arrays);
+}
+
+GLint
+StatsOpenGLContext::getAttribLocation (GLuint program, const GLchar* name)
+{
+  ++m_current.calls[GlStats::CALL_GET_ATTRIB_LOCATION];
+  return m_inner->getAttribLocation (program, name);
+}
+
+void
+StatsOpenGLContext::getIntegerv (GLenum pname, GLint* data)
+{
+  ++m_current.calls[GlStats::CALL_GET_INTEGERV];
+  m_inner->getIntegerv (pname, data);
+}
+
+void
+StatsOpenGLContext::getProgramBinary (GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary)
+{
+  ++m_current.calls[GlStats::CALL_GET_PROGRAM_BINARY];
+  m_inner->getProgramBinary (program, bufSize, length, binaryFormat, binary);
+}
+
+void
+StatsOpenGLContext::getProgramInfoLog (GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog)
+{
+  ++m_current.calls[GlStats::CALL_GET_PROGRAM_INFO_LOG];
+  m_inner->getProgramInfoLog (program, maxLength, length, infoLog);
+}
+
+void
+StatsOpenGLContext::getProgramiv (GLuint program, GLenum pname, GLint* params)
+{
+  ++m_current.calls[GlStats::CALL_GET_PROGRAMIV];
+  m_inner->getProgramiv (program, pname, params);
+}
+
+void
+StatsOpenGLContext::getQueryObjectiv (GLuint id, GLenum pname, GLint* params)
+{
+  ++m_current.calls[GlStats::CALL_GET_QUERY_OBJECTIV];
+  m_inner->getQueryObjectiv (id, pname, params);
+}
+
+void
+StatsOpenGLContext::getQueryObjectui64v (GLuint id, GLenum pname, GLuint64* params)
+{
+  ++m_current.calls[GlStats::CALL_GET_QUERY_OBJECTUI64V];
+  m_inner->getQueryObjectui64v (id, pname, params);
+}
+
+void
+StatsOpenGLContext::getShaderInfoLog (GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog)
+{
+  ++m_current.calls[GlStats::CALL_GET_SHADER_INFO_LOG];
+  m_inner->getShaderInfoLog (shader, maxLength, length, infoLog);
+}
+
+void
+StatsOpenGLContext::getShaderiv (GLuint shader, GLenum pname, GLint* params)
+{
+  ++m_current.calls[GlStats::CALL_GET_SHADERIV];
+  m_inner->getShaderiv (shader, pname, params);
+}
+
+const GLubyte*
+StatsOpenGLContext::getString (GLenum name)
+{
+  ++m_current.calls[GlStats::CALL_GET_STRING];
+  return m_inner->getString (name);
+}
+
+GLint
+StatsOpenGLContext::getUniformLocation (GLuint program, const GLchar* name)
+{
+  ++m_current.calls[GlStats::CALL_GET_UNIFORM_LOCATION];
+  return m_inner->getUniformLocation (program, name);
+}
+
+void
+StatsOpenGLContext::linkProgram (GLuint program)
+{
+  ++m_current.calls[GlStats::CALL_LINK_PROGRAM];
+  m_inner->linkProgram (program);
+}
+
+void
+StatsOpenGLContext::maxShaderCompilerThreadsKHR (GLuint count)
+{
+  ++m_current.calls[GlStats::CALL_MAX_SHADER_COMPILER_THREADS_KHR];
+  m_inner->maxShaderCompilerThreadsKHR (count);
+}
+
+void
+StatsOpenGLContext::programBinary (GLuint program, GLenum binaryFormat, const void* binary, GLsizei length)
+{
+  ++m_current.calls[GlStats::CALL_PROGRAM_BINARY];
+  m_inner->programBinary (program, binaryFormat, binary, length);
+}
+
+void
+StatsOpenGLContext::programParameteri (GLuint program, GLenum pname, GLint value)
+{
+  ++m_current.calls[GlStats::CALL_PROGRAM_PARAMETERI];
+  m_inner->programParameteri (program, pname, value);
+}
+
+void
+StatsOpenGLContext::queryCounter (GLuint id, GLenum target)
+{
+  ++m_current.calls[GlStats::CALL_QUERY_COUNTER];
+  m_inner->queryCounter (id, target);
+}
+
+void
+StatsOpenGLContext::shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length)
+{
+  ++m_current.calls[GlStats::CALL_SHADER_SOURCE];
+  m_inner->shaderSource (shader, count, string, length);
+}
+
+void
+StatsOpenGLContext::uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+  ++m_current.calls[GlStats::CALL_UNIFORM_MATRIX4FV];
+  m_inner->uniformMatrix4fv (location, count, transpose, value);
+}
+
+void
+StatsOpenGLContext::useProgram (GLuint program)
+{
+  ++m_current.calls[GlStats::CALL_USE_PROGRAM];
+  m_inner->useProgram (program);
+}
+
+void
+StatsOpenGLContext::vertexAttribPointer (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer)
+{
+  ++m_current.calls[GlStats::CALL_VERTEX_ATTRIB_POINTER];
+  m_inner->vertexAttribPointer (index, size, type, normalized, stride, pointer);
+}
+
+void
+StatsOpenGLContext::viewport (GLint x, GLint y, GLsizei width, GLsizei height)
+{
+  ++m_current.calls[GlStats::CALL_VIEWPORT];
+  m_inner->viewport (x, y, width, height);
+}
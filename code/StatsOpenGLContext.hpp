@@ -0,0 +1,369 @@
+/// \file StatsOpenGLContext.hpp
+/// \brief Declaration of StatsOpenGLContext and the GlStats it collects.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef STATS_OPENGL_CONTEXT_HPP
+#define STATS_OPENGL_CONTEXT_HPP
+
+#include <ostream>
+
+#include "OpenGLContext.hpp"
+
+/// \brief Counts of the OpenGL calls made over some period.
+struct GlStats
+{
+  /// \brief Identifies each OpenGLContext call.
+  enum Call
+  {
+    CALL_ATTACH_SHADER,
+    CALL_BEGIN_QUERY,
+    CALL_BIND_BUFFER,
+    CALL_BIND_VERTEX_ARRAY,
+    CALL_BUFFER_DATA,
+    CALL_BUFFER_SUB_DATA,
+    CALL_CLEAR,
+    CALL_CLEAR_COLOR,
+    CALL_CLIENT_WAIT_SYNC,
+    CALL_COMPILE_SHADER,
+    CALL_CREATE_PROGRAM,
+    CALL_CREATE_SHADER,
+    CALL_CULL_FACE,
+    CALL_DELETE_BUFFERS,
+    CALL_DELETE_PROGRAM,
+    CALL_DELETE_QUERIES,
+    CALL_DELETE_SHADER,
+    CALL_DELETE_SYNC,
+    CALL_DELETE_VERTEX_ARRAYS,
+    CALL_DETACH_SHADER,
+    CALL_DRAW_ARRAYS,
+    CALL_DRAW_ELEMENTS,
+    CALL_ENABLE,
+    CALL_ENABLE_VERTEX_ATTRIB_ARRAY,
+    CALL_END_QUERY,
+    CALL_FENCE_SYNC,
+    CALL_FINISH,
+    CALL_FLUSH,
+    CALL_FRONT_FACE,
+    CALL_GEN_BUFFERS,
+    CALL_GEN_QUERIES,
+    CALL_GEN_VERTEX_ARRAYS,
+    CALL_GET_ATTRIB_LOCATION,
+    CALL_GET_INTEGERV,
+    CALL_GET_PROGRAM_BINARY,
+    CALL_GET_PROGRAM_INFO_LOG,
+    CALL_GET_PROGRAMIV,
+    CALL_GET_QUERY_OBJECTIV,
+    CALL_GET_QUERY_OBJECTUI64V,
+    CALL_GET_SHADER_INFO_LOG,
+    CALL_GET_SHADERIV,
+    CALL_GET_STRING,
+    CALL_GET_UNIFORM_LOCATION,
+    CALL_LINK_PROGRAM,
+    CALL_MAX_SHADER_COMPILER_THREADS_KHR,
+    CALL_PROGRAM_BINARY,
+    CALL_PROGRAM_PARAMETERI,
+    CALL_QUERY_COUNTER,
+    CALL_SHADER_SOURCE,
+    CALL_UNIFORM_MATRIX4FV,
+    CALL_USE_PROGRAM,
+    CALL_VERTEX_ATTRIB_POINTER,
+    CALL_VIEWPORT,
+    CALL_COUNT
+  };
+
+  /// \brief Constructs GlStats with every count 0.
+  GlStats ();
+
+  /// \brief Adds another period's counts to these.
+  /// \param[in] other The counts to add.
+  void
+  add (const GlStats& other);
+
+  /// \brief Gets the total number of calls of every type.
+  /// \return The number of calls.
+  unsigned long
+  getTotalCalls () const;
+
+  /// \brief Gets the name of a call, as in OpenGLContext.
+  /// \param[in] call The call.
+  /// \return Its name.
+  static const char*
+  getCallName (Call call);
+
+  /// The number of calls of each type.
+  unsigned long calls[CALL_COUNT];
+  /// The number of drawArrays and drawElements calls.
+  unsigned long drawCalls;
+  /// The number of triangles those draws submitted.
+  unsigned long triangles;
+  /// The number of bytes passed to bufferData and bufferSubData.
+  unsigned long uploadBytes;
+};
+
+/// \brief A subclass of OpenGLContext that passes every call on to another
+///   context, counting calls by type, draw calls, triangles, and uploaded
+///   bytes as it does.
+///
+/// Counts are kept per frame, so tests and the benchmark can check draw
+///   call and upload budgets.  Counting is not synchronized: threads other
+///   than the one calling endFrame should be given getInner instead.
+class StatsOpenGLContext : public OpenGLContext
+{
+public:
+
+  /// \brief Constructs a StatsOpenGLContext with all counts 0.
+  /// \param[in] inner The context calls are passed on to.  This takes
+  ///   ownership of it, deleting it when destructed.
+  StatsOpenGLContext (OpenGLContext* inner);
+
+  /// \brief Destructs a StatsOpenGLContext and its inner context.
+  virtual
+  ~StatsOpenGLContext ();
+
+  /// \brief Copy constructor deleted because you should not be copying
+  ///   OpenGLContexts.
+  StatsOpenGLContext (const StatsOpenGLContext&) = delete;
+
+  /// \brief Assignment operator deleted because you should not be assigning
+  ///   OpenGLContexts.
+  StatsOpenGLContext&
+  operator= (const StatsOpenGLContext&) = delete;
+
+  /// \brief Gets the context calls are passed on to.
+  /// \return The inner context, which is still owned by this.
+  OpenGLContext*
+  getInner () const;
+
+  /// \brief Ends the current frame, making its counts those returned by
+  ///   getFrameStats and adding them to getTotalStats.  Logs every so many
+  ///   frames if setLogInterval was called.
+  void
+  endFrame ();
+
+  /// \brief Gets the counts for the frame in progress.
+  /// \return The counts since the last endFrame.
+  const GlStats&
+  getCurrentStats () const;
+
+  /// \brief Gets the counts for the last complete frame.
+  /// \return The counts between the last two endFrames.
+  const GlStats&
+  getFrameStats () const;
+
+  /// \brief Gets the counts for every complete frame.
+  /// \return The counts up to the last endFrame.
+  const GlStats&
+  getTotalStats () const;
+
+  /// \brief Gets the number of complete frames.
+  /// \return The number of endFrame calls.
+  unsigned long
+  getFrameCount () const;
+
+  /// \brief Clears every count, including the frame in progress.
+  void
+  reset ();
+
+  /// \brief Writes a line of per-frame averages every so many frames.
+  /// \param[in] frames How many frames to average over, or 0 to stop
+  ///   logging.
+  /// \param[in,out] out The stream to write to, which must outlive this.
+  void
+  setLogInterval (unsigned int frames, std::ostream& out);
+
+  /// \brief Writes one line summarizing counts averaged over some frames:
+  ///   draw calls, triangles, uploaded bytes, total calls, and the most
+  ///   frequent calls.
+  /// \param[in,out] out The stream to write to.
+  /// \param[in] stats The counts.
+  /// \param[in] frames The number of frames they cover.
+  static void
+  writeLogLine (std::ostream& out, const GlStats& stats, unsigned long frames);
+
+  virtual void
+  attachShader (GLuint program, GLuint shader);
+
+  virtual void
+  beginQuery (GLenum target, GLuint id);
+
+  virtual void
+  bindBuffer (GLenum target, GLuint buffer);
+
+  virtual void
+  bindVertexArray (GLuint array);
+
+  virtual void
+  bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage);
+
+  virtual void
+  bufferSubData (GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data);
+
+  virtual void
+  clear (GLbitfield mask);
+
+  virtual void
+  clearColor (GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+
+  virtual GLenum
+  clientWaitSync (GLsync sync, GLbitfield flags, GLuint64 timeout);
+
+  virtual void
+  compileShader (GLuint shader);
+
+  virtual GLuint
+  createProgram ();
+
+  virtual GLuint
+  createShader (GLenum shaderType);
+
+  virtual void
+  cullFace (GLenum mode);
+
+  virtual void
+  deleteBuffers (GLsizei n, const GLuint* buffers);
+
+  virtual void
+  deleteProgram (GLuint program);
+
+  virtual void
+  deleteQueries (GLsizei n, const GLuint* ids);
+
+  virtual void
+  deleteShader (GLuint shader);
+
+  virtual void
+  deleteSync (GLsync sync);
+
+  virtual void
+  deleteVertexArrays (GLsizei n, const GLuint* arrays);
+
+  virtual void
+  detachShader (GLuint program, GLuint shader);
+
+  virtual void
+  drawArrays (GLenum mode, GLint first, GLsizei count);
+
+  virtual void
+  drawElements (GLenum mode, GLsizei count, GLenum type, const void* indices);
+
+  virtual void
+  enable (GLenum cap);
+
+  virtual void
+  enableVertexAttribArray (GLuint index);
+
+  virtual void
+  endQuery (GLenum target);
+
+  virtual GLsync
+  fenceSync (GLenum condition, GLbitfield flags);
+
+  virtual void
+  finish ();
+
+  virtual void
+  flush ();
+
+  virtual void
+  frontFace (GLenum mode);
+
+  virtual void
+  genBuffers (GLsizei n, GLuint* buffers);
+
+  virtual void
+  genQueries (GLsizei n, GLuint* ids);
+
+  virtual void
+  genVertexArrays (GLsizei n, GLuint* arrays);
+
+  virtual GLint
+  getAttribLocation (GLuint program, const GLchar* name);
+
+  virtual void
+  getIntegerv (GLenum pname, GLint* data);
+
+  virtual void
+  getProgramBinary (GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+
+  virtual void
+  getProgramInfoLog (GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
+
+  virtual void
+  getProgramiv (GLuint program, GLenum pname, GLint* params);
+
+  virtual void
+  getQueryObjectiv (GLuint id, GLenum pname, GLint* params);
+
+  virtual void
+  getQueryObjectui64v (GLuint id, GLenum pname, GLuint64* params);
+
+  virtual void
+  getShaderInfoLog (GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
+
+  virtual void
+  getShaderiv (GLuint shader, GLenum pname, GLint* params);
+
+  virtual const GLubyte*
+  getString (GLenum name);
+
+  virtual GLint
+  getUniformLocation (GLuint program, const GLchar* name);
+
+  virtual void
+  linkProgram (GLuint program);
+
+  virtual void
+  maxShaderCompilerThreadsKHR (GLuint count);
+
+  virtual void
+  programBinary (GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+
+  virtual void
+  programParameteri (GLuint program, GLenum pname, GLint value);
+
+  virtual void
+  queryCounter (GLuint id, GLenum target);
+
+  virtual void
+  shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length);
+
+  virtual void
+  uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+
+  virtual void
+  useProgram (GLuint program);
+
+  virtual void
+  vertexAttribPointer (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer);
+
+  virtual void
+  viewport (GLint x, GLint y, GLsizei width, GLsizei height);
+
+private:
+
+  /// \brief Counts a draw call and the triangles it submits.
+  /// \param[in] mode The primitive type.
+  /// \param[in] count The number of vertices.
+  void
+  countDraw (GLenum mode, GLsizei count);
+
+  /// The context calls are passed on to.
+  OpenGLContext* m_inner;
+  /// Counts for the frame in progress.
+  GlStats m_current;
+  /// Counts for the last complete frame.
+  GlStats m_frame;
+  /// Counts for every complete frame.
+  GlStats m_total;
+  /// The number of complete frames.
+  unsigned long m_frameCount;
+  /// Counts since the last log line.
+  GlStats m_logged;
+  /// Frames between log lines, or 0 for none.
+  unsigned int m_logInterval;
+  /// Where log lines go.
+  std::ostream* m_log;
+};
+
+#endif//STATS_OPENGL_CONTEXT_HPP
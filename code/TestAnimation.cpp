@@ -0,0 +1,216 @@
+/// \file TestAnimation.cpp
+/// \brief A collection of Catch2 unit tests for the Quaternion,
+///   AnimationClip, CompressedClip, and Animator classes.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include "Animator.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+/// \brief Gets a transform that only translates.
+/// \param[in] x How far along x.
+/// \param[in] y How far along y.
+/// \param[in] z How far along z.
+/// \return The transform.
+static Transform
+translation (float x, float y, float z)
+{
+  Transform t;
+  t.setPosition (x, y, z);
+  return t;
+}
+
+SCENARIO ("Quaternions rotate like matrices and blend the short way.", "[Quaternion]") {
+  GIVEN ("A 90 degree turn about y.") {
+    Quaternion q (90.0f, Vector3 (0, 1, 0));
+    THEN ("It matches the angle-axis matrix.") {
+      Matrix3 expected;
+      expected.setFromAngleAxis (90.0f, Vector3 (0, 1, 0));
+      Matrix3 actual = q.toMatrix3 ();
+      REQUIRE (actual.getRight ().m_x == Approx (expected.getRight ().m_x).margin (1e-5));
+      REQUIRE (actual.getRight ().m_z == Approx (expected.getRight ().m_z).margin (1e-5));
+      REQUIRE (actual.getBack ().m_x == Approx (expected.getBack ().m_x).margin (1e-5));
+    }
+    WHEN ("Blended halfway from no rotation.") {
+      Quaternion half = nlerp (Quaternion (), q, 0.5f);
+      THEN ("It is a 45 degree turn.") {
+	Quaternion expected (45.0f, Vector3 (0, 1, 0));
+	REQUIRE (half.dot (expected) == Approx (1.0f));
+      }
+    }
+    WHEN ("Blended toward the same turn written negated.") {
+      Quaternion negated (-q.m_w, -q.m_x, -q.m_y, -q.m_z);
+      Quaternion half = nlerp (Quaternion (), negated, 0.5f);
+      THEN ("It still takes the short way.") {
+	Quaternion expected (45.0f, Vector3 (0, 1, 0));
+	REQUIRE (std::abs (half.dot (expected)) == Approx (1.0f));
+      }
+    }
+  }
+}
+
+SCENARIO ("AnimationClip interpolates keys and loops.", "[AnimationClip]") {
+  GIVEN ("A 1 second clip moving node 1 from x = 0 to x = 2, and turning it.") {
+    AnimationClip clip ("slide", 1.0f);
+    AnimationChannel channel;
+    channel.node = 1;
+    channel.positionKeys.push_back ({ 0.0f, Vector3 (0, 0, 0) });
+    channel.positionKeys.push_back ({ 1.0f, Vector3 (2, 0, 0) });
+    channel.rotationKeys.push_back ({ 0.0f, Quaternion () });
+    channel.rotationKeys.push_back ({ 1.0f, Quaternion (90.0f, Vector3 (0, 0, 1)) });
+    clip.addChannel (channel);
+    std::vector<Transform> locals (2, translation (0, 5, 0));
+    WHEN ("It is sampled halfway.") {
+      clip.sample (0.5f, locals);
+      THEN ("The node is halfway, and the other node is untouched.") {
+	REQUIRE (locals[1].getPosition ().m_x == Approx (1.0f));
+	REQUIRE (locals[1].getRight ().m_y == Approx (std::sin (M_PI / 4)));
+	REQUIRE (locals[0].getPosition ().m_y == Approx (5.0f));
+      }
+    }
+    WHEN ("It is sampled past its end.") {
+      clip.sample (1.25f, locals);
+      THEN ("It has wrapped around.") {
+	REQUIRE (locals[1].getPosition ().m_x == Approx (0.5f));
+      }
+    }
+  }
+}
+
+/// \brief Gets a clip with keys every frame at 30 per second: node 0 bobs
+///   and sways, and node 1 stands still and stays unscaled.
+/// \return The clip.
+static AnimationClip
+bakedClip ()
+{
+  const unsigned int FRAMES = 61;
+  AnimationClip clip ("sway", 2.0f);
+  AnimationChannel moving, still;
+  moving.node = 0;
+  still.node = 1;
+  for (unsigned int frame = 0; frame < FRAMES; ++frame)
+  {
+    float time = frame / 30.0f;
+    float phase = static_cast<float> (M_PI) * time;
+    moving.positionKeys.push_back ({ time, Vector3 (std::sin (phase), 0.1f * time, 0) });
+    moving.rotationKeys.push_back ({ time, Quaternion (30.0f * std::sin (phase), Vector3 (0, 1, 0)) });
+    still.positionKeys.push_back ({ time, Vector3 (0, 2, 0) });
+    still.scaleKeys.push_back ({ time, Vector3 (1, 1, 1) });
+  }
+  clip.addChannel (moving);
+  clip.addChannel (still);
+  return clip;
+}
+
+SCENARIO ("CompressedClip is smaller than its clip and samples like it.", "[CompressedClip]") {
+  GIVEN ("A clip baked at 30 frames per second, and it compressed.") {
+    AnimationClip clip = bakedClip ();
+    CompressedClip compressed (clip);
+    THEN ("Still tracks have one key, and the whole takes less memory.") {
+      // Node 0's 122 keys, node 1's 2; node 1's tracks shrink to 1 each.
+      REQUIRE (compressed.getKeyCount () < 122 + 2);
+      REQUIRE (compressed.getByteCount () * 3 < clip.getByteCount ());
+      REQUIRE (compressed.getDuration () == Approx (2.0f));
+    }
+    THEN ("Sampling it is within tolerance of sampling the clip.") {
+      for (float time = 0.0f; time < 3.0f; time += 0.013f)
+      {
+	std::vector<Transform> expected (2), actual (2);
+	clip.sample (time, expected);
+	compressed.sample (time, actual);
+	for (unsigned int node = 0; node < 2; ++node)
+	{
+	  Vector3 offset = actual[node].getPosition () - expected[node].getPosition ();
+	  REQUIRE (offset.length () < 4.0f * CompressedClip::POSITION_TOLERANCE);
+	  float turn = actual[node].getRight ().dot (expected[node].getRight ());
+	  REQUIRE (turn > std::cos (2.0f * CompressedClip::ROTATION_TOLERANCE_DEGREES * M_PI / 180));
+	  REQUIRE (actual[node].getUp ().length () == Approx (1.0f).margin (1e-3));
+	}
+      }
+    }
+    WHEN ("Six characters play it forward together with cursors.") {
+      std::vector<std::vector<Transform>> many (6, std::vector<Transform> (2));
+      std::vector<CompressedClip::Cursor> cursors (6);
+      std::vector<Transform>* locals[6];
+      CompressedClip::Cursor* cursorPointers[6];
+      for (unsigned int character = 0; character < 6; ++character)
+      {
+	locals[character] = &many[character];
+	cursorPointers[character] = &cursors[character];
+      }
+      THEN ("Each matches sampling alone, including across the loop.") {
+	for (float time = 0.0f; time < 5.0f; time += 0.07f)
+	{
+	  float times[6];
+	  for (unsigned int character = 0; character < 6; ++character)
+	    times[character] = time + 0.3f * character;
+	  compressed.sampleMany (6, times, locals, cursorPointers);
+	  for (unsigned int character = 0; character < 6; ++character)
+	  {
+	    std::vector<Transform> alone (2);
+	    compressed.sample (times[character], alone);
+	    Vector3 offset = many[character][0].getPosition () - alone[0].getPosition ();
+	    REQUIRE (offset.length () == Approx (0.0f).margin (1e-5));
+	    REQUIRE (many[character][0].getBack ().dot (alone[0].getBack ()) == Approx (1.0f));
+	  }
+	}
+      }
+    }
+  }
+}
+
+SCENARIO ("Animator builds bone palettes from a clip.", "[Animator]") {
+  GIVEN ("A root with a child 1 up, a mesh with one bone on the child, "
+	 "and a clip that turns the root 90 degrees about z.") {
+    Model model;
+    ModelNode root;
+    root.parent = -1;
+    model.nodes.push_back (root);
+    ModelNode child;
+    child.parent = 0;
+    child.local = translation (0, 1, 0);
+    child.world = child.local;
+    model.nodes.push_back (child);
+
+    ModelMesh mesh;
+    ModelBone bone;
+    bone.node = 1;
+    // The bone's inverse bind pose.
+    bone.offset = translation (0, -1, 0);
+    mesh.bones.push_back (bone);
+    model.meshes.push_back (mesh);
+
+    AnimationClip clip ("turn", 2.0f);
+    AnimationChannel channel;
+    channel.node = 0;
+    channel.rotationKeys.push_back ({ 0.0f, Quaternion () });
+    channel.rotationKeys.push_back ({ 1.0f, Quaternion (90.0f, Vector3 (0, 0, 1)) });
+    clip.addChannel (channel);
+    model.animations.push_back (CompressedClip (clip));
+
+    Animator animator (model);
+    THEN ("In the bind pose every bone matrix is the identity.") {
+      const std::vector<float>& palette = animator.getPalette (0);
+      REQUIRE (palette.size () == 16);
+      REQUIRE (palette[0] == Approx (1.0f));
+      REQUIRE (palette[5] == Approx (1.0f));
+      REQUIRE (palette[13] == Approx (0.0f).margin (1e-5));
+    }
+    WHEN ("The clip has played for 1 second.") {
+      animator.play (0);
+      animator.advance (1.0f);
+      animator.evaluate ();
+      THEN ("The child has swung round, and its bone matrix is the turn.") {
+	Vector3 position = animator.getWorlds ()[1].getPosition ();
+	REQUIRE (position.m_x == Approx (-1.0f));
+	REQUIRE (position.m_y == Approx (0.0f).margin (1e-5));
+	const std::vector<float>& palette = animator.getPalette (0);
+	REQUIRE (palette[0] == Approx (0.0f).margin (1e-5));
+	REQUIRE (palette[1] == Approx (1.0f));
+	REQUIRE (palette[12] == Approx (0.0f).margin (1e-5));
+      }
+    }
+  }
+}
@@ -0,0 +1,156 @@
+/// \file TestCommandBufferContext.cpp
+/// \brief A collection of Catch2 unit tests for the CommandBufferContext
+///   class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <string>
+#include <vector>
+
+#include "CommandBufferContext.hpp"
+#include "NullOpenGLContext.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+/// \brief A NullOpenGLContext that remembers the arguments of a few calls.
+class CaptureContext : public NullOpenGLContext
+{
+public:
+
+  virtual void
+  bufferData (GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+  {
+    const unsigned char* bytes = static_cast<const unsigned char*> (data);
+    if (bytes != nullptr)
+      bufferBytes.assign (bytes, bytes + size);
+    calls.push_back ("bufferData");
+  }
+
+  virtual void
+  deleteBuffers (GLsizei n, const GLuint* buffers)
+  {
+    deleted.assign (buffers, buffers + n);
+    calls.push_back ("deleteBuffers");
+  }
+
+  virtual void
+  drawElements (GLenum mode, GLsizei count, GLenum type, const void* indices)
+  {
+    drawCount = count;
+    drawOffset = reinterpret_cast<uintptr_t> (indices);
+    calls.push_back ("drawElements");
+  }
+
+  virtual void
+  shaderSource (GLuint shader, GLsizei count, const GLchar** string, const GLint* length)
+  {
+    for (GLsizei part = 0; part < count; ++part)
+      source += std::string (string[part], length[part]);
+    calls.push_back ("shaderSource");
+  }
+
+  virtual void
+  uniformMatrix4fv (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+  {
+    matrix.assign (value, value + 16 * count);
+    calls.push_back ("uniformMatrix4fv");
+  }
+
+  virtual void
+  useProgram (GLuint program)
+  {
+    programs.push_back (program);
+    calls.push_back ("useProgram");
+  }
+
+  std::vector<std::string> calls;
+  std::vector<unsigned char> bufferBytes;
+  std::vector<GLuint> deleted;
+  std::vector<GLfloat> matrix;
+  std::vector<GLuint> programs;
+  std::string source;
+  GLsizei drawCount = 0;
+  uintptr_t drawOffset = 0;
+};
+
+SCENARIO ("CommandBufferContext replays calls in order.", "[CommandBufferContext]") {
+  GIVEN ("A CommandBufferContext with several calls recorded.") {
+    CommandBufferContext buffer;
+    std::vector<unsigned char> data = { 1, 2, 3, 4, 5 };
+    GLfloat matrix[16];
+    for (int i = 0; i < 16; ++i)
+      matrix[i] = i * 0.5f;
+    GLuint names[] = { 7, 8, 9 };
+    const GLchar* parts[] = { "#version 330\n", "void main () {}" };
+
+    buffer.useProgram (3);
+    buffer.bufferData (GL_ARRAY_BUFFER, data.size (), data.data (), GL_STATIC_DRAW);
+    buffer.uniformMatrix4fv (2, 1, GL_FALSE, matrix);
+    buffer.drawElements (GL_TRIANGLES, 36, GL_UNSIGNED_INT, reinterpret_cast<void*> (24));
+    buffer.deleteBuffers (3, names);
+    buffer.shaderSource (5, 2, parts, nullptr);
+    buffer.useProgram (0);
+
+    // Recording copies, so the originals may change right away.
+    data[0] = 99;
+    matrix[0] = 99.0f;
+    names[0] = 99;
+
+    THEN ("It counts them.") {
+      REQUIRE (buffer.getCommandCount () == 7);
+      REQUIRE (buffer.getByteCount () > 0);
+    }
+    WHEN ("It is replayed.") {
+      CaptureContext capture;
+      buffer.replay (&capture);
+      THEN ("Every call arrives, in order, with its original arguments.") {
+	REQUIRE (capture.calls == std::vector<std::string> { "useProgram", "bufferData", "uniformMatrix4fv",
+							     "drawElements", "deleteBuffers", "shaderSource",
+							     "useProgram" });
+	REQUIRE (capture.programs == std::vector<GLuint> { 3, 0 });
+	REQUIRE (capture.bufferBytes == std::vector<unsigned char> { 1, 2, 3, 4, 5 });
+	REQUIRE (capture.matrix.size () == 16);
+	REQUIRE (capture.matrix[0] == 0.0f);
+	REQUIRE (capture.matrix[15] == 7.5f);
+	REQUIRE (capture.drawCount == 36);
+	REQUIRE (capture.drawOffset == 24);
+	REQUIRE (capture.deleted == std::vector<GLuint> { 7, 8, 9 });
+	REQUIRE (capture.source == "#version 330\nvoid main () {}");
+      }
+      AND_WHEN ("It is replayed again.") {
+	CaptureContext again;
+	buffer.replay (&again);
+	THEN ("The same calls arrive.") {
+	  REQUIRE (again.calls == capture.calls);
+	}
+      }
+    }
+    WHEN ("It is reset.") {
+      buffer.reset ();
+      CaptureContext capture;
+      buffer.replay (&capture);
+      THEN ("Nothing is replayed.") {
+	REQUIRE (buffer.getCommandCount () == 0);
+	REQUIRE (buffer.getByteCount () == 0);
+	REQUIRE (capture.calls.empty ());
+      }
+    }
+  }
+}
+
+SCENARIO ("CommandBufferContext keeps null data null.", "[CommandBufferContext]") {
+  GIVEN ("A recorded bufferData that only allocates.") {
+    CommandBufferContext buffer;
+    buffer.bufferData (GL_ARRAY_BUFFER, 1024, nullptr, GL_DYNAMIC_DRAW);
+    WHEN ("It is replayed.") {
+      CaptureContext capture;
+      buffer.replay (&capture);
+      THEN ("The data is still null and nothing was copied.") {
+	REQUIRE (capture.calls.size () == 1);
+	REQUIRE (capture.bufferBytes.empty ());
+	REQUIRE (buffer.getByteCount () < 64);
+      }
+    }
+  }
+}
@@ -0,0 +1,105 @@
+/// \file TestCpuProfiler.cpp
+/// \brief A collection of Catch2 unit tests for the CpuProfiler class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#define ENABLE_PROFILER
+#include "CpuProfiler.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+/// \brief Reads a whole file.
+static std::string
+readFile (const std::string& fileName)
+{
+  std::ifstream in (fileName);
+  std::stringstream contents;
+  contents << in.rdbuf ();
+  return contents.str ();
+}
+
+/// \brief Counts the occurrences of a substring.
+static unsigned int
+countOf (const std::string& text, const std::string& part)
+{
+  unsigned int count = 0;
+  for (size_t at = text.find (part); at != std::string::npos; at = text.find (part, at + 1))
+    ++count;
+  return count;
+}
+
+SCENARIO ("CpuProfiler records zones from several threads.", "[CpuProfiler]") {
+  GIVEN ("Nested zones on the main thread and zones on two workers.") {
+    uint64_t before = CpuProfiler::getZoneCount ();
+    PROFILE_THREAD_NAME ("main");
+    {
+      PROFILE_ZONE ("outer");
+      PROFILE_ZONE ("inner");
+    }
+    std::thread first ([] () { PROFILE_THREAD_NAME ("worker"); for (int i = 0; i < 10; ++i) { PROFILE_ZONE ("work"); } });
+    std::thread second ([] () { for (int i = 0; i < 10; ++i) { PROFILE_ZONE ("work"); } });
+    first.join ();
+    second.join ();
+    THEN ("Every zone is counted.") {
+      REQUIRE (CpuProfiler::getZoneCount () - before == 22);
+    }
+    WHEN ("A trace is written.") {
+      REQUIRE (CpuProfiler::writeChromeTrace ("TestCpuProfiler.json"));
+      std::string trace = readFile ("TestCpuProfiler.json");
+      std::remove ("TestCpuProfiler.json");
+      THEN ("It holds one complete event per zone and the thread names.") {
+	REQUIRE (trace.find ("{\"traceEvents\":[") == 0);
+	REQUIRE (countOf (trace, "\"name\":\"outer\"") >= 1);
+	REQUIRE (countOf (trace, "\"name\":\"inner\"") >= 1);
+	REQUIRE (countOf (trace, "\"name\":\"work\"") >= 20);
+	REQUIRE (countOf (trace, "\"args\":{\"name\":\"worker\"}") >= 1);
+	REQUIRE (countOf (trace, "\"args\":{\"name\":\"main\"}") == 1);
+      }
+    }
+  }
+}
+
+SCENARIO ("CpuProfiler escapes names in traces.", "[CpuProfiler]") {
+  GIVEN ("A zone whose name holds a quote, a backslash, and a newline.") {
+    std::thread quoted ([] ()
+			{
+			  CpuProfiler::record ("say \"C:\\\n\"", 0, 1);
+			});
+    quoted.join ();
+    WHEN ("A trace is written.") {
+      REQUIRE (CpuProfiler::writeChromeTrace ("TestCpuProfiler.json"));
+      std::string trace = readFile ("TestCpuProfiler.json");
+      std::remove ("TestCpuProfiler.json");
+      THEN ("The name comes out as a valid JSON string.") {
+	REQUIRE (countOf (trace, "\"name\":\"say \\\"C:\\\\\\u000a\\\"\"") == 1);
+      }
+    }
+  }
+}
+
+SCENARIO ("CpuProfiler keeps only the newest zones.", "[CpuProfiler]") {
+  GIVEN ("A thread that records more zones than its buffer holds.") {
+    std::thread busy ([] ()
+		      {
+			for (unsigned int i = 0; i < CpuProfiler::ZONES_PER_THREAD + 5; ++i)
+			  CpuProfiler::record ("old", 0, 1);
+			CpuProfiler::record ("newest", 0, 1);
+		      });
+    busy.join ();
+    WHEN ("A trace is written.") {
+      REQUIRE (CpuProfiler::writeChromeTrace ("TestCpuProfiler.json"));
+      std::string trace = readFile ("TestCpuProfiler.json");
+      std::remove ("TestCpuProfiler.json");
+      THEN ("The newest zone survives and the buffer did not grow.") {
+	REQUIRE (countOf (trace, "\"name\":\"newest\"") == 1);
+	REQUIRE (countOf (trace, "\"name\":\"old\"") == CpuProfiler::ZONES_PER_THREAD - 1);
+      }
+    }
+  }
+}
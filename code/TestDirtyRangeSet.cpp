@@ -0,0 +1,77 @@
+/// \file TestDirtyRangeSet.cpp
+/// \brief A collection of Catch2 unit tests for the DirtyRangeSet class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include "DirtyRangeSet.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+SCENARIO ("DirtyRangeSet starts empty.", "[DirtyRangeSet]") {
+  GIVEN ("A new DirtyRangeSet.") {
+    DirtyRangeSet d;
+    THEN ("Nothing is dirty.") {
+      REQUIRE (d.empty ());
+      REQUIRE (d.getRanges ().size () == 0);
+      REQUIRE (d.getTotalLength () == 0);
+    }
+    WHEN ("I add an empty range.") {
+      d.add (5, 5);
+      THEN ("Nothing is dirty.") {
+	REQUIRE (d.empty ());
+      }
+    }
+  }
+}
+
+SCENARIO ("DirtyRangeSet coalesces ranges.", "[DirtyRangeSet]") {
+  GIVEN ("A DirtyRangeSet containing [10, 20) and [40, 50).") {
+    DirtyRangeSet d;
+    d.add (40, 50);
+    d.add (10, 20);
+    THEN ("The ranges are kept separate and sorted.") {
+      REQUIRE (d.getRanges ().size () == 2);
+      REQUIRE (d.getRanges ()[0].begin == 10);
+      REQUIRE (d.getRanges ()[1].begin == 40);
+      REQUIRE (d.getTotalLength () == 20);
+    }
+    WHEN ("I add [20, 25), which touches the first range.") {
+      d.add (20, 25);
+      THEN ("It is merged into the first range.") {
+	REQUIRE (d.getRanges ().size () == 2);
+	REQUIRE (d.getRanges ()[0].begin == 10);
+	REQUIRE (d.getRanges ()[0].end == 25);
+      }
+    }
+    WHEN ("I add [15, 45), which overlaps both ranges.") {
+      d.add (15, 45);
+      THEN ("Everything becomes one range.") {
+	REQUIRE (d.getRanges ().size () == 1);
+	REQUIRE (d.getRanges ()[0].begin == 10);
+	REQUIRE (d.getRanges ()[0].end == 50);
+      }
+    }
+    WHEN ("I add [0, 100), which covers both ranges.") {
+      d.add (0, 100);
+      THEN ("Everything becomes one range.") {
+	REQUIRE (d.getRanges ().size () == 1);
+	REQUIRE (d.getTotalLength () == 100);
+      }
+    }
+    WHEN ("I add [25, 30), which touches neither range.") {
+      d.add (25, 30);
+      THEN ("It is inserted between them.") {
+	REQUIRE (d.getRanges ().size () == 3);
+	REQUIRE (d.getRanges ()[1].begin == 25);
+	REQUIRE (d.getRanges ()[1].end == 30);
+      }
+    }
+    WHEN ("I clear it.") {
+      d.clear ();
+      THEN ("Nothing is dirty.") {
+	REQUIRE (d.empty ());
+      }
+    }
+  }
+}
@@ -0,0 +1,93 @@
+/// \file TestFramePacer.cpp
+/// \brief A collection of Catch2 unit tests for the FramePacer class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include "FramePacer.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+SCENARIO ("FramePacer modes are named and set the swap interval.", "[FramePacer]") {
+  GIVEN ("Each mode's name.") {
+    const char* names[] = { "vsync", "uncapped", "cap", "jit" };
+    THEN ("It parses to a mode with the same name.") {
+      for (const char* name : names)
+      {
+	FramePacer::Mode mode;
+	REQUIRE (FramePacer::parseMode (name, mode));
+	REQUIRE (FramePacer (mode, 60.0).getModeName () == name);
+      }
+    }
+    THEN ("Only vsync and jit wait for vertical blank.") {
+      REQUIRE (FramePacer (FramePacer::VSYNC, 60.0).getSwapInterval () == 1);
+      REQUIRE (FramePacer (FramePacer::UNCAPPED, 60.0).getSwapInterval () == 0);
+      REQUIRE (FramePacer (FramePacer::CAPPED, 60.0).getSwapInterval () == 0);
+      REQUIRE (FramePacer (FramePacer::JUST_IN_TIME, 60.0).getSwapInterval () == 1);
+    }
+  }
+  GIVEN ("An unknown name.") {
+    FramePacer::Mode mode = FramePacer::VSYNC;
+    THEN ("It doesn't parse.") {
+      REQUIRE_FALSE (FramePacer::parseMode ("fast", mode));
+      REQUIRE (mode == FramePacer::VSYNC);
+    }
+  }
+}
+
+SCENARIO ("A capped FramePacer keeps a fixed cadence.", "[FramePacer]") {
+  GIVEN ("A pacer capped at 100 Hz whose first frame began at 10 s.") {
+    FramePacer pacer (FramePacer::CAPPED, 100.0);
+    pacer.beginFrame (10.0);
+    THEN ("The next frame is due 10 ms later.") {
+      REQUIRE (pacer.getWakeTime () == Approx (10.01));
+    }
+    WHEN ("The next frame begins a little late.") {
+      pacer.beginFrame (10.0103);
+      THEN ("The one after is still due on the cadence.") {
+	REQUIRE (pacer.getWakeTime () == Approx (10.02));
+      }
+    }
+    WHEN ("A whole frame is missed.") {
+      pacer.beginFrame (10.05);
+      THEN ("The cadence restarts rather than catching up.") {
+	REQUIRE (pacer.getWakeTime () == Approx (10.06));
+      }
+    }
+  }
+}
+
+SCENARIO ("A just-in-time FramePacer wakes just before the next blank.", "[FramePacer]") {
+  GIVEN ("A 50 Hz just-in-time pacer.") {
+    FramePacer pacer (FramePacer::JUST_IN_TIME, 50.0);
+    THEN ("Before any swap it doesn't wait.") {
+      REQUIRE (pacer.getWakeTime () == 0.0);
+      REQUIRE (pacer.getPredictedWorkSeconds () == 0.0);
+    }
+    WHEN ("Frames take 4 ms of work and the last swap returned at 2 s.") {
+      for (int frame = 0; frame < 10; ++frame)
+      {
+	pacer.beginFrame (1.0 + frame);
+	pacer.endWork (1.004 + frame);
+      }
+      pacer.endFrame (2.0);
+      THEN ("It wakes 4 ms, plus a margin, before the blank 20 ms later.") {
+	REQUIRE (pacer.getPredictedWorkSeconds () == Approx (0.004));
+	REQUIRE (pacer.getWakeTime () < 2.016);
+	REQUIRE (pacer.getWakeTime () > 2.010);
+      }
+    }
+  }
+}
+
+SCENARIO ("FramePacer::sleepUntil doesn't return early.", "[FramePacer]") {
+  GIVEN ("A deadline 5 ms off.") {
+    double deadline = FramePacer::now () + 0.005;
+    WHEN ("Sleeping until it.") {
+      FramePacer::sleepUntil (deadline);
+      THEN ("It has passed.") {
+	REQUIRE (FramePacer::now () >= deadline);
+      }
+    }
+  }
+}
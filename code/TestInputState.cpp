@@ -0,0 +1,132 @@
+/// \file TestInputState.cpp
+/// \brief A collection of Catch2 unit tests for the InputState class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include "InputState.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+/// \brief Makes a key or button event.
+/// \param[in] type InputEvent::KEY or InputEvent::MOUSE_BUTTON.
+/// \param[in] code The key or button.
+/// \param[in] action GLFW_PRESS or GLFW_RELEASE.
+/// \param[in] time When it happened.
+/// \return The event.
+static InputEvent
+press (InputEvent::Type type, int code, int action, double time)
+{
+  InputEvent event = InputEvent ();
+  event.type = type;
+  event.code = code;
+  event.action = action;
+  event.time = time;
+  return event;
+}
+
+/// \brief Makes a cursor event.
+/// \param[in] x The cursor's x-coordinate.
+/// \param[in] y The cursor's y-coordinate.
+/// \param[in] time When it happened.
+/// \return The event.
+static InputEvent
+cursor (double x, double y, double time)
+{
+  InputEvent event = InputEvent ();
+  event.type = InputEvent::CURSOR;
+  event.x = x;
+  event.y = y;
+  event.time = time;
+  return event;
+}
+
+SCENARIO ("InputState measures how long keys are held.", "[InputState]") {
+  GIVEN ("A step from 1.0 to 1.1 seconds.") {
+    InputState input;
+    input.beginStep (1.0);
+    WHEN ("W is tapped from 1.02 to 1.05.") {
+      input.apply (press (InputEvent::KEY, GLFW_KEY_W, GLFW_PRESS, 1.02));
+      input.apply (press (InputEvent::KEY, GLFW_KEY_W, GLFW_RELEASE, 1.05));
+      input.endStep (1.1);
+      THEN ("The tap counts though W is up again.") {
+	REQUIRE (input.getHeldSeconds (GLFW_KEY_W) == Approx (0.03));
+	REQUIRE_FALSE (input.isKeyDown (GLFW_KEY_W));
+      }
+    }
+    WHEN ("A is pressed at 1.04 and held.") {
+      input.apply (press (InputEvent::KEY, GLFW_KEY_A, GLFW_PRESS, 1.04));
+      input.endStep (1.1);
+      THEN ("It counts until the end of the step.") {
+	REQUIRE (input.getHeldSeconds (GLFW_KEY_A) == Approx (0.06));
+	REQUIRE (input.isKeyDown (GLFW_KEY_A));
+      }
+      AND_WHEN ("The next step runs to 1.2 and A is released at 1.15.") {
+	input.beginStep (1.1);
+	input.apply (press (InputEvent::KEY, GLFW_KEY_A, GLFW_RELEASE, 1.15));
+	input.endStep (1.2);
+	THEN ("Only this step's part counts.") {
+	  REQUIRE (input.getHeldSeconds (GLFW_KEY_A) == Approx (0.05));
+	}
+      }
+    }
+    WHEN ("A press is stamped after the step ends.") {
+      input.apply (press (InputEvent::KEY, GLFW_KEY_D, GLFW_PRESS, 1.15));
+      input.endStep (1.1);
+      THEN ("It isn't held at all during this step.") {
+	REQUIRE (input.getHeldSeconds (GLFW_KEY_D) == 0.0);
+	REQUIRE (input.isKeyDown (GLFW_KEY_D));
+      }
+      AND_WHEN ("The next step runs to 1.2.") {
+	input.beginStep (1.1);
+	input.endStep (1.2);
+	THEN ("It counts from when it was pressed.") {
+	  REQUIRE (input.getHeldSeconds (GLFW_KEY_D) == Approx (0.05));
+	}
+      }
+    }
+    WHEN ("A press is stamped before the step began.") {
+      input.apply (press (InputEvent::KEY, GLFW_KEY_S, GLFW_PRESS, 0.9));
+      input.endStep (1.1);
+      THEN ("It counts from the start of the step.") {
+	REQUIRE (input.getHeldSeconds (GLFW_KEY_S) == Approx (0.1));
+      }
+    }
+  }
+}
+
+SCENARIO ("InputState coalesces cursor motion into drags.", "[InputState]") {
+  GIVEN ("A step in which the cursor starts at (100, 100).") {
+    InputState input;
+    input.beginStep (0.0);
+    input.apply (cursor (100.0, 100.0, 0.001));
+    WHEN ("It moves in three events with the left button down.") {
+      input.apply (press (InputEvent::MOUSE_BUTTON, GLFW_MOUSE_BUTTON_LEFT, GLFW_PRESS, 0.002));
+      input.apply (cursor (103.0, 101.0, 0.003));
+      input.apply (cursor (110.0, 99.0, 0.004));
+      input.apply (cursor (108.0, 104.0, 0.005));
+      input.endStep (0.01);
+      THEN ("The drag is the total motion.") {
+	REQUIRE (input.getLeftDragX () == Approx (8.0));
+	REQUIRE (input.getLeftDragY () == Approx (4.0));
+	REQUIRE (input.getRightDragX () == Approx (0.0));
+	REQUIRE (input.getEventCount () == 5);
+      }
+      AND_WHEN ("The next step begins.") {
+	input.beginStep (0.01);
+	THEN ("The drag starts again from zero.") {
+	  REQUIRE (input.getLeftDragX () == Approx (0.0));
+	  REQUIRE (input.getEventCount () == 0);
+	}
+      }
+    }
+    WHEN ("It moves with no button down.") {
+      input.apply (cursor (150.0, 150.0, 0.002));
+      input.endStep (0.01);
+      THEN ("Nothing is dragged.") {
+	REQUIRE (input.getLeftDragX () == Approx (0.0));
+	REQUIRE (input.getRightDragX () == Approx (0.0));
+      }
+    }
+  }
+}
@@ -0,0 +1,209 @@
+/// \file TestJobSystem.cpp
+/// \brief A collection of Catch2 unit tests for the JobSystem class and the
+///   WorkStealingDeque class template it is built on.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "JobSystem.hpp"
+#include "WorkStealingDeque.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+SCENARIO ("WorkStealingDeque pops newest first and steals oldest first.", "[WorkStealingDeque]") {
+  GIVEN ("A deque of 4 holding 1, 2, 3.") {
+    WorkStealingDeque<int, 4> deque;
+    int value = -1;
+    REQUIRE (deque.empty ());
+    REQUIRE_FALSE (deque.pop (value));
+    REQUIRE_FALSE (deque.steal (value));
+    REQUIRE (deque.push (1));
+    REQUIRE (deque.push (2));
+    REQUIRE (deque.push (3));
+    THEN ("The owner gets 3 back, a thief gets 1, and then 2 is left.") {
+      REQUIRE (deque.pop (value));
+      REQUIRE (value == 3);
+      REQUIRE (deque.steal (value));
+      REQUIRE (value == 1);
+      REQUIRE (deque.pop (value));
+      REQUIRE (value == 2);
+      REQUIRE (deque.empty ());
+      REQUIRE_FALSE (deque.pop (value));
+    }
+    THEN ("One more fits, and then pushes fail until something is taken.") {
+      REQUIRE (deque.push (4));
+      REQUIRE_FALSE (deque.push (5));
+      REQUIRE (deque.steal (value));
+      REQUIRE (deque.push (5));
+    }
+  }
+  GIVEN ("An owner pushing and popping 100000 values while three threads steal.") {
+    const int VALUES = 100000;
+    const int THIEVES = 3;
+    WorkStealingDeque<int, 256> deque;
+    std::vector<std::atomic<int>> taken (VALUES);
+    std::atomic<bool> done (false);
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < THIEVES; ++t)
+      thieves.emplace_back ([&] ()
+			    {
+			      int value;
+			      while (!done.load ())
+			      {
+				if (deque.steal (value))
+				  ++taken[value];
+				else
+				  std::this_thread::yield ();
+			      }
+			    });
+    int value;
+    for (int next = 0; next < VALUES; )
+    {
+      if (deque.push (next))
+	++next;
+      else
+	std::this_thread::yield ();
+      // Take back every third, so owner and thieves race for the last one.
+      if (next % 3 == 0 && deque.pop (value))
+	++taken[value];
+    }
+    while (deque.pop (value))
+      ++taken[value];
+    done = true;
+    for (std::thread& thief : thieves)
+      thief.join ();
+    THEN ("Each value was taken exactly once.") {
+      int wrong = 0;
+      for (std::atomic<int>& count : taken)
+	wrong += count.load () != 1;
+      REQUIRE (wrong == 0);
+    }
+  }
+}
+
+SCENARIO ("JobSystem runs jobs and waits on Counters.", "[JobSystem]") {
+  GIVEN ("A JobSystem with four threads.") {
+    JobSystem jobs (4);
+    REQUIRE (jobs.getThreadCount () == 4);
+    WHEN ("1000 jobs are counted on one Counter and waited on.") {
+      std::atomic<int> sum (0);
+      JobSystem::Counter counter;
+      for (int job = 1; job <= 1000; ++job)
+	jobs.run ([&sum, job] () { sum += job; }, &counter);
+      jobs.wait (counter);
+      THEN ("Every one has run.") {
+	REQUIRE (counter.isDone ());
+	REQUIRE (sum == 500500);
+      }
+    }
+    WHEN ("A job is started after a group of them, and another after it.") {
+      std::atomic<int> finished (0);
+      std::atomic<int> seenBySecond (-1), seenByThird (-1);
+      JobSystem::Counter first, second, third;
+      for (int job = 0; job < 50; ++job)
+	jobs.run ([&finished] () { std::this_thread::yield (); ++finished; }, &first);
+      jobs.runAfter (first, [&] () { seenBySecond = finished.load (); ++finished; }, &second);
+      jobs.runAfter (second, [&] () { seenByThird = finished.load (); }, &third);
+      jobs.wait (third);
+      jobs.wait (first);
+      jobs.wait (second);
+      THEN ("Each starts only once everything before it has finished.") {
+	REQUIRE (seenBySecond == 50);
+	REQUIRE (seenByThird == 51);
+      }
+    }
+    WHEN ("A job is started after a Counter with nothing on it.") {
+      std::atomic<bool> ran (false);
+      JobSystem::Counter empty, counter;
+      jobs.runAfter (empty, [&ran] () { ran = true; }, &counter);
+      jobs.wait (counter);
+      THEN ("It starts right away.") {
+	REQUIRE (ran);
+      }
+    }
+    WHEN ("parallelFor covers a range, with nested parallelFors inside it.") {
+      std::vector<std::atomic<int>> hits (10000);
+      jobs.parallelFor (100, 1, [&] (size_t begin, size_t end)
+      {
+	for (size_t row = begin; row < end; ++row)
+	  jobs.parallelFor (100, 10, [&] (size_t columnBegin, size_t columnEnd)
+	  {
+	    for (size_t column = columnBegin; column < columnEnd; ++column)
+	      ++hits[row * 100 + column];
+	  });
+      });
+      THEN ("Every item is visited exactly once.") {
+	int wrong = 0;
+	for (std::atomic<int>& count : hits)
+	  wrong += count.load () != 1;
+	REQUIRE (wrong == 0);
+      }
+    }
+    WHEN ("parallelFor is given a range smaller than its grain.") {
+      std::vector<std::thread::id> callers;
+      jobs.parallelFor (5, 10, [&] (size_t begin, size_t end)
+      {
+	callers.push_back (std::this_thread::get_id ());
+	REQUIRE (begin == 0);
+	REQUIRE (end == 5);
+      });
+      THEN ("The caller does it all in one piece.") {
+	REQUIRE (callers.size () == 1);
+	REQUIRE (callers[0] == std::this_thread::get_id ());
+      }
+    }
+  }
+  GIVEN ("A JobSystem with one worker, kept busy until released.") {
+    JobSystem jobs (2);
+    std::atomic<bool> started (false), released (false);
+    JobSystem::Counter blocker;
+    jobs.run ([&] ()
+	      {
+		started = true;
+		while (!released.load ())
+		  std::this_thread::yield ();
+	      }, &blocker);
+    while (!started.load ())
+      std::this_thread::yield ();
+    WHEN ("Another thread's job is queued, and this thread runs and waits on its own.") {
+      std::thread::id otherRanOn, ownRanOn;
+      JobSystem::Counter other, own;
+      std::thread starter ([&] ()
+			   {
+			     jobs.run ([&otherRanOn] () { otherRanOn = std::this_thread::get_id (); },
+				       &other);
+			   });
+      starter.join ();
+      jobs.run ([&ownRanOn] () { ownRanOn = std::this_thread::get_id (); }, &own);
+      jobs.wait (own);
+      THEN ("It runs only its own, and leaves the other for the worker.") {
+	REQUIRE (ownRanOn == std::this_thread::get_id ());
+	REQUIRE_FALSE (other.isDone ());
+	released = true;
+	while (!other.isDone ())
+	  std::this_thread::yield ();
+	jobs.wait (other);
+	REQUIRE (otherRanOn != std::this_thread::get_id ());
+	REQUIRE (otherRanOn != std::thread::id ());
+      }
+    }
+    released = true;
+    jobs.wait (blocker);
+  }
+  GIVEN ("A JobSystem with one thread, and so no workers.") {
+    JobSystem jobs (1);
+    std::vector<int> order;
+    JobSystem::Counter counter;
+    jobs.run ([&order] () { order.push_back (1); }, &counter);
+    jobs.run ([&order] () { order.push_back (2); }, &counter);
+    THEN ("Nothing runs until the caller waits, and then the caller runs it all.") {
+      REQUIRE (order.empty ());
+      jobs.wait (counter);
+      REQUIRE (order == std::vector<int> ({ 1, 2 }));
+    }
+  }
+}
@@ -0,0 +1,98 @@
+/// \file TestMpscQueue.cpp
+/// \brief A collection of Catch2 unit tests for the MpscQueue class template.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "MpscQueue.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+SCENARIO ("MpscQueue is first in, first out.", "[MpscQueue]") {
+  GIVEN ("An empty queue.") {
+    MpscQueue<int> q;
+    int value = -1;
+    THEN ("Nothing can be popped.") {
+      REQUIRE (q.empty ());
+      REQUIRE_FALSE (q.tryPop (value));
+      REQUIRE (value == -1);
+    }
+    WHEN ("I push 1, 2, 3.") {
+      q.push (1);
+      q.push (2);
+      q.push (3);
+      THEN ("They come back out in the same order, then it is empty.") {
+	REQUIRE_FALSE (q.empty ());
+	REQUIRE (q.tryPop (value));
+	REQUIRE (value == 1);
+	REQUIRE (q.tryPop (value));
+	REQUIRE (value == 2);
+	REQUIRE (q.tryPop (value));
+	REQUIRE (value == 3);
+	REQUIRE (q.empty ());
+	REQUIRE_FALSE (q.tryPop (value));
+      }
+    }
+  }
+}
+
+SCENARIO ("MpscQueue holds move-only values.", "[MpscQueue]") {
+  GIVEN ("A queue of unique_ptrs that is destroyed while not empty.") {
+    std::shared_ptr<int> tracker (new int (7));
+    {
+      MpscQueue<std::unique_ptr<std::shared_ptr<int>>> q;
+      q.push (std::unique_ptr<std::shared_ptr<int>> (new std::shared_ptr<int> (tracker)));
+      q.push (std::unique_ptr<std::shared_ptr<int>> (new std::shared_ptr<int> (tracker)));
+      std::unique_ptr<std::shared_ptr<int>> out;
+      REQUIRE (q.tryPop (out));
+      REQUIRE (**out == 7);
+      REQUIRE (tracker.use_count () == 3);
+    }
+    THEN ("Everything left in it was freed.") {
+      REQUIRE (tracker.use_count () == 1);
+    }
+  }
+}
+
+SCENARIO ("MpscQueue accepts pushes from many threads at once.", "[MpscQueue]") {
+  GIVEN ("Four threads each pushing 10000 tagged values.") {
+    const int THREADS = 4;
+    const int PER_THREAD = 10000;
+    MpscQueue<int> q;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < THREADS; ++t)
+      producers.emplace_back ([&q, t] ()
+			      {
+				for (int i = 0; i < PER_THREAD; ++i)
+				  q.push (t * PER_THREAD + i);
+			      });
+
+    // Consume while the producers are still running.
+    std::vector<int> next (THREADS, 0);
+    int received = 0;
+    bool ordered = true;
+    while (received < THREADS * PER_THREAD)
+    {
+      int value;
+      if (!q.tryPop (value))
+	continue;
+      int thread = value / PER_THREAD;
+      ordered = ordered && value % PER_THREAD == next[thread];
+      ++next[thread];
+      ++received;
+    }
+    for (std::thread& producer : producers)
+      producer.join ();
+
+    THEN ("Every value arrives once, in the order its thread pushed it.") {
+      REQUIRE (ordered);
+      REQUIRE (q.empty ());
+      for (int t = 0; t < THREADS; ++t)
+	REQUIRE (next[t] == PER_THREAD);
+    }
+  }
+}
@@ -0,0 +1,148 @@
+/// \file TestObjReader.cpp
+/// \brief A collection of Catch2 unit tests for the OBJ reader.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <string>
+#include <sstream>
+
+#include "ObjReader.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+/// \brief Parses OBJ text held in a string.
+static bool
+parse (const std::string& text, std::vector<ModelMesh>& meshes,
+       unsigned int threadCount = 1)
+{
+  return parseObj (text.data (), text.data () + text.size (), meshes, threadCount);
+}
+
+SCENARIO ("Reading simple OBJ faces.", "[ObjReader]") {
+  GIVEN ("A single triangle with normals.") {
+    std::string text =
+      "# a comment\n"
+      "v 0 0 0\nv 1 0 0\nv 0 1 0\n"
+      "vn 0 0 1\n"
+      "f 1//1 2//1 3//1\n";
+    std::vector<ModelMesh> meshes;
+    REQUIRE (parse (text, meshes));
+    THEN ("There is one mesh with 3 vertices in position / normal layout.") {
+      REQUIRE (meshes.size () == 1);
+      REQUIRE (meshes[0].vertices.size () == 18);
+      REQUIRE (meshes[0].indices == std::vector<unsigned int> { 0, 1, 2 });
+      REQUIRE (meshes[0].vertices[6] == Approx (1.0f));
+      REQUIRE (meshes[0].vertices[11] == Approx (1.0f));
+    }
+  }
+
+  GIVEN ("A quad that reuses corners through negative and v/vt/vn indices.") {
+    std::string text =
+      "v 0 0 0\r\nv 1 0 0\r\nv 1 1 0\r\nv 0 1 0\r\n"
+      "vt 0 0\r\nvn 0 0 1\r\n"
+      "f -4/1/1 -3/1/1 -2/1/1 -1/1/1\r\n";
+    std::vector<ModelMesh> meshes;
+    REQUIRE (parse (text, meshes));
+    THEN ("It is split into a fan of two triangles sharing 4 vertices.") {
+      REQUIRE (meshes.size () == 1);
+      REQUIRE (meshes[0].vertices.size () == 24);
+      REQUIRE (meshes[0].indices == std::vector<unsigned int> { 0, 1, 2, 0, 2, 3 });
+    }
+  }
+
+  GIVEN ("A triangle without normals.") {
+    std::string text = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+    std::vector<ModelMesh> meshes;
+    REQUIRE (parse (text, meshes));
+    THEN ("Its normal is generated from the face.") {
+      REQUIRE (meshes[0].vertices[3] == Approx (0.0f));
+      REQUIRE (meshes[0].vertices[4] == Approx (0.0f));
+      REQUIRE (meshes[0].vertices[5] == Approx (1.0f));
+    }
+  }
+}
+
+SCENARIO ("Splitting OBJ files into meshes.", "[ObjReader]") {
+  GIVEN ("Two named objects with a material change before any faces.") {
+    std::string text =
+      "v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 1\n"
+      "o first\ng first\nusemtl a\nf 1//1 2//1 3//1\n"
+      "o second\nusemtl b\nf 3//1 2//1 1//1\nf 1//1 2//1 3//1\n";
+    std::vector<ModelMesh> meshes;
+    REQUIRE (parse (text, meshes));
+    THEN ("Each object becomes its own mesh with its own indexing.") {
+      REQUIRE (meshes.size () == 2);
+      REQUIRE (meshes[0].name == "first");
+      REQUIRE (meshes[1].name == "second");
+      REQUIRE (meshes[1].indices == std::vector<unsigned int> { 0, 1, 2, 2, 1, 0 });
+    }
+  }
+  GIVEN ("Two objects without normals sharing an edge, one facing +z and one +x.") {
+    std::string text =
+      "v 0 0 0\nv 0 1 0\nv 1 0 0\nv 0 0 1\n"
+      "o front\nf 1 3 2\n"
+      "o side\nf 1 2 4\n";
+    std::vector<ModelMesh> meshes;
+    REQUIRE (parse (text, meshes));
+    THEN ("Each mesh's shared corners get only its own face's normal.") {
+      REQUIRE (meshes.size () == 2);
+      for (unsigned int vertex = 0; vertex < 3; ++vertex)
+      {
+	REQUIRE (meshes[0].vertices[vertex * 6 + 5] == Approx (1.0f));
+	REQUIRE (meshes[1].vertices[vertex * 6 + 3] == Approx (1.0f));
+      }
+    }
+  }
+}
+
+SCENARIO ("Rejecting bad OBJ files.", "[ObjReader]") {
+  std::vector<ModelMesh> meshes;
+  GIVEN ("A face that refers to a missing vertex.") {
+    THEN ("Reading fails.") {
+      REQUIRE_FALSE (parse ("v 0 0 0\nf 1 2 3\n", meshes));
+    }
+  }
+  GIVEN ("A vertex with a missing coordinate.") {
+    THEN ("Reading fails.") {
+      REQUIRE_FALSE (parse ("v 0 0\n", meshes));
+    }
+  }
+}
+
+SCENARIO ("Parsing OBJ files on several threads.", "[ObjReader]") {
+  GIVEN ("A grid large enough to be split into several chunks.") {
+    std::ostringstream out;
+    const int SIZE = 200;
+    for (int y = 0; y <= SIZE; ++y)
+      for (int x = 0; x <= SIZE; ++x)
+	out << "v " << x << " " << y << " " << (x * y % 7) << "\nvn 0 0 1\n";
+    for (int y = 0; y < SIZE; ++y)
+    {
+      if (y == SIZE / 2)
+	out << "o upper\n";
+      for (int x = 0; x < SIZE; ++x)
+      {
+	int corner = y * (SIZE + 1) + x + 1;
+	out << "f " << corner << "//" << corner << " " << corner + 1 << "//" << corner + 1
+	    << " " << corner + SIZE + 2 << "//" << corner + SIZE + 2
+	    << " " << corner + SIZE + 1 << "//" << corner + SIZE + 1 << "\n";
+      }
+    }
+    std::string text = out.str ();
+    std::vector<ModelMesh> serial, parallel;
+    REQUIRE (parse (text, serial, 1));
+    REQUIRE (parse (text, parallel, 8));
+    THEN ("The results are identical.") {
+      REQUIRE (serial.size () == 2);
+      REQUIRE (parallel.size () == 2);
+      for (unsigned int m = 0; m < 2; ++m)
+      {
+	REQUIRE (serial[m].name == parallel[m].name);
+	REQUIRE (serial[m].indices == parallel[m].indices);
+	REQUIRE (serial[m].vertices == parallel[m].vertices);
+      }
+      REQUIRE (serial[0].indices.size () == SIZE / 2 * SIZE * 6);
+    }
+  }
+}
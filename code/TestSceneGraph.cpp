@@ -0,0 +1,198 @@
+/// \file TestSceneGraph.cpp
+/// \brief A collection of Catch2 unit tests for the SceneGraph class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include "SceneGraph.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+/// \brief Gets a transform that only translates.
+/// \param[in] x How far along x.
+/// \param[in] y How far along y.
+/// \param[in] z How far along z.
+/// \return The transform.
+static Transform
+translation (float x, float y, float z)
+{
+  Transform t;
+  t.setPosition (x, y, z);
+  return t;
+}
+
+SCENARIO ("SceneGraph computes world transforms from parents.", "[SceneGraph]") {
+  GIVEN ("A root at x = 1, yawed 90 degrees, with a child 2 along its local z.") {
+    SceneGraph graph;
+    Transform rootLocal = translation (1, 0, 0);
+    rootLocal.yaw (90);
+    unsigned int root = graph.addNode (rootLocal);
+    unsigned int child = graph.addNode (translation (0, 0, 2), root);
+    WHEN ("It is updated.") {
+      unsigned int recomputed = graph.update ();
+      THEN ("Both nodes are computed, and the child's world is parent * local.") {
+	REQUIRE (recomputed == 2);
+	REQUIRE (graph.getParent (child) == root);
+	REQUIRE (graph.getParent (root) == SceneGraph::NO_PARENT);
+	Vector3 position = graph.getWorld (child).getPosition ();
+	REQUIRE (position.m_x == Approx (3.0f));
+	REQUIRE (position.m_y == Approx (0.0f).margin (1e-5));
+	REQUIRE (position.m_z == Approx (0.0f).margin (1e-5));
+      }
+      THEN ("New nodes start with no motion to blend.") {
+	REQUIRE (graph.getPreviousWorld (child).getPosition ().m_x == Approx (3.0f));
+      }
+      THEN ("Updating again does nothing.") {
+	REQUIRE (graph.update () == 0);
+      }
+    }
+  }
+}
+
+SCENARIO ("SceneGraph recomputes only changed subtrees.", "[SceneGraph]") {
+  GIVEN ("A root with two children, each with 4999 descendants in a chain.") {
+    SceneGraph graph;
+    unsigned int root = graph.addNode (Transform ());
+    unsigned int left = graph.addNode (translation (-1, 0, 0), root);
+    unsigned int leaf = left;
+    for (int i = 0; i < 4999; ++i)
+      leaf = graph.addNode (translation (0, 1, 0), leaf);
+    unsigned int right = graph.addNode (translation (1, 0, 0), root);
+    unsigned int parent = right;
+    for (int i = 0; i < 4999; ++i)
+      parent = graph.addNode (translation (0, 1, 0), parent);
+    graph.update ();
+    REQUIRE (graph.getNodeCount () == 10001);
+    REQUIRE (graph.getWorld (leaf).getPosition ().m_y == Approx (4999.0f));
+
+    WHEN ("The root moves.") {
+      graph.setLocal (root, translation (0, 0, 5));
+      THEN ("Every node is recomputed once.") {
+	REQUIRE (graph.update () == 10001);
+	REQUIRE (graph.getWorld (leaf).getPosition ().m_z == Approx (5.0f));
+	REQUIRE (graph.getWorld (parent).getPosition ().m_z == Approx (5.0f));
+      }
+    }
+    WHEN ("One branch moves, and a node inside it too.") {
+      graph.setLocal (right, translation (2, 0, 0));
+      graph.setLocal (graph.getParent (parent), translation (0, 3, 0));
+      THEN ("Only that branch is recomputed, once.") {
+	REQUIRE (graph.update () == 5000);
+	REQUIRE (graph.getWorld (parent).getPosition ().m_x == Approx (2.0f));
+	REQUIRE (graph.getWorld (parent).getPosition ().m_y == Approx (5001.0f));
+	REQUIRE (graph.getWorld (leaf).getPosition ().m_x == Approx (-1.0f));
+      }
+    }
+  }
+}
+
+SCENARIO ("SceneGraph keeps ids when children are inserted mid-array.", "[SceneGraph]") {
+  GIVEN ("Two roots, each with a child, added root, root, child, child.") {
+    SceneGraph graph;
+    unsigned int a = graph.addNode (translation (10, 0, 0));
+    unsigned int b = graph.addNode (translation (20, 0, 0));
+    unsigned int aChild = graph.addNode (translation (0, 1, 0), a);
+    unsigned int bChild = graph.addNode (translation (0, 2, 0), b);
+    graph.update ();
+    THEN ("Each id still names its own node.") {
+      REQUIRE (graph.getParent (aChild) == a);
+      REQUIRE (graph.getParent (bChild) == b);
+      REQUIRE (graph.getWorld (aChild).getPosition ().m_x == Approx (10.0f));
+      REQUIRE (graph.getWorld (aChild).getPosition ().m_y == Approx (1.0f));
+      REQUIRE (graph.getWorld (bChild).getPosition ().m_x == Approx (20.0f));
+      REQUIRE (graph.getWorld (bChild).getPosition ().m_y == Approx (2.0f));
+    }
+    WHEN ("The first root moves.") {
+      graph.setLocal (a, translation (30, 0, 0));
+      THEN ("Only it and its child are recomputed.") {
+	REQUIRE (graph.update () == 2);
+	REQUIRE (graph.getWorld (aChild).getPosition ().m_x == Approx (30.0f));
+	REQUIRE (graph.getWorld (bChild).getPosition ().m_x == Approx (20.0f));
+      }
+    }
+    WHEN ("Previous worlds are saved and then a root moves.") {
+      graph.savePreviousWorlds ();
+      graph.setLocal (b, translation (40, 0, 0));
+      graph.update ();
+      THEN ("The previous world is where it was.") {
+	REQUIRE (graph.getPreviousWorld (bChild).getPosition ().m_x == Approx (20.0f));
+	REQUIRE (graph.getWorld (bChild).getPosition ().m_x == Approx (40.0f));
+      }
+    }
+  }
+}
+
+SCENARIO ("SceneGraph removes nodes and reattaches their children.", "[SceneGraph]") {
+  GIVEN ("A root at x = 1 with a middle node at y = 2, which has two leaves, and a second root.") {
+    SceneGraph graph;
+    unsigned int root = graph.addNode (translation (1, 0, 0));
+    unsigned int middle = graph.addNode (translation (0, 2, 0), root);
+    unsigned int left = graph.addNode (translation (0, 0, 3), middle);
+    unsigned int right = graph.addNode (translation (0, 0, 4), middle);
+    unsigned int other = graph.addNode (translation (5, 0, 0));
+    graph.update ();
+    WHEN ("The middle node is removed.") {
+      graph.removeNode (middle);
+      graph.update ();
+      THEN ("Its children hang off the root and stay where they were.") {
+	REQUIRE (graph.getNodeCount () == 4);
+	REQUIRE (graph.getParent (left) == root);
+	REQUIRE (graph.getParent (right) == root);
+	REQUIRE (graph.getLocal (left).getPosition ().m_y == Approx (2.0f));
+	REQUIRE (graph.getWorld (left).getPosition ().m_x == Approx (1.0f));
+	REQUIRE (graph.getWorld (left).getPosition ().m_y == Approx (2.0f));
+	REQUIRE (graph.getWorld (right).getPosition ().m_z == Approx (4.0f));
+	REQUIRE (graph.getWorld (other).getPosition ().m_x == Approx (5.0f));
+      }
+      THEN ("Moving the root carries them, but not the other root.") {
+	graph.setLocal (root, translation (10, 0, 0));
+	REQUIRE (graph.update () == 3);
+	REQUIRE (graph.getWorld (right).getPosition ().m_x == Approx (10.0f));
+	REQUIRE (graph.getWorld (other).getPosition ().m_x == Approx (5.0f));
+      }
+      THEN ("Its id is handed out again.") {
+	unsigned int added = graph.addNode (translation (0, 6, 0), other);
+	graph.update ();
+	REQUIRE (added == middle);
+	REQUIRE (graph.getParent (added) == other);
+	REQUIRE (graph.getWorld (added).getPosition ().m_y == Approx (6.0f));
+	REQUIRE (graph.getWorld (left).getPosition ().m_y == Approx (2.0f));
+      }
+    }
+    WHEN ("The root is removed.") {
+      graph.removeNode (root);
+      graph.update ();
+      THEN ("The middle node becomes a root where it was.") {
+	REQUIRE (graph.getParent (middle) == SceneGraph::NO_PARENT);
+	REQUIRE (graph.getWorld (left).getPosition ().m_x == Approx (1.0f));
+	REQUIRE (graph.getWorld (left).getPosition ().m_z == Approx (3.0f));
+      }
+    }
+  }
+}
+
+SCENARIO ("SceneGraph snaps nodes that jump.", "[SceneGraph]") {
+  GIVEN ("A root with a child, with previous worlds saved.") {
+    SceneGraph graph;
+    unsigned int root = graph.addNode (translation (1, 0, 0));
+    unsigned int child = graph.addNode (translation (0, 1, 0), root);
+    graph.update ();
+    graph.savePreviousWorlds ();
+    WHEN ("The root moves and is snapped.") {
+      graph.setLocal (root, translation (50, 0, 0));
+      graph.snap (root);
+      graph.update ();
+      THEN ("Neither node has any motion to blend.") {
+	REQUIRE (graph.getPreviousWorld (root).getPosition ().m_x == Approx (50.0f));
+	REQUIRE (graph.getPreviousWorld (child).getPosition ().m_x == Approx (50.0f));
+      }
+    }
+    WHEN ("The root moves without being snapped.") {
+      graph.setLocal (root, translation (50, 0, 0));
+      graph.update ();
+      THEN ("The child blends from where it was.") {
+	REQUIRE (graph.getPreviousWorld (child).getPosition ().m_x == Approx (1.0f));
+      }
+    }
+  }
+}
@@ -0,0 +1,33 @@
+/// \file TestShaderVariants.cpp
+/// \brief A collection of Catch2 unit tests for the ShaderVariants class and
+///   the ShaderLibrary it builds with.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include "NullOpenGLContext.hpp"
+#include "ShaderLibrary.hpp"
+#include "ShaderVariants.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+SCENARIO ("ShaderVariants builds each feature mask once.", "[ShaderVariants]") {
+  GIVEN ("Variants of Mesh.vert and Vec3.frag in a library with no GL behind it.") {
+    NullOpenGLContext context;
+    ShaderLibrary library (&context, false);
+    ShaderVariants variants (library, "Mesh.vert", "Vec3.frag");
+    WHEN ("Two variants are built, and the first is asked for again.") {
+      ShaderProgram* normals = variants.get (SHADER_NORMALS);
+      ShaderProgram* colors = variants.get (SHADER_VERTEX_COLOR);
+      ShaderProgram* again = variants.get (SHADER_NORMALS);
+      library.poll ();
+      THEN ("The repeat is shared, and only the vertex shader is compiled per variant.") {
+	REQUIRE (again == normals);
+	REQUIRE (colors != normals);
+	REQUIRE (variants.getVariantCount () == 2);
+	REQUIRE (library.getCompiledShaderCount () == variants.getVariantCount () + 1);
+	REQUIRE (normals->isLinked ());
+      }
+    }
+  }
+}
@@ -0,0 +1,99 @@
+/// \file TestSpscRing.cpp
+/// \brief A collection of Catch2 unit tests for the SpscRing class template.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <thread>
+
+#include "SpscRing.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+SCENARIO ("SpscRing is first in, first out, and bounded.", "[SpscRing]") {
+  GIVEN ("An empty ring of 4.") {
+    SpscRing<int, 4> ring;
+    int value = -1;
+    THEN ("Nothing can be popped.") {
+      REQUIRE (ring.empty ());
+      REQUIRE_FALSE (ring.tryPop (value));
+      REQUIRE (value == -1);
+    }
+    WHEN ("I push 1 through 5.") {
+      bool pushed[5];
+      for (int i = 0; i < 5; ++i)
+	pushed[i] = ring.push (i + 1);
+      THEN ("The first four fit and the fifth doesn't.") {
+	REQUIRE (pushed[0]);
+	REQUIRE (pushed[3]);
+	REQUIRE_FALSE (pushed[4]);
+      }
+      THEN ("Peeking shows the front without removing it.") {
+	REQUIRE (ring.tryPeek (value));
+	REQUIRE (value == 1);
+	REQUIRE (ring.tryPeek (value));
+	REQUIRE (ring.tryPop (value));
+	REQUIRE (value == 1);
+      }
+      THEN ("They come back out in order, then it is empty.") {
+	for (int i = 1; i <= 4; ++i)
+	{
+	  REQUIRE (ring.tryPop (value));
+	  REQUIRE (value == i);
+	}
+	REQUIRE (ring.empty ());
+      }
+    }
+    WHEN ("I push and pop past the end many times.") {
+      bool inOrder = true;
+      for (int i = 0; i < 100; ++i)
+      {
+	ring.push (i);
+	ring.push (i);
+	inOrder = inOrder && ring.tryPop (value) && value == i;
+	inOrder = inOrder && ring.tryPop (value) && value == i;
+      }
+      THEN ("The indices wrap correctly.") {
+	REQUIRE (inOrder);
+	REQUIRE (ring.empty ());
+      }
+    }
+  }
+}
+
+SCENARIO ("SpscRing passes values between two threads.", "[SpscRing]") {
+  GIVEN ("A producer pushing 100000 values through a ring of 64.") {
+    const int VALUES = 100000;
+    SpscRing<int, 64> ring;
+    std::thread producer ([&ring, VALUES] ()
+      {
+	for (int value = 0; value < VALUES; ++value)
+	{
+	  while (!ring.push (value))
+	    std::this_thread::yield ();
+	}
+      });
+    WHEN ("The consumer pops them all.") {
+      bool inOrder = true;
+      int expected = 0;
+      int value;
+      while (expected < VALUES)
+      {
+	if (ring.tryPop (value))
+	{
+	  inOrder = inOrder && value == expected;
+	  ++expected;
+	}
+	else
+	{
+	  std::this_thread::yield ();
+	}
+      }
+      producer.join ();
+      THEN ("Every value arrived once, in order.") {
+	REQUIRE (inOrder);
+	REQUIRE (ring.empty ());
+      }
+    }
+  }
+}
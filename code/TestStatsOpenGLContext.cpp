@@ -0,0 +1,87 @@
+/// \file TestStatsOpenGLContext.cpp
+/// \brief A collection of Catch2 unit tests for the StatsOpenGLContext class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <algorithm>
+#include <sstream>
+
+#include "NullOpenGLContext.hpp"
+#include "StatsOpenGLContext.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+SCENARIO ("StatsOpenGLContext counts calls by type.", "[StatsOpenGLContext]") {
+  GIVEN ("A StatsOpenGLContext wrapping a NullOpenGLContext.") {
+    StatsOpenGLContext stats (new NullOpenGLContext ());
+    WHEN ("A frame binds, uploads, and draws.") {
+      GLuint buffers[2];
+      stats.genBuffers (2, buffers);
+      stats.bindBuffer (GL_ARRAY_BUFFER, buffers[0]);
+      stats.bufferData (GL_ARRAY_BUFFER, 96, nullptr, GL_STATIC_DRAW);
+      stats.bindBuffer (GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+      stats.bufferSubData (GL_ELEMENT_ARRAY_BUFFER, 0, 24, nullptr);
+      stats.drawElements (GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
+      stats.drawArrays (GL_TRIANGLE_STRIP, 0, 6);
+      THEN ("The frame in progress has every call.") {
+	const GlStats& current = stats.getCurrentStats ();
+	REQUIRE (current.calls[GlStats::CALL_GEN_BUFFERS] == 1);
+	REQUIRE (current.calls[GlStats::CALL_BIND_BUFFER] == 2);
+	REQUIRE (current.calls[GlStats::CALL_BUFFER_DATA] == 1);
+	REQUIRE (current.calls[GlStats::CALL_DRAW_ELEMENTS] == 1);
+	REQUIRE (current.calls[GlStats::CALL_DRAW_ARRAYS] == 1);
+	REQUIRE (current.getTotalCalls () == 7);
+	REQUIRE (current.drawCalls == 2);
+	REQUIRE (current.triangles == 12 + 4);
+	REQUIRE (current.uploadBytes == 96 + 24);
+	REQUIRE (stats.getFrameCount () == 0);
+      }
+      AND_WHEN ("The frame ends and another draws once.") {
+	stats.endFrame ();
+	stats.drawArrays (GL_TRIANGLES, 0, 3);
+	stats.endFrame ();
+	THEN ("The last frame and the total are both kept.") {
+	  REQUIRE (stats.getFrameCount () == 2);
+	  REQUIRE (stats.getFrameStats ().getTotalCalls () == 1);
+	  REQUIRE (stats.getFrameStats ().triangles == 1);
+	  REQUIRE (stats.getTotalStats ().drawCalls == 3);
+	  REQUIRE (stats.getTotalStats ().triangles == 17);
+	  REQUIRE (stats.getCurrentStats ().getTotalCalls () == 0);
+	}
+      }
+    }
+    WHEN ("Calls return values.") {
+      GLuint shader = stats.createShader (GL_VERTEX_SHADER);
+      GLint status = GL_FALSE;
+      stats.getShaderiv (shader, GL_COMPILE_STATUS, &status);
+      THEN ("They come from the inner context.") {
+	REQUIRE (shader != 0);
+	REQUIRE (status == GL_TRUE);
+	REQUIRE (stats.getCurrentStats ().calls[GlStats::CALL_CREATE_SHADER] == 1);
+      }
+    }
+  }
+}
+
+SCENARIO ("StatsOpenGLContext logs per-frame averages.", "[StatsOpenGLContext]") {
+  GIVEN ("A StatsOpenGLContext that logs every 2 frames.") {
+    StatsOpenGLContext stats (new NullOpenGLContext ());
+    std::ostringstream log;
+    stats.setLogInterval (2, log);
+    WHEN ("Each of 3 frames makes 2 draw calls.") {
+      for (int frame = 0; frame < 3; ++frame)
+      {
+	stats.drawArrays (GL_TRIANGLES, 0, 30);
+	stats.drawArrays (GL_TRIANGLES, 0, 30);
+	stats.endFrame ();
+      }
+      THEN ("One line averaging the first 2 frames is written.") {
+	std::string text = log.str ();
+	REQUIRE (std::count (text.begin (), text.end (), '\n') == 1);
+	REQUIRE (text.find ("2.0 draws, 20 triangles") != std::string::npos);
+	REQUIRE (text.find ("drawArrays 2.0") != std::string::npos);
+      }
+    }
+  }
+}
@@ -0,0 +1,71 @@
+/// \file TestTimingHistory.cpp
+/// \brief A collection of Catch2 unit tests for the TimingHistory class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include "TimingHistory.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+SCENARIO ("TimingHistory starts empty.", "[TimingHistory]") {
+  GIVEN ("A new TimingHistory.") {
+    TimingHistory h (4);
+    THEN ("Every statistic is 0.") {
+      REQUIRE (h.getCount () == 0);
+      REQUIRE (h.getLatest () == 0.0);
+      REQUIRE (h.getMin () == 0.0);
+      REQUIRE (h.getMax () == 0.0);
+      REQUIRE (h.getAverage () == 0.0);
+      REQUIRE (h.getPercentile (99) == 0.0);
+      REQUIRE (h.getSamples ().empty ());
+    }
+  }
+}
+
+SCENARIO ("TimingHistory summarizes its samples.", "[TimingHistory]") {
+  GIVEN ("A TimingHistory holding 1 through 100, shuffled.") {
+    TimingHistory h (100);
+    for (int i = 0; i < 100; ++i)
+      h.add ((i * 37) % 100 + 1);
+    THEN ("The statistics match.") {
+      REQUIRE (h.getCount () == 100);
+      REQUIRE (h.getMin () == 1.0);
+      REQUIRE (h.getMax () == 100.0);
+      REQUIRE (h.getAverage () == Approx (50.5));
+      REQUIRE (h.getPercentile (50) == 50.0);
+      REQUIRE (h.getPercentile (95) == 95.0);
+      REQUIRE (h.getPercentile (99) == 99.0);
+      REQUIRE (h.getPercentile (100) == 100.0);
+      REQUIRE (h.getPercentile (0) == 1.0);
+    }
+  }
+}
+
+SCENARIO ("TimingHistory keeps only the newest samples.", "[TimingHistory]") {
+  GIVEN ("A TimingHistory with room for 3 samples.") {
+    TimingHistory h (3);
+    WHEN ("I add 1, 2, 3, 4, 5.") {
+      for (int i = 1; i <= 5; ++i)
+	h.add (i);
+      THEN ("Only 3, 4, 5 remain, oldest first.") {
+	REQUIRE (h.getCount () == 3);
+	REQUIRE (h.getLatest () == 5.0);
+	REQUIRE (h.getMin () == 3.0);
+	std::vector<double> samples = h.getSamples ();
+	REQUIRE (samples.size () == 3);
+	REQUIRE (samples[0] == 3.0);
+	REQUIRE (samples[1] == 4.0);
+	REQUIRE (samples[2] == 5.0);
+      }
+      AND_WHEN ("I clear it.") {
+	h.clear ();
+	THEN ("It is empty and refills from the start.") {
+	  REQUIRE (h.getCount () == 0);
+	  h.add (9);
+	  REQUIRE (h.getSamples () == std::vector<double> { 9.0 });
+	}
+      }
+    }
+  }
+}
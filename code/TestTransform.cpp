@@ -598,3 +598,28 @@ SCENARIO ("", "[Transform][A06]") {
         }
     }
 }
+
+SCENARIO ("Transform lerp", "[Transform][A08]") {
+    GIVEN ("An initialized transform and one moved and scaled from it") {
+        INIT
+        Transform t2 = init ();
+        t2.setOrientation (Matrix3 (3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f));
+        t2.setPosition (Vector3 (4.0f, 8.0f, 12.0f));
+        WHEN ("I blend them by 0 and by 1") {
+            Transform start = lerp (t, t2, 0.0f);
+            Transform end = lerp (t, t2, 1.0f);
+            THEN ("I get each of them back") {
+    REQUIRE (start == t);
+    REQUIRE (end == t2);
+            }
+        }
+
+        WHEN ("I blend them by 0.5") {
+            Transform middle = lerp (t, t2, 0.5f);
+            THEN ("Every element is halfway between") {
+    REQUIRE (middle.getOrientation () == Matrix3 (2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f));
+    REQUIRE (middle.getPosition () == Vector3 (3.0f, 6.0f, 9.0f));
+            }
+        }
+    }
+}
@@ -0,0 +1,107 @@
+/// \file TestTripleBuffer.cpp
+/// \brief A collection of Catch2 unit tests for the TripleBuffer class
+///   template.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <thread>
+
+#include "TripleBuffer.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+SCENARIO ("TripleBuffer hands over the newest value.", "[TripleBuffer]") {
+  GIVEN ("A TripleBuffer with nothing published.") {
+    TripleBuffer<int> buffer;
+    THEN ("The reader has nothing new.") {
+      REQUIRE_FALSE (buffer.update ());
+      REQUIRE (buffer.getReadBuffer () == 0);
+    }
+    WHEN ("The writer publishes 1.") {
+      buffer.getWriteBuffer () = 1;
+      buffer.publish ();
+      THEN ("The reader gets it once.") {
+	REQUIRE (buffer.update ());
+	REQUIRE (buffer.getReadBuffer () == 1);
+	REQUIRE_FALSE (buffer.update ());
+	REQUIRE (buffer.getReadBuffer () == 1);
+      }
+    }
+    WHEN ("The writer publishes 1, 2, 3 before the reader looks.") {
+      for (int value = 1; value <= 3; ++value)
+      {
+	buffer.getWriteBuffer () = value;
+	buffer.publish ();
+      }
+      THEN ("The reader skips straight to 3.") {
+	REQUIRE (buffer.update ());
+	REQUIRE (buffer.getReadBuffer () == 3);
+	REQUIRE_FALSE (buffer.update ());
+      }
+    }
+    WHEN ("The writer publishes while the reader holds a value.") {
+      buffer.getWriteBuffer () = 1;
+      buffer.publish ();
+      buffer.update ();
+      buffer.getWriteBuffer () = 2;
+      buffer.publish ();
+      buffer.getWriteBuffer () = 3;
+      THEN ("The writer never writes into the reader's slot.") {
+	REQUIRE (buffer.getReadBuffer () == 1);
+	REQUIRE (buffer.update ());
+	REQUIRE (buffer.getReadBuffer () == 2);
+      }
+    }
+  }
+}
+
+/// \brief A value whose halves must always agree, so a torn read shows.
+struct Pair
+{
+  /// The value.
+  long first = 0;
+  /// Always twice first.
+  long second = 0;
+};
+
+SCENARIO ("TripleBuffer never tears a value.", "[TripleBuffer]") {
+  GIVEN ("A writer thread publishing 100000 values.") {
+    const long VALUES = 100000;
+    TripleBuffer<Pair> buffer;
+    std::thread writer ([&buffer, VALUES] ()
+      {
+	for (long value = 1; value <= VALUES; ++value)
+	{
+	  Pair& pair = buffer.getWriteBuffer ();
+	  pair.first = value;
+	  pair.second = value * 2;
+	  buffer.publish ();
+	}
+      });
+    WHEN ("The reader reads until it sees the last one.") {
+      bool consistent = true;
+      bool increasing = true;
+      long previous = 0;
+      while (previous != VALUES)
+      {
+	if (buffer.update ())
+	{
+	  const Pair& pair = buffer.getReadBuffer ();
+	  consistent = consistent && pair.second == pair.first * 2;
+	  increasing = increasing && pair.first > previous;
+	  previous = pair.first;
+	}
+	else
+	{
+	  std::this_thread::yield ();
+	}
+      }
+      writer.join ();
+      THEN ("Every value read was whole, and newer than the last.") {
+	REQUIRE (consistent);
+	REQUIRE (increasing);
+      }
+    }
+  }
+}
@@ -0,0 +1,111 @@
+/// \file TestTweenSystem.cpp
+/// \brief A collection of Catch2 unit tests for the TweenSystem class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <memory>
+
+#include "ColorsMesh.hpp"
+#include "NullOpenGLContext.hpp"
+#include "TweenSystem.hpp"
+
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+
+SCENARIO ("Tweens move Meshes along their easing curves.", "[TweenSystem]") {
+  GIVEN ("A Mesh at x = 1 and a TweenSystem on one thread.") {
+    JobSystem serial (1);
+    NullOpenGLContext context;
+    ColorsMesh mesh (&context, nullptr);
+    Transform start;
+    start.setPosition (1, 0, 0);
+    mesh.setWorld (start);
+    TweenSystem tweens (&serial);
+    WHEN ("It is moved 2 along x linearly over a second.") {
+      tweens.translate (&mesh, Vector3 (2, 0, 0), 1.0f, TweenSystem::LINEAR);
+      tweens.update (0.5f);
+      THEN ("It is halfway after half a second.") {
+	REQUIRE (mesh.getWorld ().getPosition ().m_x == Approx (2.0f));
+      }
+      tweens.update (0.75f);
+      THEN ("It stops at the end, and the tween is removed.") {
+	REQUIRE (mesh.getWorld ().getPosition ().m_x == Approx (3.0f));
+	REQUIRE (tweens.getTweenCount () == 0);
+      }
+    }
+    WHEN ("It is moved with EASE_IN_OUT.") {
+      tweens.translate (&mesh, Vector3 (0, 1, 0), 1.0f, TweenSystem::EASE_IN_OUT);
+      tweens.update (0.25f);
+      THEN ("A quarter of the way through it has gone 3/16 - 2/64.") {
+	REQUIRE (mesh.getWorld ().getPosition ().m_y == Approx (0.15625f));
+      }
+    }
+    WHEN ("It is moved with LOOP and with PING_PONG for 1.25 seconds.") {
+      ColorsMesh other (&context, nullptr);
+      tweens.translate (&mesh, Vector3 (4, 0, 0), 1.0f, TweenSystem::LINEAR, TweenSystem::LOOP);
+      tweens.translate (&other, Vector3 (4, 0, 0), 1.0f, TweenSystem::LINEAR,
+			TweenSystem::PING_PONG);
+      tweens.update (1.25f);
+      THEN ("The looping one has started over and the other is on its way back.") {
+	REQUIRE (mesh.getWorld ().getPosition ().m_x == Approx (2.0f));
+	REQUIRE (other.getWorld ().getPosition ().m_x == Approx (3.0f));
+	REQUIRE (tweens.getTweenCount () == 2);
+      }
+      tweens.stop (&other);
+    }
+    WHEN ("It is turned 90 degrees about y while being moved.") {
+      tweens.rotate (&mesh, Vector3 (0, 90, 0), 1.0f);
+      tweens.translate (&mesh, Vector3 (0, 0, 1), 1.0f);
+      tweens.update (1.0f);
+      THEN ("Both apply, turning in place.") {
+	Transform world = mesh.getWorld ();
+	REQUIRE (world.getRight ().m_z == Approx (-1.0f));
+	REQUIRE (world.getRight ().m_x == Approx (0.0f).margin (1e-5));
+	REQUIRE (world.getPosition ().m_x == Approx (1.0f));
+	REQUIRE (world.getPosition ().m_z == Approx (1.0f));
+      }
+    }
+    WHEN ("It is scaled and moved some other way partway through.") {
+      tweens.scale (&mesh, Vector3 (2, 2, 2), 1.0f, TweenSystem::LINEAR);
+      tweens.update (0.5f);
+      mesh.moveWorld (5.0f, Vector3 (0, 1, 0));
+      tweens.update (0.5f);
+      THEN ("It carries on from where it was moved to.") {
+	Transform world = mesh.getWorld ();
+	REQUIRE (world.getPosition ().m_y == Approx (5.0f));
+	REQUIRE (world.getRight ().m_x == Approx (2.0f));
+      }
+    }
+  }
+  GIVEN ("Eleven Meshes with tweens of different lengths, on several threads.") {
+    JobSystem jobs (4);
+    NullOpenGLContext context;
+    std::vector<std::unique_ptr<ColorsMesh>> meshes;
+    TweenSystem tweens (&jobs);
+    for (unsigned int meshNum = 0; meshNum < 11; ++meshNum)
+    {
+      meshes.emplace_back (new ColorsMesh (&context, nullptr));
+      tweens.translate (meshes.back ().get (), Vector3 (1, 0, 0), 1.0f + meshNum,
+			TweenSystem::LINEAR);
+    }
+    WHEN ("A second passes.") {
+      tweens.update (1.0f);
+      THEN ("Each has gone its own fraction of the way, and the first is done.") {
+	for (unsigned int meshNum = 0; meshNum < 11; ++meshNum)
+	  REQUIRE (meshes[meshNum]->getWorld ().getPosition ().m_x == Approx (1.0f / (1 + meshNum)));
+	REQUIRE (tweens.getTweenCount () == 10);
+      }
+    }
+    WHEN ("One is stopped.") {
+      tweens.update (1.0f);
+      tweens.stop (meshes[4].get ());
+      tweens.update (1.0f);
+      THEN ("It stays put while the rest go on.") {
+	REQUIRE (meshes[4]->getWorld ().getPosition ().m_x == Approx (0.2f));
+	REQUIRE (meshes[5]->getWorld ().getPosition ().m_x == Approx (2.0f / 6));
+	REQUIRE (meshes[10]->getWorld ().getPosition ().m_x == Approx (2.0f / 11));
+	REQUIRE (tweens.getTweenCount () == 8);
+      }
+    }
+  }
+}
@@ -0,0 +1,97 @@
+/// \file TimingHistory.cpp
+/// \brief Definitions of TimingHistory member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "TimingHistory.hpp"
+
+TimingHistory::TimingHistory (unsigned int capacity)
+  : m_capacity (capacity), m_next (0)
+{
+  m_samples.reserve (capacity);
+}
+
+void
+TimingHistory::add (double value)
+{
+  if (m_samples.size () < m_capacity)
+  {
+    m_samples.push_back (value);
+    return;
+  }
+  m_samples[m_next] = value;
+  m_next = (m_next + 1) % m_capacity;
+}
+
+void
+TimingHistory::clear ()
+{
+  m_samples.clear ();
+  m_next = 0;
+}
+
+unsigned int
+TimingHistory::getCount () const
+{
+  return m_samples.size ();
+}
+
+double
+TimingHistory::getLatest () const
+{
+  if (m_samples.empty ())
+    return 0.0;
+  if (m_samples.size () < m_capacity)
+    return m_samples.back ();
+  return m_samples[(m_next + m_capacity - 1) % m_capacity];
+}
+
+double
+TimingHistory::getMin () const
+{
+  if (m_samples.empty ())
+    return 0.0;
+  return *std::min_element (m_samples.begin (), m_samples.end ());
+}
+
+double
+TimingHistory::getMax () const
+{
+  if (m_samples.empty ())
+    return 0.0;
+  return *std::max_element (m_samples.begin (), m_samples.end ());
+}
+
+double
+TimingHistory::getAverage () const
+{
+  if (m_samples.empty ())
+    return 0.0;
+  return std::accumulate (m_samples.begin (), m_samples.end (), 0.0) / m_samples.size ();
+}
+
+double
+TimingHistory::getPercentile (double percentile) const
+{
+  if (m_samples.empty ())
+    return 0.0;
+  std::vector<double> sorted (m_samples);
+  // Nearest rank: the ceil (p / 100 * n)th smallest, counting from 1.
+  double rank = std::ceil (percentile / 100.0 * sorted.size ());
+  unsigned int index = static_cast<unsigned int> (std::max (rank, 1.0)) - 1;
+  index = std::min<unsigned int> (index, sorted.size () - 1);
+  std::nth_element (sorted.begin (), sorted.begin () + index, sorted.end ());
+  return sorted[index];
+}
+
+std::vector<double>
+TimingHistory::getSamples () const
+{
+  std::vector<double> samples (m_samples.begin () + m_next, m_samples.end ());
+  samples.insert (samples.end (), m_samples.begin (), m_samples.begin () + m_next);
+  return samples;
+}
@@ -0,0 +1,82 @@
+/// \file TimingHistory.hpp
+/// \brief Declaration of TimingHistory class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef TIMING_HISTORY_HPP
+#define TIMING_HISTORY_HPP
+
+#include <vector>
+
+/// \brief The most recent measurements of something that is timed over and
+///   over (usually once per frame), with summary statistics.
+/// Once full, each new sample replaces the oldest, so the statistics always
+///   describe a fixed-length window of recent frames.
+class TimingHistory
+{
+public:
+
+  /// \brief Constructs an empty TimingHistory.
+  /// \param[in] capacity The number of samples kept.
+  /// \pre capacity > 0.
+  TimingHistory (unsigned int capacity = 240);
+
+  /// \brief Records a sample.
+  /// \param[in] value The sample (by convention, in milliseconds).
+  /// \post If the history was full, its oldest sample has been dropped.
+  void
+  add (double value);
+
+  /// \brief Forgets every sample.
+  void
+  clear ();
+
+  /// \brief Gets the number of samples held.
+  /// \return The number of samples, which is at most the capacity.
+  unsigned int
+  getCount () const;
+
+  /// \brief Gets the most recent sample.
+  /// \return The sample, or 0 if there are none.
+  double
+  getLatest () const;
+
+  /// \brief Gets the smallest sample.
+  /// \return The minimum, or 0 if there are no samples.
+  double
+  getMin () const;
+
+  /// \brief Gets the largest sample.
+  /// \return The maximum, or 0 if there are no samples.
+  double
+  getMax () const;
+
+  /// \brief Gets the mean of the samples.
+  /// \return The mean, or 0 if there are no samples.
+  double
+  getAverage () const;
+
+  /// \brief Gets a percentile of the samples, by the nearest-rank method.
+  /// \param[in] percentile The percentile wanted, from 0 to 100 (so 99 for
+  ///   p99).
+  /// \return The smallest sample that at least percentile percent of the
+  ///   samples are less than or equal to, or 0 if there are no samples.
+  double
+  getPercentile (double percentile) const;
+
+  /// \brief Gets every sample, oldest first.
+  /// \return The samples.
+  std::vector<double>
+  getSamples () const;
+
+private:
+
+  /// The samples, used as a ring once full.
+  std::vector<double> m_samples;
+  /// The number of samples kept.
+  unsigned int m_capacity;
+  /// Where the next sample goes once the history is full.
+  unsigned int m_next;
+};
+
+#endif//TIMING_HISTORY_HPP
@@ -505,6 +505,20 @@ operator<< (std::ostream& out, const Transform& t)
     return out;
 }
 
+/// \brief Blends two transforms, for drawing between two simulation steps.
+/// \param[in] t1 The transform at amount 0.
+/// \param[in] t2 The transform at amount 1.
+/// \param[in] amount How far to go from t1 toward t2.
+/// \return A new transform that is t1 * (1 - amount) + t2 * amount.
+Transform
+lerp (const Transform& t1, const Transform& t2, float amount)
+{
+    Transform t3;
+    t3.setOrientation (t1.getOrientation () * (1.0f - amount) + t2.getOrientation () * amount);
+    t3.setPosition (t1.getPosition () * (1.0f - amount) + t2.getPosition () * amount);
+    return t3;
+}
+
 /// \brief Tests whether or not two transforms are equal.
 /// Transforms are equal if their matrices and vectors are equal.
 /// \param[in] t1 A transform.
@@ -280,6 +280,17 @@ private:
 Transform
 operator* (const Transform& t1, const Transform& t2);
 
+/// \brief Blends two transforms, for drawing between two simulation steps.
+/// The rotation/scale matrices and positions are blended element by
+///   element.  Over the small change between two steps that is as good as a
+///   true rotation blend, and unlike one it also carries scale and shear.
+/// \param[in] t1 The transform at amount 0.
+/// \param[in] t2 The transform at amount 1.
+/// \param[in] amount How far to go from t1 toward t2.
+/// \return A new transform that is t1 * (1 - amount) + t2 * amount.
+Transform
+lerp (const Transform& t1, const Transform& t2, float amount);
+
 /// \brief Prints the complete 4x4 matrix the Transform represents.
 /// Each element of the matrix should have 2 digits of precision and a field
 ///   width of 10.  Elements should be in this order:
@@ -0,0 +1,99 @@
+/// \file TripleBuffer.hpp
+/// \brief Declaration and definition of the TripleBuffer class template.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include <atomic>
+
+/// \brief Hands the latest of a stream of values from one writer thread to
+///   one reader thread without either ever waiting on the other.
+/// There are three slots: the writer fills one, the reader reads another,
+///   and the third holds the newest complete value.  Publishing and
+///   picking up a value are each a single atomic exchange of which slot is
+///   the middle one, so a slow reader simply skips values and a slow writer
+///   leaves the reader re-reading the last one.
+/// \tparam T The type of value.  It must be default-constructible.  Slots
+///   are reused, not cleared, so a writer can keep their capacity.
+template<typename T>
+class TripleBuffer
+{
+public:
+
+  /// \brief Constructs a TripleBuffer whose slots hold default values and
+  ///   which has nothing published.
+  TripleBuffer ()
+    : m_slots (), m_middle (1), m_writeSlot (0), m_readSlot (2)
+  {
+  }
+
+  /// \brief Copy constructor removed because the slots are shared between
+  ///   threads.
+  TripleBuffer (const TripleBuffer&) = delete;
+
+  /// \brief Assignment operator removed because the slots are shared
+  ///   between threads.
+  TripleBuffer&
+  operator= (const TripleBuffer&) = delete;
+
+  /// \brief Gets the slot the writer fills next.  Writer thread only.
+  /// \return The slot, which holds whatever was last published from it.
+  T&
+  getWriteBuffer ()
+  {
+    return m_slots[m_writeSlot];
+  }
+
+  /// \brief Makes the write slot the newest value and takes the old middle
+  ///   slot to write into next.  Writer thread only.
+  void
+  publish ()
+  {
+    unsigned int previous = m_middle.exchange (m_writeSlot | FRESH, std::memory_order_acq_rel);
+    m_writeSlot = previous & SLOT_MASK;
+  }
+
+  /// \brief Moves the newest published value, if it hasn't been seen yet,
+  ///   into the read slot.  Reader thread only.
+  /// \return Whether the read slot now holds a value it didn't before.
+  bool
+  update ()
+  {
+    if ((m_middle.load (std::memory_order_relaxed) & FRESH) == 0)
+      return false;
+    // Anything the writer published since the load is picked up too.
+    unsigned int previous = m_middle.exchange (m_readSlot, std::memory_order_acq_rel);
+    m_readSlot = previous & SLOT_MASK;
+    return true;
+  }
+
+  /// \brief Gets the value the reader is using.  Reader thread only.
+  /// \return The value from the last successful update, or a default value
+  ///   if there hasn't been one.
+  const T&
+  getReadBuffer () const
+  {
+    return m_slots[m_readSlot];
+  }
+
+private:
+
+  /// Set in m_middle when it holds a value the reader hasn't taken.
+  static const unsigned int FRESH = 4;
+  /// The bits of m_middle that are a slot index.
+  static const unsigned int SLOT_MASK = 3;
+
+  /// The three values.
+  T m_slots[3];
+  /// The index of the middle slot, plus FRESH.  On its own cache line, as
+  ///   both threads write it.
+  alignas (64) std::atomic<unsigned int> m_middle;
+  /// The index of the slot the writer owns.
+  alignas (64) unsigned int m_writeSlot;
+  /// The index of the slot the reader owns.
+  alignas (64) unsigned int m_readSlot;
+};
+
+#endif//TRIPLE_BUFFER_HPP
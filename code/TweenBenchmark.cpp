@@ -0,0 +1,209 @@
+/// \file TweenBenchmark.cpp
+/// \brief A command-line tool that times a TweenSystem animating many
+///   Meshes, against tweening them one struct at a time.
+/// \author Ethan Gingrich
+/// \version A08
+///
+/// Usage:
+///   TweenBenchmark.out [meshes [frames]]
+///     Gives that many Meshes (100000 by default) a looping move, a
+///     ping-ponging turn, and a ping-ponging scale, each with its own length
+///     and easing, then times that many 60 Hz updates (120 by default):
+///     through a TweenSystem on one thread and on every hardware thread,
+///     and through a plain array of tween structs updated one at a time,
+///     with a switch per easing, as a first attempt might be.  Build it
+///     with optimization on, or none of the sides is inlined.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "ColorsMesh.hpp"
+#include "NullOpenGLContext.hpp"
+#include "TimingHistory.hpp"
+#include "TweenSystem.hpp"
+
+/// \brief One tween, as a first attempt might store it.
+struct NaiveTween
+{
+  /// The Mesh.
+  Mesh* mesh;
+  /// 0 to move, 1 to turn, 2 to scale.
+  int kind;
+  /// How it speeds up and slows down.
+  TweenSystem::Easing easing;
+  /// Whether it comes back after reaching the end.
+  bool pingPong;
+  /// How long it has run, and how long one way takes.
+  float elapsed, seconds;
+  /// Its values at the start and end.
+  Vector3 from, to;
+};
+
+/// \brief One Mesh's pose, as a first attempt might store it.
+struct NaivePose
+{
+  /// Where it started.
+  Transform base;
+  /// Its offset, angles, and scale.
+  Vector3 offset, angles, scale;
+};
+
+/// \brief Eases a tween's progress, branching on the curve.
+/// \param[in] easing The curve.
+/// \param[in] u The progress, from 0 to 1.
+/// \return The eased progress.
+static float
+ease (TweenSystem::Easing easing, float u)
+{
+  switch (easing)
+  {
+  case TweenSystem::LINEAR:
+    return u;
+  case TweenSystem::EASE_IN:
+    return u * u;
+  case TweenSystem::EASE_OUT:
+    return 1.0f - (1.0f - u) * (1.0f - u);
+  case TweenSystem::EASE_IN_OUT:
+    return u * u * (3.0f - 2.0f * u);
+  case TweenSystem::CUBIC_IN:
+    return u * u * u;
+  default:
+    return 1.0f - (1.0f - u) * (1.0f - u) * (1.0f - u);
+  }
+}
+
+/// \brief Times a function.
+/// \param[in] work The function to time.
+/// \return The elapsed time in milliseconds.
+template<typename Function>
+static double
+timeMs (Function work)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+  work ();
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now () - start;
+  return elapsed.count ();
+}
+
+/// \brief Runs the benchmark.
+/// \param[in] argc The number of command-line arguments.
+/// \param[in] argv The number of Meshes and of frames to time.
+/// \return EXIT_SUCCESS.
+int
+main (int argc, char* argv[])
+{
+  const float FRAME_SECONDS = 1.0f / 60.0f;
+
+  unsigned int meshCount = argc > 1 ? std::atoi (argv[1]) : 100000;
+  unsigned int frames = argc > 2 ? std::atoi (argv[2]) : 120;
+  unsigned int hardwareThreads = std::max (std::thread::hardware_concurrency (), 1u);
+
+  NullOpenGLContext context;
+  std::vector<std::unique_ptr<Mesh>> meshes;
+  for (unsigned int meshNum = 0; meshNum < meshCount; ++meshNum)
+  {
+    meshes.emplace_back (new ColorsMesh (&context, nullptr));
+    Transform world;
+    world.setPosition (meshNum % 316 * 2.0f, 0, meshNum / 316 * 2.0f);
+    meshes.back ()->setWorld (world);
+  }
+  // The same tweens for every side: lengths and curves vary by Mesh.
+  auto secondsFor = [] (unsigned int meshNum, int kind)
+  {
+    return 0.5f + (meshNum * 7 + kind * 3) % 23 * 0.1f;
+  };
+  auto easingFor = [] (unsigned int meshNum, int kind)
+  {
+    return TweenSystem::Easing ((meshNum + kind) % 6);
+  };
+
+  auto timeSystem = [&] (unsigned int threads)
+  {
+    JobSystem jobs (threads);
+    TweenSystem tweens (&jobs);
+    for (unsigned int meshNum = 0; meshNum < meshCount; ++meshNum)
+    {
+      Mesh* mesh = meshes[meshNum].get ();
+      tweens.translate (mesh, Vector3 (0, 1, 0), secondsFor (meshNum, 0), easingFor (meshNum, 0),
+			TweenSystem::LOOP);
+      tweens.rotate (mesh, Vector3 (0, 180, 0), secondsFor (meshNum, 1), easingFor (meshNum, 1),
+		     TweenSystem::PING_PONG);
+      tweens.scale (mesh, Vector3 (1.5f, 1.5f, 1.5f), secondsFor (meshNum, 2),
+		    easingFor (meshNum, 2), TweenSystem::PING_PONG);
+    }
+    TimingHistory history (frames);
+    for (unsigned int frame = 0; frame < frames; ++frame)
+      history.add (timeMs ([&] () { tweens.update (FRAME_SECONDS); }));
+    for (std::unique_ptr<Mesh>& mesh : meshes)
+      tweens.stop (mesh.get ());
+    return history.getPercentile (50);
+  };
+
+  auto timeNaive = [&] ()
+  {
+    std::vector<NaiveTween> tweens;
+    std::vector<NaivePose> poses (meshCount);
+    for (unsigned int meshNum = 0; meshNum < meshCount; ++meshNum)
+    {
+      Mesh* mesh = meshes[meshNum].get ();
+      poses[meshNum].base = mesh->getWorld ();
+      poses[meshNum].scale = Vector3 (1, 1, 1);
+      tweens.push_back ({ mesh, 0, easingFor (meshNum, 0), false, 0.0f, secondsFor (meshNum, 0),
+			  Vector3 (0, 0, 0), Vector3 (0, 1, 0) });
+      tweens.push_back ({ mesh, 1, easingFor (meshNum, 1), true, 0.0f, secondsFor (meshNum, 1),
+			  Vector3 (0, 0, 0), Vector3 (0, 180, 0) });
+      tweens.push_back ({ mesh, 2, easingFor (meshNum, 2), true, 0.0f, secondsFor (meshNum, 2),
+			  Vector3 (1, 1, 1), Vector3 (1.5f, 1.5f, 1.5f) });
+    }
+    TimingHistory history (frames);
+    for (unsigned int frame = 0; frame < frames; ++frame)
+      history.add (timeMs ([&] ()
+      {
+	for (size_t tweenNum = 0; tweenNum < tweens.size (); ++tweenNum)
+	{
+	  NaiveTween& tween = tweens[tweenNum];
+	  NaivePose& pose = poses[tweenNum / 3];
+	  tween.elapsed += FRAME_SECONDS;
+	  float period = tween.pingPong ? 2.0f * tween.seconds : tween.seconds;
+	  if (tween.elapsed >= period)
+	    tween.elapsed = std::fmod (tween.elapsed, period);
+	  float u = tween.elapsed / tween.seconds;
+	  if (u > 1.0f)
+	    u = 2.0f - u;
+	  Vector3 value = tween.from + (tween.to - tween.from) * ease (tween.easing, u);
+	  if (tween.kind == 0)
+	    pose.offset = value;
+	  else if (tween.kind == 1)
+	    pose.angles = value;
+	  else
+	    pose.scale = value;
+	  if (tween.kind != 2)
+	    continue;
+	  // A Mesh's last tween poses it.
+	  Transform world = pose.base;
+	  world.yaw (pose.angles.m_y);
+	  world.pitch (pose.angles.m_x);
+	  world.roll (pose.angles.m_z);
+	  world.scaleLocal (pose.scale.m_x, pose.scale.m_y, pose.scale.m_z);
+	  world.setPosition (pose.base.getPosition () + pose.offset);
+	  tween.mesh->moveTo (world);
+	}
+      }));
+    return history.getPercentile (50);
+  };
+
+  double naiveMs = timeNaive ();
+  double serialMs = timeSystem (1);
+  double parallelMs = timeSystem (hardwareThreads);
+  std::printf ("%u meshes, %u tweens, median of %u updates\n", meshCount, meshCount * 3, frames);
+  std::printf ("  one struct per tween     %8.3f ms\n", naiveMs);
+  std::printf ("  TweenSystem, 1 thread    %8.3f ms (%.1fx)\n", serialMs, naiveMs / serialMs);
+  std::printf ("  TweenSystem, %2u threads  %8.3f ms (%.1fx)\n", hardwareThreads, parallelMs,
+	       naiveMs / parallelMs);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,411 @@
+/// \file TweenSystem.cpp
+/// \brief Definitions of TweenSystem member functions.
+/// \author Ethan Gingrich
+/// \version A08
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "TweenSystem.hpp"
+#include "CpuProfiler.hpp"
+
+const uint32_t TweenSystem::NO_TWEEN;
+const unsigned int TweenSystem::BASE_FLOATS;
+
+/// The fewest tweens or Meshes worth handing to another thread.
+static const size_t CHUNK_SIZE = 8192;
+
+/// \brief The coefficients a, b, and c of an easing curve
+///   e (u) = a u^3 + b u^2 + c u.  Every curve runs from (0, 0) to (1, 1).
+struct EasingCurve
+{
+  /// The coefficients.
+  float a, b, c;
+};
+
+/// Each TweenSystem::Easing's curve, in order.
+static const EasingCurve EASING_CURVES[] =
+{
+  { 0.0f, 0.0f, 1.0f },   // u
+  { 0.0f, 1.0f, 0.0f },   // u^2
+  { 0.0f, -1.0f, 2.0f },  // 1 - (1 - u)^2
+  { -2.0f, 3.0f, 0.0f },  // 3 u^2 - 2 u^3
+  { 1.0f, 0.0f, 0.0f },   // u^3
+  { 1.0f, -3.0f, 3.0f }   // 1 - (1 - u)^3
+};
+
+TweenSystem::TweenSystem (JobSystem* jobs)
+  : m_jobs (jobs != nullptr ? jobs : &JobSystem::getShared ())
+{
+}
+
+void
+TweenSystem::translate (Mesh* mesh, const Vector3& by, float seconds, Easing easing, Repeat repeat)
+{
+  uint32_t object = findObject (mesh);
+  Vector3 to (value (object, OFFSET, 0) + by.m_x, value (object, OFFSET, 1) + by.m_y,
+	      value (object, OFFSET, 2) + by.m_z);
+  start (mesh, OFFSET, to, seconds, easing, repeat);
+}
+
+void
+TweenSystem::rotate (Mesh* mesh, const Vector3& byDegrees, float seconds, Easing easing,
+		     Repeat repeat)
+{
+  uint32_t object = findObject (mesh);
+  Vector3 to (value (object, ANGLES, 0) + byDegrees.m_x, value (object, ANGLES, 1) + byDegrees.m_y,
+	      value (object, ANGLES, 2) + byDegrees.m_z);
+  start (mesh, ANGLES, to, seconds, easing, repeat);
+}
+
+void
+TweenSystem::scale (Mesh* mesh, const Vector3& by, float seconds, Easing easing, Repeat repeat)
+{
+  assert (by.m_x != 0.0f && by.m_y != 0.0f && by.m_z != 0.0f);
+  uint32_t object = findObject (mesh);
+  Vector3 to (value (object, SCALE, 0) * by.m_x, value (object, SCALE, 1) * by.m_y,
+	      value (object, SCALE, 2) * by.m_z);
+  start (mesh, SCALE, to, seconds, easing, repeat);
+}
+
+void
+TweenSystem::stop (Mesh* mesh)
+{
+  std::unordered_map<Mesh*, uint32_t>::iterator found = m_objects.find (mesh);
+  if (found == m_objects.end ())
+    return;
+  uint32_t object = found->second;
+  for (unsigned int channel = 0; channel < CHANNEL_COUNT; ++channel)
+    if (m_channelTweens[object * CHANNEL_COUNT + channel] != NO_TWEEN)
+      removeTween (m_channelTweens[object * CHANNEL_COUNT + channel]);
+
+  // Move the last Mesh into the gap, pointing its tweens at its new place.
+  uint32_t last = m_meshes.size () - 1;
+  if (object != last)
+  {
+    m_meshes[object] = m_meshes[last];
+    std::copy (&m_bases[last * BASE_FLOATS], &m_bases[last * BASE_FLOATS] + BASE_FLOATS,
+	       &m_bases[object * BASE_FLOATS]);
+    m_revisions[object] = m_revisions[last];
+    for (unsigned int channel = 0; channel < CHANNEL_COUNT; ++channel)
+    {
+      uint32_t tween = m_channelTweens[last * CHANNEL_COUNT + channel];
+      m_channelTweens[object * CHANNEL_COUNT + channel] = tween;
+      if (tween != NO_TWEEN)
+	m_targets[tween] = object * CHANNEL_COUNT + channel;
+    }
+    const float* values = &value (last, OFFSET, 0);
+    std::copy (values, values + CHANNEL_COUNT * 3, &value (object, OFFSET, 0));
+    const float* posed = &m_posedValues[last * CHANNEL_COUNT * 3];
+    std::copy (posed, posed + CHANNEL_COUNT * 3, &m_posedValues[object * CHANNEL_COUNT * 3]);
+    m_objects[m_meshes[object]] = object;
+  }
+  m_objects.erase (found);
+  m_meshes.pop_back ();
+  m_bases.resize (m_meshes.size () * BASE_FLOATS);
+  m_revisions.pop_back ();
+  m_values.resize (m_meshes.size () * CHANNEL_COUNT * 3);
+  m_posedValues.resize (m_meshes.size () * CHANNEL_COUNT * 3);
+  m_channelTweens.resize (m_meshes.size () * CHANNEL_COUNT);
+  m_isMoved.pop_back ();
+}
+
+void
+TweenSystem::update (float seconds)
+{
+  assert (seconds >= 0.0f);
+  if (m_targets.empty ())
+    return;
+  PROFILE_ZONE ("TweenSystem::update");
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+
+  size_t tweenCount = m_targets.size ();
+  for (unsigned int c = 0; c < 3; ++c)
+    m_current[c].resize (tweenCount);
+  m_jobs->parallelFor (tweenCount, CHUNK_SIZE, [&] (size_t begin, size_t end)
+  {
+    advance (begin, end, seconds);
+  });
+
+  // Hand each value to its Mesh.  Going backward lets finished tweens be
+  //   replaced by ones already handed over.
+  m_moved.clear ();
+  for (size_t tween = tweenCount; tween-- > 0; )
+  {
+    uint32_t object = m_targets[tween] / CHANNEL_COUNT;
+    Channel channel = Channel (m_targets[tween] % CHANNEL_COUNT);
+    if (!m_isMoved[object])
+    {
+      m_isMoved[object] = 1;
+      m_moved.push_back (object);
+    }
+    for (unsigned int c = 0; c < 3; ++c)
+      value (object, channel, c) = m_current[c][tween];
+    if (m_repeats[tween] == ONCE && m_phases[tween] >= 1.0f)
+      removeTween (tween);
+  }
+
+  m_jobs->parallelFor (m_moved.size (), CHUNK_SIZE, [&] (size_t begin, size_t end)
+  {
+    for (size_t movedNum = begin; movedNum < end; ++movedNum)
+      pose (m_moved[movedNum]);
+  });
+  for (uint32_t object : m_moved)
+    m_isMoved[object] = 0;
+
+  std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now () - start;
+  m_updateTimes.add (elapsed.count ());
+}
+
+unsigned int
+TweenSystem::getTweenCount () const
+{
+  return m_targets.size ();
+}
+
+unsigned int
+TweenSystem::getThreadCount () const
+{
+  return m_jobs->getThreadCount ();
+}
+
+const TimingHistory&
+TweenSystem::getUpdateTimes () const
+{
+  return m_updateTimes;
+}
+
+void
+TweenSystem::start (Mesh* mesh, Channel channel, const Vector3& to, float seconds, Easing easing,
+		    Repeat repeat)
+{
+  assert (seconds > 0.0f);
+  uint32_t object = findObject (mesh);
+  uint32_t& tween = m_channelTweens[object * CHANNEL_COUNT + channel];
+  if (tween == NO_TWEEN)
+  {
+    tween = m_targets.size ();
+    m_targets.push_back (object * CHANNEL_COUNT + channel);
+    m_phases.push_back (0.0f);
+    m_rates.push_back (0.0f);
+    m_wraps.push_back (0.0f);
+    m_folds.push_back (0.0f);
+    m_easeCubic.push_back (0.0f);
+    m_easeSquare.push_back (0.0f);
+    m_easeLinear.push_back (0.0f);
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+      m_from[c].push_back (0.0f);
+      m_change[c].push_back (0.0f);
+    }
+    m_repeats.push_back (ONCE);
+  }
+  m_phases[tween] = 0.0f;
+  m_rates[tween] = 1.0f / seconds;
+  // A ONCE tween is removed as soon as its phase reaches 1, so it never
+  //   wraps.
+  m_wraps[tween] = repeat == LOOP ? 1.0f : repeat == PING_PONG ? 2.0f
+    : std::numeric_limits<float>::max ();
+  m_folds[tween] = repeat == PING_PONG ? 1.0f : 0.0f;
+  m_easeCubic[tween] = EASING_CURVES[easing].a;
+  m_easeSquare[tween] = EASING_CURVES[easing].b;
+  m_easeLinear[tween] = EASING_CURVES[easing].c;
+  float target[3] = { to.m_x, to.m_y, to.m_z };
+  for (unsigned int c = 0; c < 3; ++c)
+  {
+    m_from[c][tween] = value (object, channel, c);
+    m_change[c][tween] = target[c] - m_from[c][tween];
+  }
+  m_repeats[tween] = repeat;
+}
+
+uint32_t
+TweenSystem::findObject (Mesh* mesh)
+{
+  std::unordered_map<Mesh*, uint32_t>::iterator found = m_objects.find (mesh);
+  if (found != m_objects.end ())
+    return found->second;
+  uint32_t object = m_meshes.size ();
+  m_objects.insert (std::make_pair (mesh, object));
+  m_meshes.push_back (mesh);
+  Transform world = mesh->getWorld ();
+  Matrix3 orientation = world.getOrientation ();
+  m_bases.insert (m_bases.end (), orientation.data (), orientation.data () + 9);
+  m_bases.insert (m_bases.end (), { world.getPosition ().m_x, world.getPosition ().m_y,
+				    world.getPosition ().m_z });
+  m_revisions.push_back (mesh->getRevision ());
+  for (unsigned int channel = 0; channel < CHANNEL_COUNT; ++channel)
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+      m_values.push_back (channel == SCALE ? 1.0f : 0.0f);
+      m_posedValues.push_back (channel == SCALE ? 1.0f : 0.0f);
+    }
+  m_channelTweens.resize (m_channelTweens.size () + CHANNEL_COUNT, NO_TWEEN);
+  m_isMoved.push_back (0);
+  return object;
+}
+
+float&
+TweenSystem::value (uint32_t object, Channel channel, unsigned int component)
+{
+  return m_values[(object * CHANNEL_COUNT + channel) * 3 + component];
+}
+
+void
+TweenSystem::removeTween (uint32_t tween)
+{
+  m_channelTweens[m_targets[tween]] = NO_TWEEN;
+  uint32_t last = m_targets.size () - 1;
+  if (tween != last)
+  {
+    m_targets[tween] = m_targets[last];
+    m_phases[tween] = m_phases[last];
+    m_rates[tween] = m_rates[last];
+    m_wraps[tween] = m_wraps[last];
+    m_folds[tween] = m_folds[last];
+    m_easeCubic[tween] = m_easeCubic[last];
+    m_easeSquare[tween] = m_easeSquare[last];
+    m_easeLinear[tween] = m_easeLinear[last];
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+      m_from[c][tween] = m_from[c][last];
+      m_change[c][tween] = m_change[c][last];
+    }
+    m_repeats[tween] = m_repeats[last];
+    m_channelTweens[m_targets[tween]] = tween;
+  }
+  m_targets.pop_back ();
+  m_phases.pop_back ();
+  m_rates.pop_back ();
+  m_wraps.pop_back ();
+  m_folds.pop_back ();
+  m_easeCubic.pop_back ();
+  m_easeSquare.pop_back ();
+  m_easeLinear.pop_back ();
+  for (unsigned int c = 0; c < 3; ++c)
+  {
+    m_from[c].pop_back ();
+    m_change[c].pop_back ();
+  }
+  m_repeats.pop_back ();
+}
+
+void
+TweenSystem::advance (size_t begin, size_t end, float seconds)
+{
+  size_t tween = begin;
+#ifdef __SSE2__
+  const __m128 ones = _mm_set1_ps (1.0f);
+  const __m128 signBit = _mm_set1_ps (-0.0f);
+  const __m128 step = _mm_set1_ps (seconds);
+  for ( ; tween + 4 <= end; tween += 4)
+  {
+    __m128 wrap = _mm_loadu_ps (&m_wraps[tween]);
+    __m128 phase = _mm_add_ps (_mm_loadu_ps (&m_phases[tween]),
+			       _mm_mul_ps (step, _mm_loadu_ps (&m_rates[tween])));
+    // Phases are never negative, so truncating is flooring.
+    __m128 laps = _mm_cvtepi32_ps (_mm_cvttps_epi32 (_mm_div_ps (phase, wrap)));
+    phase = _mm_sub_ps (phase, _mm_mul_ps (laps, wrap));
+    _mm_storeu_ps (&m_phases[tween], phase);
+
+    // Out and back, 1 - |phase - 1|, for folded tweens; min (phase, 1)
+    //   for the rest.
+    __m128 fold = _mm_loadu_ps (&m_folds[tween]);
+    __m128 folded = _mm_sub_ps (ones, _mm_andnot_ps (signBit, _mm_sub_ps (phase, ones)));
+    __m128 u = _mm_add_ps (_mm_mul_ps (fold, folded),
+			   _mm_mul_ps (_mm_sub_ps (ones, fold), _mm_min_ps (phase, ones)));
+    __m128 eased = _mm_add_ps (_mm_mul_ps (_mm_loadu_ps (&m_easeCubic[tween]), u),
+			       _mm_loadu_ps (&m_easeSquare[tween]));
+    eased = _mm_add_ps (_mm_mul_ps (eased, u), _mm_loadu_ps (&m_easeLinear[tween]));
+    eased = _mm_mul_ps (eased, u);
+    for (unsigned int c = 0; c < 3; ++c)
+      _mm_storeu_ps (&m_current[c][tween],
+		     _mm_add_ps (_mm_loadu_ps (&m_from[c][tween]),
+				 _mm_mul_ps (_mm_loadu_ps (&m_change[c][tween]), eased)));
+  }
+#endif
+  for ( ; tween < end; ++tween)
+  {
+    float phase = m_phases[tween] + seconds * m_rates[tween];
+    phase -= std::floor (phase / m_wraps[tween]) * m_wraps[tween];
+    m_phases[tween] = phase;
+    float fold = m_folds[tween];
+    float u = fold * (1.0f - std::abs (phase - 1.0f)) + (1.0f - fold) * std::min (phase, 1.0f);
+    float eased = ((m_easeCubic[tween] * u + m_easeSquare[tween]) * u + m_easeLinear[tween]) * u;
+    for (unsigned int c = 0; c < 3; ++c)
+      m_current[c][tween] = m_from[c][tween] + m_change[c][tween] * eased;
+  }
+}
+
+/// \brief Works out the turn and scale a Mesh's channels make.
+/// \param[in] values The Mesh's channel values: offset, angles, and scale.
+/// \param[out] orientation The orientation they give relative to the
+///   Mesh's base, as 9 floats, column by column.
+static void
+channelOrientation (const float* values, float orientation[9])
+{
+  const float* angles = values + 3;
+  const float* scale = values + 6;
+  // The turn about y, then x, then z, multiplied out.
+  float radians = static_cast<float> (M_PI) / 180.0f;
+  float sx = std::sin (angles[0] * radians), cx = std::cos (angles[0] * radians);
+  float sy = std::sin (angles[1] * radians), cy = std::cos (angles[1] * radians);
+  float sz = std::sin (angles[2] * radians), cz = std::cos (angles[2] * radians);
+  float columns[9] = { cz * cy + sz * sx * sy, sz * cx, sz * sx * cy - cz * sy,
+		       cz * sx * sy - sz * cy, cz * cx, sz * sy + cz * sx * cy,
+		       cx * sy, -sx, cx * cy };
+  for (unsigned int i = 0; i < 9; ++i)
+    orientation[i] = columns[i] * scale[i / 3];
+}
+
+void
+TweenSystem::pose (uint32_t object)
+{
+  Mesh* mesh = m_meshes[object];
+  float* base = &m_bases[object * BASE_FLOATS];
+  float* posed = &m_posedValues[object * CHANNEL_COUNT * 3];
+  if (mesh->getRevision () != m_revisions[object])
+  {
+    // Something else moved the Mesh since it was last posed here, so carry
+    //   on from there: take the channels it was posed with back out of
+    //   where it is now.
+    Transform moved = mesh->getWorld ();
+    float local[9];
+    channelOrientation (posed, local);
+    Matrix3 undo (local[0], local[1], local[2], local[3], local[4], local[5],
+		  local[6], local[7], local[8]);
+    Matrix3 orientation = moved.getOrientation ();
+    if (undo.determinant () != 0.0f)
+    {
+      undo.invert ();
+      orientation = orientation * undo;
+    }
+    Vector3 position = moved.getPosition () - Vector3 (posed[0], posed[1], posed[2]);
+    std::copy (orientation.data (), orientation.data () + 9, base);
+    base[9] = position.m_x;
+    base[10] = position.m_y;
+    base[11] = position.m_z;
+  }
+
+  const float* values = &value (object, OFFSET, 0);
+  std::copy (values, values + CHANNEL_COUNT * 3, posed);
+  float local[9], world[9];
+  channelOrientation (values, local);
+  for (unsigned int column = 0; column < 3; ++column)
+    for (unsigned int row = 0; row < 3; ++row)
+      world[column * 3 + row] = base[row] * local[column * 3] + base[3 + row] * local[column * 3 + 1]
+	+ base[6 + row] * local[column * 3 + 2];
+  Transform pose;
+  pose.setOrientation (Vector3 (world[0], world[1], world[2]), Vector3 (world[3], world[4], world[5]),
+		       Vector3 (world[6], world[7], world[8]));
+  pose.setPosition (base[9] + values[0], base[10] + values[1], base[11] + values[2]);
+  mesh->moveTo (pose);
+  m_revisions[object] = mesh->getRevision ();
+}
@@ -0,0 +1,256 @@
+/// \file TweenSystem.hpp
+/// \brief Declaration of TweenSystem class.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef TWEEN_SYSTEM_HPP
+#define TWEEN_SYSTEM_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "JobSystem.hpp"
+#include "Mesh.hpp"
+#include "TimingHistory.hpp"
+#include "Vector3.hpp"
+
+/// \brief Moves, turns, and scales Meshes smoothly over time.
+/// Each tween animates one of a Mesh's three channels (its offset, its
+///   angles about its own x, y, and z axes, or its scale along them) from
+///   one value to another.  Tweens are stored as parallel arrays, one per
+///   field, and every easing curve is a cubic, so each update advances all
+///   of them in one branch-free pass four at a time (with SSE2), split
+///   among a JobSystem's threads when there are enough.  Each Mesh a tween
+///   moved then gets its new world transform: where it was when first
+///   tweened, moved by its offset, turned by its angles, and scaled by its
+///   scale.
+/// A Mesh moved some other way while tweened carries on from where it was
+///   moved to.  Everything here must be called from the one thread that
+///   moves Meshes, typically from updateScene.
+class TweenSystem
+{
+public:
+
+  /// \brief How a tween speeds up and slows down.
+  enum Easing
+  {
+    /// At a constant speed.
+    LINEAR,
+    /// Speeding up from rest (quadratic).
+    EASE_IN,
+    /// Slowing down to rest (quadratic).
+    EASE_OUT,
+    /// Speeding up, then slowing down (smoothstep).
+    EASE_IN_OUT,
+    /// Speeding up from rest (cubic).
+    CUBIC_IN,
+    /// Slowing down to rest (cubic).
+    CUBIC_OUT
+  };
+
+  /// \brief What a tween does once it reaches the end.
+  enum Repeat
+  {
+    /// Stops there and is removed.
+    ONCE,
+    /// Jumps back to the start.
+    LOOP,
+    /// Heads back to the start, then out again.
+    PING_PONG
+  };
+
+  /// \brief Constructs a TweenSystem with no tweens.
+  /// \param[in] jobs The JobSystem to update tweens on, or nullptr for the
+  ///   shared one.  It must outlive this TweenSystem.
+  explicit TweenSystem (JobSystem* jobs = nullptr);
+
+  /// \brief Copy constructor removed because you shouldn't be copying
+  ///   TweenSystems.
+  TweenSystem (const TweenSystem&) = delete;
+
+  /// \brief Assignment operator removed because you shouldn't be assigning
+  ///   TweenSystems.
+  TweenSystem&
+  operator= (const TweenSystem&) = delete;
+
+  /// \brief Starts moving a Mesh, replacing any move it was making.
+  /// \param[in] mesh The Mesh.  It must stay alive until stop is called
+  ///   for it or this TweenSystem is destroyed.
+  /// \param[in] by How far to move it, in world coordinates, from where the
+  ///   last move left it.
+  /// \param[in] seconds How long to take, which must be positive.
+  /// \param[in] easing How to speed up and slow down.
+  /// \param[in] repeat What to do at the end.
+  void
+  translate (Mesh* mesh, const Vector3& by, float seconds, Easing easing = EASE_IN_OUT,
+	     Repeat repeat = ONCE);
+
+  /// \brief Starts turning a Mesh, replacing any turn it was making.
+  /// \param[in] mesh The Mesh, as for translate.
+  /// \param[in] byDegrees How much more to turn it about its own x, y, and
+  ///   z axes, applied in the order y, x, z.
+  /// \param[in] seconds How long to take, which must be positive.
+  /// \param[in] easing How to speed up and slow down.
+  /// \param[in] repeat What to do at the end.
+  void
+  rotate (Mesh* mesh, const Vector3& byDegrees, float seconds, Easing easing = EASE_IN_OUT,
+	  Repeat repeat = ONCE);
+
+  /// \brief Starts scaling a Mesh, replacing any scaling it was doing.
+  /// \param[in] mesh The Mesh, as for translate.
+  /// \param[in] by How much more to scale it along its own x, y, and z
+  ///   axes, which must not be 0.
+  /// \param[in] seconds How long to take, which must be positive.
+  /// \param[in] easing How to speed up and slow down.
+  /// \param[in] repeat What to do at the end.
+  void
+  scale (Mesh* mesh, const Vector3& by, float seconds, Easing easing = EASE_IN_OUT,
+	 Repeat repeat = ONCE);
+
+  /// \brief Stops every tween of a Mesh and forgets it, leaving it where it
+  ///   is.  Call before a tweened Mesh is destroyed.
+  /// \param[in] mesh The Mesh, which need not have been tweened.
+  void
+  stop (Mesh* mesh);
+
+  /// \brief Moves every tween forward and poses the Meshes they move.
+  /// \param[in] seconds How far to move forward, which must not be
+  ///   negative.
+  void
+  update (float seconds);
+
+  /// \brief Gets the number of tweens running.
+  /// \return The number of tweens.
+  unsigned int
+  getTweenCount () const;
+
+  /// \brief Gets the most threads tweens are updated on, those of its
+  ///   JobSystem.
+  /// \return The number of threads, counting the one calling update.
+  unsigned int
+  getThreadCount () const;
+
+  /// \brief Gets how long each update took.
+  /// \return One sample per update with any tweens, in milliseconds.
+  const TimingHistory&
+  getUpdateTimes () const;
+
+private:
+
+  /// \brief The parts of a Mesh's pose a tween can animate.
+  enum Channel
+  {
+    /// Its offset from where it started.
+    OFFSET,
+    /// Its angles about its own axes, in degrees.
+    ANGLES,
+    /// Its scale along its own axes.
+    SCALE,
+    /// The number of channels.
+    CHANNEL_COUNT
+  };
+
+  /// Marks a channel with no tween.
+  static const uint32_t NO_TWEEN = ~0u;
+
+  /// The floats in m_bases per Mesh.
+  static const unsigned int BASE_FLOATS = 12;
+
+  /// \brief Starts a tween, replacing any on the same channel.
+  /// \param[in] mesh The Mesh.
+  /// \param[in] channel The channel.
+  /// \param[in] to The channel's value at the end.
+  /// \param[in] seconds How long to take.
+  /// \param[in] easing How to speed up and slow down.
+  /// \param[in] repeat What to do at the end.
+  void
+  start (Mesh* mesh, Channel channel, const Vector3& to, float seconds, Easing easing,
+	 Repeat repeat);
+
+  /// \brief Gets the position of a Mesh in the per-Mesh arrays, adding it
+  ///   there if it is new.
+  /// \param[in] mesh The Mesh.
+  /// \return Its position.
+  uint32_t
+  findObject (Mesh* mesh);
+
+  /// \brief Gets one component of a Mesh's channel.
+  /// \param[in] object The Mesh's position in the per-Mesh arrays.
+  /// \param[in] channel The channel.
+  /// \param[in] component 0, 1, or 2.
+  /// \return The value.
+  float&
+  value (uint32_t object, Channel channel, unsigned int component);
+
+  /// \brief Removes a tween by moving the last one into its place.
+  /// \param[in] tween The tween's position.
+  void
+  removeTween (uint32_t tween);
+
+  /// \brief Moves some tweens forward and works out their channels' values.
+  /// \param[in] begin The first tween.
+  /// \param[in] end One past the last.
+  /// \param[in] seconds How far to move forward.
+  void
+  advance (size_t begin, size_t end, float seconds);
+
+  /// \brief Works out and sets one Mesh's world transform from its
+  ///   channels, first resetting its base if something else has moved it.
+  /// \param[in] object The Mesh's position in the per-Mesh arrays.
+  void
+  pose (uint32_t object);
+
+  // Per tween.  Each tween's channel value at progress u, eased by
+  //   e (u) = ((a u + b) u + c) u, is from + change * e (u).
+  /// Which Mesh (times CHANNEL_COUNT) and channel each tween animates.
+  std::vector<uint32_t> m_targets;
+  /// How far through its curve each tween is: from 0 to 1 (or to 2 for
+  ///   PING_PONG, which comes back over the second half).
+  std::vector<float> m_phases;
+  /// How much of each tween's curve passes per second.
+  std::vector<float> m_rates;
+  /// Where each tween's phase wraps back to 0: 1, 2, or huge for ONCE.
+  std::vector<float> m_wraps;
+  /// 1 for tweens that come back over the second half of their phase, else
+  ///   0.
+  std::vector<float> m_folds;
+  /// Each tween's easing coefficients a, b, and c.
+  std::vector<float> m_easeCubic, m_easeSquare, m_easeLinear;
+  /// Each tween's channel value at the start, component by component.
+  std::vector<float> m_from[3];
+  /// Each tween's change in channel value over its curve.
+  std::vector<float> m_change[3];
+  /// Each tween's channel value as of the last update.
+  std::vector<float> m_current[3];
+  /// What each tween does at its end.
+  std::vector<uint8_t> m_repeats;
+
+  // Per Mesh.
+  /// The position of each Mesh in the per-Mesh arrays.
+  std::unordered_map<Mesh*, uint32_t> m_objects;
+  /// Each Mesh.
+  std::vector<Mesh*> m_meshes;
+  /// Each Mesh's world transform with its channels taken out: its
+  ///   orientation column by column, then its position.
+  std::vector<float> m_bases;
+  /// Each Mesh's revision after it was last posed here.
+  std::vector<unsigned long> m_revisions;
+  /// Each Mesh's channel values, CHANNEL_COUNT * 3 per Mesh.
+  std::vector<float> m_values;
+  /// Each Mesh's channel values when it was last posed.
+  std::vector<float> m_posedValues;
+  /// The tween on each channel of each Mesh, or NO_TWEEN.
+  std::vector<uint32_t> m_channelTweens;
+  /// Whether each Mesh is in m_moved.
+  std::vector<uint8_t> m_isMoved;
+  /// The Meshes tweens moved in the current update.
+  std::vector<uint32_t> m_moved;
+
+  /// The JobSystem tweens are updated on.
+  JobSystem* m_jobs;
+  /// How long each update took, in milliseconds.
+  TimingHistory m_updateTimes;
+};
+
+#endif//TWEEN_SYSTEM_HPP
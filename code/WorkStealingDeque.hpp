@@ -0,0 +1,130 @@
+/// \file WorkStealingDeque.hpp
+/// \brief Declaration and definition of the WorkStealingDeque class
+///   template.
+/// \author Ethan Gingrich
+/// \version A08
+
+#ifndef WORK_STEALING_DEQUE_HPP
+#define WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <cstdint>
+
+/// \brief A fixed-size lock-free deque that one thread pushes onto and pops
+///   from at the bottom while any other thread may steal from the top.
+/// The owner works last in, first out, so it keeps working on what it just
+///   split off while it is still in cache; thieves take the oldest, and
+///   typically biggest, piece.  Pushes and pops are a few loads and stores
+///   and only touch the same atomic as a thief when one item is left.  This
+///   is the Chase-Lev deque as written for C11 atomics by Lê et al.  When
+///   the deque is full, pushes fail rather than grow.
+/// \tparam T The type of value stored, typically a pointer.  It must be
+///   trivially copyable.
+/// \tparam Capacity The number of slots, which must be a power of two.
+template<typename T, unsigned int Capacity>
+class WorkStealingDeque
+{
+  static_assert (Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+		 "WorkStealingDeque capacity must be a power of two");
+
+public:
+
+  /// \brief Constructs an empty deque.
+  WorkStealingDeque ()
+    : m_top (0), m_bottom (0), m_slots ()
+  {
+  }
+
+  /// \brief Copy constructor removed because deques are shared between
+  ///   threads.
+  WorkStealingDeque (const WorkStealingDeque&) = delete;
+
+  /// \brief Assignment operator removed because deques are shared between
+  ///   threads.
+  WorkStealingDeque&
+  operator= (const WorkStealingDeque&) = delete;
+
+  /// \brief Adds a value at the bottom.  Owner thread only.
+  /// \param[in] value The value.
+  /// \return True if it was added, or false if the deque was full.
+  bool
+  push (T value)
+  {
+    int64_t bottom = m_bottom.load (std::memory_order_relaxed);
+    int64_t top = m_top.load (std::memory_order_acquire);
+    if (bottom - top >= static_cast<int64_t> (Capacity))
+      return false;
+    m_slots[bottom & (Capacity - 1)].store (value, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+    m_bottom.store (bottom + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /// \brief Removes the value at the bottom, the one most recently pushed,
+  ///   if any.  Owner thread only.
+  /// \param[out] value Receives the value that was removed.
+  /// \return True if a value was removed, or false if the deque was empty
+  ///   or a thief took the last one first.
+  bool
+  pop (T& value)
+  {
+    int64_t bottom = m_bottom.load (std::memory_order_relaxed) - 1;
+    // Claim the bottom slot before looking at top, so a thief either sees
+    //   the claim or is seen here.
+    m_bottom.store (bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_seq_cst);
+    int64_t top = m_top.load (std::memory_order_relaxed);
+    if (top > bottom)
+    {
+      m_bottom.store (bottom + 1, std::memory_order_relaxed);
+      return false;
+    }
+    value = m_slots[bottom & (Capacity - 1)].load (std::memory_order_relaxed);
+    if (top < bottom)
+      return true;
+    // The last value: race any thief for it.
+    bool won = m_top.compare_exchange_strong (top, top + 1, std::memory_order_seq_cst,
+					      std::memory_order_relaxed);
+    m_bottom.store (bottom + 1, std::memory_order_relaxed);
+    return won;
+  }
+
+  /// \brief Removes the value at the top, the oldest, if any.  Safe to call
+  ///   from any thread.
+  /// \param[out] value Receives the value that was removed.
+  /// \return True if a value was removed, or false if the deque was empty
+  ///   or another thread took it first.
+  bool
+  steal (T& value)
+  {
+    int64_t top = m_top.load (std::memory_order_acquire);
+    std::atomic_thread_fence (std::memory_order_seq_cst);
+    int64_t bottom = m_bottom.load (std::memory_order_acquire);
+    if (top >= bottom)
+      return false;
+    value = m_slots[top & (Capacity - 1)].load (std::memory_order_relaxed);
+    return m_top.compare_exchange_strong (top, top + 1, std::memory_order_seq_cst,
+					  std::memory_order_relaxed);
+  }
+
+  /// \brief Tests whether the deque looks empty.  Safe to call from any
+  ///   thread, though the answer may be stale by the time it is used.
+  /// \return True if there was nothing to pop or steal.
+  bool
+  empty () const
+  {
+    return m_top.load (std::memory_order_acquire) >= m_bottom.load (std::memory_order_acquire);
+  }
+
+private:
+
+  /// The next value to steal.  Written by thieves and, for the last value,
+  ///   the owner.
+  alignas (64) std::atomic<int64_t> m_top;
+  /// One past the last value pushed.  Only written by the owner.
+  alignas (64) std::atomic<int64_t> m_bottom;
+  /// The values, at their positions modulo Capacity.
+  std::atomic<T> m_slots[Capacity];
+};
+
+#endif//WORK_STEALING_DEQUE_HPP